@@ -0,0 +1,61 @@
+/*
+ * Catalogo embutido do Detective Quest: textos e associacoes de mapas/mansao_padrao.txt
+ * Gerado por: detective_quest_mestre --gerar-catalogo mapas/mansao_padrao.txt catalogo_embutido.h (nao edite a mao)
+ */
+
+static const char* const textosEmbutidos[] = {
+    "",
+    "Flores venenosas recentemente colhidas",
+    "Cofre Secreto",
+    "Documento com assinatura falsificada",
+    "Frasco vazio de ars\303\252nico",
+    "Cozinha",
+    "Cinzas ainda quentes na lareira",
+    "Carta de ameaca parcialmente queimada",
+    "Estufa",
+    "Jardim",
+    "Biblioteca",
+    "Escritorio",
+    "Hall de Entrada",
+    "Uma pegada estranha na entrada principal",
+    "Sr. Williams",
+    "Piano Antigo",
+    "Partitura com codigo secreto",
+    "Sala de Musica",
+    "Despensa",
+    "Sala de Estar",
+    "Mordomo James",
+    "Luvas com residuos toxicos",
+    "Sra. Johnson",
+    "Faca com manchas suspeitas",
+    "Dr. Smith",
+    "Livro sobre venenos deixado aberto na mesa",
+};
+
+static const uint64_t hashesEmbutidos[] = {
+    0xefd01f60ba992926ULL, 0x22332216f1a70fe8ULL, 0x93c784b839d4d9a3ULL, 0x27c85dfcdb129c81ULL,
+    0xa2fe5642afd1fa5bULL, 0x3df8a78091955325ULL, 0x9b638eb46e0116c8ULL, 0x3fb307be7208c588ULL,
+    0xbe3e4338fa1f912dULL, 0x02e8f75c1dcfdba4ULL, 0xb84131366d92f652ULL, 0x54bcac5f994dbe0aULL,
+    0xd4a31967b5fe7084ULL, 0x96ef7b34aea3fb61ULL, 0x026c6e93c984a8d3ULL, 0x696fe76f7c08cea2ULL,
+    0x6d05fec6469c7eb5ULL, 0xdb81ff52b35e6a6cULL, 0xa56e544397a29cf9ULL, 0xe5c85b4bae427d95ULL,
+    0x96347ecc9e6cfce6ULL, 0xc3d76443d33421d3ULL, 0xbcae529c3430da3bULL, 0x2579b52eaafbf60eULL,
+    0x4c413437a3a85de6ULL, 0xf8f836ecae60c1e9ULL,
+};
+
+static const uint32_t deslocamentosEmbutidos[] = {
+    5, 8, 1, 8, 4, 83, 7,
+};
+
+static const IdTexto suspeitosEmbutidos[] = {
+    ID_TEXTO_INVALIDO, 24, ID_TEXTO_INVALIDO, 22,
+    24, ID_TEXTO_INVALIDO, 14, 22,
+    ID_TEXTO_INVALIDO, ID_TEXTO_INVALIDO, ID_TEXTO_INVALIDO, ID_TEXTO_INVALIDO,
+    ID_TEXTO_INVALIDO, 14, ID_TEXTO_INVALIDO, ID_TEXTO_INVALIDO,
+    14, ID_TEXTO_INVALIDO, ID_TEXTO_INVALIDO, ID_TEXTO_INVALIDO,
+    ID_TEXTO_INVALIDO, 20, ID_TEXTO_INVALIDO, 20,
+    ID_TEXTO_INVALIDO, 24,
+};
+
+static const CatalogoEmbutido catalogoEmbutido = {
+    26, 7, 10, textosEmbutidos, hashesEmbutidos, deslocamentosEmbutidos, suspeitosEmbutidos
+};
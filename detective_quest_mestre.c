@@ -1,525 +1,11487 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <stdatomic.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#else
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// Servidor de sessões e gerador de carga orientados a eventos (epoll)
+#ifdef __linux__
+#define DQ_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+// Contagem de bits com AVX2 (escolhida em tempo de execução) em x86 com GCC/Clang
+#if defined(__GNUC__) && defined(__x86_64__)
+#define DQ_SIMD_X86
+#include <immintrin.h>
+#endif
 
-#define TAMANHO_HASH 20  // Tamanho da tabela hash para pistas/suspeitos
+#define CAPACIDADE_INICIAL_HASH 16  // Capacidade inicial da tabela hash (sempre potência de 2)
+#define CARGA_MAXIMA_HASH_NUM 7     // Fator de carga máximo da tabela hash: 7/10
+#define CARGA_MAXIMA_HASH_DEN 10
+#define TAMANHO_BLOCO_ARENA (1 << 20)  // Tamanho padrão de cada bloco da arena (1 MiB)
+#define ALINHAMENTO_ARENA 16           // Alinhamento das alocações feitas na arena
+#define ID_TEXTO_VAZIO 0               // Id do texto vazio "" (sala sem pista)
+#define ID_TEXTO_INVALIDO UINT32_MAX   // Id inexistente (também marca posições livres)
+#define SALA_NENHUMA UINT32_MAX        // Índice de sala inexistente nos mapas carregados
+#define VERSAO_MAPA_BINARIO 1          // Versão do formato binário de mapas (.dqm)
+#define TAMANHO_LINHA_MAPA 4096        // Tamanho máximo de uma linha do formato texto
+#define TAMANHO_FATIA_LOTE 64          // Sessões retiradas de uma faixa de trabalho por vez
+#define MAX_THREADS_LOTE 256           // Limite de threads do modo em lote paralelo
+#define INDICE_NENHUM UINT32_MAX       // Pista/suspeito inexistente nos vetores do solucionador
+#define MARCA_SAIDA_SALA 0x80000000u   // Marca de "sair da sala" na pilha do solucionador
+#define TAREFAS_POR_THREAD 16          // Subárvores por thread na divisão do solucionador
+#define MAX_EXEMPLOS_SEM_SOLUCAO 5     // Caminhos sem acusação possível exibidos pelo solucionador
+#define PILHA_LOCAL_ITERADOR 64        // Níveis guardados no próprio iterador antes de usar o heap
+#define VERSAO_SNAPSHOT 1              // Versão do formato binário de estados de sessões (.dqs)
+#define PISTAS_POR_LOTE_RESTAURACAO 64 // Pistas mescladas ao caderno por vez na restauração
+#define PALAVRAS_POR_BLOCO_PONTUACAO 256  // Palavras do caderno de bits pontuadas por vez (2 KiB, cabe na L1)
+#define PILHA_LOCAL_INDICE_TEXTOS 128  // Nós pendentes guardados na pilha antes de usar o heap
+#define TAMANHO_LOCAL_DISTANCIA 4096   // Células da matriz de edição guardadas na pilha
+#define DISTANCIA_MAXIMA_ACUSACAO 2    // Erros de digitação tolerados no nome do acusado
+#define MAX_RESULTADOS_PREFIXO 20      // Pistas exibidas por busca de prefixo no jogo
+#define PISTAS_PARA_CONDENACAO 2       // Pistas distintas contra um suspeito que sustentam a acusação
+#define CONDENACAO_INALCANCAVEL UINT32_MAX         // Nenhum caminho a partir da sala leva a uma condenação
+#define CONDENACAO_NAO_CALCULADA (UINT32_MAX - 1)  // A sala ainda não passou por resumirCondenacoes
+#define TAMANHO_PREFIXO_BUSCA 100      // Início de pista digitado na busca (com o '\0')
+#define TAMANHO_NOME_ACUSADO 50        // Nome digitado na acusação (com o '\0')
+#define MAX_SUSPEITOS_LISTADOS 12      // Suspeitos citados pelo nome no início da acusação
+#define TAMANHO_NOME_CASO 100          // Número ou nome do caso digitado pelo jogador (com o '\0')
+#define ORCAMENTO_PADRAO_CASOS_KIB (256 * 1024)  // Memória dos casos carregados antes de despejar (256 MiB)
+#define TAMANHO_BUFFER_SAIDA (1 << 16) // Buffer reutilizável da saída do jogo (64 KiB)
+#define TAMANHO_BUFFER_CONEXAO 4096    // Buffer inicial de saída de cada conexão do servidor (cresce se preciso)
+#define SALAS_POR_TAREFA_GERADOR (1 << 16)   // Maior subárvore gerada de uma vez por uma thread
+#define SALAS_POR_BLOCO_GRAVACAO (1 << 21)   // Salas geradas em memória antes de cada escrita no arquivo
+#define SALAS_POR_JANELA_PISTAS 64           // Salas sorteadas juntas na distribuição das pistas
+#define TAMANHO_ENTRADA_CONEXAO 512    // Linha mais longa aceita de um jogador conectado
+#define TAMANHO_BLOCO_CONEXAO 4096     // Blocos da arena do caderno de cada conexão
+#define EVENTOS_POR_ESPERA 256         // Eventos tratados por chamada ao epoll
+#define FILA_CONEXOES_SERVIDOR 4096    // Conexões pendentes aceitas pelo listen
+#define THREADS_LEITOR_CASOS 4         // Threads que leem mapas do acervo para o servidor
+#define CONEXOES_PADRAO_CARGA 100      // Conexões simultâneas do gerador de carga
+#define SESSOES_POR_CONEXAO_CARGA 10   // Sessões por conexão quando o total não é informado
+#define TAMANHO_RECEBIDO_CARGA 4096    // Linha mais longa guardada por cliente do gerador de carga
+#define ESPERA_MAXIMA_CARGA_MS 10000   // Silêncio do servidor que interrompe o gerador de carga
+#define MAX_LEITORES_TABELA 256        // Leitores registrados ao mesmo tempo na tabela hash concorrente
+#define APOSENTADOS_POR_RECUPERACAO 64 // Blocos substituídos acumulados antes de tentar liberá-los
+
+/**
+ * Tipo que identifica um texto internado (pista, nome de sala ou de suspeito)
+ * Cada texto distinto é armazenado uma única vez; comparar ids equivale a comparar textos
+ */
+typedef uint32_t IdTexto;
 
 /**
  * Estrutura que representa uma pista coletada
- * Usada para criar uma árvore binária de busca (BST) das pistas
+ * Usada para criar uma árvore binária de busca (BST) das pistas; a altura
+ * permite mantê-la balanceada (AVL) com inserirPistaBalanceada
  */
 typedef struct PistaNode {
-    char conteudo[100];              // Conteúdo da pista encontrada
+    IdTexto conteudo;                // Conteúdo da pista encontrada (texto internado)
+    int altura;                      // Altura da subárvore (folha = 1)
     struct PistaNode* esquerda;      // Ponteiro para pista lexicograficamente menor
     struct PistaNode* direita;       // Ponteiro para pista lexicograficamente maior
 } PistaNode;
 
+/**
+ * Estrutura de um iterador em ordem (alfabética) sobre o caderno de pistas
+ * Usa uma pilha explícita de ancestrais: árvores rasas usam apenas pilhaLocal e árvores
+ * profundas (BST simples degenerada) crescem a pilha no heap, sem recursão
+ */
+typedef struct IteradorPistas {
+    PistaNode** pilha;          // Ancestrais cuja visita está pendente
+    size_t topo;                // Quantidade de ancestrais na pilha
+    size_t capacidade;          // Capacidade atual da pilha
+    PistaNode* proximo;         // Subárvore ainda não descida
+    int erro;                   // 1 se a pilha não pôde crescer (a iteração parou antes do fim)
+    PistaNode* pilhaLocal[PILHA_LOCAL_ITERADOR];
+} IteradorPistas;
+
 /**
  * Estrutura que representa uma sala da mansão
  * Cada sala possui um nome, uma pista opcional e ponteiros para duas salas adjacentes
  */
 typedef struct Sala {
-    char nome[50];           // Nome da sala
-    char pista[100];         // Pista encontrada nesta sala (pode estar vazia)
+    IdTexto nome;            // Nome da sala (texto internado)
+    IdTexto pista;           // Pista encontrada nesta sala (ID_TEXTO_VAZIO se não houver)
+    uint32_t salasAteCondenacao;  // Salas a descer até o caminho sustentar uma acusação (ver resumirCondenacoes)
     struct Sala* esquerda;   // Ponteiro para a sala à esquerda
     struct Sala* direita;    // Ponteiro para a sala à direita
 } Sala;
 
 /**
- * Estrutura que representa um nó da tabela hash
+ * Estrutura com um passo pendente da passada de resumirCondenacoes
+ */
+typedef struct PassoResumo {
+    Sala* sala;
+    int saida;               // 0 = entrar na sala, 1 = sair dela (os filhos já foram resumidos)
+} PassoResumo;
+
+/**
+ * Estrutura que representa o catálogo embutido (textos e associações fixados na compilação)
+ * Os textos têm ids fixos: o vazio é o id 0 e os demais ficam na posição dada por um hash
+ * perfeito mínimo (hash-and-displace), de modo que achar um texto custa uma posição e uma
+ * comparação; a associação pista -> suspeito é um vetor indexado pelo id da pista
+ */
+typedef struct CatalogoEmbutido {
+    uint32_t numTextos;             // Textos do catálogo, incluindo o vazio (id 0)
+    uint32_t numBaldes;             // Baldes do hash perfeito
+    uint32_t numAssociacoes;        // Pistas com suspeito associado
+    const char* const* textos;      // id -> texto
+    const uint64_t* hashes;         // id -> funcaoHash(texto)
+    const uint32_t* deslocamentos;  // balde -> deslocamento que separa seus textos
+    const IdTexto* suspeitos;       // id da pista -> id do suspeito (ID_TEXTO_INVALIDO = nenhum)
+} CatalogoEmbutido;
+
+/**
+ * Estrutura que representa uma associação pista/suspeito da tabela hash
  * Cada nó contém uma pista (chave) e o suspeito associado (valor)
  */
 typedef struct HashNode {
-    char pista[100];            // Chave: pista encontrada
-    char suspeito[50];          // Valor: nome do suspeito associado
-    struct HashNode* proximo;   // Ponteiro para o próximo nó (tratamento de colisões)
+    IdTexto pista;              // Chave: pista encontrada (ID_TEXTO_INVALIDO = posição livre)
+    IdTexto suspeito;           // Valor: nome do suspeito associado
 } HashNode;
 
+/**
+ * Estrutura que representa uma posição da tabela hash (endereçamento aberto)
+ * O nó fica embutido na posição, ao lado do hash completo da pista, de modo que
+ * a sondagem compara apenas inteiros e nunca precisa seguir ponteiros
+ */
+typedef struct EntradaHash {
+    uint64_t hash;              // Hash completo da pista armazenada
+    HashNode no;                // Associação armazenada
+} EntradaHash;
+
 /**
  * Estrutura que representa a tabela hash de pistas/suspeitos
+ * Usa endereçamento aberto com sondagem linear e cresce automaticamente
+ * (dobrando de tamanho) quando o fator de carga ultrapassa 7/10
  */
 typedef struct TabelaHash {
-    HashNode* tabela[TAMANHO_HASH];  // Array de ponteiros para os nós
+    EntradaHash* entradas;      // Vetor contíguo de posições (alocado na primeira inserção)
+    size_t capacidade;          // Número de posições (potência de 2, ou 0)
+    size_t quantidade;          // Número de associações armazenadas
+    const CatalogoEmbutido* embutido;  // Associações do catálogo embutido (NULL = nenhuma)
+    size_t substituidas;        // Pistas do catálogo embutido também armazenadas (têm precedência)
+    IdTexto* suspeitos;         // Suspeitos distintos em ordem alfabética (montados por suspeitosDaTabela)
+    size_t numSuspeitos;
 } TabelaHash;
 
 /**
- * Função: funcaoHash
- * Propósito: Calcular o índice na tabela hash para uma dada pista
- * Parâmetros: pista - string da pista para calcular o hash
- * Retorno: índice na tabela hash (0 a TAMANHO_HASH-1)
+ * Estrutura que representa uma associação da tabela hash concorrente
+ * Imutável depois de publicada: trocar o suspeito de uma pista publica uma entrada nova,
+ * de modo que um leitor nunca vê uma associação pela metade
  */
-int funcaoHash(const char* pista) {
-    int hash = 0;
-    for (int i = 0; pista[i] != '\0'; i++) {
-        hash += (int)pista[i];
-    }
-    return hash % TAMANHO_HASH;
-}
+typedef struct EntradaConcorrente {
+    uint64_t hash;              // Hash completo da pista (funcaoHash)
+    const char* suspeito;       // Nome do suspeito (aponta para dentro de textos)
+    char textos[];              // "pista\0suspeito\0"
+} EntradaConcorrente;
 
 /**
- * Função: criarTabelaHash
- * Propósito: Criar e inicializar uma nova tabela hash
- * Retorno: ponteiro para a tabela hash criada
+ * Estrutura que representa o vetor de posições da tabela hash concorrente
+ * Endereçamento aberto com sondagem linear sobre ponteiros para entradas imutáveis;
+ * o redimensionamento monta um vetor novo e o publica de uma só vez
  */
-TabelaHash* criarTabelaHash() {
-    TabelaHash* tabela = (TabelaHash*)malloc(sizeof(TabelaHash));
-    if (tabela == NULL) {
-        printf("Erro: Falha na alocação de memória para tabela hash!\n");
-        return NULL;
-    }
-    
-    // Inicializa todos os ponteiros como NULL
-    for (int i = 0; i < TAMANHO_HASH; i++) {
-        tabela->tabela[i] = NULL;
+typedef struct VetorHashConcorrente {
+    size_t capacidade;          // Número de posições (potência de 2)
+    _Atomic(EntradaConcorrente*) posicoes[];  // NULL = posição livre
+} VetorHashConcorrente;
+
+/**
+ * Estrutura que representa a vaga de um leitor da tabela hash concorrente
+ * Guarda a época anunciada pelo leitor enquanto ele está dentro de uma leitura;
+ * o preenchimento mantém cada vaga em sua própria linha de cache
+ */
+typedef struct LeitorTabela {
+    atomic_uint_least64_t epoca;  // Época anunciada (0 = fora de leitura)
+    atomic_int ocupada;           // 1 se a vaga pertence a um leitor registrado
+    char preenchimento[64 - sizeof(atomic_uint_least64_t) - sizeof(atomic_int)];
+} LeitorTabela;
+
+/**
+ * Estrutura que representa um bloco retirado da tabela concorrente e ainda não liberado
+ * (liberado quando nenhum leitor anunciou uma época anterior à da retirada)
+ */
+typedef struct BlocoAposentado {
+    void* bloco;                // Entrada ou vetor de posições substituído
+    uint64_t epoca;             // Época em que o bloco deixou de ser alcançável
+} BlocoAposentado;
+
+/**
+ * Estrutura que representa a tabela hash pista/suspeito compartilhada entre threads
+ * Leituras não usam travas nem laços de nova tentativa (wait-free); escritores se
+ * revezam por uma trava simples e a memória substituída é recuperada por épocas
+ */
+typedef struct TabelaHashConcorrente {
+    _Atomic(VetorHashConcorrente*) vetor;  // Vetor de posições publicado
+    atomic_uint_least64_t epoca;  // Época global (começa em 1)
+    atomic_flag travaEscrita;     // Serializa inserções e redimensionamentos
+    size_t quantidade;            // Associações armazenadas (protegida pela trava)
+    BlocoAposentado* aposentados; // Blocos à espera de liberação (protegidos pela trava)
+    size_t numAposentados;
+    size_t capacidadeAposentados;
+    size_t redimensionamentos;    // Quantas vezes o vetor foi substituído
+    atomic_int numLeitores;       // Vagas de leitores já usadas (limite da varredura)
+    LeitorTabela leitores[MAX_LEITORES_TABELA];
+} TabelaHashConcorrente;
+
+/**
+ * Estrutura que representa a ficha de um suspeito no índice de evidências
+ * Guarda quantas pistas coletadas apontam para ele e quais são elas
+ */
+typedef struct FichaSuspeito {
+    IdTexto suspeito;           // Nome do suspeito (texto internado)
+    int contagem;               // Número de pistas coletadas que apontam para ele
+    IdTexto* pistas;            // Pistas coletadas, na ordem da coleta
+    int capacidadePistas;       // Capacidade alocada do vetor de pistas
+} FichaSuspeito;
+
+/**
+ * Estrutura que representa o índice de evidências por suspeito
+ * É atualizado no momento em que cada pista é coletada, de modo que a acusação
+ * e o ranking não precisem percorrer a árvore de pistas
+ */
+typedef struct IndiceSuspeitos {
+    FichaSuspeito* fichas;      // Fichas dos suspeitos, na ordem em que apareceram
+    size_t quantidade;          // Número de fichas em uso
+    size_t reservadas;          // Fichas com vetor de pistas já alocado (reaproveitado após limpar)
+    size_t capacidade;          // Capacidade alocada do vetor de fichas
+    int* posicoes;              // Endereçamento aberto suspeito -> índice da ficha (-1 = livre)
+    size_t capacidadePosicoes;  // Número de posições (potência de 2)
+    int lider;                  // Ficha com mais evidências, empate pelo nome (-1 se vazio)
+} IndiceSuspeitos;
+
+/**
+ * Estrutura que representa um nó da árvore radix de textos
+ * O trecho da aresta que chega ao nó fica no próprio nó, e o primeiro byte de cada filho
+ * fica em um vetor contíguo: a descida não toca os textos internados nem os nós irmãos
+ */
+typedef struct NoTexto {
+    IdTexto valor;              // Texto que termina neste nó (ID_TEXTO_INVALIDO se nenhum)
+    uint32_t tamanhoRotulo;     // Tamanho do trecho da aresta
+    uint32_t numFilhos;         // Filhos em uso
+    uint32_t capacidadeFilhos;  // Capacidade dos vetores de filhos
+    struct NoTexto** filhos;    // Filhos ordenados pelo primeiro byte do rótulo
+    unsigned char* primeiros;   // Primeiro byte do rótulo de cada filho (mesmo bloco de filhos)
+    char rotulo[];              // Trecho da aresta (sem '\0')
+} NoTexto;
+
+/**
+ * Estrutura do índice de textos (árvore radix) para buscas por prefixo e aproximadas
+ */
+typedef struct IndiceTextos {
+    NoTexto* raiz;              // Raiz (rótulo vazio)
+    size_t quantidade;          // Textos indexados
+    size_t numNos;              // Nós da árvore
+} IndiceTextos;
+
+/**
+ * Estrutura com o catálogo fixo de pistas de um caso (todas as associações da tabela hash)
+ * Cada pista recebe um bit (ordem alfabética) e cada suspeito uma máscara com os bits das
+ * suas pistas; as máscaras ficam uma após a outra, com o mesmo número de palavras
+ */
+typedef struct CatalogoPistas {
+    size_t numPistas;           // Pistas do catálogo (bits)
+    size_t palavras;            // Palavras de 64 bits por conjunto
+    IdTexto* idPista;           // Bit -> pista
+    uint32_t* bitDaPista;       // Id do texto -> bit (INDICE_NENHUM fora do catálogo)
+    size_t numTextos;           // Ids cobertos por bitDaPista e indiceDoSuspeito
+    size_t numSuspeitos;        // Suspeitos distintos
+    IdTexto* idSuspeito;        // Suspeito compacto -> id do nome
+    uint32_t* indiceDoSuspeito; // Id do texto -> suspeito compacto (INDICE_NENHUM se não é suspeito)
+    uint64_t* mascaras;         // numSuspeitos máscaras de `palavras` palavras
+} CatalogoPistas;
+
+/**
+ * Estrutura que representa o caderno de pistas como conjunto de bits sobre um catálogo
+ */
+typedef struct CadernoBits {
+    uint64_t* bits;             // Bit i ligado = pista i do catálogo coletada
+    size_t quantidade;          // Pistas coletadas
+} CadernoBits;
+
+/**
+ * Formatos da saída do jogo
+ */
+typedef enum ModoSaida {
+    SAIDA_TEXTO,                // Mensagens em prosa (padrão)
+    SAIDA_EVENTOS,              // Um objeto JSON por linha para cada evento do jogo
+    SAIDA_NENHUMA               // Nada é formatado nem escrito
+} ModoSaida;
+
+/**
+ * Estrutura que representa o destino das mensagens do jogo
+ * O texto se acumula em um buffer reutilizável e só é escrito no arquivo quando o buffer
+ * enche, antes de ler a entrada (se o destino é um terminal) ou ao final
+ */
+typedef struct SaidaJogo {
+    ModoSaida modo;
+    FILE* destino;              // NULL = saída em memória (o buffer cresce, ver iniciarSaidaMemoria)
+    char* buffer;
+    size_t usados;
+    size_t capacidade;          // 0 = sem buffer (cada trecho vai direto para o arquivo)
+    int interativa;             // 1 se o destino é um terminal
+} SaidaJogo;
+
+/**
+ * Estados da leitura de um caso feita fora da thread que usa o acervo (servidor de sessões)
+ */
+typedef enum LeituraCaso {
+    LEITURA_NENHUMA,            // Nenhuma leitura em andamento: abrir o caso lê o mapa na hora
+    LEITURA_PENDENTE,           // O mapa está sendo lido por outra thread
+    LEITURA_PRONTA              // Leitura terminada: mapaLido é o mapa (NULL se a leitura falhou)
+} LeituraCaso;
+
+/**
+ * Estrutura que representa um caso do acervo: um mapa em disco e, enquanto estiver em
+ * memória, a mansão e a tabela de suspeitos montadas a partir dele
+ */
+typedef struct CasoAcervo {
+    char* caminho;              // Mapa do caso (texto ou binário), lido só quando o caso é aberto
+    LeituraCaso leitura;        // Leitura antecipada do mapa (servidor; sem ela, o mapa é lido ao abrir)
+    struct MapaMansao* mapaLido;     // Mapa da leitura pronta, à espera de ser montado
+    struct Arena* arena;        // Salas do caso (NULL enquanto o caso não está em memória)
+    Sala* hall;                 // Sala de entrada (NULL fora da memória)
+    TabelaHash* tabela;         // Suspeitos do caso (NULL fora da memória)
+    size_t bytes;               // Memória ocupada enquanto carregado (salas, tabela e lista de suspeitos)
+    size_t emUso;               // Sessões jogando o caso (não pode ser despejado)
+    size_t carregamentos;       // Vezes em que o caso foi lido do disco
+    int falhou;                 // 1 se o mapa não pôde ser carregado (o caso não é lido de novo)
+    struct CasoAcervo* anterior;     // Vizinho usado mais recentemente (lista LRU dos carregados)
+    struct CasoAcervo* proximo;      // Vizinho usado menos recentemente
+} CasoAcervo;
+
+/**
+ * Estrutura que representa o acervo de casos: muitos mapas registrados, carregados sob
+ * demanda e despejados do menos recentemente usado quando a memória passa do orçamento.
+ * O orçamento limita apenas as salas, tabelas e listas de suspeitos dos casos: os textos
+ * (pistas, salas e suspeitos) ficam na tabela de textos internados, uma única vez para
+ * todos os casos, e nunca são devolvidos. Cada caso novo lido acrescenta os seus textos
+ * inéditos, fora do orçamento (ver memoriaTextosInternados)
+ */
+typedef struct AcervoCasos {
+    CasoAcervo* casos;          // Casos na ordem da lista
+    IdTexto* nomes;             // Nome de cada caso: arquivo sem diretório nem extensão
+    size_t numCasos;
+    CasoAcervo* maisRecente;    // Cabeça da lista LRU dos casos em memória
+    CasoAcervo* menosRecente;   // Cauda: primeiro candidato ao despejo
+    size_t orcamento;           // Bytes de casos em memória tolerados, sem os textos (0 = sem limite)
+    size_t bytesCarregados;     // Soma de bytes dos casos em memória
+    size_t carregados;          // Casos em memória
+    size_t aberturas;           // Casos abertos (com ou sem leitura do disco)
+    size_t leituras;            // Aberturas que precisaram ler o mapa do disco
+    size_t despejos;            // Casos retirados da memória pelo orçamento
+    int (*carregar)(CasoAcervo* caso);      // Lê o mapa e monta hall, tabela e bytes (1 = sucesso)
+    void (*descarregar)(CasoAcervo* caso);  // Libera o que carregar montou
+    struct MapaMansao* (*lerMapa)(const char* caminho);  // Só a leitura do disco (segura em outra thread)
+} AcervoCasos;
+
+/**
+ * Fases de uma sessão de jogo: o que a próxima entrada do jogador significa
+ */
+typedef enum FaseSessao {
+    FASE_CASO,                  // Esperando o número ou o nome do caso (sessões do acervo)
+    FASE_NAVEGACAO,             // Esperando uma opção (e, d, b ou s)
+    FASE_BUSCA,                 // Esperando o início de pista da busca no caderno
+    FASE_ACUSACAO,              // Esperando o nome do acusado
+    FASE_ENCERRADA              // Investigação terminada, nenhuma entrada é esperada
+} FaseSessao;
+
+/**
+ * Estrutura com o estado de uma sessão de jogo, retomada a cada entrada do jogador
+ * explorarSalas() a conduz lendo o terminal; o servidor, pelas linhas de cada conexão.
+ * A mansão e a tabela de suspeitos são apenas lidas (compartilhadas entre sessões)
+ */
+typedef struct SessaoJogo {
+    Sala* salaAtual;            // Sala onde o jogador está
+    PistaNode* caderno;         // Pistas coletadas
+    TabelaHash* tabela;         // Tabela de suspeitos
+    IndiceSuspeitos* indice;    // Evidências por suspeito desta sessão
+    IndiceTextos* indicePistas; // Índice do caderno para a busca (montado na primeira busca)
+    FaseSessao fase;            // Entrada esperada
+    AcervoCasos* acervo;        // Acervo de onde o caso é escolhido (NULL = mansão única)
+    CasoAcervo* caso;           // Caso aberto pela sessão (devolvido ao acervo ao final)
+} SessaoJogo;
+
+/**
+ * Estrutura que representa um bloco de memória da arena
+ * Os nós são alocados em sequência dentro de dados[] (alocação por incremento)
+ */
+typedef struct BlocoArena {
+    struct BlocoArena* proximo;  // Bloco alocado anteriormente
+    size_t tamanho;              // Capacidade de dados[] em bytes
+    size_t usado;                // Bytes já entregues
+    unsigned char dados[];       // Área de alocação
+} BlocoArena;
+
+/**
+ * Estrutura que representa uma arena (pool) de nós de uma sessão de jogo
+ * Salas e nós de pistas ficam contíguos e são liberados de uma só vez
+ * (os nós da hash ficam embutidos no próprio vetor de posições da tabela)
+ */
+typedef struct Arena {
+    BlocoArena* blocos;          // Bloco atual (cabeça da lista de blocos)
+    size_t tamanhoBloco;         // Tamanho usado para novos blocos
+    size_t alocacoes;            // Contador: nós alocados na arena
+    size_t bytesAlocados;        // Contador: bytes entregues pela arena
+    size_t blocosAlocados;       // Contador: blocos obtidos do malloc e ainda em uso
+} Arena;
+
+/**
+ * Estrutura com os contadores do caminho de alocação individual (malloc por nó)
+ */
+typedef struct ContadoresAlocacao {
+    size_t alocacoes;            // Chamadas a malloc para nós
+    size_t liberacoes;           // Chamadas a free para nós
+    size_t bytesAlocados;        // Bytes pedidos ao malloc para nós
+} ContadoresAlocacao;
+
+/**
+ * Estrutura que representa a tabela de textos internados
+ * Guarda cada texto distinto uma única vez (em uma arena própria) e associa a ele
+ * um id sequencial; os nós do jogo armazenam apenas esses ids
+ */
+typedef struct TabelaTextos {
+    const char** textos;        // id -> texto
+    uint64_t* hashes;           // id -> hash do texto (reaproveitado pelas outras tabelas)
+    size_t quantidade;          // Número de textos internados (começa pelos do catálogo embutido)
+    size_t capacidade;          // Capacidade alocada dos vetores (0 = vetores do catálogo embutido)
+    IdTexto* posicoes;          // Endereçamento aberto dos textos fora do catálogo (ID_TEXTO_INVALIDO = livre)
+    size_t capacidadePosicoes;  // Número de posições (potência de 2)
+    Arena* armazenamento;       // Arena onde os caracteres dos textos ficam guardados
+} TabelaTextos;
+
+/**
+ * Estrutura que representa uma sala em um mapa carregado de arquivo
+ * Os filhos são índices no vetor de salas e os textos são deslocamentos no
+ * bloco de textos do mapa, de modo que o registro pode ser usado direto do arquivo
+ */
+typedef struct RegistroSala {
+    uint32_t esquerda;          // Índice da sala à esquerda (SALA_NENHUMA se não houver)
+    uint32_t direita;           // Índice da sala à direita (SALA_NENHUMA se não houver)
+    uint32_t nome;              // Deslocamento do nome no bloco de textos
+    uint32_t pista;             // Deslocamento da pista no bloco de textos (0 = sem pista)
+} RegistroSala;
+
+/**
+ * Estrutura que representa uma associação pista/suspeito em um mapa carregado
+ */
+typedef struct RegistroAssociacao {
+    uint32_t pista;             // Deslocamento da pista no bloco de textos
+    uint32_t suspeito;          // Deslocamento do nome do suspeito no bloco de textos
+} RegistroAssociacao;
+
+/**
+ * Estrutura do cabeçalho do formato binário de mapas (.dqm)
+ * O arquivo é: cabeçalho, salas[numSalas], associacoes[numAssociacoes], textos[tamanhoTextos]
+ * (inteiros em little-endian; os textos terminam em '\0' e o deslocamento 0 é o texto vazio)
+ */
+typedef struct CabecalhoMapaBinario {
+    char magica[4];             // "DQMB"
+    uint32_t versao;            // VERSAO_MAPA_BINARIO
+    uint32_t numSalas;          // Número de salas (a sala 0 é a entrada)
+    uint32_t numAssociacoes;    // Número de associações pista/suspeito
+    uint64_t tamanhoTextos;     // Tamanho do bloco de textos em bytes
+} CabecalhoMapaBinario;
+
+/**
+ * Estrutura que representa um mapa da mansão carregado (texto ou binário)
+ * No formato binário os vetores apontam direto para o arquivo mapeado em memória
+ */
+typedef struct MapaMansao {
+    uint32_t numSalas;                  // Número de salas (a sala 0 é a entrada)
+    uint32_t numAssociacoes;            // Número de associações pista/suspeito
+    RegistroSala* salas;                // Salas indexadas
+    RegistroAssociacao* associacoes;    // Catálogo de pistas/suspeitos do caso
+    char* textos;                       // Bloco de textos terminados em '\0'
+    uint64_t tamanhoTextos;             // Tamanho do bloco de textos
+    void* mapeamento;                   // Arquivo mapeado (NULL se os vetores foram alocados)
+    size_t tamanhoMapeamento;           // Tamanho do arquivo mapeado
+} MapaMansao;
+
+/**
+ * Estrutura auxiliar para montar um MapaMansao em memória (carregamento do formato
+ * texto, conversão e mapas sintéticos), com textos repetidos guardados uma única vez
+ */
+typedef struct ConstrutorMapa {
+    RegistroSala* salas;
+    size_t numSalas, capacidadeSalas;
+    RegistroAssociacao* associacoes;
+    size_t numAssociacoes, capacidadeAssociacoes;
+    char* textos;
+    size_t tamanhoTextos, capacidadeTextos;
+    uint32_t* posicoes;                 // Endereçamento aberto texto -> deslocamento (UINT32_MAX = livre)
+    size_t capacidadePosicoes, numTextos;
+} ConstrutorMapa;
+
+/**
+ * Parâmetros do gerador procedural de mansões
+ * A mesma semente gera sempre a mesma mansão, com qualquer número de threads
+ */
+typedef struct ParametrosGerador {
+    uint64_t semente;
+    uint64_t numSalas;
+    uint32_t profundidadeMaxima;    // Níveis da árvore (0 = sem limite)
+    double equilibrio;              // 1 = subárvores irmãs do mesmo tamanho, 0 = divisão sorteada
+    double densidadePistas;         // Fração das salas com pista (0 a 1)
+    uint32_t numSuspeitos;
+} ParametrosGerador;
+
+/**
+ * Estrutura que representa uma subárvore a gerar (as salas são numeradas em pré-ordem, então
+ * a subárvore ocupa as salas [sala, sala + tamanho))
+ */
+typedef struct TarefaGerador {
+    uint64_t sala;                  // Raiz da subárvore
+    uint64_t tamanho;               // Salas da subárvore
+    uint32_t niveis;                // Níveis disponíveis a partir da raiz (0 = sem limite)
+    int somenteRaiz;                // 1 = gerar só a raiz (os filhos são outras tarefas)
+} TarefaGerador;
+
+/**
+ * Estrutura com os valores derivados dos parâmetros do gerador
+ * Os textos têm tamanho conhecido ("Sala i", "Pista sintetica c", "Suspeito k"), então o
+ * deslocamento de cada um no bloco de textos sai de uma fórmula, sem somas de prefixos
+ */
+typedef struct GeradorMansao {
+    ParametrosGerador parametros;
+    uint64_t densidade;             // Pistas por sala em ponto fixo (2^32 = todas as salas)
+    uint64_t numPistas;
+    uint64_t inicioPistas;          // Deslocamento do primeiro texto de pista
+    uint64_t inicioSuspeitos;       // Deslocamento do primeiro nome de suspeito
+    uint64_t tamanhoTextos;
+    TarefaGerador* tarefas;         // Subárvores em ordem de numeração
+    size_t numTarefas;
+} GeradorMansao;
+
+/**
+ * Estrutura que representa a janela de memória onde uma faixa de salas é gerada
+ * (a mansão inteira no gerador em memória; um bloco por escrita na gravação em fluxo)
+ */
+typedef struct BlocoGerador {
+    uint64_t primeiraSala;          // Sala gravada em salas[0]
+    uint64_t primeiraPista;         // Pista gravada em associacoes[0]
+    uint64_t inicioNomes;           // Deslocamento no bloco de textos de nomes[0]
+    uint64_t inicioPistas;          // Deslocamento no bloco de textos de pistas[0]
+    RegistroSala* salas;
+    RegistroAssociacao* associacoes;
+    char* nomes;
+    char* pistas;
+} BlocoGerador;
+
+/**
+ * Estrutura com o estado de uma thread do gerador
+ */
+typedef struct TrabalhadorGerador {
+    const GeradorMansao* gerador;
+    const BlocoGerador* bloco;
+    atomic_size_t* proximaTarefa;   // Próxima tarefa livre (compartilhada)
+    size_t fimTarefas;              // Fim das tarefas deste bloco
+    int ok;                         // 0 se faltou memória
+} TrabalhadorGerador;
+
+/**
+ * Estrutura que representa uma sessão de um roteiro de lote (modo não interativo)
+ * Linha do roteiro: movimentos ('e'/'d'), depois 's' e o nome do acusado, ex.: eed s "Dr. Smith"
+ */
+typedef struct SessaoRoteiro {
+    const char* movimentos;     // Movimentos da sessão (dentro do conteúdo do roteiro)
+    size_t numMovimentos;       // Quantidade de caracteres de movimento
+    IdTexto acusado;            // Suspeito acusado (ID_TEXTO_INVALIDO se desconhecido/ausente)
+    const char* textoAcusado;   // Nome do acusado como escrito no roteiro ("" se ausente)
+} SessaoRoteiro;
+
+/**
+ * Estrutura que representa um roteiro de lote carregado (as linhas são divididas no lugar)
+ */
+typedef struct RoteiroLote {
+    char* conteudo;             // Conteúdo completo do arquivo
+    SessaoRoteiro* sessoes;     // Sessões, na ordem do arquivo
+    size_t numSessoes;          // Quantidade de sessões
+} RoteiroLote;
+
+/**
+ * Estrutura com o resultado compacto de uma sessão executada em lote
+ */
+typedef struct ResultadoSessao {
+    IdTexto salaFinal;          // Sala onde a investigação terminou
+    int pistasColetadas;        // Pistas distintas no caderno
+    int movimentosInvalidos;    // Movimentos sem saída ou caracteres desconhecidos
+    int evidencias;             // Pistas que apontam para o acusado
+    int resolvido;              // 1 se havia evidências suficientes (>= PISTAS_PARA_CONDENACAO)
+} ResultadoSessao;
+
+/**
+ * Estrutura do cabeçalho do arquivo de estados de sessões (.dqs)
+ * Depois do cabeçalho vêm numSessoes registros de bytesPorSessao bytes (RegistroSessao)
+ */
+typedef struct CabecalhoSnapshot {
+    char magica[4];             // "DQSS"
+    uint32_t versao;            // VERSAO_SNAPSHOT
+    uint64_t impressao;         // Impressão digital da mansão (salas e pistas em ordem de largura)
+    uint64_t numSessoes;        // Quantidade de registros
+    uint32_t numSalas;          // Salas da mansão (índices válidos de RegistroSessao.sala)
+    uint32_t numPistas;         // Bits do conjunto de pistas de cada registro
+    uint32_t bytesPorSessao;    // Tamanho de cada registro (múltiplo de 8)
+    uint32_t reservado;
+} CabecalhoSnapshot;
+
+/**
+ * Estrutura com o estado de uma sessão em andamento, no mesmo formato do arquivo
+ * As pistas são um conjunto de bits: o bit i é a i-ésima pista da mansão em ordem alfabética
+ */
+typedef struct RegistroSessao {
+    uint32_t sala;                  // Sala atual (índice em ordem de largura)
+    uint32_t movimentos;            // Movimentos já consumidos do roteiro
+    uint32_t movimentosInvalidos;   // Movimentos sem saída ou caracteres desconhecidos
+    uint32_t reservado;
+    uint64_t pistas[];              // Conjunto de pistas coletadas
+} RegistroSessao;
+
+/**
+ * Estrutura que liga uma mansão montada aos índices usados nos estados de sessões
+ * (apenas leitura depois de criada: pode ser compartilhada entre threads)
+ */
+typedef struct ContextoSnapshot {
+    size_t numSalas;            // Salas alcançáveis a partir do hall
+    Sala** salas;               // Índice -> sala (ordem de largura)
+    Sala** salasPorEndereco;    // Salas ordenadas por endereço (busca binária do índice)
+    uint32_t* indicePorEndereco;// Índice de cada sala de salasPorEndereco
+    size_t numPistas;           // Pistas distintas da mansão
+    IdTexto* idPista;           // Bit -> pista (ordem alfabética)
+    uint32_t* bitDaPista;       // Id do texto -> bit (INDICE_NENHUM se não é pista da mansão)
+    size_t numTextos;           // Ids cobertos por bitDaPista
+    size_t palavras;            // Palavras de 64 bits por conjunto de pistas
+    uint64_t impressao;         // Impressão digital da mansão
+} ContextoSnapshot;
+
+/**
+ * Estrutura que representa uma população de estados de sessões: a imagem em memória é
+ * idêntica ao arquivo (gravada com uma única escrita e lida por mmap, sem conversão)
+ */
+typedef struct SnapshotSessoes {
+    CabecalhoSnapshot* cabecalho;   // Início da imagem
+    unsigned char* registros;       // Primeiro registro (logo após o cabeçalho)
+    size_t tamanho;                 // Tamanho da imagem em bytes
+    int mapeado;                    // 1 se a imagem é um arquivo mapeado (somente leitura)
+} SnapshotSessoes;
+
+/**
+ * Estrutura que representa a faixa de sessões de uma thread do lote paralelo
+ * O dono e os ladrões retiram fatias com a mesma operação atômica, sem travas;
+ * o preenchimento mantém cada faixa em sua própria linha de cache
+ */
+typedef struct FaixaTrabalho {
+    atomic_size_t proximo;      // Próxima sessão ainda não retirada
+    size_t fim;                 // Fim (exclusivo) da faixa
+    char preenchimento[64 - sizeof(atomic_size_t) - sizeof(size_t)];
+} FaixaTrabalho;
+
+/**
+ * Estrutura que descreve uma execução do lote paralelo (entradas e totais de saída)
+ * A mansão, a tabela de suspeitos e os textos internados são apenas lidos pelas threads
+ */
+typedef struct ExecucaoLote {
+    Sala* hall;                     // Sala de entrada da mansão compartilhada
+    TabelaHash* tabela;             // Tabela de suspeitos compartilhada
+    const SessaoRoteiro* sessoes;   // Sessões distintas do roteiro
+    size_t numSessoes;              // Quantidade de sessões distintas
+    size_t totalSessoes;            // Sessões a executar (a sessão g usa sessoes[g % numSessoes])
+    int numThreads;                 // Threads de trabalho
+    ResultadoSessao* resultados;    // Resultado por sessão (NULL se não for necessário)
+    const ContextoSnapshot* contexto;   // Índices da mansão para os estados (NULL sem estados)
+    const SnapshotSessoes* retomar; // Estados iniciais das sessões (NULL: todas começam no hall)
+    SnapshotSessoes* salvar;        // Saída: estado de cada sessão antes da acusação (ou NULL)
+    FaixaTrabalho* faixas;          // Uma faixa de trabalho por thread
+    size_t executadas;              // Saída: sessões executadas
+    size_t resolvidas;              // Saída: sessões com o caso resolvido
+    size_t fatiasRoubadas;          // Saída: fatias executadas fora da thread dona
+    double tempo;                   // Saída: tempo de parede em segundos
+} ExecucaoLote;
+
+/**
+ * Estrutura com o estado de uma thread do lote paralelo (caderno, arena e índice próprios)
+ */
+typedef struct TrabalhadorLote {
+    ExecucaoLote* execucao;     // Execução compartilhada
+    int id;                     // Índice da thread (e da sua faixa)
+    size_t executadas;          // Sessões executadas por esta thread
+    size_t resolvidas;          // Sessões resolvidas por esta thread
+    size_t fatiasRoubadas;      // Fatias retiradas das faixas de outras threads
+} TrabalhadorLote;
+
+/**
+ * Estrutura que representa um jogador conectado ao servidor de sessões
+ * Cada conexão tem a sua sessão, a sua arena (o caderno sai de uma vez ao fechar) e o
+ * texto ainda não enviado; a mansão e a tabela de suspeitos são as do servidor
+ */
+typedef struct ConexaoJogo {
+    int fd;                     // Socket da conexão (não bloqueante)
+    size_t posicao;             // Posição no vetor de conexões do servidor
+    SessaoJogo sessao;          // Sala, caderno e fase do jogador
+    Arena* arena;               // Nós do caderno desta sessão
+    SaidaJogo saida;            // Respostas em memória ainda não enviadas
+    size_t enviados;            // Bytes de saida.buffer já enviados
+    uint32_t interesse;         // Eventos esperados do epoll (leitura ou escrita)
+    int descartando;            // 1 enquanto o resto de uma linha longa demais é ignorado
+    CasoAcervo* casoAguardado;  // Caso pedido cujo mapa ainda está sendo lido (NULL = nenhum)
+    size_t usadosEntrada;       // Bytes recebidos e ainda não processados
+    char entrada[TAMANHO_ENTRADA_CONEXAO];
+} ConexaoJogo;
+
+/**
+ * Estrutura que representa o servidor de sessões: uma única thread atende todas as
+ * conexões pelo epoll, e cada linha recebida avança a sessão da sua conexão
+ */
+typedef struct ServidorJogo {
+    Sala* hall;                 // Mansão compartilhada (apenas lida)
+    TabelaHash* tabela;         // Tabela de suspeitos compartilhada (apenas lida)
+    AcervoCasos* acervo;        // Casos à escolha de cada sessão (NULL = todas jogam hall/tabela)
+    struct LeitorCasos* leitor; // Leitura dos mapas do acervo fora da thread do epoll (NULL sem acervo)
+    ModoSaida modo;             // Formato das respostas
+    int escuta;                 // Socket que aceita conexões
+    int epoll;                  // Descritor do epoll
+    int escutaPausada;          // 1 se o limite de descritores suspendeu o accept
+    ConexaoJogo** conexoes;     // Conexões abertas
+    size_t numConexoes;
+    size_t capacidadeConexoes;
+    size_t sessoesIniciadas;    // Conexões aceitas
+    size_t sessoesConcluidas;   // Sessões que chegaram ao fim da investigação
+    size_t entradas;            // Linhas processadas
+} ServidorJogo;
+
+/**
+ * Estrutura com o estado de uma conexão do gerador de carga
+ * A sessão segue uma linha do roteiro de lote: um movimento por linha, 's' e o acusado
+ */
+typedef struct ClienteCarga {
+    int fd;                         // Socket (-1 quando o cliente não tem sessão em andamento)
+    const SessaoRoteiro* roteiro;   // Sessão do roteiro em andamento
+    size_t sessao;                  // Número da sessão (escolhe o caso quando o servidor pede um)
+    size_t passo;                   // Próximo caractere de movimento do roteiro
+    int encerrou;                   // 1 depois de enviar 's'
+    int mediuMovimento;             // 1 se a última linha enviada foi um movimento
+    int recebeuAlgo;                // 1 depois do primeiro byte recebido nesta sessão
+    int pediuCaso;                  // 1 depois que o servidor pediu o caso nesta sessão
+    double envio;                   // Instante do envio da última linha
+    size_t usados;                  // Bytes da linha ainda incompleta
+    char recebido[TAMANHO_RECEBIDO_CARGA];
+} ClienteCarga;
+
+/**
+ * Estrutura que descreve uma execução do gerador de carga (entradas e medições)
+ */
+typedef struct ExecucaoCarga {
+    const char* endereco;       // Porta TCP em 127.0.0.1 ou caminho do socket Unix
+    RoteiroLote* roteiro;       // Sessões a repetir (a sessão g usa sessoes[g % numSessoes])
+    int epoll;                  // Descritor do epoll
+    size_t totalSessoes;        // Sessões a executar
+    size_t proximaSessao;       // Próxima sessão a iniciar
+    size_t ativas;              // Sessões em andamento
+    size_t concluidas;          // Sessões encerradas pelo servidor
+    size_t falhas;              // Conexões recusadas ou interrompidas
+    int formatoInvalido;        // 1 se o servidor não responde com eventos
+    double* latencias;          // Segundos entre o envio de cada movimento e a resposta
+    size_t numLatencias;
+    size_t capacidadeLatencias;
+} ExecucaoCarga;
+
+/**
+ * Ordem em que as salas de um GrafoSalas são dispostas na memória
+ */
+typedef enum OrdemGrafo {
+    ORDEM_LARGURA,      // Em largura: cada nível da mansão é contíguo
+    ORDEM_VEB           // van Emde Boas: subárvores de altura ~sqrt(h) contíguas, em qualquer escala
+} OrdemGrafo;
+
+/**
+ * Estrutura que representa a mansão como grafo compacto (estrutura de vetores)
+ * A sala 0 é a entrada; filhos são índices. Percursos tocam apenas esquerda/direita/pista
+ * (12 bytes por sala, em vetores contíguos) em vez de nós espalhados pelo heap
+ */
+typedef struct GrafoSalas {
+    size_t numSalas;            // Número de salas
+    uint32_t* esquerda;         // Filho à esquerda (SALA_NENHUMA se não houver)
+    uint32_t* direita;          // Filho à direita (SALA_NENHUMA se não houver)
+    IdTexto* pista;             // Pista da sala (ID_TEXTO_VAZIO se não houver)
+    IdTexto* nome;              // Nome da sala (usado apenas para exibição)
+} GrafoSalas;
+
+/**
+ * Estrutura com a mansão em vetores indexados, preparada para o solucionador
+ * O grafo está em ordem de largura (os filhos sempre depois do pai) e pistas e
+ * suspeitos recebem índices compactos; só contam as pistas associadas a um suspeito
+ */
+typedef struct MansaoIndexada {
+    size_t numSalas;                // Salas alcançáveis a partir do hall
+    GrafoSalas* grafo;              // Filhos e nomes das salas (ordem de largura)
+    uint32_t* pai;                  // Sala de origem (SALA_NENHUMA no hall)
+    uint32_t* profundidade;         // Movimentos desde o hall
+    uint32_t* pista;                // Pista compacta da sala (INDICE_NENHUM se não houver)
+    uint64_t* folhas;               // Caminhos completos (folhas) na subárvore
+    uint8_t* temPista;              // 1 se a subárvore contém alguma pista
+    uint32_t profundidadeMaxima;    // Maior profundidade da mansão
+    size_t numPistas;               // Pistas distintas
+    uint32_t* suspeitoDaPista;      // Pista compacta -> suspeito compacto
+    size_t numSuspeitos;            // Suspeitos distintos
+    IdTexto* idSuspeito;            // Suspeito compacto -> id do nome
+    uint32_t* pistasDoSuspeito;     // Pistas distintas de cada suspeito na mansão inteira
+} MansaoIndexada;
+
+/**
+ * Estrutura com o estado de uma thread do solucionador: contagens incrementais do
+ * caminho atual e totais acumulados
+ */
+typedef struct EstadoSolucionador {
+    const MansaoIndexada* mansao;   // Mansão compartilhada (apenas leitura)
+    const uint32_t* tarefas;        // Subárvores a resolver (compartilhadas)
+    FaixaTrabalho* faixas;          // Faixas de tarefas, uma por thread
+    int id, numThreads;             // Índice desta thread e total de threads
+    uint32_t* contagemPista;        // Ocorrências de cada pista no caminho atual
+    uint32_t* contagemSuspeito;     // Pistas distintas de cada suspeito no caminho atual
+    uint32_t* condenaveis;          // Suspeitos com >= PISTAS_PARA_CONDENACAO pistas no caminho atual
+    uint32_t* posicaoCondenavel;    // Suspeito -> posição em condenaveis
+    size_t numCondenaveis;          // Quantidade de suspeitos condenáveis agora
+    uint32_t* pilha;                // Pilha explícita do percurso
+    uint64_t caminhos;              // Caminhos completos visitados
+    uint64_t caminhosResolviveis;   // Caminhos com pelo menos um suspeito condenável
+    uint64_t* caminhosPorSuspeito;  // Caminhos em que cada suspeito é condenável
+    uint32_t* salaMaisRasa;         // Sala mais rasa em que cada suspeito se torna condenável
+    uint32_t exemplosSemSolucao[MAX_EXEMPLOS_SEM_SOLUCAO];  // Salas finais de caminhos sem solução
+    size_t numExemplos;             // Exemplos guardados
+} EstadoSolucionador;
+
+// Arena ativa da thread: quando não é NULL, criarSala e criarPistaNode alocam seus
+// nós nela. Quem libera a árvore informa a arena dona a liberarMemoriaSalas/Pistas
+static _Thread_local Arena* arenaAtual = NULL;
+static _Thread_local ContadoresAlocacao contadoresMalloc = {0, 0, 0};
+
+// Catálogo embutido, gerado por --gerar-catalogo a partir de mapas/mansao_padrao.txt; para
+// embutir o catálogo de outro mapa, compile com -DDQ_CATALOGO_EMBUTIDO='"arquivo.h"'
+#ifndef DQ_CATALOGO_EMBUTIDO
+#define DQ_CATALOGO_EMBUTIDO "catalogo_embutido.h"
+#endif
+#include DQ_CATALOGO_EMBUTIDO
+
+// Estado inicial da tabela de textos: os vetores do catálogo embutido, somente leitura até o
+// primeiro texto de fora do catálogo (nenhuma alocação até lá)
+#define TEXTOS_INICIAIS { (const char**)textosEmbutidos, (uint64_t*)hashesEmbutidos, \
+                          sizeof(textosEmbutidos) / sizeof(textosEmbutidos[0]), 0, NULL, 0, NULL }
+
+// Tabela global de textos internados (compartilhada por todas as estruturas)
+static TabelaTextos textosInternados = TEXTOS_INICIAIS;
+
+#ifdef DQ_INSTRUMENTAR
+// Contadores de instrumentação (compilar com -DDQ_INSTRUMENTAR); sem a opção, as macros
+// INSTRUMENTAR_* não geram código. Campos "maior*" guardam máximos, os demais são somas
+#define CAMPOS_INSTRUMENTACAO(X) \
+    X(buscasHash) X(sondagensHash) X(maiorSondagemHash) X(redimensionamentosHash) \
+    X(buscasEncadeada) X(nosPercorridosEncadeada) X(maiorCadeiaEncadeada) \
+    X(internacoesTexto) X(textosNovos) X(sondagensTexto) \
+    X(insercoesPista) X(comparacoesInsercaoPista) X(profundidadeTotalInsercaoPista) X(maiorProfundidadePista) \
+    X(buscasPista) X(comparacoesBuscaPista) \
+    X(alocacoesNoMalloc) X(alocacoesNoArena) X(bytesNos) X(blocosArena) X(liberacoesNo)
+
+typedef struct Instrumentacao {
+#define DECLARAR_CAMPO_INSTRUMENTACAO(campo) atomic_uint_least64_t campo;
+    CAMPOS_INSTRUMENTACAO(DECLARAR_CAMPO_INSTRUMENTACAO)
+#undef DECLARAR_CAMPO_INSTRUMENTACAO
+} Instrumentacao;
+
+static Instrumentacao instrumentacao;
+static _Thread_local uint64_t profundidadeInsercaoPista = 0;  // Comparações da inserção em curso
+
+static void registrarMaximoInstrumentacao(atomic_uint_least64_t* campo, uint64_t valor) {
+    uint64_t atual = atomic_load_explicit(campo, memory_order_relaxed);
+    while (valor > atual && !atomic_compare_exchange_weak_explicit(campo, &atual, valor, memory_order_relaxed,
+                                                                   memory_order_relaxed)) {
     }
-    
-    return tabela;
 }
 
+static void registrarFimInsercaoPista(void) {
+    atomic_fetch_add_explicit(&instrumentacao.insercoesPista, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&instrumentacao.profundidadeTotalInsercaoPista, profundidadeInsercaoPista,
+                              memory_order_relaxed);
+    registrarMaximoInstrumentacao(&instrumentacao.maiorProfundidadePista, profundidadeInsercaoPista);
+    profundidadeInsercaoPista = 0;
+}
+
+#define INSTRUMENTAR_SOMAR(campo, valor) \
+    atomic_fetch_add_explicit(&instrumentacao.campo, (uint64_t)(valor), memory_order_relaxed)
+#define INSTRUMENTAR_MAXIMO(campo, valor) registrarMaximoInstrumentacao(&instrumentacao.campo, (uint64_t)(valor))
+#define INSTRUMENTAR_COMPARACAO_PISTA() \
+    (INSTRUMENTAR_SOMAR(comparacoesInsercaoPista, 1), profundidadeInsercaoPista++)
+#define INSTRUMENTAR_FIM_INSERCAO_PISTA() registrarFimInsercaoPista()
+
 /**
- * Função: inserirNaHash
- * Propósito: Inserir uma associação pista/suspeito na tabela hash
- * Parâmetros: tabela - ponteiro para a tabela hash
- *             pista - string da pista (chave)
- *             suspeito - string do nome do suspeito (valor)
+ * Função: exibirInstrumentacao
+ * Propósito: Gravar os contadores de instrumentação ao sair do programa (registrada com
+ * atexit), um "campo<TAB>valor" por linha, no arquivo da variável de ambiente
+ * DQ_INSTRUMENTACAO (acrescentando) ou em stderr
+ * Parâmetros: nenhum
  * Retorno: void
  */
-void inserirNaHash(TabelaHash* tabela, const char* pista, const char* suspeito) {
-    if (tabela == NULL) return;
+static void exibirInstrumentacao(void) {
+    const char* caminho = getenv("DQ_INSTRUMENTACAO");
+    FILE* destino = caminho != NULL ? fopen(caminho, "a") : NULL;
+    if (destino == NULL) destino = stderr;
     
-    int indice = funcaoHash(pista);
+    fprintf(destino, "# instrumentacao detective_quest\n");
+#define EXIBIR_CAMPO_INSTRUMENTACAO(campo) \
+    fprintf(destino, "%s\t%llu\n", #campo, \
+            (unsigned long long)atomic_load_explicit(&instrumentacao.campo, memory_order_relaxed));
+    CAMPOS_INSTRUMENTACAO(EXIBIR_CAMPO_INSTRUMENTACAO)
+#undef EXIBIR_CAMPO_INSTRUMENTACAO
     
-    // Cria um novo nó
-    HashNode* novoNode = (HashNode*)malloc(sizeof(HashNode));
-    if (novoNode == NULL) {
-        printf("Erro: Falha na alocação de memória para nó hash!\n");
-        return;
+    if (destino != stderr) fclose(destino);
+}
+#else
+#define INSTRUMENTAR_SOMAR(campo, valor) ((void)0)
+#define INSTRUMENTAR_MAXIMO(campo, valor) ((void)0)
+#define INSTRUMENTAR_COMPARACAO_PISTA() ((void)0)
+#define INSTRUMENTAR_FIM_INSERCAO_PISTA() ((void)0)
+#endif
+
+/**
+ * Função: criarArena
+ * Propósito: Criar uma arena vazia para alocação de nós
+ * Parâmetros: tamanhoBloco - tamanho de cada bloco (0 para TAMANHO_BLOCO_ARENA)
+ * Retorno: ponteiro para a arena criada
+ */
+Arena* criarArena(size_t tamanhoBloco) {
+    Arena* arena = (Arena*)calloc(1, sizeof(Arena));
+    if (arena == NULL) {
+        printf("Erro: Falha na alocação de memória para a arena!\n");
+        return NULL;
     }
-    
-    strcpy(novoNode->pista, pista);
-    strcpy(novoNode->suspeito, suspeito);
-    novoNode->proximo = tabela->tabela[indice];  // Inserção no início da lista
-    tabela->tabela[indice] = novoNode;
+    arena->tamanhoBloco = tamanhoBloco > 0 ? tamanhoBloco : TAMANHO_BLOCO_ARENA;
+    return arena;
 }
 
 /**
- * Função: encontrarSuspeito
- * Propósito: Buscar o suspeito associado a uma pista na tabela hash
- * Parâmetros: tabela - ponteiro para a tabela hash
- *             pista - string da pista a ser buscada
- * Retorno: ponteiro para o nome do suspeito ou NULL se não encontrado
+ * Função: reservarNaArena
+ * Propósito: Reservar memória dentro da arena com o alinhamento pedido
+ * (obtém um novo bloco quando o atual enche)
+ * Parâmetros: arena - ponteiro para a arena
+ *             tamanho - quantidade de bytes
+ *             alinhamento - alinhamento do endereço devolvido (potência de 2)
+ * Retorno: ponteiro para a memória reservada ou NULL em caso de falha
  */
-char* encontrarSuspeito(TabelaHash* tabela, const char* pista) {
-    if (tabela == NULL) return NULL;
+static void* reservarNaArena(Arena* arena, size_t tamanho, size_t alinhamento) {
+    BlocoArena* bloco = arena->blocos;
+    size_t deslocamento = 0;
     
-    int indice = funcaoHash(pista);
-    HashNode* atual = tabela->tabela[indice];
-    
-    // Percorre a lista encadeada no índice
-    while (atual != NULL) {
-        if (strcmp(atual->pista, pista) == 0) {
-            return atual->suspeito;
+    if (bloco != NULL) {
+        uintptr_t endereco = (uintptr_t)(bloco->dados + bloco->usado);
+        deslocamento = bloco->usado + (((endereco + alinhamento - 1) & ~(uintptr_t)(alinhamento - 1)) - endereco);
+    }
+    if (bloco == NULL || deslocamento + tamanho > bloco->tamanho) {
+        size_t capacidade = tamanho + alinhamento > arena->tamanhoBloco ? tamanho + alinhamento : arena->tamanhoBloco;
+        bloco = (BlocoArena*)malloc(sizeof(BlocoArena) + capacidade);
+        if (bloco == NULL) {
+            printf("Erro: Falha na alocação de memória para a arena!\n");
+            return NULL;
         }
-        atual = atual->proximo;
+        bloco->tamanho = capacidade;
+        bloco->usado = 0;
+        bloco->proximo = arena->blocos;
+        arena->blocos = bloco;
+        arena->blocosAlocados++;
+        INSTRUMENTAR_SOMAR(blocosArena, 1);
+        
+        uintptr_t endereco = (uintptr_t)bloco->dados;
+        deslocamento = ((endereco + alinhamento - 1) & ~(uintptr_t)(alinhamento - 1)) - endereco;
     }
     
-    return NULL;  // Pista não encontrada
+    void* memoria = bloco->dados + deslocamento;
+    bloco->usado = deslocamento + tamanho;
+    arena->alocacoes++;
+    arena->bytesAlocados += tamanho;
+    return memoria;
 }
 
 /**
- * Função: criarSala
- * Propósito: Criar uma nova sala com nome e pista especificados usando alocação dinâmica
- * Parâmetros: nome - string com o nome da sala
- *             pista - string com a pista da sala (pode ser vazia)
- * Retorno: ponteiro para a nova sala criada
+ * Função: alocarNaArena
+ * Propósito: Reservar memória alinhada a ALINHAMENTO_ARENA dentro da arena
+ * Parâmetros: arena - ponteiro para a arena
+ *             tamanho - quantidade de bytes
+ * Retorno: ponteiro para a memória reservada ou NULL em caso de falha
  */
-Sala* criarSala(const char* nome, const char* pista) {
-    // Aloca memória dinamicamente para uma nova sala
-    Sala* novaSala = (Sala*)malloc(sizeof(Sala));
+void* alocarNaArena(Arena* arena, size_t tamanho) {
+    return reservarNaArena(arena, tamanho, ALINHAMENTO_ARENA);
+}
+
+/**
+ * Função: reiniciarArena
+ * Propósito: Descartar todos os nós da arena mantendo o bloco mais recente para reuso
+ * Parâmetros: arena - ponteiro para a arena
+ * Retorno: void
+ */
+void reiniciarArena(Arena* arena) {
+    if (arena == NULL || arena->blocos == NULL) return;
     
-    // Verifica se a alocação foi bem-sucedida
-    if (novaSala == NULL) {
-        printf("Erro: Falha na alocação de memória!\n");
-        return NULL;
+    BlocoArena* bloco = arena->blocos->proximo;
+    while (bloco != NULL) {
+        BlocoArena* temp = bloco;
+        bloco = bloco->proximo;
+        free(temp);
     }
-    
-    // Copia o nome e a pista para a sala e inicializa os ponteiros como NULL
-    strcpy(novaSala->nome, nome);
-    strcpy(novaSala->pista, pista);
-    novaSala->esquerda = NULL;
-    novaSala->direita = NULL;
-    
-    return novaSala;
+    arena->blocos->proximo = NULL;
+    arena->blocos->usado = 0;
+    arena->blocosAlocados = 1;
 }
 
 /**
- * Função: criarPistaNode
- * Propósito: Criar um novo nó para a árvore de pistas usando alocação dinâmica
- * Parâmetros: conteudo - string com o conteúdo da pista
- * Retorno: ponteiro para o novo nó de pista criado
+ * Função: liberarArena
+ * Propósito: Liberar de uma só vez todos os blocos (e portanto todos os nós) da arena
+ * Parâmetros: arena - ponteiro para a arena
+ * Retorno: void
  */
-PistaNode* criarPistaNode(const char* conteudo) {
-    // Aloca memória dinamicamente para um novo nó de pista
-    PistaNode* novoNode = (PistaNode*)malloc(sizeof(PistaNode));
+void liberarArena(Arena* arena) {
+    if (arena == NULL) return;
     
-    // Verifica se a alocação foi bem-sucedida
-    if (novoNode == NULL) {
-        printf("Erro: Falha na alocação de memória para pista!\n");
-        return NULL;
+    BlocoArena* bloco = arena->blocos;
+    while (bloco != NULL) {
+        BlocoArena* temp = bloco;
+        bloco = bloco->proximo;
+        free(temp);
+    }
+    if (arenaAtual == arena) {
+        arenaAtual = NULL;
+    }
+    free(arena);
+}
+
+/**
+ * Função: memoriaReservadaArena
+ * Propósito: Somar a memória que os blocos da arena ocupam (usada ou não)
+ * Parâmetros: arena - ponteiro para a arena
+ * Retorno: bytes obtidos do malloc pelos blocos, com os cabeçalhos
+ */
+size_t memoriaReservadaArena(const Arena* arena) {
+    size_t total = 0;
+    for (const BlocoArena* bloco = arena != NULL ? arena->blocos : NULL; bloco != NULL; bloco = bloco->proximo) {
+        total += sizeof(BlocoArena) + bloco->tamanho;
+    }
+    return total;
+}
+
+/**
+ * Função: usarArena
+ * Propósito: Ativar (ou desativar, com NULL) o modo de alocação em arena da thread atual
+ * Parâmetros: arena - arena que passa a receber os nós
+ * Retorno: arena que estava ativa antes
+ */
+Arena* usarArena(Arena* arena) {
+    Arena* anterior = arenaAtual;
+    arenaAtual = arena;
+    return anterior;
+}
+
+/**
+ * Função: alocarNo
+ * Propósito: Alocar um nó (Sala ou PistaNode) na arena ativa ou com malloc
+ * Parâmetros: tamanho - tamanho do nó em bytes
+ * Retorno: ponteiro para o nó ou NULL em caso de falha
+ */
+static void* alocarNo(size_t tamanho) {
+    INSTRUMENTAR_SOMAR(bytesNos, tamanho);
+    if (arenaAtual != NULL) {
+        INSTRUMENTAR_SOMAR(alocacoesNoArena, 1);
+        return alocarNaArena(arenaAtual, tamanho);
+    }
+    INSTRUMENTAR_SOMAR(alocacoesNoMalloc, 1);
+    contadoresMalloc.alocacoes++;
+    contadoresMalloc.bytesAlocados += tamanho;
+    return malloc(tamanho);
+}
+
+/**
+ * Função: liberarNo
+ * Propósito: Liberar um nó alocado com malloc (nunca chamada para nós de arena, que
+ * são liberados por liberarArena)
+ * Parâmetros: no - ponteiro para o nó
+ * Retorno: void
+ */
+static void liberarNo(void* no) {
+    if (no == NULL) return;
+    INSTRUMENTAR_SOMAR(liberacoesNo, 1);
+    contadoresMalloc.liberacoes++;
+    free(no);
+}
+
+/**
+ * Função: funcaoHash
+ * Propósito: Calcular o hash de 64 bits de uma pista (FNV-1a seguido de um
+ * finalizador de avalanche, para que os bits baixos usados como índice
+ * dependam de todos os caracteres)
+ * Parâmetros: pista - string da pista para calcular o hash
+ * Retorno: hash de 64 bits da pista
+ */
+uint64_t funcaoHash(const char* pista) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char* c = (const unsigned char*)pista; *c != '\0'; c++) {
+        hash ^= *c;
+        hash *= 1099511628211ULL;
+    }
+    
+    // Finalizador (mistura dos bits altos nos bits baixos)
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * Função: posicaoNoCatalogo
+ * Propósito: Calcular a posição de um texto no hash perfeito do catálogo embutido
+ * (o deslocamento do balde do texto foi escolhido, na geração, para separá-lo dos demais)
+ * Parâmetros: hash - funcaoHash do texto
+ *             deslocamento - deslocamento do balde do texto
+ *             numPosicoes - número de posições (textos não vazios do catálogo)
+ * Retorno: posição em [0, numPosicoes)
+ */
+static uint32_t posicaoNoCatalogo(uint64_t hash, uint32_t deslocamento, uint32_t numPosicoes) {
+    uint64_t misturado = (hash ^ ((uint64_t)deslocamento * 0x9E3779B97F4A7C15ULL)) * 0xff51afd7ed558ccdULL;
+    return (uint32_t)(((misturado >> 32) * numPosicoes) >> 32);
+}
+
+/**
+ * Função: baldeNoCatalogo
+ * Propósito: Calcular o balde de um texto no hash perfeito do catálogo embutido
+ * Parâmetros: hash - funcaoHash do texto
+ *             numBaldes - número de baldes
+ * Retorno: balde em [0, numBaldes)
+ */
+static uint32_t baldeNoCatalogo(uint64_t hash, uint32_t numBaldes) {
+    return (uint32_t)(((hash & 0xffffffffULL) * numBaldes) >> 32);
+}
+
+/**
+ * Função: buscarTextoEmbutido
+ * Propósito: Consultar o id fixo de um texto do catálogo embutido: uma posição do hash
+ * perfeito e uma comparação
+ * Parâmetros: hash - funcaoHash do texto
+ *             texto - string procurada
+ * Retorno: id do texto ou ID_TEXTO_INVALIDO se ele não faz parte do catálogo
+ */
+static IdTexto buscarTextoEmbutido(uint64_t hash, const char* texto) {
+    const CatalogoEmbutido* catalogo = &catalogoEmbutido;
+    if (texto[0] == '\0') return ID_TEXTO_VAZIO;
+    if (catalogo->numTextos <= 1) return ID_TEXTO_INVALIDO;
+    
+    uint32_t balde = baldeNoCatalogo(hash, catalogo->numBaldes);
+    IdTexto id = 1 + posicaoNoCatalogo(hash, catalogo->deslocamentos[balde], catalogo->numTextos - 1);
+    if (catalogo->hashes[id] == hash && strcmp(catalogo->textos[id], texto) == 0) {
+        return id;
+    }
+    return ID_TEXTO_INVALIDO;
+}
+
+/**
+ * Função: localizarPosicaoTexto
+ * Propósito: Encontrar a posição de um texto no endereçamento aberto da tabela de textos
+ * Parâmetros: hash - hash do texto
+ *             texto - string procurada
+ * Retorno: posição que referencia o id do texto ou a posição livre onde ele entraria
+ */
+static IdTexto* localizarPosicaoTexto(uint64_t hash, const char* texto) {
+    TabelaTextos* tabela = &textosInternados;
+    size_t mascara = tabela->capacidadePosicoes - 1;
+    size_t posicao = (size_t)hash & mascara;
+    
+    while (tabela->posicoes[posicao] != ID_TEXTO_INVALIDO) {
+        IdTexto id = tabela->posicoes[posicao];
+        INSTRUMENTAR_SOMAR(sondagensTexto, 1);
+        if (tabela->hashes[id] == hash && strcmp(tabela->textos[id], texto) == 0) {
+            break;
+        }
+        posicao = (posicao + 1) & mascara;
+    }
+    return &tabela->posicoes[posicao];
+}
+
+/**
+ * Função: buscarIdTexto
+ * Propósito: Consultar o id de um texto já internado, sem internar textos novos
+ * Parâmetros: texto - string procurada
+ * Retorno: id do texto ou ID_TEXTO_INVALIDO se ele nunca foi internado
+ */
+IdTexto buscarIdTexto(const char* texto) {
+    uint64_t hash = funcaoHash(texto);
+    IdTexto id = buscarTextoEmbutido(hash, texto);
+    if (id != ID_TEXTO_INVALIDO || textosInternados.posicoes == NULL) return id;
+    return *localizarPosicaoTexto(hash, texto);
+}
+
+/**
+ * Função: internarTexto
+ * Propósito: Obter o id único de um texto, armazenando-o na primeira vez que aparece
+ * (o texto vazio sempre recebe o id ID_TEXTO_VAZIO e os textos do catálogo embutido,
+ * seus ids fixos, sem cópia)
+ * Parâmetros: texto - string a internar (qualquer tamanho)
+ * Retorno: id do texto ou ID_TEXTO_INVALIDO se faltou memória (a tabela fica como estava)
+ */
+IdTexto internarTexto(const char* texto) {
+    TabelaTextos* tabela = &textosInternados;
+    uint64_t hash = funcaoHash(texto);
+    INSTRUMENTAR_SOMAR(internacoesTexto, 1);
+    
+    // Textos do catálogo embutido já têm id fixo
+    IdTexto embutido = buscarTextoEmbutido(hash, texto);
+    if (embutido != ID_TEXTO_INVALIDO) {
+        return embutido;
+    }
+    
+    // Inicialização preguiçosa da parte dinâmica (textos de fora do catálogo)
+    if (tabela->posicoes == NULL) {
+        IdTexto* posicoes = (IdTexto*)malloc(CAPACIDADE_INICIAL_HASH * sizeof(IdTexto));
+        Arena* armazenamento = posicoes != NULL ? criarArena(0) : NULL;
+        if (armazenamento == NULL) {
+            printf("Erro: Falha na alocação de memória para a tabela de textos!\n");
+            free(posicoes);
+            return ID_TEXTO_INVALIDO;
+        }
+        memset(posicoes, 0xff, CAPACIDADE_INICIAL_HASH * sizeof(IdTexto));
+        tabela->armazenamento = armazenamento;
+        tabela->posicoes = posicoes;
+        tabela->capacidadePosicoes = CAPACIDADE_INICIAL_HASH;
+    }
+    
+    IdTexto* posicao = localizarPosicaoTexto(hash, texto);
+    if (*posicao != ID_TEXTO_INVALIDO) {
+        return *posicao;
+    }
+    INSTRUMENTAR_SOMAR(textosNovos, 1);
+    
+    // Texto novo: copia os caracteres para a arena de textos (os vetores do catálogo
+    // embutido são somente leitura e são copiados na primeira expansão)
+    if (tabela->quantidade >= tabela->capacidade) {
+        int embutidos = tabela->capacidade == 0;
+        size_t novaCapacidade = embutidos ? tabela->quantidade * 2 + 64 : tabela->capacidade * 2;
+        const char** textos = (const char**)realloc(embutidos ? NULL : (void*)tabela->textos,
+                                                    novaCapacidade * sizeof(const char*));
+        if (textos != NULL && !embutidos) tabela->textos = textos;
+        uint64_t* hashes = textos == NULL ? NULL :
+            (uint64_t*)realloc(embutidos ? NULL : tabela->hashes, novaCapacidade * sizeof(uint64_t));
+        if (hashes != NULL && !embutidos) tabela->hashes = hashes;
+        if (textos == NULL || hashes == NULL) {
+            printf("Erro: Falha na alocação de memória para a tabela de textos!\n");
+            if (embutidos) free((void*)textos);
+            return ID_TEXTO_INVALIDO;
+        }
+        if (embutidos) {
+            memcpy((void*)textos, (const void*)tabela->textos, tabela->quantidade * sizeof(const char*));
+            memcpy(hashes, tabela->hashes, tabela->quantidade * sizeof(uint64_t));
+            tabela->textos = textos;
+            tabela->hashes = hashes;
+        }
+        tabela->capacidade = novaCapacidade;
+    }
+    
+    // Mantém a ocupação das posições abaixo de 1/2, dobrando antes de inserir
+    if ((tabela->quantidade + 1 - catalogoEmbutido.numTextos) * 2 > tabela->capacidadePosicoes) {
+        size_t novaCapacidade = tabela->capacidadePosicoes * 2;
+        IdTexto* posicoes = (IdTexto*)malloc(novaCapacidade * sizeof(IdTexto));
+        if (posicoes == NULL) {
+            printf("Erro: Falha na alocação de memória para a tabela de textos!\n");
+            return ID_TEXTO_INVALIDO;
+        }
+        memset(posicoes, 0xff, novaCapacidade * sizeof(IdTexto));
+        size_t mascara = novaCapacidade - 1;
+        for (size_t i = catalogoEmbutido.numTextos; i < tabela->quantidade; i++) {
+            size_t p = (size_t)tabela->hashes[i] & mascara;
+            while (posicoes[p] != ID_TEXTO_INVALIDO) {
+                p = (p + 1) & mascara;
+            }
+            posicoes[p] = (IdTexto)i;
+        }
+        free(tabela->posicoes);
+        tabela->posicoes = posicoes;
+        tabela->capacidadePosicoes = novaCapacidade;
+        posicao = localizarPosicaoTexto(hash, texto);
+    }
+    
+    size_t tamanho = strlen(texto) + 1;
+    char* copia = (char*)reservarNaArena(tabela->armazenamento, tamanho, 1);
+    if (copia == NULL) return ID_TEXTO_INVALIDO;
+    memcpy(copia, texto, tamanho);
+    
+    IdTexto id = (IdTexto)tabela->quantidade++;
+    tabela->textos[id] = copia;
+    tabela->hashes[id] = hash;
+    *posicao = id;
+    return id;
+}
+
+/**
+ * Função: textoDoId
+ * Propósito: Obter o texto correspondente a um id internado
+ * Parâmetros: id - id do texto
+ * Retorno: ponteiro para o texto (válido até liberarTextosInternados)
+ */
+const char* textoDoId(IdTexto id) {
+    return textosInternados.textos[id];
+}
+
+/**
+ * Função: memoriaTextosInternados
+ * Propósito: Somar a memória da tabela de textos internados (caracteres, vetores por id e
+ * posições); os vetores do catálogo embutido não contam, pois não são alocados
+ * Parâmetros: nenhum
+ * Retorno: bytes alocados pela tabela de textos
+ */
+size_t memoriaTextosInternados(void) {
+    return memoriaReservadaArena(textosInternados.armazenamento) +
+           textosInternados.capacidade * (sizeof(const char*) + sizeof(uint64_t)) +
+           textosInternados.capacidadePosicoes * sizeof(IdTexto);
+}
+
+/**
+ * Função: hashDoTexto
+ * Propósito: Obter o hash (funcaoHash) já calculado de um texto internado
+ * Parâmetros: id - id do texto
+ * Retorno: hash de 64 bits do texto
+ */
+uint64_t hashDoTexto(IdTexto id) {
+    return textosInternados.hashes[id];
+}
+
+/**
+ * Função: compararTextosPorId
+ * Propósito: Comparar dois textos internados em ordem alfabética
+ * (ids iguais dispensam o strcmp)
+ * Parâmetros: a, b - ids dos textos
+ * Retorno: negativo, zero ou positivo, como strcmp
+ */
+int compararTextosPorId(IdTexto a, IdTexto b) {
+    if (a == b) return 0;
+    return strcmp(textosInternados.textos[a], textosInternados.textos[b]);
+}
+
+/**
+ * Função: compararIdsTexto
+ * Propósito: Comparador de qsort para vetores de ids de textos (ordem alfabética)
+ */
+static int compararIdsTexto(const void* a, const void* b) {
+    return compararTextosPorId(*(const IdTexto*)a, *(const IdTexto*)b);
+}
+
+/**
+ * Função: liberarTextosInternados
+ * Propósito: Liberar a tabela de textos internados (invalida todos os ids de fora do
+ * catálogo embutido, que volta a ser o único conteúdo da tabela)
+ * Retorno: void
+ */
+void liberarTextosInternados(void) {
+    TabelaTextos* tabela = &textosInternados;
+    Arena* anterior = arenaAtual;
+    liberarArena(tabela->armazenamento);
+    arenaAtual = anterior;
+    if (tabela->capacidade > 0) {
+        free((void*)tabela->textos);
+        free(tabela->hashes);
+    }
+    free(tabela->posicoes);
+    TabelaTextos inicial = TEXTOS_INICIAIS;
+    *tabela = inicial;
+}
+
+/**
+ * Função: iniciarSaidaJogo
+ * Propósito: Preparar a saída do jogo (sem buffer no modo SAIDA_NENHUMA; se o buffer não
+ * puder ser alocado, cada trecho é escrito direto no arquivo)
+ * Parâmetros: saida - ponteiro para a saída
+ *             modo - formato das mensagens
+ *             destino - arquivo de destino
+ * Retorno: void
+ */
+void iniciarSaidaJogo(SaidaJogo* saida, ModoSaida modo, FILE* destino) {
+    saida->modo = modo;
+    saida->destino = destino;
+    saida->usados = 0;
+    saida->buffer = modo != SAIDA_NENHUMA ? (char*)malloc(TAMANHO_BUFFER_SAIDA) : NULL;
+    saida->capacidade = saida->buffer != NULL ? TAMANHO_BUFFER_SAIDA : 0;
+#ifdef _WIN32
+    saida->interativa = _isatty(_fileno(destino));
+#else
+    saida->interativa = isatty(fileno(destino));
+#endif
+}
+
+/**
+ * Função: iniciarSaidaMemoria
+ * Propósito: Preparar uma saída sem arquivo: o buffer cresce até o dono retirar o texto
+ * acumulado (usado pelo servidor, que envia o buffer de cada conexão pelo socket)
+ * Parâmetros: saida - ponteiro para a saída
+ *             modo - formato das mensagens
+ * Retorno: void
+ */
+void iniciarSaidaMemoria(SaidaJogo* saida, ModoSaida modo) {
+    saida->modo = modo;
+    saida->destino = NULL;
+    saida->usados = 0;
+    saida->buffer = modo != SAIDA_NENHUMA ? (char*)malloc(TAMANHO_BUFFER_CONEXAO) : NULL;
+    saida->capacidade = saida->buffer != NULL ? TAMANHO_BUFFER_CONEXAO : 0;
+    saida->interativa = 0;
+}
+
+/**
+ * Função: ampliarSaidaMemoria
+ * Propósito: Dobrar o buffer de uma saída sem arquivo até caber mais um trecho
+ * Parâmetros: saida - ponteiro para a saída (destino NULL)
+ *             tamanho - bytes que precisam caber além dos já usados
+ * Retorno: 1 se o trecho cabe, 0 se faltou memória
+ */
+static int ampliarSaidaMemoria(SaidaJogo* saida, size_t tamanho) {
+    size_t capacidade = saida->capacidade > 0 ? saida->capacidade : TAMANHO_BUFFER_CONEXAO;
+    while (capacidade < saida->usados + tamanho) capacidade *= 2;
+    char* buffer = (char*)realloc(saida->buffer, capacidade);
+    if (buffer == NULL) {
+        printf("Erro: Falha na alocação de memória para a saida da conexao!\n");
+        return 0;
+    }
+    saida->buffer = buffer;
+    saida->capacidade = capacidade;
+    return 1;
+}
+
+/**
+ * Função: descarregarSaida
+ * Propósito: Escrever no arquivo o que está acumulado no buffer (saídas em memória
+ * continuam com o texto, que é retirado pelo dono)
+ * Parâmetros: saida - ponteiro para a saída
+ * Retorno: void
+ */
+void descarregarSaida(SaidaJogo* saida) {
+    if (saida->destino == NULL) return;
+    if (saida->usados > 0) {
+        fwrite(saida->buffer, 1, saida->usados, saida->destino);
+        saida->usados = 0;
+    }
+    fflush(saida->destino);
+}
+
+/**
+ * Função: prepararLeituraSaida
+ * Propósito: Antes de ler a entrada, descarregar a saída se ela é um terminal (o jogador
+ * precisa ver a pergunta); em arquivos e pipes o buffer continua acumulando
+ * Parâmetros: saida - ponteiro para a saída
+ * Retorno: void
+ */
+void prepararLeituraSaida(SaidaJogo* saida) {
+    if (saida->interativa) descarregarSaida(saida);
+}
+
+/**
+ * Função: finalizarSaidaJogo
+ * Propósito: Descarregar e liberar o buffer da saída
+ * Parâmetros: saida - ponteiro para a saída
+ * Retorno: void
+ */
+void finalizarSaidaJogo(SaidaJogo* saida) {
+    if (saida->modo != SAIDA_NENHUMA) descarregarSaida(saida);
+    free(saida->buffer);
+    saida->buffer = NULL;
+    saida->capacidade = 0;
+}
+
+/**
+ * Função: escreverNaSaida
+ * Propósito: Acrescentar bytes ao buffer, descarregando-o quando não há espaço
+ * Parâmetros: saida - ponteiro para a saída
+ *             dados - bytes a escrever
+ *             tamanho - quantidade de bytes
+ * Retorno: void
+ */
+static void escreverNaSaida(SaidaJogo* saida, const char* dados, size_t tamanho) {
+    if (saida->usados + tamanho > saida->capacidade) {
+        if (saida->destino == NULL) {
+            if (!ampliarSaidaMemoria(saida, tamanho)) return;
+        } else if (saida->usados > 0) {
+            fwrite(saida->buffer, 1, saida->usados, saida->destino);
+            saida->usados = 0;
+        }
+        if (tamanho > saida->capacidade) {
+            fwrite(dados, 1, tamanho, saida->destino);
+            return;
+        }
+    }
+    memcpy(saida->buffer + saida->usados, dados, tamanho);
+    saida->usados += tamanho;
+}
+
+/**
+ * Função: formatarDecimal
+ * Propósito: Escrever um inteiro sem sinal em decimal (sem '\0' e sem passar por printf)
+ * Parâmetros: destino - onde os dígitos são escritos (pelo menos 20 bytes)
+ *             valor - número a escrever
+ * Retorno: quantidade de dígitos escritos
+ */
+static size_t formatarDecimal(char* destino, unsigned long long valor) {
+    char digitos[20];
+    size_t tamanho = 0;
+    do {
+        digitos[tamanho++] = (char)('0' + valor % 10);
+        valor /= 10;
+    } while (valor > 0);
+    for (size_t i = 0; i < tamanho; i++) {
+        destino[i] = digitos[tamanho - 1 - i];
+    }
+    return tamanho;
+}
+
+/**
+ * Função: escreverInteiroSaida
+ * Propósito: Escrever um inteiro em decimal sem passar por printf
+ * Parâmetros: saida - ponteiro para a saída
+ *             valor - número a escrever
+ * Retorno: void
+ */
+static void escreverInteiroSaida(SaidaJogo* saida, long long valor) {
+    char digitos[24];
+    size_t tamanho = 0;
+    if (valor < 0) digitos[tamanho++] = '-';
+    tamanho += formatarDecimal(&digitos[tamanho], valor < 0 ? 0ULL - (unsigned long long)valor : (unsigned long long)valor);
+    escreverNaSaida(saida, digitos, tamanho);
+}
+
+/**
+ * Função: saidaTexto
+ * Propósito: Escrever uma mensagem em prosa já pronta (só no modo SAIDA_TEXTO)
+ * Parâmetros: saida - ponteiro para a saída
+ *             texto - mensagem
+ * Retorno: void
+ */
+void saidaTexto(SaidaJogo* saida, const char* texto) {
+    if (saida->modo != SAIDA_TEXTO) return;
+    escreverNaSaida(saida, texto, strlen(texto));
+}
+
+/**
+ * Função: saidaFormatada
+ * Propósito: Escrever uma mensagem em prosa com formato de printf, direto no buffer (só no
+ * modo SAIDA_TEXTO; nos outros modos os argumentos nem chegam a ser formatados)
+ * Parâmetros: saida - ponteiro para a saída
+ *             formato, ... - como em printf
+ * Retorno: void
+ */
+void saidaFormatada(SaidaJogo* saida, const char* formato, ...) {
+    if (saida->modo != SAIDA_TEXTO) return;
+    
+    for (int tentativa = 0; tentativa < 2; tentativa++) {
+        size_t livre = saida->capacidade - saida->usados;
+        va_list argumentos;
+        va_start(argumentos, formato);
+        int tamanho = vsnprintf(saida->buffer != NULL ? saida->buffer + saida->usados : NULL, livre, formato, argumentos);
+        va_end(argumentos);
+        if (tamanho < 0) return;
+        if ((size_t)tamanho < livre) {
+            saida->usados += (size_t)tamanho;
+            return;
+        }
+        // Não coube: amplia o buffer (saída em memória) ou descarrega e tenta de novo vazio
+        if (saida->destino == NULL) {
+            if (!ampliarSaidaMemoria(saida, (size_t)tamanho + 1)) return;
+            continue;
+        }
+        if (saida->usados == 0) break;
+        fwrite(saida->buffer, 1, saida->usados, saida->destino);
+        saida->usados = 0;
+    }
+    
+    // Mensagem maior que o buffer inteiro (ou sem buffer): vai direto para o arquivo
+    if (saida->destino == NULL) return;
+    va_list argumentos;
+    va_start(argumentos, formato);
+    vfprintf(saida->destino, formato, argumentos);
+    va_end(argumentos);
+}
+
+/**
+ * Função: escreverTextoJson
+ * Propósito: Escrever um texto como string JSON, com aspas e escapes
+ * Parâmetros: saida - ponteiro para a saída
+ *             texto - texto a escrever (NULL vira null)
+ * Retorno: void
+ */
+static void escreverTextoJson(SaidaJogo* saida, const char* texto) {
+    static const char hexadecimal[] = "0123456789abcdef";
+    if (texto == NULL) {
+        escreverNaSaida(saida, "null", 4);
+        return;
+    }
+    
+    escreverNaSaida(saida, "\"", 1);
+    const char* trecho = texto;
+    for (const char* c = texto; *c != '\0'; c++) {
+        unsigned char byte = (unsigned char)*c;
+        if (byte >= 0x20 && byte != '"' && byte != '\\') continue;
+        
+        // Copia o trecho sem escapes de uma vez e escapa o byte atual
+        escreverNaSaida(saida, trecho, (size_t)(c - trecho));
+        char escape[6] = {'\\', (char)byte, 0, 0, 0, 0};
+        size_t tamanho = 2;
+        if (byte == '\n') {
+            escape[1] = 'n';
+        } else if (byte == '\t') {
+            escape[1] = 't';
+        } else if (byte < 0x20) {
+            escape[1] = 'u';
+            escape[2] = '0';
+            escape[3] = '0';
+            escape[4] = hexadecimal[byte >> 4];
+            escape[5] = hexadecimal[byte & 0xF];
+            tamanho = 6;
+        }
+        escreverNaSaida(saida, escape, tamanho);
+        trecho = c + 1;
+    }
+    escreverNaSaida(saida, trecho, strlen(trecho));
+    escreverNaSaida(saida, "\"", 1);
+}
+
+/**
+ * Função: escreverNomeCampo
+ * Propósito: Escrever ,"nome": dentro de um evento aberto
+ * Parâmetros: saida - ponteiro para a saída
+ *             nome - nome do campo (sem caracteres que precisem de escape)
+ * Retorno: void
+ */
+static void escreverNomeCampo(SaidaJogo* saida, const char* nome) {
+    escreverNaSaida(saida, ",\"", 2);
+    escreverNaSaida(saida, nome, strlen(nome));
+    escreverNaSaida(saida, "\":", 2);
+}
+
+/**
+ * Função: abrirEvento
+ * Propósito: Começar uma linha de evento {"evento":"tipo" (só no modo SAIDA_EVENTOS; o
+ * mesmo vale para as funções de campo e fecharEvento)
+ * Parâmetros: saida - ponteiro para a saída
+ *             tipo - tipo do evento
+ * Retorno: void
+ */
+void abrirEvento(SaidaJogo* saida, const char* tipo) {
+    if (saida->modo != SAIDA_EVENTOS) return;
+    escreverNaSaida(saida, "{\"evento\":", 10);
+    escreverTextoJson(saida, tipo);
+}
+
+/**
+ * Função: campoTextoEvento
+ * Propósito: Acrescentar um campo de texto ao evento aberto
+ * Parâmetros: saida - ponteiro para a saída
+ *             nome - nome do campo
+ *             valor - texto (NULL vira null)
+ * Retorno: void
+ */
+void campoTextoEvento(SaidaJogo* saida, const char* nome, const char* valor) {
+    if (saida->modo != SAIDA_EVENTOS) return;
+    escreverNomeCampo(saida, nome);
+    escreverTextoJson(saida, valor);
+}
+
+/**
+ * Função: campoNumeroEvento
+ * Propósito: Acrescentar um campo numérico ao evento aberto
+ * Parâmetros: saida - ponteiro para a saída
+ *             nome - nome do campo
+ *             valor - número
+ * Retorno: void
+ */
+void campoNumeroEvento(SaidaJogo* saida, const char* nome, long long valor) {
+    if (saida->modo != SAIDA_EVENTOS) return;
+    escreverNomeCampo(saida, nome);
+    escreverInteiroSaida(saida, valor);
+}
+
+/**
+ * Função: campoListaEvento
+ * Propósito: Acrescentar ao evento aberto um campo com uma lista de textos internados
+ * Parâmetros: saida - ponteiro para a saída
+ *             nome - nome do campo
+ *             ids - ids dos textos
+ *             quantidade - tamanho da lista
+ * Retorno: void
+ */
+void campoListaEvento(SaidaJogo* saida, const char* nome, const IdTexto* ids, size_t quantidade) {
+    if (saida->modo != SAIDA_EVENTOS) return;
+    escreverNomeCampo(saida, nome);
+    escreverNaSaida(saida, "[", 1);
+    for (size_t i = 0; i < quantidade; i++) {
+        if (i > 0) escreverNaSaida(saida, ",", 1);
+        escreverTextoJson(saida, textoDoId(ids[i]));
+    }
+    escreverNaSaida(saida, "]", 1);
+}
+
+/**
+ * Função: fecharEvento
+ * Propósito: Terminar a linha do evento aberto
+ * Parâmetros: saida - ponteiro para a saída
+ * Retorno: void
+ */
+void fecharEvento(SaidaJogo* saida) {
+    if (saida->modo != SAIDA_EVENTOS) return;
+    escreverNaSaida(saida, "}\n", 2);
+}
+
+/**
+ * Função: criarTabelaHash
+ * Propósito: Criar e inicializar uma nova tabela hash
+ * (o vetor de posições só é alocado na primeira inserção)
+ * Retorno: ponteiro para a tabela hash criada
+ */
+TabelaHash* criarTabelaHash() {
+    TabelaHash* tabela = (TabelaHash*)malloc(sizeof(TabelaHash));
+    if (tabela == NULL) {
+        printf("Erro: Falha na alocação de memória para tabela hash!\n");
+        return NULL;
+    }
+    
+    tabela->entradas = NULL;
+    tabela->capacidade = 0;
+    tabela->quantidade = 0;
+    tabela->embutido = NULL;
+    tabela->substituidas = 0;
+    tabela->suspeitos = NULL;
+    tabela->numSuspeitos = 0;
+    
+    return tabela;
+}
+
+/**
+ * Função: buscarEntradaHash
+ * Propósito: Localizar a posição de uma pista na tabela (sondagem linear)
+ * Parâmetros: entradas - vetor de posições
+ *             capacidade - número de posições (potência de 2)
+ *             hash - hash completo da pista
+ *             pista - id da pista (ID_TEXTO_INVALIDO para procurar apenas uma posição livre)
+ * Retorno: posição que contém a pista ou a primeira posição livre encontrada
+ */
+static EntradaHash* buscarEntradaHash(EntradaHash* entradas, size_t capacidade, uint64_t hash, IdTexto pista) {
+    size_t mascara = capacidade - 1;
+    size_t indice = (size_t)hash & mascara;
+#ifdef DQ_INSTRUMENTAR
+    size_t sondagens = 1;
+#endif
+    
+    // O fator de carga garante que sempre existe uma posição livre
+    while (entradas[indice].no.pista != ID_TEXTO_INVALIDO) {
+        // Textos internados: a igualdade das pistas é uma comparação de inteiros
+        if (entradas[indice].hash == hash && entradas[indice].no.pista == pista) {
+            break;
+        }
+        indice = (indice + 1) & mascara;
+#ifdef DQ_INSTRUMENTAR
+        sondagens++;
+#endif
+    }
+    INSTRUMENTAR_SOMAR(buscasHash, 1);
+    INSTRUMENTAR_SOMAR(sondagensHash, sondagens);
+    INSTRUMENTAR_MAXIMO(maiorSondagemHash, sondagens);
+    return &entradas[indice];
+}
+
+/**
+ * Função: redimensionarTabelaHash
+ * Propósito: Realocar a tabela com uma nova capacidade, reposicionando as associações
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ *             novaCapacidade - nova quantidade de posições (potência de 2)
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória (a tabela antiga é mantida)
+ */
+static int redimensionarTabelaHash(TabelaHash* tabela, size_t novaCapacidade) {
+    EntradaHash* novas = (EntradaHash*)malloc(novaCapacidade * sizeof(EntradaHash));
+    if (novas == NULL) {
+        printf("Erro: Falha na alocação de memória para tabela hash!\n");
+        return 0;
+    }
+    memset(novas, 0xff, novaCapacidade * sizeof(EntradaHash));
+    INSTRUMENTAR_SOMAR(redimensionamentosHash, 1);
+    
+    // Os hashes guardados evitam recalcular funcaoHash para cada pista
+    for (size_t i = 0; i < tabela->capacidade; i++) {
+        if (tabela->entradas[i].no.pista != ID_TEXTO_INVALIDO) {
+            *buscarEntradaHash(novas, novaCapacidade, tabela->entradas[i].hash, ID_TEXTO_INVALIDO) = tabela->entradas[i];
+        }
+    }
+    
+    free(tabela->entradas);
+    tabela->entradas = novas;
+    tabela->capacidade = novaCapacidade;
+    return 1;
+}
+
+/**
+ * Função: pistaDoCatalogoEmbutido
+ * Propósito: Verificar se uma pista tem suspeito no catálogo embutido da tabela
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ *             pista - id da pista
+ * Retorno: 1 se o catálogo embutido associa a pista a um suspeito, 0 caso contrário
+ */
+static int pistaDoCatalogoEmbutido(const TabelaHash* tabela, IdTexto pista) {
+    return tabela->embutido != NULL && pista < tabela->embutido->numTextos &&
+           tabela->embutido->suspeitos[pista] != ID_TEXTO_INVALIDO;
+}
+
+/**
+ * Função: inserirNaHashPorId
+ * Propósito: Inserir uma associação entre textos já internados
+ * (se a pista já existir, o suspeito associado é substituído)
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ *             pista - id da pista (chave)
+ *             suspeito - id do nome do suspeito (valor)
+ * Retorno: 1 em caso de sucesso, 0 se a pista é inválida ou faltou memória
+ */
+int inserirNaHashPorId(TabelaHash* tabela, IdTexto pista, IdTexto suspeito) {
+    if (tabela == NULL || pista == ID_TEXTO_INVALIDO) return 0;
+    
+    // A lista de suspeitos já montada deixa de valer
+    if (tabela->suspeitos != NULL) {
+        free(tabela->suspeitos);
+        tabela->suspeitos = NULL;
+        tabela->numSuspeitos = 0;
+    }
+    
+    // Cresce antes de ultrapassar o fator de carga máximo
+    if ((tabela->quantidade + 1) * CARGA_MAXIMA_HASH_DEN > tabela->capacidade * CARGA_MAXIMA_HASH_NUM) {
+        size_t novaCapacidade = tabela->capacidade > 0 ? tabela->capacidade * 2 : CAPACIDADE_INICIAL_HASH;
+        if (!redimensionarTabelaHash(tabela, novaCapacidade)) return 0;
+    }
+    
+    uint64_t hash = hashDoTexto(pista);
+    EntradaHash* entrada = buscarEntradaHash(tabela->entradas, tabela->capacidade, hash, pista);
+    
+    // Pista nova ocupa a posição livre; pista já cadastrada apenas troca o suspeito
+    if (entrada->no.pista == ID_TEXTO_INVALIDO) {
+        entrada->hash = hash;
+        entrada->no.pista = pista;
+        tabela->quantidade++;
+        tabela->substituidas += (size_t)pistaDoCatalogoEmbutido(tabela, pista);
+    }
+    entrada->no.suspeito = suspeito;
+    return 1;
+}
+
+/**
+ * Função: inserirNaHash
+ * Propósito: Inserir uma associação pista/suspeito na tabela hash
+ * (se a pista já existir, o suspeito associado é substituído)
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ *             pista - string da pista (chave)
+ *             suspeito - string do nome do suspeito (valor)
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória
+ */
+int inserirNaHash(TabelaHash* tabela, const char* pista, const char* suspeito) {
+    if (tabela == NULL) return 0;
+    IdTexto idSuspeito = internarTexto(suspeito);
+    if (idSuspeito == ID_TEXTO_INVALIDO) return 0;
+    return inserirNaHashPorId(tabela, internarTexto(pista), idSuspeito);
+}
+
+/**
+ * Função: reservarTabelaHash
+ * Propósito: Dimensionar a tabela de uma só vez para um total de associações, de modo que
+ * as inserções seguintes não provoquem nenhum redimensionamento
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ *             total - quantidade total de associações esperada
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória (a tabela antiga é mantida)
+ */
+int reservarTabelaHash(TabelaHash* tabela, size_t total) {
+    if (tabela == NULL) return 0;
+    
+    if (total == 0) return 1;
+    size_t capacidade = tabela->capacidade > 0 ? tabela->capacidade : CAPACIDADE_INICIAL_HASH;
+    while (total * CARGA_MAXIMA_HASH_DEN > capacidade * CARGA_MAXIMA_HASH_NUM) {
+        capacidade *= 2;
+    }
+    if (capacidade == tabela->capacidade) return 1;
+    return redimensionarTabelaHash(tabela, capacidade);
+}
+
+/**
+ * Função: inserirNaHashEmLote
+ * Propósito: Inserir várias associações pista/suspeito com um único dimensionamento
+ * da tabela (em vez de dobrá-la várias vezes durante a carga)
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ *             pistas - vetor de pistas (chaves)
+ *             suspeitos - vetor de suspeitos, na mesma ordem das pistas
+ *             quantidade - número de associações
+ * Retorno: void
+ */
+void inserirNaHashEmLote(TabelaHash* tabela, const char* const* pistas, const char* const* suspeitos, size_t quantidade) {
+    if (tabela == NULL) return;
+    
+    // Pistas repetidas apenas superestimam a reserva
+    reservarTabelaHash(tabela, tabela->quantidade + quantidade);
+    for (size_t i = 0; i < quantidade; i++) {
+        inserirNaHash(tabela, pistas[i], suspeitos[i]);
+    }
+}
+
+/**
+ * Função: encontrarSuspeitoPorId
+ * Propósito: Buscar o suspeito associado a uma pista já internada (as associações inseridas
+ * têm precedência sobre as do catálogo embutido)
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ *             pista - id da pista a ser buscada
+ * Retorno: id do nome do suspeito ou ID_TEXTO_INVALIDO se não encontrado
+ */
+IdTexto encontrarSuspeitoPorId(TabelaHash* tabela, IdTexto pista) {
+    if (tabela == NULL || pista == ID_TEXTO_INVALIDO) return ID_TEXTO_INVALIDO;
+    
+    if (tabela->quantidade > 0) {
+        EntradaHash* entrada = buscarEntradaHash(tabela->entradas, tabela->capacidade, hashDoTexto(pista), pista);
+        if (entrada->no.pista != ID_TEXTO_INVALIDO || tabela->embutido == NULL) {
+            return entrada->no.suspeito;  // Posição livre guarda ID_TEXTO_INVALIDO
+        }
+    }
+    
+    // Catálogo embutido: o id fixo da pista indexa direto o suspeito
+    if (tabela->embutido != NULL && pista < tabela->embutido->numTextos) {
+        return tabela->embutido->suspeitos[pista];
+    }
+    return ID_TEXTO_INVALIDO;
+}
+
+/**
+ * Função: encontrarSuspeito
+ * Propósito: Buscar o suspeito associado a uma pista na tabela hash
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ *             pista - string da pista a ser buscada
+ * Retorno: ponteiro para o nome do suspeito ou NULL se não encontrado
+ */
+const char* encontrarSuspeito(TabelaHash* tabela, const char* pista) {
+    IdTexto suspeito = encontrarSuspeitoPorId(tabela, buscarIdTexto(pista));
+    if (suspeito != ID_TEXTO_INVALIDO) {
+        return textoDoId(suspeito);
+    }
+    
+    return NULL;  // Pista não encontrada
+}
+
+/**
+ * Função: posicoesDaTabela
+ * Propósito: Informar quantas posições associacaoNaPosicao percorre em uma tabela
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ * Retorno: posições dinâmicas mais textos do catálogo embutido (se houver)
+ */
+size_t posicoesDaTabela(const TabelaHash* tabela) {
+    return tabela->capacidade + (tabela->embutido != NULL ? tabela->embutido->numTextos : 0);
+}
+
+/**
+ * Função: associacaoNaPosicao
+ * Propósito: Percorrer todas as associações de uma tabela: primeiro as posições dinâmicas,
+ * depois as pistas do catálogo embutido que não estão nas posições dinâmicas (cada pista
+ * aparece uma única vez, com o suspeito de encontrarSuspeitoPorId)
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ *             posicao - índice em [0, posicoesDaTabela(tabela))
+ *             no - saída: associação da posição
+ * Retorno: 1 se a posição contém uma associação, 0 se está livre
+ */
+int associacaoNaPosicao(TabelaHash* tabela, size_t posicao, HashNode* no) {
+    if (posicao < tabela->capacidade) {
+        *no = tabela->entradas[posicao].no;
+        return no->pista != ID_TEXTO_INVALIDO;
+    }
+    
+    IdTexto pista = (IdTexto)(posicao - tabela->capacidade);
+    if (!pistaDoCatalogoEmbutido(tabela, pista)) return 0;
+    if (tabela->quantidade > 0 &&
+        buscarEntradaHash(tabela->entradas, tabela->capacidade, hashDoTexto(pista), pista)->no.pista == pista) {
+        return 0;  // Já percorrida nas posições dinâmicas, mesmo com o mesmo suspeito
+    }
+    no->pista = pista;
+    no->suspeito = tabela->embutido->suspeitos[pista];
+    return 1;
+}
+
+/**
+ * Função: totalAssociacoes
+ * Propósito: Contar as associações de uma tabela (as pistas do catálogo embutido que
+ * também foram inseridas contam uma vez)
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ * Retorno: número de associações que associacaoNaPosicao percorre
+ */
+size_t totalAssociacoes(const TabelaHash* tabela) {
+    return tabela->quantidade + (tabela->embutido != NULL ? tabela->embutido->numAssociacoes - tabela->substituidas : 0);
+}
+
+/**
+ * Função: suspeitosDaTabela
+ * Propósito: Listar os suspeitos distintos de uma tabela (do caso carregado), em ordem
+ * alfabética; a lista é montada na primeira consulta e guardada até a próxima inserção
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ *             quantidade - saída: número de suspeitos
+ * Retorno: vetor de ids dos nomes (NULL se a tabela está vazia ou faltou memória)
+ */
+const IdTexto* suspeitosDaTabela(TabelaHash* tabela, size_t* quantidade) {
+    *quantidade = 0;
+    if (tabela == NULL) return NULL;
+    if (tabela->suspeitos != NULL) {
+        *quantidade = tabela->numSuspeitos;
+        return tabela->suspeitos;
+    }
+    
+    size_t total = totalAssociacoes(tabela);
+    if (total == 0) return NULL;
+    IdTexto* suspeitos = (IdTexto*)malloc(total * sizeof(IdTexto));
+    if (suspeitos == NULL) {
+        printf("Erro: Falha na alocação de memória para a lista de suspeitos!\n");
+        return NULL;
+    }
+    size_t numSuspeitos = 0;
+    HashNode no;
+    for (size_t i = 0; i < posicoesDaTabela(tabela) && numSuspeitos < total; i++) {
+        if (associacaoNaPosicao(tabela, i, &no)) suspeitos[numSuspeitos++] = no.suspeito;
+    }
+    
+    // Ordena pelo nome e remove as repetições (ids iguais ficam vizinhos)
+    qsort(suspeitos, numSuspeitos, sizeof(IdTexto), compararIdsTexto);
+    size_t distintos = 0;
+    for (size_t i = 0; i < numSuspeitos; i++) {
+        if (distintos == 0 || suspeitos[distintos - 1] != suspeitos[i]) suspeitos[distintos++] = suspeitos[i];
+    }
+    IdTexto* justo = distintos > 0 ? (IdTexto*)realloc(suspeitos, distintos * sizeof(IdTexto)) : NULL;
+    if (justo != NULL) suspeitos = justo;
+    tabela->suspeitos = suspeitos;
+    tabela->numSuspeitos = distintos;
+    *quantidade = distintos;
+    return suspeitos;
+}
+
+/**
+ * Função: criarVetorHashConcorrente
+ * Propósito: Alocar um vetor de posições vazio para a tabela hash concorrente
+ * Parâmetros: capacidade - número de posições (potência de 2)
+ * Retorno: ponteiro para o vetor ou NULL se faltou memória
+ */
+static VetorHashConcorrente* criarVetorHashConcorrente(size_t capacidade) {
+    VetorHashConcorrente* vetor = (VetorHashConcorrente*)malloc(sizeof(VetorHashConcorrente) +
+                                                                capacidade * sizeof(vetor->posicoes[0]));
+    if (vetor == NULL) return NULL;
+    vetor->capacidade = capacidade;
+    for (size_t i = 0; i < capacidade; i++) {
+        atomic_init(&vetor->posicoes[i], NULL);
+    }
+    return vetor;
+}
+
+/**
+ * Função: criarTabelaHashConcorrente
+ * Propósito: Criar uma tabela hash pista/suspeito compartilhada entre threads
+ * (consultas sem travas, inserções e redimensionamentos sem bloquear os leitores)
+ * Retorno: ponteiro para a tabela criada ou NULL se faltou memória
+ */
+TabelaHashConcorrente* criarTabelaHashConcorrente(void) {
+    TabelaHashConcorrente* tabela = (TabelaHashConcorrente*)malloc(sizeof(TabelaHashConcorrente));
+    VetorHashConcorrente* vetor = criarVetorHashConcorrente(CAPACIDADE_INICIAL_HASH);
+    if (tabela == NULL || vetor == NULL) {
+        printf("Erro: Falha na alocação de memória para tabela hash concorrente!\n");
+        free(tabela);
+        free(vetor);
+        return NULL;
+    }
+    
+    atomic_init(&tabela->vetor, vetor);
+    atomic_init(&tabela->epoca, 1);
+    atomic_flag_clear(&tabela->travaEscrita);
+    tabela->quantidade = 0;
+    tabela->aposentados = NULL;
+    tabela->numAposentados = 0;
+    tabela->capacidadeAposentados = 0;
+    tabela->redimensionamentos = 0;
+    atomic_init(&tabela->numLeitores, 0);
+    for (int i = 0; i < MAX_LEITORES_TABELA; i++) {
+        atomic_init(&tabela->leitores[i].epoca, 0);
+        atomic_init(&tabela->leitores[i].ocupada, 0);
+    }
+    return tabela;
+}
+
+/**
+ * Função: registrarLeitorTabela
+ * Propósito: Reservar uma vaga de leitor na tabela concorrente (uma por thread leitora)
+ * Parâmetros: tabela - ponteiro para a tabela concorrente
+ * Retorno: índice da vaga ou -1 se todas as vagas estão ocupadas
+ */
+int registrarLeitorTabela(TabelaHashConcorrente* tabela) {
+    if (tabela == NULL) return -1;
+    
+    for (int i = 0; i < MAX_LEITORES_TABELA; i++) {
+        int livre = 0;
+        if (atomic_compare_exchange_strong(&tabela->leitores[i].ocupada, &livre, 1)) {
+            // Estende a varredura dos escritores até esta vaga antes da primeira leitura
+            int usadas = atomic_load(&tabela->numLeitores);
+            while (usadas <= i && !atomic_compare_exchange_weak(&tabela->numLeitores, &usadas, i + 1)) {
+            }
+            return i;
+        }
+    }
+    printf("Erro: Limite de %d leitores da tabela concorrente atingido!\n", MAX_LEITORES_TABELA);
+    return -1;
+}
+
+/**
+ * Função: liberarLeitorTabela
+ * Propósito: Devolver a vaga de um leitor que não vai mais consultar a tabela
+ * Parâmetros: tabela - ponteiro para a tabela concorrente
+ *             leitor - vaga obtida em registrarLeitorTabela (fora de uma leitura)
+ * Retorno: void
+ */
+void liberarLeitorTabela(TabelaHashConcorrente* tabela, int leitor) {
+    if (tabela == NULL || leitor < 0) return;
+    atomic_store_explicit(&tabela->leitores[leitor].epoca, 0, memory_order_release);
+    atomic_store_explicit(&tabela->leitores[leitor].ocupada, 0, memory_order_release);
+}
+
+/**
+ * Função: entrarLeituraTabela
+ * Propósito: Iniciar uma leitura: anuncia a época atual, impedindo que os escritores
+ * liberem qualquer entrada ou vetor que o leitor ainda possa alcançar
+ * Parâmetros: tabela - ponteiro para a tabela concorrente
+ *             leitor - vaga do leitor (leituras não podem ser aninhadas)
+ * Retorno: void
+ */
+void entrarLeituraTabela(TabelaHashConcorrente* tabela, int leitor) {
+    uint64_t epoca = atomic_load_explicit(&tabela->epoca, memory_order_acquire);
+    atomic_store_explicit(&tabela->leitores[leitor].epoca, epoca, memory_order_relaxed);
+    // O anúncio precisa ser visível antes de qualquer ponteiro lido da tabela
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+/**
+ * Função: sairLeituraTabela
+ * Propósito: Encerrar uma leitura (os textos obtidos nela deixam de ser válidos)
+ * Parâmetros: tabela - ponteiro para a tabela concorrente
+ *             leitor - vaga do leitor
+ * Retorno: void
+ */
+void sairLeituraTabela(TabelaHashConcorrente* tabela, int leitor) {
+    atomic_store_explicit(&tabela->leitores[leitor].epoca, 0, memory_order_release);
+}
+
+/**
+ * Função: localizarPosicaoConcorrente
+ * Propósito: Localizar uma pista no vetor de posições (sondagem linear); cada posição é
+ * lida uma única vez, então o resultado é coerente mesmo com um escritor ativo
+ * Parâmetros: vetor - vetor de posições
+ *             hash - hash completo da pista
+ *             pista - string da pista
+ *             entrada - saída: entrada encontrada ou NULL se a posição está livre
+ * Retorno: índice da posição que contém a pista ou da posição livre onde ela entraria
+ */
+static size_t localizarPosicaoConcorrente(VetorHashConcorrente* vetor, uint64_t hash, const char* pista,
+                                          EntradaConcorrente** entrada) {
+    size_t mascara = vetor->capacidade - 1;
+    size_t indice = (size_t)hash & mascara;
+    
+    // O fator de carga garante uma posição livre: no máximo capacidade sondagens
+    for (;;) {
+        EntradaConcorrente* atual = atomic_load_explicit(&vetor->posicoes[indice], memory_order_acquire);
+        if (atual == NULL || (atual->hash == hash && strcmp(atual->textos, pista) == 0)) {
+            *entrada = atual;
+            return indice;
+        }
+        indice = (indice + 1) & mascara;
+    }
+}
+
+/**
+ * Função: encontrarSuspeitoConcorrente
+ * Propósito: Buscar o suspeito associado a uma pista sem travas e sem novas tentativas
+ * (deve ser chamada entre entrarLeituraTabela e sairLeituraTabela)
+ * Parâmetros: tabela - ponteiro para a tabela concorrente
+ *             pista - string da pista a ser buscada
+ * Retorno: nome do suspeito (válido até sairLeituraTabela) ou NULL se não encontrado
+ */
+const char* encontrarSuspeitoConcorrente(TabelaHashConcorrente* tabela, const char* pista) {
+    if (tabela == NULL || pista == NULL) return NULL;
+    
+    EntradaConcorrente* entrada;
+    VetorHashConcorrente* vetor = atomic_load_explicit(&tabela->vetor, memory_order_acquire);
+    localizarPosicaoConcorrente(vetor, funcaoHash(pista), pista, &entrada);
+    return entrada != NULL ? entrada->suspeito : NULL;
+}
+
+/**
+ * Função: recuperarAposentados
+ * Propósito: Liberar os blocos retirados antes da menor época anunciada pelos leitores
+ * ativos (nenhum leitor ainda pode alcançá-los); chamada com a trava de escrita
+ * Parâmetros: tabela - ponteiro para a tabela concorrente
+ * Retorno: void
+ */
+static void recuperarAposentados(TabelaHashConcorrente* tabela) {
+    // Par da barreira de entrarLeituraTabela: ou o escritor vê o anúncio do leitor,
+    // ou o leitor vê os ponteiros já substituídos
+    atomic_thread_fence(memory_order_seq_cst);
+    uint64_t menor = UINT64_MAX;
+    int numLeitores = atomic_load(&tabela->numLeitores);
+    for (int i = 0; i < numLeitores; i++) {
+        uint64_t epoca = atomic_load_explicit(&tabela->leitores[i].epoca, memory_order_acquire);
+        if (epoca != 0 && epoca < menor) menor = epoca;
+    }
+    
+    size_t mantidos = 0;
+    for (size_t i = 0; i < tabela->numAposentados; i++) {
+        if (tabela->aposentados[i].epoca < menor) {
+            free(tabela->aposentados[i].bloco);
+        } else {
+            tabela->aposentados[mantidos++] = tabela->aposentados[i];
+        }
+    }
+    tabela->numAposentados = mantidos;
+}
+
+/**
+ * Função: aposentarBloco
+ * Propósito: Registrar um bloco que acabou de se tornar inalcançável para novas leituras
+ * e avançar a época; a liberação fica para quando os leitores antigos terminarem
+ * Parâmetros: tabela - ponteiro para a tabela concorrente (com a trava de escrita)
+ *             bloco - entrada ou vetor substituído
+ * Retorno: void (sem memória para o registro, o bloco nunca é liberado)
+ */
+static void aposentarBloco(TabelaHashConcorrente* tabela, void* bloco) {
+    if (tabela->numAposentados == tabela->capacidadeAposentados) {
+        size_t novaCapacidade = tabela->capacidadeAposentados == 0 ? APOSENTADOS_POR_RECUPERACAO
+                                                                    : tabela->capacidadeAposentados * 2;
+        BlocoAposentado* novos = (BlocoAposentado*)realloc(tabela->aposentados, novaCapacidade * sizeof(BlocoAposentado));
+        if (novos == NULL) {
+            printf("Erro: Falha na alocação de memória para tabela hash concorrente!\n");
+            return;
+        }
+        tabela->aposentados = novos;
+        tabela->capacidadeAposentados = novaCapacidade;
+    }
+    
+    uint64_t epoca = atomic_fetch_add(&tabela->epoca, 1);
+    tabela->aposentados[tabela->numAposentados].bloco = bloco;
+    tabela->aposentados[tabela->numAposentados].epoca = epoca;
+    tabela->numAposentados++;
+    
+    // Tentativas espaçadas: um leitor parado não faz cada inserção varrer as vagas
+    if (tabela->numAposentados % APOSENTADOS_POR_RECUPERACAO == 0) {
+        recuperarAposentados(tabela);
+    }
+}
+
+/**
+ * Função: inserirNaHashConcorrente
+ * Propósito: Inserir (ou substituir) uma associação pista/suspeito enquanto outras threads
+ * consultam a tabela; escritores simultâneos se revezam pela trava de escrita
+ * Parâmetros: tabela - ponteiro para a tabela concorrente
+ *             pista - string da pista (chave)
+ *             suspeito - string do nome do suspeito (valor)
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória (a tabela não muda)
+ */
+int inserirNaHashConcorrente(TabelaHashConcorrente* tabela, const char* pista, const char* suspeito) {
+    if (tabela == NULL || pista == NULL || suspeito == NULL) return 0;
+    
+    // A entrada é montada inteira antes de ser publicada
+    size_t tamanhoPista = strlen(pista) + 1;
+    size_t tamanhoSuspeito = strlen(suspeito) + 1;
+    EntradaConcorrente* nova = (EntradaConcorrente*)malloc(sizeof(EntradaConcorrente) + tamanhoPista + tamanhoSuspeito);
+    if (nova == NULL) {
+        printf("Erro: Falha na alocação de memória para tabela hash concorrente!\n");
+        return 0;
+    }
+    nova->hash = funcaoHash(pista);
+    memcpy(nova->textos, pista, tamanhoPista);
+    memcpy(nova->textos + tamanhoPista, suspeito, tamanhoSuspeito);
+    nova->suspeito = nova->textos + tamanhoPista;
+    
+    // Os escritores são raros: uma trava de espera ativa basta
+    while (atomic_flag_test_and_set_explicit(&tabela->travaEscrita, memory_order_acquire)) {
+    }
+    
+    // Cresce em um vetor novo; os leitores seguem no antigo até a publicação
+    VetorHashConcorrente* vetor = atomic_load_explicit(&tabela->vetor, memory_order_relaxed);
+    if ((tabela->quantidade + 1) * CARGA_MAXIMA_HASH_DEN > vetor->capacidade * CARGA_MAXIMA_HASH_NUM) {
+        VetorHashConcorrente* maior = criarVetorHashConcorrente(vetor->capacidade * 2);
+        if (maior == NULL) {
+            atomic_flag_clear_explicit(&tabela->travaEscrita, memory_order_release);
+            printf("Erro: Falha na alocação de memória para tabela hash concorrente!\n");
+            free(nova);
+            return 0;
+        }
+        // As entradas são imutáveis: o vetor novo reaproveita os mesmos ponteiros
+        for (size_t i = 0; i < vetor->capacidade; i++) {
+            EntradaConcorrente* entrada = atomic_load_explicit(&vetor->posicoes[i], memory_order_relaxed);
+            if (entrada == NULL) continue;
+            size_t mascara = maior->capacidade - 1;
+            size_t indice = (size_t)entrada->hash & mascara;
+            while (atomic_load_explicit(&maior->posicoes[indice], memory_order_relaxed) != NULL) {
+                indice = (indice + 1) & mascara;
+            }
+            atomic_store_explicit(&maior->posicoes[indice], entrada, memory_order_relaxed);
+        }
+        atomic_store_explicit(&tabela->vetor, maior, memory_order_release);
+        aposentarBloco(tabela, vetor);
+        tabela->redimensionamentos++;
+        vetor = maior;
+    }
+    
+    // Pista nova ocupa a posição livre; pista já cadastrada troca a entrada inteira
+    EntradaConcorrente* antiga;
+    size_t indice = localizarPosicaoConcorrente(vetor, nova->hash, pista, &antiga);
+    atomic_store_explicit(&vetor->posicoes[indice], nova, memory_order_release);
+    if (antiga == NULL) {
+        tabela->quantidade++;
+    } else {
+        aposentarBloco(tabela, antiga);
+    }
+    
+    atomic_flag_clear_explicit(&tabela->travaEscrita, memory_order_release);
+    return 1;
+}
+
+/**
+ * Função: copiarParaTabelaConcorrente
+ * Propósito: Publicar na tabela concorrente todas as associações de uma tabela hash comum
+ * (executada pela thread que interna os textos, já que lê os ids da tabela de origem)
+ * Parâmetros: destino - ponteiro para a tabela concorrente
+ *             origem - ponteiro para a tabela hash de origem
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória
+ */
+int copiarParaTabelaConcorrente(TabelaHashConcorrente* destino, TabelaHash* origem) {
+    if (destino == NULL || origem == NULL) return 0;
+    
+    HashNode no;
+    for (size_t i = 0; i < posicoesDaTabela(origem); i++) {
+        if (!associacaoNaPosicao(origem, i, &no)) continue;
+        if (!inserirNaHashConcorrente(destino, textoDoId(no.pista), textoDoId(no.suspeito))) return 0;
+    }
+    return 1;
+}
+
+/**
+ * Função: liberarTabelaHashConcorrente
+ * Propósito: Liberar a tabela concorrente, suas entradas e os blocos ainda aposentados
+ * (nenhuma thread pode estar usando a tabela)
+ * Parâmetros: tabela - ponteiro para a tabela concorrente
+ * Retorno: void
+ */
+void liberarTabelaHashConcorrente(TabelaHashConcorrente* tabela) {
+    if (tabela == NULL) return;
+    
+    VetorHashConcorrente* vetor = atomic_load(&tabela->vetor);
+    for (size_t i = 0; i < vetor->capacidade; i++) {
+        free(atomic_load_explicit(&vetor->posicoes[i], memory_order_relaxed));
+    }
+    free(vetor);
+    for (size_t i = 0; i < tabela->numAposentados; i++) {
+        free(tabela->aposentados[i].bloco);
+    }
+    free(tabela->aposentados);
+    free(tabela);
+}
+
+/**
+ * Função: criarSala
+ * Propósito: Criar uma nova sala com nome e pista especificados usando alocação dinâmica
+ * Parâmetros: nome - string com o nome da sala
+ *             pista - string com a pista da sala (pode ser vazia)
+ * Retorno: ponteiro para a nova sala criada ou NULL se faltou memória
+ */
+Sala* criarSala(const char* nome, const char* pista) {
+    // Aloca memória dinamicamente para uma nova sala (na arena, se houver uma ativa)
+    Sala* novaSala = (Sala*)alocarNo(sizeof(Sala));
+    
+    // Verifica se a alocação foi bem-sucedida
+    if (novaSala == NULL) {
+        printf("Erro: Falha na alocação de memória!\n");
+        return NULL;
+    }
+    
+    // Guarda os ids internados do nome e da pista e inicializa os ponteiros como NULL
+    novaSala->nome = internarTexto(nome);
+    novaSala->pista = internarTexto(pista);
+    if (novaSala->nome == ID_TEXTO_INVALIDO || novaSala->pista == ID_TEXTO_INVALIDO) {
+        if (arenaAtual == NULL) liberarNo(novaSala);
+        return NULL;
+    }
+    novaSala->salasAteCondenacao = CONDENACAO_NAO_CALCULADA;
+    novaSala->esquerda = NULL;
+    novaSala->direita = NULL;
+    
+    return novaSala;
+}
+
+/**
+ * Função: criarPistaNode
+ * Propósito: Criar um novo nó para a árvore de pistas usando alocação dinâmica
+ * Parâmetros: conteudo - id internado do conteúdo da pista
+ * Retorno: ponteiro para o novo nó de pista criado
+ */
+PistaNode* criarPistaNode(IdTexto conteudo) {
+    // Aloca memória dinamicamente para um novo nó de pista (na arena, se houver uma ativa)
+    PistaNode* novoNode = (PistaNode*)alocarNo(sizeof(PistaNode));
+    
+    // Verifica se a alocação foi bem-sucedida
+    if (novoNode == NULL) {
+        printf("Erro: Falha na alocação de memória para pista!\n");
+        return NULL;
+    }
+    
+    // Guarda o conteúdo e inicializa os ponteiros como NULL
+    novoNode->conteudo = conteudo;
+    novoNode->altura = 1;
+    novoNode->esquerda = NULL;
+    novoNode->direita = NULL;
+    
+    return novoNode;
+}
+
+/**
+ * Função: inserirPista (também conhecida como adicionarPista)
+ * Propósito: Inserir uma nova pista na árvore BST de pistas em ordem alfabética
+ * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas
+ *             conteudo - id internado do conteúdo da pista a ser inserida
+ * Retorno: ponteiro para a raiz da árvore (pode ter mudado)
+ */
+PistaNode* inserirPista(PistaNode* raiz, IdTexto conteudo) {
+    // Desce iterativamente até o local de inserção (a árvore pode ser degenerada)
+    PistaNode** ligacao = &raiz;
+    while (*ligacao != NULL) {
+        // Compara a nova pista com a pista atual
+        int comparacao = compararTextosPorId(conteudo, (*ligacao)->conteudo);
+        INSTRUMENTAR_COMPARACAO_PISTA();
+        
+        if (comparacao == 0) {
+            INSTRUMENTAR_FIM_INSERCAO_PISTA();  // Pista já existe, não insere duplicata
+            return raiz;
+        }
+        // Menor lexicograficamente vai à esquerda, maior à direita
+        ligacao = comparacao < 0 ? &(*ligacao)->esquerda : &(*ligacao)->direita;
+    }
+    
+    INSTRUMENTAR_FIM_INSERCAO_PISTA();
+    *ligacao = criarPistaNode(conteudo);
+    return raiz;
+}
+
+/**
+ * Função: alturaPista
+ * Propósito: Obter a altura de uma subárvore de pistas (0 para árvore vazia)
+ * Parâmetros: raiz - ponteiro para a raiz da subárvore
+ * Retorno: altura da subárvore
+ */
+static int alturaPista(PistaNode* raiz) {
+    return raiz != NULL ? raiz->altura : 0;
+}
+
+/**
+ * Função: atualizarAlturaPista
+ * Propósito: Recalcular a altura de um nó a partir das alturas dos filhos
+ * Parâmetros: no - ponteiro para o nó
+ * Retorno: void
+ */
+static void atualizarAlturaPista(PistaNode* no) {
+    int alturaEsquerda = alturaPista(no->esquerda);
+    int alturaDireita = alturaPista(no->direita);
+    no->altura = 1 + (alturaEsquerda > alturaDireita ? alturaEsquerda : alturaDireita);
+}
+
+/**
+ * Função: rotacionarDireita
+ * Propósito: Rotação simples à direita (o filho esquerdo sobe para a raiz)
+ * Parâmetros: raiz - ponteiro para a raiz da subárvore desbalanceada
+ * Retorno: nova raiz da subárvore
+ */
+static PistaNode* rotacionarDireita(PistaNode* raiz) {
+    PistaNode* novaRaiz = raiz->esquerda;
+    raiz->esquerda = novaRaiz->direita;
+    novaRaiz->direita = raiz;
+    atualizarAlturaPista(raiz);
+    atualizarAlturaPista(novaRaiz);
+    return novaRaiz;
+}
+
+/**
+ * Função: rotacionarEsquerda
+ * Propósito: Rotação simples à esquerda (o filho direito sobe para a raiz)
+ * Parâmetros: raiz - ponteiro para a raiz da subárvore desbalanceada
+ * Retorno: nova raiz da subárvore
+ */
+static PistaNode* rotacionarEsquerda(PistaNode* raiz) {
+    PistaNode* novaRaiz = raiz->direita;
+    raiz->direita = novaRaiz->esquerda;
+    novaRaiz->esquerda = raiz;
+    atualizarAlturaPista(raiz);
+    atualizarAlturaPista(novaRaiz);
+    return novaRaiz;
+}
+
+/**
+ * Função: inserirPistaBalanceada
+ * Propósito: Inserir uma nova pista mantendo a árvore balanceada (AVL), de modo que
+ * a inserção continue O(log n) mesmo quando as pistas chegam ordenadas
+ * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas
+ *             conteudo - id internado do conteúdo da pista a ser inserida
+ * Retorno: ponteiro para a raiz da árvore (pode ter mudado)
+ */
+PistaNode* inserirPistaBalanceada(PistaNode* raiz, IdTexto conteudo) {
+    if (raiz == NULL) {
+        INSTRUMENTAR_FIM_INSERCAO_PISTA();
+        return criarPistaNode(conteudo);
+    }
+    
+    int comparacao = compararTextosPorId(conteudo, raiz->conteudo);
+    INSTRUMENTAR_COMPARACAO_PISTA();
+    if (comparacao < 0) {
+        raiz->esquerda = inserirPistaBalanceada(raiz->esquerda, conteudo);
+    } else if (comparacao > 0) {
+        raiz->direita = inserirPistaBalanceada(raiz->direita, conteudo);
+    } else {
+        INSTRUMENTAR_FIM_INSERCAO_PISTA();
+        return raiz;  // Pista já existe, não insere duplicata
+    }
+    
+    atualizarAlturaPista(raiz);
+    int fator = alturaPista(raiz->esquerda) - alturaPista(raiz->direita);
+    
+    if (fator > 1) {
+        // Caso esquerda-direita: primeiro gira o filho esquerdo
+        if (alturaPista(raiz->esquerda->esquerda) < alturaPista(raiz->esquerda->direita)) {
+            raiz->esquerda = rotacionarEsquerda(raiz->esquerda);
+        }
+        return rotacionarDireita(raiz);
+    }
+    if (fator < -1) {
+        // Caso direita-esquerda: primeiro gira o filho direito
+        if (alturaPista(raiz->direita->direita) < alturaPista(raiz->direita->esquerda)) {
+            raiz->direita = rotacionarDireita(raiz->direita);
+        }
+        return rotacionarEsquerda(raiz);
+    }
+    
+    return raiz;
+}
+
+/**
+ * Função: buscarPista
+ * Propósito: Verificar se uma pista já está no caderno (busca iterativa na BST)
+ * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas
+ *             conteudo - id internado do conteúdo da pista
+ * Retorno: ponteiro para o nó encontrado ou NULL
+ */
+PistaNode* buscarPista(PistaNode* raiz, IdTexto conteudo) {
+    INSTRUMENTAR_SOMAR(buscasPista, 1);
+    while (raiz != NULL) {
+        int comparacao = compararTextosPorId(conteudo, raiz->conteudo);
+        INSTRUMENTAR_SOMAR(comparacoesBuscaPista, 1);
+        if (comparacao == 0) return raiz;
+        raiz = comparacao < 0 ? raiz->esquerda : raiz->direita;
+    }
+    return NULL;
+}
+
+/**
+ * Função: iniciarIteradorPistas
+ * Propósito: Preparar um iterador em ordem alfabética sobre o caderno de pistas
+ * Parâmetros: iterador - iterador a preparar
+ *             raiz - ponteiro para a raiz da árvore de pistas
+ * Retorno: void
+ */
+void iniciarIteradorPistas(IteradorPistas* iterador, PistaNode* raiz) {
+    iterador->pilha = iterador->pilhaLocal;
+    iterador->topo = 0;
+    iterador->capacidade = PILHA_LOCAL_ITERADOR;
+    iterador->proximo = raiz;
+    iterador->erro = 0;
+}
+
+/**
+ * Função: proximaPista
+ * Propósito: Avançar o iterador: desce pela esquerda empilhando ancestrais e devolve
+ * o menor ainda não visitado (custo amortizado O(1) por pista)
+ * Parâmetros: iterador - iterador preparado com iniciarIteradorPistas
+ * Retorno: próximo nó em ordem alfabética ou NULL ao final (ou se faltou memória para a
+ * pilha: nesse caso iterador->erro passa a 1 e a iteração não foi completa)
+ */
+PistaNode* proximaPista(IteradorPistas* iterador) {
+    while (iterador->proximo != NULL) {
+        if (iterador->topo == iterador->capacidade) {
+            size_t novaCapacidade = iterador->capacidade * 2;
+            PistaNode** pilha = iterador->pilha == iterador->pilhaLocal
+                              ? (PistaNode**)malloc(novaCapacidade * sizeof(PistaNode*))
+                              : (PistaNode**)realloc(iterador->pilha, novaCapacidade * sizeof(PistaNode*));
+            if (pilha == NULL) {
+                printf("Erro: Falha na alocação de memória para o iterador de pistas!\n");
+                iterador->erro = 1;
+                return NULL;
+            }
+            if (iterador->pilha == iterador->pilhaLocal) {
+                memcpy(pilha, iterador->pilhaLocal, sizeof(iterador->pilhaLocal));
+            }
+            iterador->pilha = pilha;
+            iterador->capacidade = novaCapacidade;
+        }
+        iterador->pilha[iterador->topo++] = iterador->proximo;
+        iterador->proximo = iterador->proximo->esquerda;
+    }
+    if (iterador->topo == 0) return NULL;
+    
+    PistaNode* atual = iterador->pilha[--iterador->topo];
+    iterador->proximo = atual->direita;
+    return atual;
+}
+
+/**
+ * Função: finalizarIteradorPistas
+ * Propósito: Liberar a pilha do iterador (se ela cresceu para o heap)
+ * Parâmetros: iterador - iterador a finalizar
+ * Retorno: void
+ */
+void finalizarIteradorPistas(IteradorPistas* iterador) {
+    if (iterador->pilha != iterador->pilhaLocal) free(iterador->pilha);
+    iterador->pilha = iterador->pilhaLocal;
+    iterador->topo = 0;
+    iterador->proximo = NULL;
+}
+
+/**
+ * Função: montarPistasBalanceadas
+ * Propósito: Ligar um vetor de nós em ordem alfabética como uma árvore perfeitamente
+ * balanceada (o elemento do meio vira a raiz), com as alturas AVL corretas
+ * Parâmetros: nos - vetor de nós em ordem
+ *             quantidade - número de nós
+ * Retorno: raiz da árvore montada (recursão com profundidade log n)
+ */
+static PistaNode* montarPistasBalanceadas(PistaNode** nos, size_t quantidade) {
+    if (quantidade == 0) return NULL;
+    
+    size_t meio = quantidade / 2;
+    PistaNode* raiz = nos[meio];
+    raiz->esquerda = montarPistasBalanceadas(nos, meio);
+    raiz->direita = montarPistasBalanceadas(nos + meio + 1, quantidade - meio - 1);
+    atualizarAlturaPista(raiz);
+    return raiz;
+}
+
+/**
+ * Função: inserirPistasEmLote
+ * Propósito: Inserir um lote de pistas de uma só vez (importação de um caderno salvo ou
+ * de uma grande carga de evidências): o lote é ordenado uma vez, as repetições são
+ * descartadas, e o resultado é mesclado com as pistas já existentes em uma árvore
+ * perfeitamente balanceada, em O(n) após a ordenação. Todos os nós novos são alocados
+ * antes da mescla, então uma falha não deixa a árvore pela metade
+ * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas (*raiz pode ser NULL)
+ *             pistas - vetor de ids internados das pistas (não é alterado)
+ *             quantidade - número de pistas no vetor
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória (*raiz e a árvore ficam intactas)
+ */
+int inserirPistasEmLote(PistaNode** raiz, const IdTexto* pistas, size_t quantidade) {
+    if (quantidade == 0) return 1;
+    
+    IdTexto* ordenadas = (IdTexto*)malloc(quantidade * sizeof(IdTexto));
+    size_t capacidadeExistentes = 64, numExistentes = 0;
+    PistaNode** existentes = (PistaNode**)malloc(capacidadeExistentes * sizeof(PistaNode*));
+    if (ordenadas == NULL || existentes == NULL) {
+        printf("Erro: Falha na alocação de memória para pista!\n");
+        free(ordenadas);
+        free(existentes);
+        return 0;
+    }
+    
+    // Ordena e descarta repetições do lote
+    memcpy(ordenadas, pistas, quantidade * sizeof(IdTexto));
+    qsort(ordenadas, quantidade, sizeof(IdTexto), compararIdsTexto);
+    size_t numNovas = 1;
+    for (size_t i = 1; i < quantidade; i++) {
+        if (ordenadas[i] != ordenadas[numNovas - 1]) ordenadas[numNovas++] = ordenadas[i];
+    }
+    
+    // Os nós atuais, já em ordem alfabética, são reaproveitados
+    IteradorPistas iterador;
+    int falhou = 0;
+    iniciarIteradorPistas(&iterador, *raiz);
+    for (PistaNode* no = proximaPista(&iterador); no != NULL; no = proximaPista(&iterador)) {
+        if (numExistentes == capacidadeExistentes) {
+            PistaNode** maior = (PistaNode**)realloc(existentes, capacidadeExistentes * 2 * sizeof(PistaNode*));
+            if (maior == NULL) {
+                printf("Erro: Falha na alocação de memória para pista!\n");
+                falhou = 1;
+                break;
+            }
+            existentes = maior;
+            capacidadeExistentes *= 2;
+        }
+        existentes[numExistentes++] = no;
+    }
+    finalizarIteradorPistas(&iterador);
+    falhou |= iterador.erro;
+    
+    // Um caderno lido só em parte não pode ser remontado: a árvore fica como estava
+    PistaNode** nos = falhou ? NULL : (PistaNode**)malloc((numExistentes + numNovas) * sizeof(PistaNode*));
+    if (nos == NULL) {
+        if (!falhou) printf("Erro: Falha na alocação de memória para pista!\n");
+        free(ordenadas);
+        free(existentes);
+        return 0;
+    }
+    
+    // Mantém só as pistas do lote que ainda não estão na árvore
+    size_t i = 0, numAusentes = 0;
+    for (size_t j = 0; j < numNovas; j++) {
+        while (i < numExistentes && compararTextosPorId(existentes[i]->conteudo, ordenadas[j]) < 0) i++;
+        if (i == numExistentes || existentes[i]->conteudo != ordenadas[j]) ordenadas[numAusentes++] = ordenadas[j];
+    }
+    
+    // Aloca os nós novos no fim do vetor; se um falhar, os anteriores são devolvidos
+    PistaNode** novos = nos + numExistentes;
+    for (size_t j = 0; j < numAusentes; j++) {
+        novos[j] = criarPistaNode(ordenadas[j]);
+        if (novos[j] == NULL) {
+            while (j > 0 && arenaAtual == NULL) liberarNo(novos[--j]);
+            free(ordenadas);
+            free(existentes);
+            free(nos);
+            return 0;
+        }
+    }
+    
+    // Mescla as duas sequências ordenadas; a escrita em nos[total] nunca passa à frente
+    // do próximo nó novo a ler (total = i + j <= numExistentes + j)
+    size_t j = 0, total = 0;
+    i = 0;
+    while (i < numExistentes || j < numAusentes) {
+        if (j == numAusentes || (i < numExistentes &&
+                                 compararTextosPorId(existentes[i]->conteudo, novos[j]->conteudo) < 0)) {
+            nos[total++] = existentes[i++];
+        } else {
+            nos[total++] = novos[j++];
+        }
+    }
+    
+    *raiz = montarPistasBalanceadas(nos, total);
+    free(ordenadas);
+    free(existentes);
+    free(nos);
+    return 1;
+}
+
+/**
+ * Função: exibirPistas
+ * Propósito: Exibir todas as pistas coletadas em ordem alfabética (um evento "caderno"
+ * por pista no modo de eventos)
+ * Parâmetros: saida - destino das mensagens
+ *             raiz - ponteiro para a raiz da árvore de pistas
+ *             contador - ponteiro para variável que conta as pistas exibidas
+ * Retorno: void
+ */
+void exibirPistas(SaidaJogo* saida, PistaNode* raiz, int* contador) {
+    IteradorPistas iterador;
+    iniciarIteradorPistas(&iterador, raiz);
+    
+    // Percorre em ordem (in-order) sem recursão
+    for (PistaNode* pista = proximaPista(&iterador); pista != NULL; pista = proximaPista(&iterador)) {
+        (*contador)++;
+        saidaFormatada(saida, "%d. %s\n", *contador, textoDoId(pista->conteudo));
+        abrirEvento(saida, "caderno");
+        campoNumeroEvento(saida, "posicao", *contador);
+        campoTextoEvento(saida, "pista", textoDoId(pista->conteudo));
+        fecharEvento(saida);
+    }
+    finalizarIteradorPistas(&iterador);
+}
+
+/**
+ * Função: contarPistasPorIdSuspeito
+ * Propósito: Contar as pistas da árvore que apontam para um suspeito já internado
+ * (cada nó custa uma busca na hash e uma comparação de inteiros). Usa o percurso de
+ * Morris: ligações temporárias ao sucessor substituem a pilha, sem memória extra e sem
+ * recursão; a árvore volta ao estado original ao final
+ * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas
+ *             tabela - ponteiro para a tabela hash
+ *             suspeito - id do nome do suspeito
+ * Retorno: número de pistas que apontam para o suspeito
+ */
+static int contarPistasPorIdSuspeito(PistaNode* raiz, TabelaHash* tabela, IdTexto suspeito) {
+    int count = 0;
+    PistaNode* atual = raiz;
+    
+    while (atual != NULL) {
+        if (atual->esquerda == NULL) {
+            count += encontrarSuspeitoPorId(tabela, atual->conteudo) == suspeito;
+            atual = atual->direita;
+            continue;
+        }
+        
+        // Predecessor em ordem: o nó mais à direita da subárvore esquerda
+        PistaNode* predecessor = atual->esquerda;
+        while (predecessor->direita != NULL && predecessor->direita != atual) {
+            predecessor = predecessor->direita;
+        }
+        
+        if (predecessor->direita == NULL) {
+            predecessor->direita = atual;  // Ligação temporária de volta ao nó atual
+            atual = atual->esquerda;
+        } else {
+            predecessor->direita = NULL;   // Subárvore esquerda concluída: desfaz a ligação
+            count += encontrarSuspeitoPorId(tabela, atual->conteudo) == suspeito;
+            atual = atual->direita;
+        }
+    }
+    
+    return count;
+}
+
+/**
+ * Função: contarPistasPorSuspeito
+ * Propósito: Contar quantas pistas apontam para um determinado suspeito
+ * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas
+ *             tabela - ponteiro para a tabela hash
+ *             suspeito - nome do suspeito a ser contado
+ * Retorno: número de pistas que apontam para o suspeito
+ */
+int contarPistasPorSuspeito(PistaNode* raiz, TabelaHash* tabela, const char* suspeito) {
+    // Um nome que nunca foi internado não pode estar associado a nenhuma pista
+    IdTexto id = buscarIdTexto(suspeito);
+    if (id == ID_TEXTO_INVALIDO) return 0;
+    
+    return contarPistasPorIdSuspeito(raiz, tabela, id);
+}
+
+/**
+ * Função: criarIndiceSuspeitos
+ * Propósito: Criar um índice de evidências por suspeito vazio
+ * Retorno: ponteiro para o índice criado
+ */
+IndiceSuspeitos* criarIndiceSuspeitos() {
+    IndiceSuspeitos* indice = (IndiceSuspeitos*)calloc(1, sizeof(IndiceSuspeitos));
+    if (indice == NULL) {
+        printf("Erro: Falha na alocação de memória para o indice de suspeitos!\n");
+        return NULL;
+    }
+    
+    indice->capacidadePosicoes = CAPACIDADE_INICIAL_HASH;
+    indice->posicoes = (int*)malloc(indice->capacidadePosicoes * sizeof(int));
+    if (indice->posicoes == NULL) {
+        printf("Erro: Falha na alocação de memória para o indice de suspeitos!\n");
+        free(indice);
+        return NULL;
+    }
+    memset(indice->posicoes, -1, indice->capacidadePosicoes * sizeof(int));
+    indice->lider = -1;
+    
+    return indice;
+}
+
+/**
+ * Função: localizarPosicaoSuspeito
+ * Propósito: Encontrar a posição do suspeito no endereçamento aberto do índice
+ * Parâmetros: indice - ponteiro para o índice
+ *             suspeito - id do nome do suspeito
+ * Retorno: posição que referencia a ficha do suspeito ou a posição livre onde ela entraria
+ */
+static int* localizarPosicaoSuspeito(IndiceSuspeitos* indice, IdTexto suspeito) {
+    size_t mascara = indice->capacidadePosicoes - 1;
+    size_t posicao = (size_t)hashDoTexto(suspeito) & mascara;
+    
+    while (indice->posicoes[posicao] >= 0 &&
+           indice->fichas[indice->posicoes[posicao]].suspeito != suspeito) {
+        posicao = (posicao + 1) & mascara;
+    }
+    return &indice->posicoes[posicao];
+}
+
+/**
+ * Função: buscarFichaSuspeitoPorId
+ * Propósito: Consultar em O(1) a ficha de evidências de um suspeito já internado
+ * Parâmetros: indice - ponteiro para o índice
+ *             suspeito - id do nome do suspeito
+ * Retorno: ponteiro para a ficha ou NULL se nenhuma pista coletada aponta para ele
+ */
+FichaSuspeito* buscarFichaSuspeitoPorId(IndiceSuspeitos* indice, IdTexto suspeito) {
+    if (indice == NULL || suspeito == ID_TEXTO_INVALIDO) return NULL;
+    
+    int posicao = *localizarPosicaoSuspeito(indice, suspeito);
+    return posicao >= 0 ? &indice->fichas[posicao] : NULL;
+}
+
+/**
+ * Função: buscarFichaSuspeito
+ * Propósito: Consultar em O(1) a ficha de evidências de um suspeito
+ * Parâmetros: indice - ponteiro para o índice
+ *             nome - nome do suspeito
+ * Retorno: ponteiro para a ficha ou NULL se nenhuma pista coletada aponta para ele
+ */
+FichaSuspeito* buscarFichaSuspeito(IndiceSuspeitos* indice, const char* nome) {
+    return buscarFichaSuspeitoPorId(indice, buscarIdTexto(nome));
+}
+
+/**
+ * Função: registrarPistaSuspeito
+ * Propósito: Atualizar o índice quando uma pista que aponta para um suspeito é coletada
+ * Parâmetros: indice - ponteiro para o índice
+ *             suspeito - id do nome do suspeito apontado pela pista
+ *             pista - id da pista coletada
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória (o índice fica como estava)
+ */
+int registrarPistaSuspeito(IndiceSuspeitos* indice, IdTexto suspeito, IdTexto pista) {
+    if (indice == NULL) return 0;
+    
+    int* posicao = localizarPosicaoSuspeito(indice, suspeito);
+    
+    if (*posicao < 0) {
+        // Primeiro indício contra este suspeito: cria a ficha
+        if (indice->quantidade == indice->capacidade) {
+            size_t novaCapacidade = indice->capacidade == 0 ? 8 : indice->capacidade * 2;
+            FichaSuspeito* novas = (FichaSuspeito*)realloc(indice->fichas, novaCapacidade * sizeof(FichaSuspeito));
+            if (novas == NULL) {
+                printf("Erro: Falha na alocação de memória para o indice de suspeitos!\n");
+                return 0;
+            }
+            indice->fichas = novas;
+            indice->capacidade = novaCapacidade;
+        }
+        
+        // Mantém a ocupação das posições abaixo de 1/2, dobrando antes de inserir
+        if ((indice->quantidade + 1) * 2 > indice->capacidadePosicoes) {
+            size_t novaCapacidade = indice->capacidadePosicoes * 2;
+            int* posicoes = (int*)malloc(novaCapacidade * sizeof(int));
+            if (posicoes == NULL) {
+                printf("Erro: Falha na alocação de memória para o indice de suspeitos!\n");
+                return 0;
+            }
+            memset(posicoes, -1, novaCapacidade * sizeof(int));
+            free(indice->posicoes);
+            indice->posicoes = posicoes;
+            indice->capacidadePosicoes = novaCapacidade;
+            for (size_t i = 0; i < indice->quantidade; i++) {
+                *localizarPosicaoSuspeito(indice, indice->fichas[i].suspeito) = (int)i;
+            }
+            posicao = localizarPosicaoSuspeito(indice, suspeito);
+        }
+        
+        // Fichas já usadas antes de limparIndiceSuspeitos mantêm o vetor de pistas
+        FichaSuspeito* ficha = &indice->fichas[indice->quantidade];
+        if (indice->quantidade == indice->reservadas) {
+            ficha->pistas = NULL;
+            ficha->capacidadePistas = 0;
+            indice->reservadas++;
+        }
+        ficha->suspeito = suspeito;
+        ficha->contagem = 0;
+        *posicao = (int)indice->quantidade++;
+    }
+    
+    FichaSuspeito* ficha = &indice->fichas[*posicao];
+    if (ficha->contagem == ficha->capacidadePistas) {
+        int novaCapacidade = ficha->capacidadePistas == 0 ? 4 : ficha->capacidadePistas * 2;
+        IdTexto* novas = (IdTexto*)realloc(ficha->pistas, novaCapacidade * sizeof(IdTexto));
+        if (novas == NULL) {
+            printf("Erro: Falha na alocação de memória para o indice de suspeitos!\n");
+            if (ficha->contagem == 0) {
+                // Desfaz a ficha recém-criada (a posição estava livre antes dela)
+                indice->quantidade--;
+                *posicao = -1;
+            }
+            return 0;
+        }
+        ficha->pistas = novas;
+        ficha->capacidadePistas = novaCapacidade;
+    }
+    ficha->pistas[ficha->contagem++] = pista;
+    
+    // Só a ficha que cresceu pode tomar a liderança: o ranking 1º lugar fica em O(1)
+    const FichaSuspeito* lider = indice->lider >= 0 ? &indice->fichas[indice->lider] : NULL;
+    if (lider == NULL || ficha->contagem > lider->contagem ||
+        (ficha->contagem == lider->contagem && compararTextosPorId(ficha->suspeito, lider->suspeito) < 0)) {
+        indice->lider = *posicao;
+    }
+    return 1;
+}
+
+/**
+ * Função: liderSuspeitos
+ * Propósito: Consultar o suspeito com mais evidências (o primeiro do ranking)
+ * Parâmetros: indice - ponteiro para o índice
+ * Retorno: ficha do líder ou NULL se nenhuma pista aponta para um suspeito
+ */
+const FichaSuspeito* liderSuspeitos(const IndiceSuspeitos* indice) {
+    if (indice == NULL || indice->lider < 0) return NULL;
+    return &indice->fichas[indice->lider];
+}
+
+/**
+ * Função: compararFichasPorEvidencia
+ * Propósito: Comparador de qsort para o ranking (mais pistas primeiro, empate por nome)
+ */
+static int compararFichasPorEvidencia(const void* a, const void* b) {
+    const FichaSuspeito* fichaA = *(const FichaSuspeito* const*)a;
+    const FichaSuspeito* fichaB = *(const FichaSuspeito* const*)b;
+    if (fichaA->contagem != fichaB->contagem) {
+        return fichaB->contagem - fichaA->contagem;
+    }
+    return compararTextosPorId(fichaA->suspeito, fichaB->suspeito);
+}
+
+/**
+ * Função: exibirRankingSuspeitos
+ * Propósito: Exibir todos os suspeitos com pistas coletadas, ordenados pela quantidade
+ * de evidências (usa apenas o índice, sem percorrer a árvore de pistas)
+ * Parâmetros: saida - destino das mensagens
+ *             indice - ponteiro para o índice
+ * Retorno: void
+ */
+void exibirRankingSuspeitos(SaidaJogo* saida, IndiceSuspeitos* indice) {
+    if (saida->modo == SAIDA_NENHUMA || indice == NULL || indice->quantidade == 0) return;
+    
+    const FichaSuspeito** ranking = (const FichaSuspeito**)malloc(indice->quantidade * sizeof(FichaSuspeito*));
+    if (ranking == NULL) return;
+    for (size_t i = 0; i < indice->quantidade; i++) {
+        ranking[i] = &indice->fichas[i];
+    }
+    qsort(ranking, indice->quantidade, sizeof(FichaSuspeito*), compararFichasPorEvidencia);
+    
+    saidaTexto(saida, "\nRanking de suspeitos por evidencias:\n");
+    for (size_t i = 0; i < indice->quantidade; i++) {
+        saidaFormatada(saida, "%zu. %s - %d pista(s)\n", i + 1, textoDoId(ranking[i]->suspeito), ranking[i]->contagem);
+        abrirEvento(saida, "ranking");
+        campoNumeroEvento(saida, "posicao", (long long)(i + 1));
+        campoTextoEvento(saida, "suspeito", textoDoId(ranking[i]->suspeito));
+        campoNumeroEvento(saida, "pistas", ranking[i]->contagem);
+        fecharEvento(saida);
+    }
+    free(ranking);
+}
+
+/**
+ * Função: limparIndiceSuspeitos
+ * Propósito: Esvaziar o índice para uma nova sessão, mantendo a memória já alocada
+ * Parâmetros: indice - ponteiro para o índice
+ * Retorno: void
+ */
+void limparIndiceSuspeitos(IndiceSuspeitos* indice) {
+    if (indice == NULL || indice->quantidade == 0) return;
+    
+    indice->quantidade = 0;
+    indice->lider = -1;
+    memset(indice->posicoes, -1, indice->capacidadePosicoes * sizeof(int));
+}
+
+/**
+ * Função: liberarIndiceSuspeitos
+ * Propósito: Liberar toda a memória do índice de evidências
+ * Parâmetros: indice - ponteiro para o índice
+ * Retorno: void
+ */
+void liberarIndiceSuspeitos(IndiceSuspeitos* indice) {
+    if (indice == NULL) return;
+    
+    for (size_t i = 0; i < indice->reservadas; i++) {
+        free(indice->fichas[i].pistas);
+    }
+    free(indice->fichas);
+    free(indice->posicoes);
+    free(indice);
+}
+
+/**
+ * Função: contarBits64
+ * Propósito: Contar os bits ligados de uma palavra de 64 bits
+ * Parâmetros: x - palavra
+ * Retorno: número de bits ligados
+ */
+static uint64_t contarBits64(uint64_t x) {
+#ifdef __GNUC__
+    return (uint64_t)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (x * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+/**
+ * Função: contarInterseccaoPortatil
+ * Propósito: Contar os bits ligados em (a AND b), palavra a palavra
+ * Parâmetros: a, b - conjuntos de bits
+ *             palavras - palavras de 64 bits em cada conjunto
+ * Retorno: tamanho da interseção
+ */
+static uint64_t contarInterseccaoPortatil(const uint64_t* a, const uint64_t* b, size_t palavras) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < palavras; i++) {
+        total += contarBits64(a[i] & b[i]);
+    }
+    return total;
+}
+
+#ifdef DQ_SIMD_X86
+/**
+ * Função: contarInterseccaoAvx2
+ * Propósito: Contar os bits ligados em (a AND b) com AVX2, 256 bits por vez: cada nibble é
+ * contado por consulta a uma tabela de 16 entradas (vpshufb) e os bytes são somados com vpsadbw
+ * Parâmetros: a, b - conjuntos de bits
+ *             palavras - palavras de 64 bits em cada conjunto
+ * Retorno: tamanho da interseção
+ */
+__attribute__((target("avx2")))
+static uint64_t contarInterseccaoAvx2(const uint64_t* a, const uint64_t* b, size_t palavras) {
+    const __m256i tabela = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    __m256i acumulado = _mm256_setzero_si256();
+    size_t i = 0;
+    
+    for (; i + 4 <= palavras; i += 4) {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a + i)),
+                                     _mm256_loadu_si256((const __m256i*)(b + i)));
+        __m256i baixos = _mm256_shuffle_epi8(tabela, _mm256_and_si256(v, nibble));
+        __m256i altos = _mm256_shuffle_epi8(tabela, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        acumulado = _mm256_add_epi64(acumulado, _mm256_sad_epu8(_mm256_add_epi8(baixos, altos), _mm256_setzero_si256()));
+    }
+    
+    uint64_t total = (uint64_t)_mm256_extract_epi64(acumulado, 0) + (uint64_t)_mm256_extract_epi64(acumulado, 1) +
+                     (uint64_t)_mm256_extract_epi64(acumulado, 2) + (uint64_t)_mm256_extract_epi64(acumulado, 3);
+    for (; i < palavras; i++) {
+        total += contarBits64(a[i] & b[i]);
+    }
+    return total;
+}
+#endif
+
+/**
+ * Função: contarInterseccao
+ * Propósito: Contar os bits ligados em (a AND b) com a melhor versão disponível no
+ * processador (AVX2 ou portátil), escolhida na primeira chamada
+ * Parâmetros: a, b - conjuntos de bits
+ *             palavras - palavras de 64 bits em cada conjunto
+ * Retorno: tamanho da interseção
+ */
+static uint64_t contarInterseccao(const uint64_t* a, const uint64_t* b, size_t palavras) {
+#ifdef DQ_SIMD_X86
+    static int temAvx2 = -1;  // Corrida benigna: todas as threads chegam ao mesmo valor
+    if (temAvx2 < 0) temAvx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+    if (temAvx2) return contarInterseccaoAvx2(a, b, palavras);
+#endif
+    return contarInterseccaoPortatil(a, b, palavras);
+}
+
+/**
+ * Função: liberarCatalogoPistas
+ * Propósito: Liberar um catálogo de pistas
+ * Parâmetros: catalogo - ponteiro para o catálogo
+ * Retorno: void
+ */
+void liberarCatalogoPistas(CatalogoPistas* catalogo) {
+    if (catalogo == NULL) return;
+    free(catalogo->idPista);
+    free(catalogo->bitDaPista);
+    free(catalogo->idSuspeito);
+    free(catalogo->indiceDoSuspeito);
+    free(catalogo->mascaras);
+    free(catalogo);
+}
+
+/**
+ * Função: criarCatalogoPistas
+ * Propósito: Montar o catálogo fixo de pistas a partir das associações da tabela hash:
+ * um bit por pista (ordem alfabética) e uma máscara de bits por suspeito
+ * Parâmetros: tabela - tabela hash de suspeitos (já preenchida)
+ * Retorno: ponteiro para o catálogo ou NULL em caso de erro
+ */
+CatalogoPistas* criarCatalogoPistas(TabelaHash* tabela) {
+    CatalogoPistas* catalogo = (CatalogoPistas*)calloc(1, sizeof(CatalogoPistas));
+    if (catalogo == NULL || tabela == NULL) {
+        free(catalogo);
+        return NULL;
+    }
+    
+    // associacaoNaPosicao entrega cada pista uma vez: um bit por pista
+    size_t total = totalAssociacoes(tabela);
+    catalogo->numTextos = textosInternados.quantidade;
+    catalogo->idPista = (IdTexto*)malloc((total + 1) * sizeof(IdTexto));
+    catalogo->bitDaPista = (uint32_t*)malloc(catalogo->numTextos * sizeof(uint32_t));
+    catalogo->idSuspeito = (IdTexto*)malloc((total + 1) * sizeof(IdTexto));
+    catalogo->indiceDoSuspeito = (uint32_t*)malloc(catalogo->numTextos * sizeof(uint32_t));
+    if (catalogo->idPista == NULL || catalogo->bitDaPista == NULL || catalogo->idSuspeito == NULL ||
+        catalogo->indiceDoSuspeito == NULL) {
+        printf("Erro: Falha na alocação de memória para o catalogo de pistas!\n");
+        liberarCatalogoPistas(catalogo);
+        return NULL;
+    }
+    for (size_t t = 0; t < catalogo->numTextos; t++) {
+        catalogo->bitDaPista[t] = INDICE_NENHUM;
+        catalogo->indiceDoSuspeito[t] = INDICE_NENHUM;
+    }
+    
+    // Pistas (em ordem alfabética) e suspeitos (na ordem da tabela)
+    HashNode no;
+    for (size_t i = 0; i < posicoesDaTabela(tabela); i++) {
+        if (!associacaoNaPosicao(tabela, i, &no)) continue;
+        catalogo->idPista[catalogo->numPistas++] = no.pista;
+        if (catalogo->indiceDoSuspeito[no.suspeito] == INDICE_NENHUM) {
+            catalogo->indiceDoSuspeito[no.suspeito] = (uint32_t)catalogo->numSuspeitos;
+            catalogo->idSuspeito[catalogo->numSuspeitos++] = no.suspeito;
+        }
+    }
+    qsort(catalogo->idPista, catalogo->numPistas, sizeof(IdTexto), compararIdsTexto);
+    
+    catalogo->palavras = (catalogo->numPistas + 63) / 64;
+    catalogo->mascaras = (uint64_t*)calloc(catalogo->numSuspeitos * catalogo->palavras + 1, sizeof(uint64_t));
+    if (catalogo->mascaras == NULL) {
+        printf("Erro: Falha na alocação de memória para o catalogo de pistas!\n");
+        liberarCatalogoPistas(catalogo);
+        return NULL;
+    }
+    for (size_t b = 0; b < catalogo->numPistas; b++) {
+        IdTexto pista = catalogo->idPista[b];
+        uint32_t suspeito = catalogo->indiceDoSuspeito[encontrarSuspeitoPorId(tabela, pista)];
+        catalogo->bitDaPista[pista] = (uint32_t)b;
+        catalogo->mascaras[suspeito * catalogo->palavras + b / 64] |= (uint64_t)1 << (b % 64);
+    }
+    return catalogo;
+}
+
+/**
+ * Função: criarCadernoBits
+ * Propósito: Criar um caderno de bits vazio para um catálogo
+ * Parâmetros: catalogo - ponteiro para o catálogo
+ * Retorno: ponteiro para o caderno ou NULL em caso de erro
+ */
+CadernoBits* criarCadernoBits(const CatalogoPistas* catalogo) {
+    CadernoBits* caderno = (CadernoBits*)malloc(sizeof(CadernoBits));
+    if (caderno == NULL) {
+        printf("Erro: Falha na alocação de memória para o caderno!\n");
+        return NULL;
+    }
+    caderno->bits = (uint64_t*)calloc(catalogo->palavras + 1, sizeof(uint64_t));
+    if (caderno->bits == NULL) {
+        printf("Erro: Falha na alocação de memória para o caderno!\n");
+        free(caderno);
+        return NULL;
+    }
+    caderno->quantidade = 0;
+    return caderno;
+}
+
+/**
+ * Função: limparCadernoBits
+ * Propósito: Esvaziar um caderno de bits (reaproveitado entre sessões)
+ * Parâmetros: catalogo - ponteiro para o catálogo
+ *             caderno - ponteiro para o caderno
+ * Retorno: void
+ */
+void limparCadernoBits(const CatalogoPistas* catalogo, CadernoBits* caderno) {
+    memset(caderno->bits, 0, catalogo->palavras * sizeof(uint64_t));
+    caderno->quantidade = 0;
+}
+
+/**
+ * Função: liberarCadernoBits
+ * Propósito: Liberar um caderno de bits
+ * Parâmetros: caderno - ponteiro para o caderno
+ * Retorno: void
+ */
+void liberarCadernoBits(CadernoBits* caderno) {
+    if (caderno == NULL) return;
+    free(caderno->bits);
+    free(caderno);
+}
+
+/**
+ * Função: marcarPistaBits
+ * Propósito: Registrar uma pista coletada no caderno de bits
+ * Parâmetros: catalogo - ponteiro para o catálogo
+ *             caderno - ponteiro para o caderno
+ *             pista - id da pista
+ * Retorno: 1 se a pista é nova no caderno, 0 se já estava ou não pertence ao catálogo
+ */
+int marcarPistaBits(const CatalogoPistas* catalogo, CadernoBits* caderno, IdTexto pista) {
+    if (pista >= catalogo->numTextos || catalogo->bitDaPista[pista] == INDICE_NENHUM) return 0;
+    
+    uint32_t bit = catalogo->bitDaPista[pista];
+    uint64_t mascara = (uint64_t)1 << (bit % 64);
+    if (caderno->bits[bit / 64] & mascara) return 0;
+    caderno->bits[bit / 64] |= mascara;
+    caderno->quantidade++;
+    return 1;
+}
+
+/**
+ * Função: contarPistasPorSuspeitoBits
+ * Propósito: Versão de contarPistasPorSuspeito para o caderno de bits: interseção do
+ * caderno com a máscara do suspeito (AND + contagem de bits)
+ * Parâmetros: catalogo - ponteiro para o catálogo
+ *             caderno - ponteiro para o caderno
+ *             suspeito - id do nome do suspeito
+ * Retorno: número de pistas coletadas que apontam para o suspeito
+ */
+int contarPistasPorSuspeitoBits(const CatalogoPistas* catalogo, const CadernoBits* caderno, IdTexto suspeito) {
+    if (suspeito >= catalogo->numTextos || catalogo->indiceDoSuspeito[suspeito] == INDICE_NENHUM) return 0;
+    
+    const uint64_t* mascara = catalogo->mascaras + catalogo->indiceDoSuspeito[suspeito] * catalogo->palavras;
+    return (int)contarInterseccao(caderno->bits, mascara, catalogo->palavras);
+}
+
+/**
+ * Função: pontuarSuspeitosBits
+ * Propósito: Contar as pistas de todos os suspeitos em uma única passada pelo caderno: a
+ * cada bloco de PALAVRAS_POR_BLOCO_PONTUACAO palavras (que fica na cache), todas as
+ * máscaras são aplicadas antes de avançar
+ * Parâmetros: catalogo - ponteiro para o catálogo
+ *             caderno - ponteiro para o caderno
+ *             contagens - saída: pistas por suspeito compacto (numSuspeitos posições)
+ * Retorno: void
+ */
+void pontuarSuspeitosBits(const CatalogoPistas* catalogo, const CadernoBits* caderno, uint32_t* contagens) {
+    memset(contagens, 0, catalogo->numSuspeitos * sizeof(uint32_t));
+    
+    for (size_t inicio = 0; inicio < catalogo->palavras; inicio += PALAVRAS_POR_BLOCO_PONTUACAO) {
+        size_t palavras = catalogo->palavras - inicio;
+        if (palavras > PALAVRAS_POR_BLOCO_PONTUACAO) palavras = PALAVRAS_POR_BLOCO_PONTUACAO;
+        
+        const uint64_t* bloco = caderno->bits + inicio;
+        for (size_t s = 0; s < catalogo->numSuspeitos; s++) {
+            contagens[s] += (uint32_t)contarInterseccao(bloco, catalogo->mascaras + s * catalogo->palavras + inicio, palavras);
+        }
+    }
+}
+
+/**
+ * Função: criarNoTexto
+ * Propósito: Criar um nó da árvore radix com uma cópia do trecho da aresta
+ * Parâmetros: rotulo - início do trecho da aresta
+ *             tamanhoRotulo - tamanho do trecho
+ *             valor - texto que termina no nó (ou ID_TEXTO_INVALIDO)
+ * Retorno: ponteiro para o nó ou NULL em caso de erro
+ */
+static NoTexto* criarNoTexto(const char* rotulo, uint32_t tamanhoRotulo, IdTexto valor) {
+    NoTexto* no = (NoTexto*)malloc(sizeof(NoTexto) + tamanhoRotulo);
+    if (no == NULL) {
+        printf("Erro: Falha na alocação de memória para o indice de textos!\n");
+        return NULL;
+    }
+    no->valor = valor;
+    no->tamanhoRotulo = tamanhoRotulo;
+    no->numFilhos = 0;
+    no->capacidadeFilhos = 0;
+    no->filhos = NULL;
+    no->primeiros = NULL;
+    memcpy(no->rotulo, rotulo, tamanhoRotulo);
+    return no;
+}
+
+/**
+ * Função: localizarFilhoTexto
+ * Propósito: Busca binária do filho cujo rótulo começa por um byte
+ * Parâmetros: no - nó pai
+ *             byte - primeiro byte procurado
+ * Retorno: posição do filho, ou posição de inserção se ele não existe
+ */
+static uint32_t localizarFilhoTexto(const NoTexto* no, unsigned char byte) {
+    uint32_t inicio = 0, fim = no->numFilhos;
+    while (inicio < fim) {
+        uint32_t meio = (inicio + fim) / 2;
+        if (no->primeiros[meio] < byte) {
+            inicio = meio + 1;
+        } else {
+            fim = meio;
+        }
+    }
+    return inicio;
+}
+
+/**
+ * Função: filhoTexto
+ * Propósito: Obter o filho cujo rótulo começa por um byte
+ * Parâmetros: no - nó pai
+ *             byte - primeiro byte procurado
+ * Retorno: ponteiro para o filho ou NULL se não existe
+ */
+static NoTexto* filhoTexto(const NoTexto* no, unsigned char byte) {
+    uint32_t posicao = localizarFilhoTexto(no, byte);
+    return posicao < no->numFilhos && no->primeiros[posicao] == byte ? no->filhos[posicao] : NULL;
+}
+
+/**
+ * Função: inserirFilhoTexto
+ * Propósito: Inserir um filho na posição ordenada (filhos e primeiros bytes crescem juntos,
+ * em um único bloco)
+ * Parâmetros: no - nó pai
+ *             posicao - posição de inserção
+ *             filho - novo filho
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória
+ */
+static int inserirFilhoTexto(NoTexto* no, uint32_t posicao, NoTexto* filho) {
+    if (no->numFilhos == no->capacidadeFilhos) {
+        uint32_t capacidade = no->capacidadeFilhos != 0 ? no->capacidadeFilhos * 2 : 2;
+        NoTexto** filhos = (NoTexto**)malloc(capacidade * (sizeof(NoTexto*) + 1));
+        if (filhos == NULL) {
+            printf("Erro: Falha na alocação de memória para o indice de textos!\n");
+            return 0;
+        }
+        unsigned char* primeiros = (unsigned char*)(filhos + capacidade);
+        if (no->numFilhos > 0) {
+            memcpy(filhos, no->filhos, no->numFilhos * sizeof(NoTexto*));
+            memcpy(primeiros, no->primeiros, no->numFilhos);
+        }
+        free(no->filhos);
+        no->filhos = filhos;
+        no->primeiros = primeiros;
+        no->capacidadeFilhos = capacidade;
+    }
+    memmove(&no->filhos[posicao + 1], &no->filhos[posicao], (no->numFilhos - posicao) * sizeof(NoTexto*));
+    memmove(&no->primeiros[posicao + 1], &no->primeiros[posicao], no->numFilhos - posicao);
+    no->filhos[posicao] = filho;
+    no->primeiros[posicao] = (unsigned char)filho->rotulo[0];
+    no->numFilhos++;
+    return 1;
+}
+
+/**
+ * Função: criarIndiceTextos
+ * Propósito: Criar um índice de textos vazio
+ * Retorno: ponteiro para o índice ou NULL em caso de erro
+ */
+IndiceTextos* criarIndiceTextos(void) {
+    IndiceTextos* indice = (IndiceTextos*)malloc(sizeof(IndiceTextos));
+    if (indice == NULL) {
+        printf("Erro: Falha na alocação de memória para o indice de textos!\n");
+        return NULL;
+    }
+    indice->raiz = criarNoTexto("", 0, ID_TEXTO_INVALIDO);
+    if (indice->raiz == NULL) {
+        free(indice);
+        return NULL;
+    }
+    indice->quantidade = 0;
+    indice->numNos = 1;
+    return indice;
+}
+
+/**
+ * Função: inserirNoIndiceTextos
+ * Propósito: Indexar um texto internado; uma aresta que diverge no meio é dividida em duas
+ * Parâmetros: indice - ponteiro para o índice
+ *             id - id do texto
+ * Retorno: 1 se o texto foi inserido, 0 se já estava no índice ou faltou memória
+ */
+int inserirNoIndiceTextos(IndiceTextos* indice, IdTexto id) {
+    const char* texto = textoDoId(id);
+    NoTexto* no = indice->raiz;
+    
+    for (;;) {
+        if (*texto == '\0') {
+            if (no->valor != ID_TEXTO_INVALIDO) return 0;
+            no->valor = id;
+            indice->quantidade++;
+            return 1;
+        }
+        
+        uint32_t posicao = localizarFilhoTexto(no, (unsigned char)*texto);
+        if (posicao == no->numFilhos || no->primeiros[posicao] != (unsigned char)*texto) {
+            // Nenhuma aresta começa por este byte: o restante do texto vira uma folha
+            NoTexto* folha = criarNoTexto(texto, (uint32_t)strlen(texto), id);
+            if (folha == NULL) return 0;
+            if (!inserirFilhoTexto(no, posicao, folha)) {
+                free(folha);
+                return 0;
+            }
+            indice->numNos++;
+            indice->quantidade++;
+            return 1;
+        }
+        
+        NoTexto* filho = no->filhos[posicao];
+        uint32_t comum = 1;
+        while (comum < filho->tamanhoRotulo && texto[comum] == filho->rotulo[comum]) comum++;
+        
+        if (comum < filho->tamanhoRotulo) {
+            // O texto diverge no meio da aresta: um nó intermediário assume o trecho comum
+            NoTexto* meio = criarNoTexto(filho->rotulo, comum, ID_TEXTO_INVALIDO);
+            if (meio == NULL) return 0;
+            memmove(filho->rotulo, filho->rotulo + comum, filho->tamanhoRotulo - comum);
+            filho->tamanhoRotulo -= comum;
+            if (!inserirFilhoTexto(meio, 0, filho)) {
+                // Desfaz o corte do rótulo (o bloco do filho continua grande o bastante)
+                memmove(filho->rotulo + comum, filho->rotulo, filho->tamanhoRotulo);
+                memcpy(filho->rotulo, meio->rotulo, comum);
+                filho->tamanhoRotulo += comum;
+                free(meio);
+                return 0;
+            }
+            no->filhos[posicao] = meio;
+            indice->numNos++;
+            filho = meio;
+        }
+        no = filho;
+        texto += comum;
+    }
+}
+
+/**
+ * Função: buscarNoIndiceTextos
+ * Propósito: Verificar se um texto está no índice (comparação exata)
+ * Parâmetros: indice - ponteiro para o índice
+ *             texto - texto procurado
+ * Retorno: id do texto ou ID_TEXTO_INVALIDO se não encontrado
+ */
+IdTexto buscarNoIndiceTextos(const IndiceTextos* indice, const char* texto) {
+    const NoTexto* no = indice->raiz;
+    while (*texto != '\0') {
+        no = filhoTexto(no, (unsigned char)*texto);
+        if (no == NULL || strncmp(texto, no->rotulo, no->tamanhoRotulo) != 0) return ID_TEXTO_INVALIDO;
+        texto += no->tamanhoRotulo;
+    }
+    return no->valor;
+}
+
+/**
+ * Função: empilharNoTexto
+ * Propósito: Empilhar um nó na pilha de percurso do índice (começa nos vetores locais do
+ * chamador e passa para o heap quando eles enchem)
+ * Parâmetros: pilha - ponteiro para o vetor de nós
+ *             profundidades - ponteiro para o vetor de profundidades
+ *             topo - ponteiro para o topo
+ *             capacidade - ponteiro para a capacidade
+ *             local - vetor local de nós do chamador
+ *             no - nó a empilhar
+ *             profundidade - bytes consumidos até o início do rótulo do nó
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória
+ */
+static int empilharNoTexto(NoTexto*** pilha, uint32_t** profundidades, size_t* topo, size_t* capacidade,
+                           NoTexto** local, NoTexto* no, uint32_t profundidade) {
+    if (*topo == *capacidade) {
+        size_t novaCapacidade = *capacidade * 2;
+        NoTexto** maior = (NoTexto**)malloc(novaCapacidade * sizeof(NoTexto*));
+        uint32_t* maisProfundidades = (uint32_t*)malloc(novaCapacidade * sizeof(uint32_t));
+        if (maior == NULL || maisProfundidades == NULL) {
+            free(maior);
+            free(maisProfundidades);
+            return 0;
+        }
+        memcpy(maior, *pilha, *topo * sizeof(NoTexto*));
+        memcpy(maisProfundidades, *profundidades, *topo * sizeof(uint32_t));
+        if (*pilha != local) {
+            free(*pilha);
+            free(*profundidades);
+        }
+        *pilha = maior;
+        *profundidades = maisProfundidades;
+        *capacidade = novaCapacidade;
+    }
+    (*pilha)[*topo] = no;
+    (*profundidades)[(*topo)++] = profundidade;
+    return 1;
+}
+
+/**
+ * Função: listarPorPrefixo
+ * Propósito: Enumerar, em ordem alfabética (de bytes), os textos que começam por um prefixo
+ * Parâmetros: indice - ponteiro para o índice
+ *             prefixo - prefixo procurado ("" lista tudo)
+ *             saida - vetor de saída para os ids
+ *             maximo - capacidade de saida (a busca para ao preenchê-la)
+ * Retorno: quantidade de ids gravados em saida
+ */
+size_t listarPorPrefixo(const IndiceTextos* indice, const char* prefixo, IdTexto* saida, size_t maximo) {
+    NoTexto* no = indice->raiz;
+    
+    // Desce pelo prefixo; ele pode terminar no meio de uma aresta
+    while (*prefixo != '\0') {
+        no = filhoTexto(no, (unsigned char)*prefixo);
+        if (no == NULL) return 0;
+        uint32_t i = 0;
+        while (i < no->tamanhoRotulo && prefixo[i] != '\0') {
+            if (prefixo[i] != no->rotulo[i]) return 0;
+            i++;
+        }
+        prefixo += i;
+    }
+    
+    // Percurso em pré-ordem da subárvore; filhos empilhados do maior para o menor
+    NoTexto* local[PILHA_LOCAL_INDICE_TEXTOS];
+    uint32_t profundidadesLocais[PILHA_LOCAL_INDICE_TEXTOS];
+    NoTexto** pilha = local;
+    uint32_t* profundidades = profundidadesLocais;
+    size_t topo = 0, capacidade = PILHA_LOCAL_INDICE_TEXTOS, encontrados = 0;
+    
+    empilharNoTexto(&pilha, &profundidades, &topo, &capacidade, local, no, 0);
+    while (topo > 0 && encontrados < maximo) {
+        NoTexto* atual = pilha[--topo];
+        if (atual->valor != ID_TEXTO_INVALIDO) saida[encontrados++] = atual->valor;
+        for (uint32_t f = atual->numFilhos; f > 0; f--) {
+            if (!empilharNoTexto(&pilha, &profundidades, &topo, &capacidade, local, atual->filhos[f - 1], 0)) {
+                topo = 0;
+                break;
+            }
+        }
+    }
+    
+    if (pilha != local) {
+        free(pilha);
+        free(profundidades);
+    }
+    return encontrados;
+}
+
+/**
+ * Função: linhaDistanciaTexto
+ * Propósito: Calcular a faixa de uma linha da matriz de edição de buscarTextoAproximado: só
+ * as células a até distanciaMaxima da diagonal (fora delas a distância já passa do limite),
+ * e as vizinhas da faixa recebem o limite
+ * Parâmetros: consulta - texto digitado
+ *             m - tamanho da consulta
+ *             distanciaMaxima - maior distância aceita
+ *             anterior - linha da profundidade anterior
+ *             linha - linha a preencher
+ *             profundidade - profundidade da nova linha (bytes do índice consumidos)
+ *             byte - byte do índice consumido
+ * Retorno: menor valor da linha (distanciaMaxima + 1 se a faixa inteira passou do limite)
+ */
+static uint32_t linhaDistanciaTexto(const char* consulta, size_t m, uint32_t distanciaMaxima,
+                                    const uint32_t* anterior, uint32_t* linha, size_t profundidade, char byte) {
+    uint32_t limite = distanciaMaxima + 1;
+    size_t inicio = profundidade > distanciaMaxima ? profundidade - distanciaMaxima : 1;
+    size_t fim = profundidade + distanciaMaxima < m ? profundidade + distanciaMaxima : m;
+    linha[0] = profundidade < limite ? (uint32_t)profundidade : limite;
+    if (inicio > 1) linha[inicio - 1] = limite;
+    uint32_t menor = linha[0];
+    for (size_t j = inicio; j <= fim; j++) {
+        uint32_t custo = anterior[j - 1] + (consulta[j - 1] != byte);
+        if (anterior[j] + 1 < custo) custo = anterior[j] + 1;
+        if (linha[j - 1] + 1 < custo) custo = linha[j - 1] + 1;
+        if (custo > limite) custo = limite;
+        linha[j] = custo;
+        if (custo < menor) menor = custo;
+    }
+    linha[fim + 1] = limite;
+    return menor;
+}
+
+/**
+ * Função: buscarTextoAteDistancia
+ * Propósito: Percorrer a árvore uma vez, em ordem alfabética, com uma linha da matriz de
+ * edição por byte de profundidade, até o primeiro texto a no máximo distanciaMaxima da
+ * consulta. Um filho só é visitado se a linha do seu primeiro byte (calculada a partir do
+ * vetor de primeiros bytes do pai, sem tocar no filho) ainda cabe no limite; o teste é pulado
+ * enquanto a linha do pai tem folga
+ * Parâmetros: indice - ponteiro para o índice
+ *             consulta - texto digitado
+ *             m - tamanho da consulta
+ *             distanciaMaxima - maior distância aceita
+ *             matriz - (m + distanciaMaxima + 1) linhas de m + 2 colunas
+ *             rascunho - linha avulsa de m + 2 colunas para testar os filhos
+ * Retorno: id do primeiro texto dentro do limite ou ID_TEXTO_INVALIDO se nenhum
+ */
+static IdTexto buscarTextoAteDistancia(const IndiceTextos* indice, const char* consulta, size_t m,
+                                       uint32_t distanciaMaxima, uint32_t* matriz, uint32_t* rascunho) {
+    size_t linhas = m + distanciaMaxima + 1;  // Textos mais longos que isso já passam do limite
+    size_t colunas = m + 2;                   // Uma coluna extra de sentinela à direita
+    uint32_t limite = distanciaMaxima + 1;    // Qualquer valor acima do limite é guardado como limite
+    for (size_t j = 0; j <= m; j++) matriz[j] = j < limite ? (uint32_t)j : limite;
+    matriz[m + 1] = limite;
+    
+    NoTexto* local[PILHA_LOCAL_INDICE_TEXTOS];
+    uint32_t profundidadesLocais[PILHA_LOCAL_INDICE_TEXTOS];
+    NoTexto** pilha = local;
+    uint32_t* profundidades = profundidadesLocais;
+    size_t topo = 0, capacidade = PILHA_LOCAL_INDICE_TEXTOS;
+    IdTexto encontrado = ID_TEXTO_INVALIDO;
+    
+    // A linha de profundidade d só é reescrita por nós mais fundos que o seu dono: quando um
+    // irmão é desempilhado, a linha do pai continua válida
+    empilharNoTexto(&pilha, &profundidades, &topo, &capacidade, local, indice->raiz, 0);
+    while (topo > 0) {
+        NoTexto* no = pilha[--topo];
+        size_t profundidade = profundidades[topo];
+        uint32_t menorDaLinha = 0;
+        
+        for (uint32_t c = 0; c < no->tamanhoRotulo; c++) {
+            if (profundidade + 1 >= linhas) {
+                menorDaLinha = limite;
+                break;
+            }
+            uint32_t* anterior = matriz + profundidade * colunas;
+            profundidade++;
+            menorDaLinha = linhaDistanciaTexto(consulta, m, distanciaMaxima, anterior, anterior + colunas,
+                                               profundidade, no->rotulo[c]);
+            if (menorDaLinha >= limite) break;
+        }
+        if (menorDaLinha >= limite) continue;
+        
+        const uint32_t* linha = matriz + profundidade * colunas;
+        if (no->valor != ID_TEXTO_INVALIDO && profundidade + distanciaMaxima >= m && linha[m] < limite) {
+            encontrado = no->valor;
+            break;
+        }
+        if (profundidade + 1 >= linhas) continue;
+        // Com folga na linha (menor valor abaixo do limite), um byte a mais custa no máximo 1 e
+        // todo filho cabe: o teste pelo primeiro byte só é feito quando a linha está no limite
+        int comFolga = menorDaLinha + 1 < limite;
+        for (uint32_t f = no->numFilhos; f > 0; f--) {
+            if (!comFolga && linhaDistanciaTexto(consulta, m, distanciaMaxima, linha, rascunho, profundidade + 1,
+                                                 (char)no->primeiros[f - 1]) >= limite) {
+                continue;
+            }
+            if (!empilharNoTexto(&pilha, &profundidades, &topo, &capacidade, local, no->filhos[f - 1],
+                                 (uint32_t)profundidade)) {
+                topo = 0;
+                break;
+            }
+        }
+    }
+    
+    if (pilha != local) {
+        free(pilha);
+        free(profundidades);
+    }
+    return encontrado;
+}
+
+/**
+ * Função: buscarTextoAproximado
+ * Propósito: Encontrar o texto do índice mais próximo de uma consulta pela distância de
+ * edição (Levenshtein), limitada a distanciaMaxima. Primeiro tenta a busca exata; depois
+ * percorre a árvore com limites crescentes (1, 2, ...): no primeiro limite em que algum texto
+ * cabe, nenhum está mais perto, e o percurso em ordem alfabética para no primeiro encontrado
+ * Parâmetros: indice - ponteiro para o índice
+ *             consulta - texto digitado
+ *             distanciaMaxima - maior distância aceita
+ *             distancia - saída: distância do texto encontrado (pode ser NULL)
+ * Retorno: id do texto mais próximo (o primeiro em ordem alfabética em caso de empate)
+ * ou ID_TEXTO_INVALIDO se nenhum está dentro do limite
+ */
+IdTexto buscarTextoAproximado(const IndiceTextos* indice, const char* consulta, uint32_t distanciaMaxima,
+                              uint32_t* distancia) {
+    IdTexto melhor = buscarNoIndiceTextos(indice, consulta);
+    uint32_t melhorDistancia = melhor != ID_TEXTO_INVALIDO ? 0 : distanciaMaxima + 1;
+    
+    size_t m = strlen(consulta);
+    size_t celulas = (m + distanciaMaxima + 2) * (m + 2);  // Maior matriz e a linha de rascunho
+    uint32_t matrizLocal[TAMANHO_LOCAL_DISTANCIA];
+    uint32_t* matriz = matrizLocal;
+    if (melhor == ID_TEXTO_INVALIDO && distanciaMaxima > 0 && celulas > TAMANHO_LOCAL_DISTANCIA) {
+        matriz = (uint32_t*)malloc(celulas * sizeof(uint32_t));
+        if (matriz == NULL) return ID_TEXTO_INVALIDO;
+    }
+    
+    for (uint32_t limite = 1; limite <= distanciaMaxima && melhor == ID_TEXTO_INVALIDO; limite++) {
+        melhor = buscarTextoAteDistancia(indice, consulta, m, limite, matriz, matriz + (celulas - (m + 2)));
+        if (melhor != ID_TEXTO_INVALIDO) melhorDistancia = limite;
+    }
+    
+    if (matriz != matrizLocal) free(matriz);
+    if (distancia != NULL) *distancia = melhorDistancia;
+    return melhor;
+}
+
+/**
+ * Função: liberarIndiceTextos
+ * Propósito: Liberar o índice de textos (sem recursão; os textos não são afetados)
+ * Parâmetros: indice - ponteiro para o índice
+ * Retorno: void
+ */
+void liberarIndiceTextos(IndiceTextos* indice) {
+    if (indice == NULL) return;
+    
+    // Cada nó liberado entrega os filhos para a pilha
+    size_t topo = 0, capacidade = 64;
+    NoTexto** pilha = (NoTexto**)malloc(capacidade * sizeof(NoTexto*));
+    if (pilha != NULL) pilha[topo++] = indice->raiz;
+    while (topo > 0) {
+        NoTexto* no = pilha[--topo];
+        if (topo + no->numFilhos > capacidade) {
+            while (topo + no->numFilhos > capacidade) capacidade *= 2;
+            NoTexto** maior = (NoTexto**)realloc(pilha, capacidade * sizeof(NoTexto*));
+            if (maior == NULL) break;
+            pilha = maior;
+        }
+        if (no->numFilhos > 0) memcpy(&pilha[topo], no->filhos, no->numFilhos * sizeof(NoTexto*));
+        topo += no->numFilhos;
+        free(no->filhos);
+        free(no);
+    }
+    free(pilha);
+    free(indice);
+}
+
+/**
+ * Função: indexarNomesSuspeitos
+ * Propósito: Montar o índice com os nomes dos suspeitos da tabela hash (a partir da lista
+ * de suspeitos distintos guardada na tabela: um nó por nome, não por associação)
+ * Parâmetros: tabela - tabela hash de suspeitos
+ * Retorno: ponteiro para o índice ou NULL em caso de erro
+ */
+IndiceTextos* indexarNomesSuspeitos(TabelaHash* tabela) {
+    IndiceTextos* nomes = criarIndiceTextos();
+    if (nomes == NULL || tabela == NULL) return nomes;
+    size_t numSuspeitos;
+    const IdTexto* suspeitos = suspeitosDaTabela(tabela, &numSuspeitos);
+    for (size_t i = 0; i < numSuspeitos; i++) {
+        inserirNoIndiceTextos(nomes, suspeitos[i]);
+    }
+    return nomes;
+}
+
+/**
+ * Função: anunciarAcusacaoFinal
+ * Propósito: Abrir a fase de julgamento final: suspeitos do caso, ranking de evidências e a pergunta
+ * Parâmetros: saida - destino das mensagens
+ *             tabela - tabela de suspeitos do caso em jogo
+ *             indice - ponteiro para o índice de evidências por suspeito
+ * Retorno: void
+ */
+void anunciarAcusacaoFinal(SaidaJogo* saida, TabelaHash* tabela, IndiceSuspeitos* indice) {
+    size_t numSuspeitos;
+    const IdTexto* suspeitos = suspeitosDaTabela(tabela, &numSuspeitos);
+    saidaTexto(saida, "\n=== FASE DE ACUSACAO FINAL ===\n"
+                      "Com base nas pistas coletadas, voce deve fazer sua acusacao!\n"
+                      "Suspeitos disponiveis: ");
+    for (size_t i = 0; i < numSuspeitos && i < MAX_SUSPEITOS_LISTADOS && saida->modo == SAIDA_TEXTO; i++) {
+        saidaFormatada(saida, "%s%s", i > 0 ? ", " : "", textoDoId(suspeitos[i]));
+    }
+    if (numSuspeitos > MAX_SUSPEITOS_LISTADOS) {
+        saidaFormatada(saida, " e mais %zu", numSuspeitos - MAX_SUSPEITOS_LISTADOS);
+    }
+    saidaTexto(saida, numSuspeitos > 0 ? "\n" : "nenhum\n");
+    abrirEvento(saida, "suspeitos");
+    campoListaEvento(saida, "suspeitos", suspeitos, numSuspeitos);
+    fecharEvento(saida);
+    exibirRankingSuspeitos(saida, indice);
+    saidaTexto(saida, "\nQuem voce acusa do crime? ");
+}
+
+/**
+ * Função: verificarSuspeitoFinal
+ * Propósito: Julgar a acusação do jogador, verificando se há evidências suficientes
+ * (a contagem e a lista de pistas vêm do índice mantido durante a exploração)
+ * Parâmetros: saida - destino das mensagens
+ *             indice - ponteiro para o índice de evidências por suspeito
+ *             tabela - tabela de suspeitos, para tolerar erros de digitação no nome (pode ser NULL)
+ *             suspeitoDigitado - nome do acusado como o jogador escreveu
+ * Retorno: void
+ */
+void verificarSuspeitoFinal(SaidaJogo* saida, IndiceSuspeitos* indice, TabelaHash* tabela,
+                            const char* suspeitoDigitado) {
+    const char* suspeitoAcusado = suspeitoDigitado;
+    
+    // Texto nunca visto (não pode ser o nome exato de um suspeito): vale o suspeito mais
+    // próximo, se a diferença for pequena. O índice de nomes só é montado neste caso
+    if (tabela != NULL && strlen(suspeitoDigitado) > DISTANCIA_MAXIMA_ACUSACAO &&
+        buscarIdTexto(suspeitoDigitado) == ID_TEXTO_INVALIDO) {
+        IndiceTextos* nomesSuspeitos = indexarNomesSuspeitos(tabela);
+        IdTexto corrigido = nomesSuspeitos != NULL
+                          ? buscarTextoAproximado(nomesSuspeitos, suspeitoDigitado, DISTANCIA_MAXIMA_ACUSACAO, NULL)
+                          : ID_TEXTO_INVALIDO;
+        liberarIndiceTextos(nomesSuspeitos);
+        if (corrigido != ID_TEXTO_INVALIDO) {
+            suspeitoAcusado = textoDoId(corrigido);
+            saidaFormatada(saida, "Considerando \"%s\" (voce digitou \"%s\").\n", suspeitoAcusado, suspeitoDigitado);
+        }
+    }
+    
+    // Consulta a ficha do suspeito acusado
+    FichaSuspeito* ficha = buscarFichaSuspeito(indice, suspeitoAcusado);
+    int pistasEncontradas = ficha != NULL ? ficha->contagem : 0;
+    if (saida->modo == SAIDA_NENHUMA) return;
+    if (pistasEncontradas > 0) {
+        qsort(ficha->pistas, ficha->contagem, sizeof(IdTexto), compararIdsTexto);
+    }
+    
+    abrirEvento(saida, "acusacao");
+    campoTextoEvento(saida, "digitado", suspeitoDigitado);
+    campoTextoEvento(saida, "suspeito", suspeitoAcusado);
+    campoNumeroEvento(saida, "evidencias", pistasEncontradas);
+    campoListaEvento(saida, "pistas", pistasEncontradas > 0 ? ficha->pistas : NULL, (size_t)pistasEncontradas);
+    campoTextoEvento(saida, "veredicto", pistasEncontradas >= PISTAS_PARA_CONDENACAO ? "RESOLVIDO" : "ABERTO");
+    fecharEvento(saida);
+    if (saida->modo != SAIDA_TEXTO) return;
+    
+    saidaFormatada(saida, "\n=== ANALISE DAS EVIDENCIAS ===\n"
+                          "Suspeito acusado: %s\n"
+                          "Pistas que apontam para %s: %d\n", suspeitoAcusado, suspeitoAcusado, pistasEncontradas);
+    
+    if (pistasEncontradas > 0) {
+        saidaTexto(saida, "\nPistas encontradas:\n");
+        for (int i = 0; i < ficha->contagem; i++) {
+            saidaFormatada(saida, "   - %s\n", textoDoId(ficha->pistas[i]));
+        }
+    }
+    
+    saidaTexto(saida, "\n=== VEREDICTO ===\n");
+    if (pistasEncontradas >= PISTAS_PARA_CONDENACAO) {
+        saidaFormatada(saida, "*** PARABENS! ***\n"
+                              "Voce resolveu o caso com sucesso!\n"
+                              "Ha evidencias suficientes (%d pistas) para sustentar sua acusacao.\n"
+                              "%s foi preso(a) e confessou o crime!\n"
+                              "A mansao misteriosa finalmente pode descansar em paz.\n",
+                       pistasEncontradas, suspeitoAcusado);
+    } else {
+        saidaFormatada(saida, "*** CASO NAO RESOLVIDO ***\n"
+                              "Evidencias insuficientes para uma condenacao.\n"
+                              "Voce precisa de pelo menos %d pistas convincentes para sustentar a acusacao.\n",
+                       PISTAS_PARA_CONDENACAO);
+        if (pistasEncontradas > 0) {
+            saidaFormatada(saida, "Apenas %d %s - nao e suficiente para o tribunal.\n", pistasEncontradas,
+                           pistasEncontradas == 1 ? "pista foi encontrada" : "pistas foram encontradas");
+        } else {
+            saidaFormatada(saida, "Nenhuma pista aponta para %s.\n", suspeitoAcusado);
+        }
+        saidaTexto(saida, "O caso permanece em aberto...\n");
+    }
+}
+
+/**
+ * Função: inicializarSuspeitos
+ * Propósito: Associar à tabela hash as pistas e suspeitos do catálogo embutido
+ * (dados estáticos: nenhuma alocação nem cálculo de hash; as associações são as de
+ * mapas/mansao_padrao.txt, ver catalogo_embutido.h)
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ * Retorno: void
+ */
+void inicializarSuspeitos(TabelaHash* tabela) {
+    tabela->embutido = &catalogoEmbutido;
+    
+    // Associações inseridas antes continuam com precedência sobre as do catálogo
+    tabela->substituidas = 0;
+    for (size_t i = 0; i < tabela->capacidade; i++) {
+        IdTexto pista = tabela->entradas[i].no.pista;
+        tabela->substituidas += (size_t)(pista != ID_TEXTO_INVALIDO && pistaDoCatalogoEmbutido(tabela, pista));
+    }
+}
+
+/**
+ * Função: construirMansaoPadrao
+ * Propósito: Montar manualmente a mansão padrão do jogo (11 salas)
+ * Retorno: ponteiro para o Hall de entrada
+ */
+Sala* construirMansaoPadrao() {
+    // Criação manual da árvore binária representando o mapa da mansão com pistas
+    
+    // Nível 0 - Raiz (Hall de entrada)
+    Sala* hallEntrada = criarSala("Hall de Entrada", "Uma pegada estranha na entrada principal");
+    
+    // Nível 1
+    Sala* biblioteca = criarSala("Biblioteca", "Livro sobre venenos deixado aberto na mesa");
+    Sala* salaEstar = criarSala("Sala de Estar", "Cinzas ainda quentes na lareira");
+    
+    // Nível 2 - Lado esquerdo (filhos da Biblioteca)
+    Sala* escritorio = criarSala("Escritorio", "Carta de ameaca parcialmente queimada");
+    Sala* salaMusica = criarSala("Sala de Musica", "");  // Sem pista
+    
+    // Nível 2 - Lado direito (filhos da Sala de Estar)
+    Sala* cozinha = criarSala("Cozinha", "Faca com manchas suspeitas");
+    Sala* jardim = criarSala("Jardim", "Flores venenosas recentemente colhidas");
+    
+    // Nível 3 - Folhas (salas finais)
+    Sala* cofre = criarSala("Cofre Secreto", "Documento com assinatura falsificada");
+    Sala* piano = criarSala("Piano Antigo", "Partitura com codigo secreto");
+    Sala* despensa = criarSala("Despensa", "Frasco vazio de arsênico");
+    Sala* greenhouse = criarSala("Estufa", "Luvas com residuos toxicos");
+    
+    // Montagem da estrutura da árvore
+    
+    // Hall de entrada -> Biblioteca (esquerda) e Sala de Estar (direita)
+    hallEntrada->esquerda = biblioteca;
+    hallEntrada->direita = salaEstar;
+    
+    // Biblioteca -> Escritório (esquerda) e Sala de Música (direita)
+    biblioteca->esquerda = escritorio;
+    biblioteca->direita = salaMusica;
+    
+    // Sala de Estar -> Cozinha (esquerda) e Jardim (direita)
+    salaEstar->esquerda = cozinha;
+    salaEstar->direita = jardim;
+    
+    // Escritório -> Cofre Secreto (esquerda apenas)
+    escritorio->esquerda = cofre;
+    
+    // Sala de Música -> Piano Antigo (direita apenas)
+    salaMusica->direita = piano;
+    
+    // Cozinha -> Despensa (esquerda apenas)
+    cozinha->esquerda = despensa;
+    
+    // Jardim -> Estufa (direita apenas)
+    jardim->direita = greenhouse;
+    
+    return hallEntrada;
+}
+
+/**
+ * Função: coletarPistaDaSala
+ * Propósito: Coletar a pista de uma sala: adiciona ao caderno e ao índice de suspeitos
+ * (pistas já anotadas não são contadas de novo)
+ * Parâmetros: sala - sala visitada
+ *             arvorePistas - ponteiro para ponteiro da raiz da árvore de pistas
+ *             tabela - ponteiro para a tabela hash de suspeitos
+ *             indice - índice de evidências por suspeito
+ *             suspeito - saída: suspeito apontado pela pista (ID_TEXTO_INVALIDO se a sala
+ *                        não tem pista ou a pista não aponta para ninguém)
+ * Retorno: 1 se uma pista nova entrou no caderno, 0 caso contrário
+ */
+int coletarPistaDaSala(Sala* sala, PistaNode** arvorePistas, TabelaHash* tabela, IndiceSuspeitos* indice,
+                       IdTexto* suspeito) {
+    *suspeito = ID_TEXTO_INVALIDO;
+    if (sala->pista == ID_TEXTO_VAZIO) return 0;
+    
+    *suspeito = encontrarSuspeitoPorId(tabela, sala->pista);
+    if (buscarPista(*arvorePistas, sala->pista) != NULL) return 0;
+    
+    *arvorePistas = inserirPistaBalanceada(*arvorePistas, sala->pista);
+    if (*suspeito != ID_TEXTO_INVALIDO) {
+        registrarPistaSuspeito(indice, *suspeito, sala->pista);
+    }
+    return 1;
+}
+
+/**
+ * Função: resumirCondenacoes
+ * Propósito: Preparar as dicas de acusação: numa única passada em profundidade, anota em cada
+ * sala quantas salas ainda é preciso descer para que o caminho desde o hall reúna
+ * PISTAS_PARA_CONDENACAO pistas distintas contra um mesmo suspeito (0 se já reúne, ou
+ * CONDENACAO_INALCANCAVEL). Como a navegação só desce, as pistas do jogador são as do
+ * caminho e a consulta durante o jogo custa O(1)
+ * Parâmetros: hall - sala de entrada
+ *             tabela - tabela hash de suspeitos
+ * Retorno: 1 se a mansão foi resumida, 0 em caso de erro
+ */
+int resumirCondenacoes(Sala* hall, TabelaHash* tabela) {
+    if (hall == NULL) return 1;
+    
+    // Contagens do caminho atual, indexadas pelo id da pista e do suspeito
+    size_t numTextos = textosInternados.quantidade;
+    uint32_t* ocorrencias = (uint32_t*)calloc(numTextos, sizeof(uint32_t));
+    uint32_t* distintas = (uint32_t*)calloc(numTextos, sizeof(uint32_t));
+    size_t capacidade = 64;
+    PassoResumo* pilha = (PassoResumo*)malloc(capacidade * sizeof(PassoResumo));
+    if (ocorrencias == NULL || distintas == NULL || pilha == NULL) {
+        printf("Erro: Falha na alocação de memória para o resumo de condenacoes!\n");
+        free(ocorrencias);
+        free(distintas);
+        free(pilha);
+        return 0;
+    }
+    
+    size_t topo = 0;
+    size_t condenaveis = 0;  // Suspeitos com pistas suficientes no caminho atual
+    pilha[topo++] = (PassoResumo){ hall, 0 };
+    while (topo > 0) {
+        PassoResumo passo = pilha[--topo];
+        Sala* sala = passo.sala;
+        IdTexto suspeito = sala->pista != ID_TEXTO_VAZIO ? encontrarSuspeitoPorId(tabela, sala->pista)
+                                                         : ID_TEXTO_INVALIDO;
+        
+        if (passo.saida) {
+            // Os filhos já foram resumidos: completa a sala e desfaz a sua pista
+            if (sala->salasAteCondenacao != 0) {
+                uint32_t melhor = CONDENACAO_INALCANCAVEL;
+                Sala* filhos[2] = { sala->esquerda, sala->direita };
+                for (int f = 0; f < 2; f++) {
+                    if (filhos[f] != NULL && filhos[f]->salasAteCondenacao < melhor) {
+                        melhor = filhos[f]->salasAteCondenacao;
+                    }
+                }
+                sala->salasAteCondenacao = melhor == CONDENACAO_INALCANCAVEL ? melhor : melhor + 1;
+            }
+            if (suspeito != ID_TEXTO_INVALIDO && --ocorrencias[sala->pista] == 0 &&
+                distintas[suspeito]-- == PISTAS_PARA_CONDENACAO) {
+                condenaveis--;
+            }
+            continue;
+        }
+        
+        if (suspeito != ID_TEXTO_INVALIDO && ocorrencias[sala->pista]++ == 0 &&
+            ++distintas[suspeito] == PISTAS_PARA_CONDENACAO) {
+            condenaveis++;
+        }
+        sala->salasAteCondenacao = condenaveis > 0 ? 0 : CONDENACAO_NAO_CALCULADA;
+        
+        if (topo + 3 > capacidade) {
+            PassoResumo* maior = (PassoResumo*)realloc(pilha, capacidade * 2 * sizeof(PassoResumo));
+            if (maior == NULL) {
+                printf("Erro: Falha na alocação de memória para o resumo de condenacoes!\n");
+                free(ocorrencias);
+                free(distintas);
+                free(pilha);
+                return 0;
+            }
+            pilha = maior;
+            capacidade *= 2;
+        }
+        pilha[topo++] = (PassoResumo){ sala, 1 };
+        if (sala->direita != NULL) pilha[topo++] = (PassoResumo){ sala->direita, 0 };
+        if (sala->esquerda != NULL) pilha[topo++] = (PassoResumo){ sala->esquerda, 0 };
+    }
+    
+    free(ocorrencias);
+    free(distintas);
+    free(pilha);
+    return 1;
+}
+
+/**
+ * Função: desligarCasoLru
+ * Propósito: Retirar um caso carregado da lista LRU do acervo
+ * Parâmetros: acervo - acervo de casos
+ *             caso - caso presente na lista
+ * Retorno: void
+ */
+static void desligarCasoLru(AcervoCasos* acervo, CasoAcervo* caso) {
+    if (caso->anterior != NULL) {
+        caso->anterior->proximo = caso->proximo;
+    } else {
+        acervo->maisRecente = caso->proximo;
+    }
+    if (caso->proximo != NULL) {
+        caso->proximo->anterior = caso->anterior;
+    } else {
+        acervo->menosRecente = caso->anterior;
+    }
+    caso->anterior = NULL;
+    caso->proximo = NULL;
+}
+
+/**
+ * Função: ligarCasoLru
+ * Propósito: Colocar um caso na cabeça da lista LRU (o usado mais recentemente)
+ * Parâmetros: acervo - acervo de casos
+ *             caso - caso fora da lista
+ * Retorno: void
+ */
+static void ligarCasoLru(AcervoCasos* acervo, CasoAcervo* caso) {
+    caso->anterior = NULL;
+    caso->proximo = acervo->maisRecente;
+    if (acervo->maisRecente != NULL) {
+        acervo->maisRecente->anterior = caso;
+    } else {
+        acervo->menosRecente = caso;
+    }
+    acervo->maisRecente = caso;
+}
+
+/**
+ * Função: ajustarAcervoAoOrcamento
+ * Propósito: Despejar casos, do menos para o mais recentemente usado, até a memória dos
+ * casos carregados caber no orçamento (casos em uso ficam, mesmo acima do orçamento)
+ * Parâmetros: acervo - acervo de casos
+ * Retorno: void
+ */
+static void ajustarAcervoAoOrcamento(AcervoCasos* acervo) {
+    CasoAcervo* caso = acervo->menosRecente;
+    while (caso != NULL && acervo->orcamento > 0 && acervo->bytesCarregados > acervo->orcamento) {
+        CasoAcervo* anterior = caso->anterior;
+        if (caso->emUso == 0) {
+            desligarCasoLru(acervo, caso);
+            acervo->bytesCarregados -= caso->bytes;
+            acervo->carregados--;
+            acervo->despejos++;
+            acervo->descarregar(caso);
+            caso->bytes = 0;
+        }
+        caso = anterior;
+    }
+}
+
+/**
+ * Função: abrirCasoAcervo
+ * Propósito: Entregar um caso pronto para jogar: lido do disco no primeiro uso (ou depois
+ * de despejado), marcado como o mais recente e protegido do despejo até soltarCasoAcervo.
+ * Um caso cujo mapa não pôde ser carregado é recusado nas próximas aberturas sem nova leitura
+ * Parâmetros: acervo - acervo de casos
+ *             indice - posição do caso na lista
+ * Retorno: ponteiro para o caso ou NULL se o índice é inválido ou o mapa não pôde ser carregado
+ */
+CasoAcervo* abrirCasoAcervo(AcervoCasos* acervo, size_t indice) {
+    if (acervo == NULL || indice >= acervo->numCasos) return NULL;
+    
+    CasoAcervo* caso = &acervo->casos[indice];
+    if (caso->hall == NULL) {
+        if (caso->falhou) return NULL;
+        if (!acervo->carregar(caso)) {
+            caso->falhou = 1;
+            return NULL;
+        }
+        caso->carregamentos++;
+        acervo->leituras++;
+        acervo->carregados++;
+        acervo->bytesCarregados += caso->bytes;
+    } else {
+        desligarCasoLru(acervo, caso);
+    }
+    ligarCasoLru(acervo, caso);
+    caso->emUso++;
+    acervo->aberturas++;
+    
+    // O caso recém-aberto está em uso: quem sai são os outros
+    ajustarAcervoAoOrcamento(acervo);
+    return caso;
+}
+
+/**
+ * Função: soltarCasoAcervo
+ * Propósito: Devolver um caso aberto; sem sessões, ele pode ser despejado pelo orçamento
+ * Parâmetros: acervo - acervo de casos
+ *             caso - caso obtido de abrirCasoAcervo
+ * Retorno: void
+ */
+void soltarCasoAcervo(AcervoCasos* acervo, CasoAcervo* caso) {
+    if (acervo == NULL || caso == NULL || caso->emUso == 0) return;
+    caso->emUso--;
+    ajustarAcervoAoOrcamento(acervo);
+}
+
+/**
+ * Função: buscarCasoAcervo
+ * Propósito: Encontrar o caso pedido pelo jogador, pelo número na lista (a partir de 1) ou pelo nome
+ * Parâmetros: acervo - acervo de casos
+ *             texto - número ou nome digitado (espaços nas pontas são ignorados)
+ * Retorno: posição do caso ou acervo->numCasos se nenhum corresponde
+ */
+size_t buscarCasoAcervo(const AcervoCasos* acervo, const char* texto) {
+    char pedido[TAMANHO_NOME_CASO];
+    while (*texto == ' ' || *texto == '\t') texto++;
+    snprintf(pedido, sizeof(pedido), "%s", texto);
+    size_t tamanho = strlen(pedido);
+    while (tamanho > 0 && (pedido[tamanho - 1] == ' ' || pedido[tamanho - 1] == '\t' || pedido[tamanho - 1] == '\r')) {
+        pedido[--tamanho] = '\0';
+    }
+    if (tamanho == 0) return acervo->numCasos;
+    
+    if (strspn(pedido, "0123456789") == tamanho) {
+        unsigned long long numero = strtoull(pedido, NULL, 10);
+        return numero >= 1 && numero <= acervo->numCasos ? (size_t)(numero - 1) : acervo->numCasos;
+    }
+    
+    // Nomes internados: um texto nunca visto não é nome de caso
+    IdTexto nome = buscarIdTexto(pedido);
+    for (size_t i = 0; i < acervo->numCasos && nome != ID_TEXTO_INVALIDO; i++) {
+        if (acervo->nomes[i] == nome) return i;
+    }
+    return acervo->numCasos;
+}
+
+/**
+ * Função: exibirPalpiteSessao
+ * Propósito: Mostrar o suspeito que lidera as evidências, quantas pistas faltam para
+ * acusá-lo e se ainda há condenação possível descendo a partir da sala atual
+ * Parâmetros: saida - destino das mensagens
+ *             sessao - sessão do jogador
+ * Retorno: void
+ */
+static void exibirPalpiteSessao(SaidaJogo* saida, const SessaoJogo* sessao) {
+    const FichaSuspeito* lider = liderSuspeitos(sessao->indice);
+    int evidencias = lider != NULL ? lider->contagem : 0;
+    int faltam = evidencias < PISTAS_PARA_CONDENACAO ? PISTAS_PARA_CONDENACAO - evidencias : 0;
+    uint32_t salas = sessao->salaAtual->salasAteCondenacao;
+    
+    if (lider == NULL) {
+        saidaTexto(saida, "\nPalpite: nenhuma pista aponta para um suspeito ainda.\n");
+    } else if (faltam == 0) {
+        saidaFormatada(saida, "\nPalpite: %s tem %d pistas - evidencias suficientes para a acusacao!\n",
+                       textoDoId(lider->suspeito), evidencias);
+    } else {
+        saidaFormatada(saida, "\nPalpite: %s lidera com %d pista(s); %s %d pista%s para a acusacao.\n",
+                       textoDoId(lider->suspeito), evidencias, faltam == 1 ? "falta" : "faltam", faltam,
+                       faltam == 1 ? "" : "s");
+    }
+    if (salas == CONDENACAO_INALCANCAVEL) {
+        saidaTexto(saida, "Nenhum caminho a partir daqui leva a uma condenacao.\n");
+    } else if (salas != CONDENACAO_NAO_CALCULADA && salas > 0) {
+        saidaFormatada(saida, "Uma condenacao ainda e possivel descendo a partir daqui (a %u sala%s).\n",
+                       (unsigned)salas, salas == 1 ? "" : "s");
+    }
+    
+    abrirEvento(saida, "palpite");
+    campoTextoEvento(saida, "lider", lider != NULL ? textoDoId(lider->suspeito) : NULL);
+    campoNumeroEvento(saida, "evidencias", evidencias);
+    campoNumeroEvento(saida, "faltam", faltam);
+    if (salas != CONDENACAO_NAO_CALCULADA) {
+        campoNumeroEvento(saida, "salas", salas == CONDENACAO_INALCANCAVEL ? -1 : (long long)salas);
+    }
+    fecharEvento(saida);
+}
+
+/**
+ * Função: apresentarSalaSessao
+ * Propósito: Mostrar a sala atual da sessão, coletar sua pista e listar as opções de navegação
+ * Parâmetros: saida - destino das mensagens (prosa, eventos JSON ou nada)
+ *             sessao - sessão que acabou de chegar (ou continua) na sala
+ * Retorno: void
+ */
+static void apresentarSalaSessao(SaidaJogo* saida, SessaoJogo* sessao) {
+    Sala* salaAtual = sessao->salaAtual;
+    Sala* esquerda = salaAtual->esquerda;
+    Sala* direita = salaAtual->direita;
+    saidaFormatada(saida, "\n=== DETECTIVE QUEST - NIVEL MESTRE ===\n"
+                          "Voce esta na: %s\n", textoDoId(salaAtual->nome));
+    abrirEvento(saida, "sala");
+    campoTextoEvento(saida, "sala", textoDoId(salaAtual->nome));
+    campoTextoEvento(saida, "esquerda", esquerda != NULL ? textoDoId(esquerda->nome) : NULL);
+    campoTextoEvento(saida, "direita", direita != NULL ? textoDoId(direita->nome) : NULL);
+    fecharEvento(saida);
+    
+    // Verifica se há uma pista nesta sala
+    if (salaAtual->pista != ID_TEXTO_VAZIO) {
+        // Adiciona a pista ao caderno e ao índice e mostra o suspeito associado
+        IdTexto suspeito;
+        int nova = coletarPistaDaSala(salaAtual, &sessao->caderno, sessao->tabela, sessao->indice, &suspeito);
+        if (nova && sessao->indicePistas != NULL) {
+            inserirNoIndiceTextos(sessao->indicePistas, salaAtual->pista);
+        }
+        
+        saidaFormatada(saida, "\n*** PISTA ENCONTRADA! ***\n"
+                              "Pista: %s\n", textoDoId(salaAtual->pista));
+        if (suspeito != ID_TEXTO_INVALIDO) {
+            saidaFormatada(saida, "Esta pista aponta para: %s\n", textoDoId(suspeito));
+        } else {
+            saidaTexto(saida, "Pista nao associada a nenhum suspeito conhecido.\n");
+        }
+        saidaTexto(saida, "Pista adicionada ao seu caderno de investigacao!\n");
+        
+        abrirEvento(saida, "pista");
+        campoTextoEvento(saida, "pista", textoDoId(salaAtual->pista));
+        campoTextoEvento(saida, "suspeito", suspeito != ID_TEXTO_INVALIDO ? textoDoId(suspeito) : NULL);
+        campoNumeroEvento(saida, "nova", nova);
+        fecharEvento(saida);
+    } else {
+        saidaTexto(saida, "\nEsta sala nao contem pistas visiveis.\n");
+    }
+    exibirPalpiteSessao(saida, sessao);
+    
+    // Verifica se é uma sala final (nó-folha)
+    if (esquerda == NULL && direita == NULL) {
+        saidaTexto(saida, "\nVoce chegou ao fim deste caminho!\n"
+                          "Esta sala nao possui mais saidas.\n"
+                          "Pressione 's' para sair ou explore outro caminho.\n");
+    }
+    
+    // Exibe as opções disponíveis
+    saidaTexto(saida, "\nOpcoes de navegacao:\n");
+    if (esquerda != NULL) {
+        saidaFormatada(saida, "(e) - Ir para a esquerda: %s\n", textoDoId(esquerda->nome));
+    }
+    if (direita != NULL) {
+        saidaFormatada(saida, "(d) - Ir para a direita: %s\n", textoDoId(direita->nome));
+    }
+    saidaTexto(saida, "(b) - Buscar pistas do caderno pelo inicio do texto\n"
+                      "(s) - Encerrar investigacao e fazer acusacao final\n"
+                      "\nEscolha sua acao: ");
+}
+
+/**
+ * Função: iniciarSessaoJogo
+ * Propósito: Começar uma sessão de jogo no hall e apresentar a primeira sala
+ * Parâmetros: saida - destino das mensagens
+ *             sessao - sessão a preparar
+ *             hall - sala de entrada (NULL: a sessão já começa encerrada)
+ *             caderno - caderno inicial (normalmente NULL)
+ *             tabela - tabela hash de suspeitos
+ *             indice - índice de evidências da sessão, atualizado a cada pista coletada
+ * Retorno: void
+ */
+void iniciarSessaoJogo(SaidaJogo* saida, SessaoJogo* sessao, Sala* hall, PistaNode* caderno, TabelaHash* tabela,
+                       IndiceSuspeitos* indice) {
+    sessao->salaAtual = hall;
+    sessao->caderno = caderno;
+    sessao->tabela = tabela;
+    sessao->indice = indice;
+    sessao->indicePistas = NULL;
+    sessao->fase = hall != NULL ? FASE_NAVEGACAO : FASE_ENCERRADA;
+    sessao->acervo = NULL;
+    sessao->caso = NULL;
+    if (hall != NULL) apresentarSalaSessao(saida, sessao);
+}
+
+/**
+ * Função: apresentarCasosSessao
+ * Propósito: Listar os casos do acervo e pedir a escolha do jogador
+ * Parâmetros: saida - destino das mensagens
+ *             sessao - sessão em FASE_CASO
+ * Retorno: void
+ */
+static void apresentarCasosSessao(SaidaJogo* saida, const SessaoJogo* sessao) {
+    const AcervoCasos* acervo = sessao->acervo;
+    saidaTexto(saida, "\n=== CASOS DISPONIVEIS ===\n");
+    for (size_t i = 0; i < acervo->numCasos && saida->modo == SAIDA_TEXTO; i++) {
+        saidaFormatada(saida, "%3zu. %s\n", i + 1, textoDoId(acervo->nomes[i]));
+    }
+    saidaTexto(saida, "\nEscolha o caso (numero ou nome): ");
+    abrirEvento(saida, "casos");
+    campoListaEvento(saida, "casos", acervo->nomes, acervo->numCasos);
+    fecharEvento(saida);
+}
+
+/**
+ * Função: iniciarSessaoAcervo
+ * Propósito: Começar uma sessão que primeiro escolhe o caso no acervo (a mansão e a
+ * tabela de suspeitos vêm do caso escolhido)
+ * Parâmetros: saida - destino das mensagens
+ *             sessao - sessão a preparar
+ *             acervo - acervo de casos
+ *             caderno - caderno inicial (normalmente NULL)
+ *             indice - índice de evidências da sessão
+ * Retorno: void
+ */
+void iniciarSessaoAcervo(SaidaJogo* saida, SessaoJogo* sessao, AcervoCasos* acervo, PistaNode* caderno,
+                         IndiceSuspeitos* indice) {
+    iniciarSessaoJogo(saida, sessao, NULL, caderno, NULL, indice);
+    if (acervo == NULL || acervo->numCasos == 0) return;
+    sessao->acervo = acervo;
+    sessao->fase = FASE_CASO;
+    apresentarCasosSessao(saida, sessao);
+}
+
+/**
+ * Função: finalizarSessaoJogo
+ * Propósito: Liberar o que a própria sessão montou e devolver o caso aberto ao acervo
+ * (o caderno e o índice são de quem a iniciou)
+ * Parâmetros: sessao - ponteiro para a sessão
+ * Retorno: void
+ */
+void finalizarSessaoJogo(SessaoJogo* sessao) {
+    liberarIndiceTextos(sessao->indicePistas);
+    sessao->indicePistas = NULL;
+    sessao->fase = FASE_ENCERRADA;
+    
+    // O caso volta ao acervo: a partir daqui a mansão dele pode ser despejada
+    if (sessao->caso != NULL) {
+        soltarCasoAcervo(sessao->acervo, sessao->caso);
+        sessao->caso = NULL;
+        sessao->salaAtual = NULL;
+        sessao->tabela = NULL;
+    }
+}
+
+/**
+ * Função: encerrarInvestigacaoSessao
+ * Propósito: Exibir o relatório final e passar à acusação (ou encerrar, sem pistas)
+ * Parâmetros: saida - destino das mensagens
+ *             sessao - sessão em FASE_NAVEGACAO
+ * Retorno: void
+ */
+static void encerrarInvestigacaoSessao(SaidaJogo* saida, SessaoJogo* sessao) {
+    saidaTexto(saida, "\n=== RELATORIO FINAL DE INVESTIGACAO ===\n"
+                      "Investigacao da mansao encerrada!\n");
+    
+    // Exibe todas as pistas coletadas
+    int contador = 0;
+    if (sessao->caderno != NULL) {
+        saidaTexto(saida, "\nPistas coletadas (em ordem alfabetica):\n"
+                          "========================================\n");
+        if (saida->modo != SAIDA_NENHUMA) exibirPistas(saida, sessao->caderno, &contador);
+        saidaFormatada(saida, "========================================\n"
+                              "Total de pistas coletadas: %d\n", contador);
+        abrirEvento(saida, "relatorio");
+        campoNumeroEvento(saida, "pistas", contador);
+        fecharEvento(saida);
+        
+        // Inicia a fase de acusação final
+        anunciarAcusacaoFinal(saida, sessao->tabela, sessao->indice);
+        sessao->fase = FASE_ACUSACAO;
+        return;
+    }
+    
+    saidaTexto(saida, "\nNenhuma pista foi coletada durante a investigacao.\n"
+                      "Impossivel fazer uma acusacao sem evidencias!\n");
+    abrirEvento(saida, "relatorio");
+    campoNumeroEvento(saida, "pistas", 0);
+    fecharEvento(saida);
+    saidaTexto(saida, "\nObrigado por jogar Detective Quest - Nivel Mestre!\n");
+    finalizarSessaoJogo(sessao);
+}
+
+/**
+ * Função: buscarNoCadernoSessao
+ * Propósito: Listar as pistas do caderno que começam por um prefixo
+ * (o índice do caderno é montado na primeira busca e mantido a cada pista coletada depois dela)
+ * Parâmetros: saida - destino das mensagens
+ *             sessao - sessão do jogador
+ *             prefixo - início de pista digitado
+ * Retorno: void
+ */
+static void buscarNoCadernoSessao(SaidaJogo* saida, SessaoJogo* sessao, const char* prefixo) {
+    IdTexto encontradas[MAX_RESULTADOS_PREFIXO];
+    
+    if (sessao->indicePistas == NULL) {
+        sessao->indicePistas = criarIndiceTextos();
+        IteradorPistas iterador;
+        iniciarIteradorPistas(&iterador, sessao->indicePistas != NULL ? sessao->caderno : NULL);
+        for (PistaNode* no = proximaPista(&iterador); no != NULL; no = proximaPista(&iterador)) {
+            inserirNoIndiceTextos(sessao->indicePistas, no->conteudo);
+        }
+        finalizarIteradorPistas(&iterador);
+        if (iterador.erro) {
+            // Um índice com parte do caderno esconderia pistas; a próxima busca tenta de novo
+            liberarIndiceTextos(sessao->indicePistas);
+            sessao->indicePistas = NULL;
+        }
+    }
+    
+    size_t total = sessao->indicePistas != NULL
+                 ? listarPorPrefixo(sessao->indicePistas, prefixo, encontradas, MAX_RESULTADOS_PREFIXO) : 0;
+    saidaFormatada(saida, "\nPistas do caderno que comecam com \"%s\": %zu%s\n", prefixo, total,
+                   total == MAX_RESULTADOS_PREFIXO ? " (ou mais)" : "");
+    for (size_t i = 0; i < total && saida->modo == SAIDA_TEXTO; i++) {
+        saidaFormatada(saida, "   - %s\n", textoDoId(encontradas[i]));
+    }
+    abrirEvento(saida, "busca");
+    campoTextoEvento(saida, "prefixo", prefixo);
+    campoListaEvento(saida, "pistas", encontradas, total);
+    fecharEvento(saida);
+}
+
+/**
+ * Função: escolherOpcaoSessao
+ * Propósito: Aplicar uma opção de navegação (e, d, b ou s) e apresentar o que vem depois
+ * Parâmetros: saida - destino das mensagens
+ *             sessao - sessão em FASE_NAVEGACAO
+ *             escolha - opção digitada
+ * Retorno: void
+ */
+void escolherOpcaoSessao(SaidaJogo* saida, SessaoJogo* sessao, char escolha) {
+    if (sessao->fase != FASE_NAVEGACAO) return;
+    
+    switch (escolha) {
+        case 'e':
+        case 'E':
+        case 'd':
+        case 'D': {
+            int paraEsquerda = escolha == 'e' || escolha == 'E';
+            Sala* destino = paraEsquerda ? sessao->salaAtual->esquerda : sessao->salaAtual->direita;
+            if (destino != NULL) {
+                sessao->salaAtual = destino;
+                saidaTexto(saida, paraEsquerda ? "\nMovendo-se para a esquerda...\n"
+                                               : "\nMovendo-se para a direita...\n");
+            } else {
+                saidaTexto(saida, paraEsquerda ? "\nNao ha caminho a esquerda! Tente outra direcao.\n"
+                                               : "\nNao ha caminho a direita! Tente outra direcao.\n");
+            }
+            abrirEvento(saida, destino != NULL ? "movimento" : "movimento_invalido");
+            campoTextoEvento(saida, "direcao", paraEsquerda ? "esquerda" : "direita");
+            fecharEvento(saida);
+            break;
+        }
+            
+        case 's':
+        case 'S':
+            encerrarInvestigacaoSessao(saida, sessao);
+            return;
+            
+        case 'b':
+        case 'B':
+            saidaTexto(saida, "Inicio da pista: ");
+            sessao->fase = FASE_BUSCA;
+            return;
+            
+        default: {
+            char opcao[2] = {escolha, '\0'};
+            saidaTexto(saida, "\nOpcao invalida! Use 'e' para esquerda, 'd' para direita, 'b' para buscar ou 's' para sair.\n");
+            abrirEvento(saida, "opcao_invalida");
+            campoTextoEvento(saida, "opcao", opcao);
+            fecharEvento(saida);
+            break;
+        }
+    }
+    apresentarSalaSessao(saida, sessao);
+}
+
+/**
+ * Função: escolherCasoSessao
+ * Propósito: Abrir o caso pedido pelo jogador e apresentar a primeira sala dele
+ * (um pedido desconhecido, ou um caso cujo mapa não abre, repete a pergunta)
+ * Parâmetros: saida - destino das mensagens
+ *             sessao - sessão em FASE_CASO
+ *             pedido - número ou nome digitado
+ * Retorno: void
+ */
+static void escolherCasoSessao(SaidaJogo* saida, SessaoJogo* sessao, const char* pedido) {
+    AcervoCasos* acervo = sessao->acervo;
+    size_t indice = buscarCasoAcervo(acervo, pedido);
+    size_t leituras = acervo->leituras;
+    CasoAcervo* caso = indice < acervo->numCasos ? abrirCasoAcervo(acervo, indice) : NULL;
+    if (caso == NULL) {
+        if (indice < acervo->numCasos) {
+            saidaFormatada(saida, "\nO caso %s nao pode ser aberto. Escolha outro.\n", textoDoId(acervo->nomes[indice]));
+        } else {
+            saidaFormatada(saida, "\nCaso desconhecido: \"%s\". Use o numero ou o nome de um caso da lista.\n", pedido);
+        }
+        saidaTexto(saida, "Escolha o caso (numero ou nome): ");
+        abrirEvento(saida, "caso_invalido");
+        campoTextoEvento(saida, "caso", pedido);
+        fecharEvento(saida);
+        return;
+    }
+    
+    sessao->caso = caso;
+    sessao->salaAtual = caso->hall;
+    sessao->tabela = caso->tabela;
+    sessao->fase = FASE_NAVEGACAO;
+    saidaFormatada(saida, "\nCaso escolhido: %s\n", textoDoId(acervo->nomes[indice]));
+    abrirEvento(saida, "caso");
+    campoTextoEvento(saida, "caso", textoDoId(acervo->nomes[indice]));
+    campoNumeroEvento(saida, "lido", acervo->leituras != leituras);
+    fecharEvento(saida);
+    apresentarSalaSessao(saida, sessao);
+}
+
+/**
+ * Função: responderSessao
+ * Propósito: Entregar à sessão a linha que ela espera (caso, início de pista ou nome do acusado)
+ * Parâmetros: saida - destino das mensagens
+ *             sessao - sessão em FASE_CASO, FASE_BUSCA ou FASE_ACUSACAO
+ *             linha - texto digitado, sem a quebra de linha (NULL: a entrada terminou)
+ * Retorno: void
+ */
+void responderSessao(SaidaJogo* saida, SessaoJogo* sessao, const char* linha) {
+    if (sessao->fase == FASE_CASO) {
+        if (linha != NULL) {
+            escolherCasoSessao(saida, sessao, linha);
+            return;
+        }
+        saidaTexto(saida, "\nNenhum caso escolhido.\n"
+                          "\nObrigado por jogar Detective Quest - Nivel Mestre!\n");
+        finalizarSessaoJogo(sessao);
+    } else if (sessao->fase == FASE_BUSCA) {
+        // Sem entrada, a busca é abandonada e a sala é apresentada de novo
+        sessao->fase = FASE_NAVEGACAO;
+        if (linha != NULL) {
+            char prefixo[TAMANHO_PREFIXO_BUSCA];
+            snprintf(prefixo, sizeof(prefixo), "%s", linha);
+            buscarNoCadernoSessao(saida, sessao, prefixo);
+        }
+        apresentarSalaSessao(saida, sessao);
+    } else if (sessao->fase == FASE_ACUSACAO) {
+        char suspeitoDigitado[TAMANHO_NOME_ACUSADO];
+        snprintf(suspeitoDigitado, sizeof(suspeitoDigitado), "%s", linha != NULL ? linha : "");
+        verificarSuspeitoFinal(saida, sessao->indice, sessao->tabela, suspeitoDigitado);
+        saidaTexto(saida, "\nObrigado por jogar Detective Quest - Nivel Mestre!\n");
+        finalizarSessaoJogo(sessao);
+    }
+}
+
+/**
+ * Função: avancarSessao
+ * Propósito: Aplicar uma linha de entrada do jogador à sessão, qualquer que seja a fase
+ * (na navegação vale o primeiro caractere visível; linhas em branco são ignoradas)
+ * Parâmetros: saida - destino das mensagens
+ *             sessao - sessão do jogador
+ *             linha - linha recebida, sem a quebra de linha
+ * Retorno: void
+ */
+void avancarSessao(SaidaJogo* saida, SessaoJogo* sessao, const char* linha) {
+    if (sessao->fase != FASE_NAVEGACAO) {
+        responderSessao(saida, sessao, linha);
+        return;
+    }
+    while (*linha == ' ' || *linha == '\t' || *linha == '\r') linha++;
+    if (*linha != '\0') escolherOpcaoSessao(saida, sessao, *linha);
+}
+
+/**
+ * Função: conduzirSessao
+ * Propósito: Conduzir uma sessão já iniciada com as entradas lidas do terminal, até o fim
+ * Parâmetros: saida - destino das mensagens (prosa, eventos JSON ou nada)
+ *             sessao - sessão iniciada
+ * Retorno: void
+ */
+void conduzirSessao(SaidaJogo* saida, SessaoJogo* sessao) {
+    char linha[TAMANHO_PREFIXO_BUSCA];
+    
+    // Continua lendo entradas até o jogador encerrar a investigação
+    while (sessao->fase != FASE_ENCERRADA) {
+        prepararLeituraSaida(saida);
+        if (sessao->fase == FASE_NAVEGACAO) {
+            char escolha;
+            if (scanf(" %c", &escolha) != 1) escolha = 's';
+            getchar(); // Limpa o buffer para fgets
+            escolherOpcaoSessao(saida, sessao, escolha);
+            continue;
+        }
+        
+        // Caso, início de pista ou nome do suspeito, com espaços
+        int tamanho = sessao->fase == FASE_CASO ? TAMANHO_NOME_CASO
+                    : sessao->fase == FASE_BUSCA ? TAMANHO_PREFIXO_BUSCA : TAMANHO_NOME_ACUSADO;
+        if (fgets(linha, tamanho, stdin) == NULL) {
+            responderSessao(saida, sessao, NULL);
+            continue;
+        }
+        linha[strcspn(linha, "\n")] = 0; // Remove quebra de linha
+        responderSessao(saida, sessao, linha);
+    }
+}
+
+/**
+ * Função: explorarSalas
+ * Propósito: Permitir a navegação interativa do jogador pela mansão com coleta de pistas
+ * (conduz uma SessaoJogo com as entradas lidas do terminal)
+ * Parâmetros: saida - destino das mensagens (prosa, eventos JSON ou nada)
+ *             salaAtual - ponteiro para a sala onde o jogador está
+ *             arvorePistas - ponteiro para ponteiro da raiz da árvore de pistas
+ *             tabela - ponteiro para a tabela hash de suspeitos
+ *             indice - índice de evidências por suspeito, atualizado a cada pista coletada
+ * Retorno: void
+ */
+void explorarSalas(SaidaJogo* saida, Sala* salaAtual, PistaNode** arvorePistas, TabelaHash* tabela,
+                   IndiceSuspeitos* indice) {
+    SessaoJogo sessao;
+    iniciarSessaoJogo(saida, &sessao, salaAtual, *arvorePistas, tabela, indice);
+    conduzirSessao(saida, &sessao);
+    *arvorePistas = sessao.caderno;
+}
+
+/**
+ * Função: exibirBoasVindas
+ * Propósito: Mostrar a apresentação do jogo antes da primeira sala
+ * Parâmetros: saida - destino das mensagens
+ * Retorno: void
+ */
+void exibirBoasVindas(SaidaJogo* saida) {
+    saidaTexto(saida, "=== BEM-VINDO AO DETECTIVE QUEST - NIVEL MESTRE ===\n"
+                      "Explore a mansao misteriosa, colete pistas e desvende quem e o culpado!\n"
+                      "Use 'e' para ir a esquerda, 'd' para direita e 's' para encerrar.\n"
+                      "As pistas serao associadas automaticamente aos suspeitos!\n"
+                      "No final, voce devera fazer uma acusacao baseada nas evidencias!\n");
+}
+
+/**
+ * Função: liberarMemoriaSalas
+ * Propósito: Liberar toda a memória alocada para a árvore de salas
+ * (árvores de arena não são tocadas: saem inteiras com liberarArena).
+ * Sem recursão nem pilha: rotações à direita trazem cada filho esquerdo para cima
+ * até a raiz não ter filho esquerdo, quando ela pode ser liberada
+ * Parâmetros: raiz - ponteiro para a raiz da árvore
+ *             arena - arena em que a árvore foi montada (NULL = nós alocados com malloc)
+ * Retorno: void
+ */
+void liberarMemoriaSalas(Sala* raiz, const Arena* arena) {
+    if (arena != NULL) return;
+    
+    while (raiz != NULL) {
+        if (raiz->esquerda != NULL) {
+            Sala* esquerda = raiz->esquerda;
+            raiz->esquerda = esquerda->direita;
+            esquerda->direita = raiz;
+            raiz = esquerda;
+        } else {
+            Sala* direita = raiz->direita;
+            liberarNo(raiz);
+            raiz = direita;
+        }
+    }
+}
+
+/**
+ * Função: liberarMemoriaPistas
+ * Propósito: Liberar toda a memória alocada para a árvore de pistas
+ * (árvores de arena não são tocadas: saem inteiras com liberarArena).
+ * Mesma técnica de liberarMemoriaSalas: rotações à direita, sem recursão nem pilha
+ * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas
+ *             arena - arena em que a árvore foi montada (NULL = nós alocados com malloc)
+ * Retorno: void
+ */
+void liberarMemoriaPistas(PistaNode* raiz, const Arena* arena) {
+    if (arena != NULL) return;
+    
+    while (raiz != NULL) {
+        if (raiz->esquerda != NULL) {
+            PistaNode* esquerda = raiz->esquerda;
+            raiz->esquerda = esquerda->direita;
+            esquerda->direita = raiz;
+            raiz = esquerda;
+        } else {
+            PistaNode* direita = raiz->direita;
+            liberarNo(raiz);
+            raiz = direita;
+        }
+    }
+}
+
+/**
+ * Função: liberarMemoriaHash
+ * Propósito: Liberar toda a memória alocada para a tabela hash
+ * (os nós ficam embutidos no vetor de posições; os textos pertencem à tabela de textos)
+ * Parâmetros: tabela - ponteiro para a tabela hash
+ * Retorno: void
+ */
+void liberarMemoriaHash(TabelaHash* tabela) {
+    if (tabela == NULL) return;
+    
+    free(tabela->entradas);
+    free(tabela->suspeitos);
+    free(tabela);
+}
+
+/**
+ * Função: tempoAtualSegundos
+ * Propósito: Ler um relógio monotônico de alta resolução (usado nos benchmarks)
+ * Retorno: instante atual em segundos
+ */
+double tempoAtualSegundos(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequencia, contador;
+    QueryPerformanceFrequency(&frequencia);
+    QueryPerformanceCounter(&contador);
+    return (double)contador.QuadPart / (double)frequencia.QuadPart;
+#else
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (double)agora.tv_sec + (double)agora.tv_nsec * 1e-9;
+#endif
+}
+
+/**
+ * Função: carregarRoteiroLote
+ * Propósito: Ler um roteiro de sessões para o modo em lote. Cada linha não vazia (que não
+ * comece com '#') é uma sessão: movimentos 'e'/'d', depois 's' e o nome do acusado,
+ * opcionalmente entre aspas. Os nomes são resolvidos para ids já internados
+ * Parâmetros: caminho - caminho do arquivo de roteiro
+ * Retorno: ponteiro para o roteiro ou NULL em caso de erro
+ */
+RoteiroLote* carregarRoteiroLote(const char* caminho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        printf("Erro: Nao foi possivel abrir o roteiro %s!\n", caminho);
+        return NULL;
+    }
+    fseek(arquivo, 0, SEEK_END);
+    long tamanho = ftell(arquivo);
+    fseek(arquivo, 0, SEEK_SET);
+    
+    RoteiroLote* roteiro = (RoteiroLote*)calloc(1, sizeof(RoteiroLote));
+    char* conteudo = tamanho >= 0 ? (char*)malloc((size_t)tamanho + 1) : NULL;
+    if (roteiro == NULL || conteudo == NULL || fread(conteudo, 1, (size_t)tamanho, arquivo) != (size_t)tamanho) {
+        printf("Erro: Falha ao ler o roteiro %s!\n", caminho);
+        free(roteiro);
+        free(conteudo);
+        fclose(arquivo);
+        return NULL;
+    }
+    fclose(arquivo);
+    conteudo[tamanho] = '\0';
+    roteiro->conteudo = conteudo;
+    
+    size_t capacidade = 0;
+    char* linha = conteudo;
+    while (linha != NULL && *linha != '\0') {
+        char* fimLinha = strchr(linha, '\n');
+        char* proxima = fimLinha != NULL ? fimLinha + 1 : NULL;
+        if (fimLinha != NULL) *fimLinha = '\0';
+        
+        size_t tamanhoLinha = strlen(linha);
+        while (tamanhoLinha > 0 && (linha[tamanhoLinha - 1] == '\r' || linha[tamanhoLinha - 1] == ' ' ||
+                                    linha[tamanhoLinha - 1] == '\t')) {
+            linha[--tamanhoLinha] = '\0';
+        }
+        while (*linha == ' ' || *linha == '\t') linha++;
+        
+        if (*linha != '\0' && *linha != '#') {
+            if (roteiro->numSessoes == capacidade) {
+                capacidade = capacidade == 0 ? 64 : capacidade * 2;
+                SessaoRoteiro* novas = (SessaoRoteiro*)realloc(roteiro->sessoes, capacidade * sizeof(SessaoRoteiro));
+                if (novas == NULL) {
+                    printf("Erro: Falha na alocação de memória para o roteiro!\n");
+                    free(roteiro->sessoes);
+                    free(conteudo);
+                    free(roteiro);
+                    return NULL;
+                }
+                roteiro->sessoes = novas;
+            }
+            
+            // Movimentos vão até o primeiro 's'; o restante da linha é o acusado
+            SessaoRoteiro* sessao = &roteiro->sessoes[roteiro->numSessoes++];
+            char* fimMovimentos = linha + strcspn(linha, "sS");
+            sessao->movimentos = linha;
+            sessao->numMovimentos = (size_t)(fimMovimentos - linha);
+            
+            char* acusado = *fimMovimentos != '\0' ? fimMovimentos + 1 : fimMovimentos;
+            while (*acusado == ' ' || *acusado == '\t') acusado++;
+            size_t tamanhoAcusado = strlen(acusado);
+            if (tamanhoAcusado >= 2 && acusado[0] == '"' && acusado[tamanhoAcusado - 1] == '"') {
+                acusado[tamanhoAcusado - 1] = '\0';
+                acusado++;
+            }
+            sessao->textoAcusado = acusado;
+            sessao->acusado = buscarIdTexto(acusado);
+        }
+        linha = proxima;
+    }
+    
+    return roteiro;
+}
+
+/**
+ * Função: liberarRoteiroLote
+ * Propósito: Liberar um roteiro de lote
+ * Parâmetros: roteiro - ponteiro para o roteiro
+ * Retorno: void
+ */
+void liberarRoteiroLote(RoteiroLote* roteiro) {
+    if (roteiro == NULL) return;
+    free(roteiro->sessoes);
+    free(roteiro->conteudo);
+    free(roteiro);
+}
+
+/**
+ * Função: mapearArquivo
+ * Propósito: Mapear um arquivo inteiro em memória somente leitura (mmap); em sistemas
+ * sem mmap o arquivo é lido para um buffer
+ * Parâmetros: caminho - caminho do arquivo
+ *             tamanho - saída: tamanho do arquivo em bytes
+ * Retorno: ponteiro para o conteúdo ou NULL em caso de erro
+ */
+void* mapearArquivo(const char* caminho, size_t* tamanho) {
+#ifdef _WIN32
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) return NULL;
+    fseek(arquivo, 0, SEEK_END);
+    long fim = ftell(arquivo);
+    fseek(arquivo, 0, SEEK_SET);
+    void* conteudo = fim > 0 ? malloc((size_t)fim) : NULL;
+    if (conteudo == NULL || fread(conteudo, 1, (size_t)fim, arquivo) != (size_t)fim) {
+        free(conteudo);
+        fclose(arquivo);
+        return NULL;
+    }
+    fclose(arquivo);
+    *tamanho = (size_t)fim;
+    return conteudo;
+#else
+    int descritor = open(caminho, O_RDONLY);
+    if (descritor < 0) return NULL;
+    
+    struct stat info;
+    if (fstat(descritor, &info) != 0 || info.st_size <= 0) {
+        close(descritor);
+        return NULL;
+    }
+    
+    void* conteudo = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, descritor, 0);
+    close(descritor);  // O mapeamento continua válido depois do close
+    if (conteudo == MAP_FAILED) return NULL;
+    
+    *tamanho = (size_t)info.st_size;
+    return conteudo;
+#endif
+}
+
+/**
+ * Função: desmapearArquivo
+ * Propósito: Desfazer um mapeamento criado por mapearArquivo
+ * Parâmetros: conteudo - ponteiro devolvido por mapearArquivo
+ *             tamanho - tamanho do mapeamento
+ * Retorno: void
+ */
+void desmapearArquivo(void* conteudo, size_t tamanho) {
+    if (conteudo == NULL) return;
+#ifdef _WIN32
+    (void)tamanho;
+    free(conteudo);
+#else
+    munmap(conteudo, tamanho);
+#endif
+}
+
+/**
+ * Função: compararSalasPorEndereco
+ * Propósito: Comparador de qsort para vetores de salas (ordem de endereço)
+ */
+static int compararSalasPorEndereco(const void* a, const void* b) {
+    uintptr_t salaA = (uintptr_t)*(Sala* const*)a;
+    uintptr_t salaB = (uintptr_t)*(Sala* const*)b;
+    return salaA < salaB ? -1 : salaA > salaB;
+}
+
+/**
+ * Função: liberarContextoSnapshot
+ * Propósito: Liberar um contexto de estados de sessões (a mansão não é afetada)
+ * Parâmetros: contexto - ponteiro para o contexto
+ * Retorno: void
+ */
+void liberarContextoSnapshot(ContextoSnapshot* contexto) {
+    if (contexto == NULL) return;
+    free(contexto->salas);
+    free(contexto->salasPorEndereco);
+    free(contexto->indicePorEndereco);
+    free(contexto->idPista);
+    free(contexto->bitDaPista);
+    free(contexto);
+}
+
+/**
+ * Função: criarContextoSnapshot
+ * Propósito: Numerar as salas (ordem de largura) e as pistas (ordem alfabética) de uma
+ * mansão montada; os números dependem só da mansão, não da ordem de internação dos textos,
+ * e a impressão digital impede retomar estados em outra mansão
+ * Parâmetros: hall - sala de entrada
+ * Retorno: ponteiro para o contexto ou NULL em caso de erro
+ */
+ContextoSnapshot* criarContextoSnapshot(Sala* hall) {
+    ContextoSnapshot* contexto = (ContextoSnapshot*)calloc(1, sizeof(ContextoSnapshot));
+    size_t capacidade = 1024, n = 0;
+    if (contexto == NULL || hall == NULL) {
+        free(contexto);
+        return NULL;
+    }
+    
+    // Salas em ordem de largura (mesma numeração de grafoDeSalas); a impressão digital
+    // combina forma, nomes e pistas
+    contexto->salas = (Sala**)malloc(capacidade * sizeof(Sala*));
+    if (contexto->salas != NULL) contexto->salas[n++] = hall;
+    uint64_t impressao = funcaoHash("DQSS");
+    for (size_t i = 0; i < n; i++) {
+        Sala* sala = contexto->salas[i];
+        if (n + 2 > capacidade) {
+            Sala** maior = (Sala**)realloc(contexto->salas, capacidade * 2 * sizeof(Sala*));
+            if (maior == NULL) {
+                n = 0;
+                break;
+            }
+            contexto->salas = maior;
+            capacidade *= 2;
+        }
+        if (sala->esquerda != NULL) contexto->salas[n++] = sala->esquerda;
+        if (sala->direita != NULL) contexto->salas[n++] = sala->direita;
+        impressao = (impressao ^ hashDoTexto(sala->nome)) * 1099511628211ULL;
+        impressao = (impressao ^ hashDoTexto(sala->pista)) * 1099511628211ULL;
+        impressao = (impressao ^ ((uint64_t)(sala->esquerda != NULL) << 1 | (sala->direita != NULL))) * 1099511628211ULL;
+    }
+    contexto->numSalas = n;
+    contexto->impressao = impressao;
+    contexto->numTextos = textosInternados.quantidade;
+    contexto->salasPorEndereco = (Sala**)malloc(n * sizeof(Sala*));
+    contexto->indicePorEndereco = (uint32_t*)malloc(n * sizeof(uint32_t));
+    contexto->idPista = (IdTexto*)malloc(n * sizeof(IdTexto));
+    contexto->bitDaPista = (uint32_t*)malloc(contexto->numTextos * sizeof(uint32_t));
+    if (n == 0 || n >= SALA_NENHUMA || contexto->salas == NULL || contexto->salasPorEndereco == NULL ||
+        contexto->indicePorEndereco == NULL || contexto->idPista == NULL || contexto->bitDaPista == NULL) {
+        printf("Erro: Falha na alocação de memória para os estados de sessoes!\n");
+        liberarContextoSnapshot(contexto);
+        return NULL;
+    }
+    
+    memcpy(contexto->salasPorEndereco, contexto->salas, n * sizeof(Sala*));
+    qsort(contexto->salasPorEndereco, n, sizeof(Sala*), compararSalasPorEndereco);
+    for (size_t i = 0; i < n; i++) {
+        Sala** encontrada = (Sala**)bsearch(&contexto->salas[i], contexto->salasPorEndereco, n, sizeof(Sala*),
+                                            compararSalasPorEndereco);
+        contexto->indicePorEndereco[encontrada - contexto->salasPorEndereco] = (uint32_t)i;
+    }
+    
+    // Pistas distintas da mansão em ordem alfabética
+    for (size_t t = 0; t < contexto->numTextos; t++) contexto->bitDaPista[t] = INDICE_NENHUM;
+    for (size_t i = 0; i < n; i++) {
+        IdTexto pista = contexto->salas[i]->pista;
+        if (pista != ID_TEXTO_VAZIO && contexto->bitDaPista[pista] == INDICE_NENHUM) {
+            contexto->bitDaPista[pista] = 0;
+            contexto->idPista[contexto->numPistas++] = pista;
+        }
+    }
+    qsort(contexto->idPista, contexto->numPistas, sizeof(IdTexto), compararIdsTexto);
+    for (size_t b = 0; b < contexto->numPistas; b++) {
+        contexto->bitDaPista[contexto->idPista[b]] = (uint32_t)b;
+    }
+    contexto->palavras = (contexto->numPistas + 63) / 64;
+    return contexto;
+}
+
+/**
+ * Função: indiceDaSala
+ * Propósito: Obter o índice (ordem de largura) de uma sala da mansão do contexto
+ * Parâmetros: contexto - ponteiro para o contexto
+ *             sala - sala da mansão
+ * Retorno: índice da sala ou SALA_NENHUMA se ela não pertence à mansão
+ */
+uint32_t indiceDaSala(const ContextoSnapshot* contexto, Sala* sala) {
+    Sala** encontrada = (Sala**)bsearch(&sala, contexto->salasPorEndereco, contexto->numSalas, sizeof(Sala*),
+                                        compararSalasPorEndereco);
+    return encontrada != NULL ? contexto->indicePorEndereco[encontrada - contexto->salasPorEndereco] : SALA_NENHUMA;
+}
+
+/**
+ * Função: bytesPorRegistroSessao
+ * Propósito: Tamanho de um RegistroSessao para as pistas de um contexto
+ * Parâmetros: contexto - ponteiro para o contexto
+ * Retorno: tamanho do registro em bytes (múltiplo de 8)
+ */
+size_t bytesPorRegistroSessao(const ContextoSnapshot* contexto) {
+    return sizeof(RegistroSessao) + contexto->palavras * sizeof(uint64_t);
+}
+
+/**
+ * Função: criarSnapshotSessoes
+ * Propósito: Alocar a imagem de uma população de estados (cabeçalho preenchido e todas
+ * as sessões no hall, sem pistas)
+ * Parâmetros: contexto - ponteiro para o contexto da mansão
+ *             numSessoes - quantidade de sessões
+ * Retorno: ponteiro para a população ou NULL em caso de erro
+ */
+SnapshotSessoes* criarSnapshotSessoes(const ContextoSnapshot* contexto, size_t numSessoes) {
+    size_t bytesPorSessao = bytesPorRegistroSessao(contexto);
+    SnapshotSessoes* snapshot = (SnapshotSessoes*)calloc(1, sizeof(SnapshotSessoes));
+    if (snapshot == NULL || numSessoes > (SIZE_MAX - sizeof(CabecalhoSnapshot)) / bytesPorSessao) {
+        printf("Erro: Falha na alocação de memória para os estados de sessoes!\n");
+        free(snapshot);
+        return NULL;
+    }
+    
+    snapshot->tamanho = sizeof(CabecalhoSnapshot) + numSessoes * bytesPorSessao;
+    snapshot->cabecalho = (CabecalhoSnapshot*)calloc(1, snapshot->tamanho);
+    if (snapshot->cabecalho == NULL) {
+        printf("Erro: Falha na alocação de memória para os estados de sessoes!\n");
+        free(snapshot);
+        return NULL;
+    }
+    memcpy(snapshot->cabecalho->magica, "DQSS", 4);
+    snapshot->cabecalho->versao = VERSAO_SNAPSHOT;
+    snapshot->cabecalho->impressao = contexto->impressao;
+    snapshot->cabecalho->numSessoes = numSessoes;
+    snapshot->cabecalho->numSalas = (uint32_t)contexto->numSalas;
+    snapshot->cabecalho->numPistas = (uint32_t)contexto->numPistas;
+    snapshot->cabecalho->bytesPorSessao = (uint32_t)bytesPorSessao;
+    snapshot->registros = (unsigned char*)(snapshot->cabecalho + 1);
+    return snapshot;
+}
+
+/**
+ * Função: registroDoSnapshot
+ * Propósito: Acessar o registro de uma sessão dentro da imagem
+ * Parâmetros: snapshot - ponteiro para a população
+ *             sessao - número da sessão
+ * Retorno: ponteiro para o registro (NULL se a sessão não existe)
+ */
+RegistroSessao* registroDoSnapshot(const SnapshotSessoes* snapshot, size_t sessao) {
+    if (snapshot == NULL || sessao >= snapshot->cabecalho->numSessoes) return NULL;
+    return (RegistroSessao*)(snapshot->registros + sessao * snapshot->cabecalho->bytesPorSessao);
+}
+
+/**
+ * Função: capturarSessao
+ * Propósito: Gravar o estado de uma sessão em andamento em um registro
+ * Parâmetros: contexto - ponteiro para o contexto da mansão
+ *             registro - registro de destino
+ *             salaAtual - sala onde o jogador está
+ *             caderno - árvore de pistas coletadas
+ *             movimentos - movimentos já consumidos
+ *             movimentosInvalidos - movimentos inválidos até agora
+ * Retorno: 1 em caso de sucesso, 0 se a sala não pertence à mansão do contexto ou faltou
+ * memória para percorrer o caderno
+ */
+int capturarSessao(const ContextoSnapshot* contexto, RegistroSessao* registro, Sala* salaAtual,
+                   PistaNode* caderno, uint32_t movimentos, uint32_t movimentosInvalidos) {
+    uint32_t sala = indiceDaSala(contexto, salaAtual);
+    if (sala == SALA_NENHUMA) return 0;
+    
+    registro->sala = sala;
+    registro->movimentos = movimentos;
+    registro->movimentosInvalidos = movimentosInvalidos;
+    registro->reservado = 0;
+    memset(registro->pistas, 0, contexto->palavras * sizeof(uint64_t));
+    
+    // Pistas que não existem na mansão (não há como coletá-las nela) não têm bit
+    IteradorPistas iterador;
+    iniciarIteradorPistas(&iterador, caderno);
+    for (PistaNode* no = proximaPista(&iterador); no != NULL; no = proximaPista(&iterador)) {
+        uint32_t bit = no->conteudo < contexto->numTextos ? contexto->bitDaPista[no->conteudo] : INDICE_NENHUM;
+        if (bit != INDICE_NENHUM) registro->pistas[bit / 64] |= (uint64_t)1 << (bit % 64);
+    }
+    finalizarIteradorPistas(&iterador);
+    return !iterador.erro;
+}
+
+/**
+ * Função: restaurarLotePistas
+ * Propósito: Levar um lote de pistas (em ordem alfabética) ao caderno e, se ele entrou, ao
+ * índice de evidências, para que os dois nunca divirjam
+ * Parâmetros: pistas - ids das pistas do lote
+ *             numPistas - tamanho do lote
+ *             caderno - caderno de destino
+ *             tabela - tabela hash de suspeitos
+ *             indice - índice de evidências de destino
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória
+ */
+static int restaurarLotePistas(const IdTexto* pistas, size_t numPistas, PistaNode** caderno,
+                               TabelaHash* tabela, IndiceSuspeitos* indice) {
+    if (!inserirPistasEmLote(caderno, pistas, numPistas)) return 0;
+    for (size_t i = 0; i < numPistas; i++) {
+        IdTexto suspeito = encontrarSuspeitoPorId(tabela, pistas[i]);
+        if (suspeito != ID_TEXTO_INVALIDO && !registrarPistaSuspeito(indice, suspeito, pistas[i])) return 0;
+    }
+    return 1;
+}
+
+/**
+ * Função: restaurarSessao
+ * Propósito: Reconstruir o caderno e o índice de evidências de uma sessão a partir de um
+ * registro (os bits saem em ordem alfabética, então o caderno é montado em lote, já
+ * balanceado; as pistas de cada lote entram no índice nessa mesma ordem, só depois de
+ * entrarem no caderno)
+ * Parâmetros: contexto - ponteiro para o contexto da mansão
+ *             registro - registro de origem
+ *             caderno - caderno de destino (normalmente vazio)
+ *             tabela - tabela hash de suspeitos
+ *             indice - índice de evidências de destino
+ * Retorno: sala atual da sessão ou NULL se o registro é inválido para esta mansão ou faltou memória
+ */
+Sala* restaurarSessao(const ContextoSnapshot* contexto, const RegistroSessao* registro, PistaNode** caderno,
+                      TabelaHash* tabela, IndiceSuspeitos* indice) {
+    if (registro->sala >= contexto->numSalas) return NULL;
+    
+    IdTexto pistas[PISTAS_POR_LOTE_RESTAURACAO];
+    size_t numPistas = 0;
+    for (size_t palavra = 0; palavra < contexto->palavras; palavra++) {
+        uint64_t bits = registro->pistas[palavra];
+        for (size_t bit = palavra * 64; bits != 0; bit++, bits >>= 1) {
+            if (!(bits & 1)) continue;
+            if (bit >= contexto->numPistas) return NULL;  // Bit além das pistas da mansão
+            
+            pistas[numPistas++] = contexto->idPista[bit];
+            if (numPistas == PISTAS_POR_LOTE_RESTAURACAO) {
+                if (!restaurarLotePistas(pistas, numPistas, caderno, tabela, indice)) return NULL;
+                numPistas = 0;
+            }
+        }
+    }
+    if (numPistas > 0 && !restaurarLotePistas(pistas, numPistas, caderno, tabela, indice)) return NULL;
+    return contexto->salas[registro->sala];
+}
+
+/**
+ * Função: liberarSnapshotSessoes
+ * Propósito: Liberar uma população de estados (alocada ou mapeada)
+ * Parâmetros: snapshot - ponteiro para a população
+ * Retorno: void
+ */
+void liberarSnapshotSessoes(SnapshotSessoes* snapshot) {
+    if (snapshot == NULL) return;
+    if (snapshot->mapeado) {
+        desmapearArquivo(snapshot->cabecalho, snapshot->tamanho);
+    } else {
+        free(snapshot->cabecalho);
+    }
+    free(snapshot);
+}
+
+/**
+ * Função: salvarSnapshotSessoes
+ * Propósito: Gravar uma população de estados: a imagem em memória já está no formato do
+ * arquivo, então é uma única escrita, sem conversão de registros
+ * Parâmetros: snapshot - ponteiro para a população
+ *             caminho - caminho do arquivo .dqs
+ * Retorno: 1 em caso de sucesso, 0 em caso de erro
+ */
+int salvarSnapshotSessoes(const SnapshotSessoes* snapshot, const char* caminho) {
+    FILE* arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        printf("Erro: Nao foi possivel criar %s!\n", caminho);
+        return 0;
+    }
+    
+    int ok = fwrite(snapshot->cabecalho, 1, snapshot->tamanho, arquivo) == snapshot->tamanho;
+    ok = fclose(arquivo) == 0 && ok;
+    if (!ok) {
+        printf("Erro: Falha ao gravar %s!\n", caminho);
+    }
+    return ok;
+}
+
+/**
+ * Função: abrirSnapshotSessoes
+ * Propósito: Mapear em memória um arquivo de estados e validá-lo contra a mansão atual;
+ * os registros são usados direto do mapeamento, sem cópia
+ * Parâmetros: contexto - ponteiro para o contexto da mansão
+ *             caminho - caminho do arquivo .dqs
+ * Retorno: ponteiro para a população (somente leitura) ou NULL em caso de erro
+ */
+SnapshotSessoes* abrirSnapshotSessoes(const ContextoSnapshot* contexto, const char* caminho) {
+    size_t tamanho = 0;
+    unsigned char* conteudo = (unsigned char*)mapearArquivo(caminho, &tamanho);
+    if (conteudo == NULL) {
+        printf("Erro: Nao foi possivel abrir os estados %s!\n", caminho);
+        return NULL;
+    }
+    
+    CabecalhoSnapshot cabecalho;
+    if (tamanho < sizeof(cabecalho)) {
+        printf("Erro: Arquivo de estados %s truncado!\n", caminho);
+        desmapearArquivo(conteudo, tamanho);
+        return NULL;
+    }
+    memcpy(&cabecalho, conteudo, sizeof(cabecalho));
+    
+    uint64_t esperado = sizeof(cabecalho) + cabecalho.numSessoes * cabecalho.bytesPorSessao;
+    if (memcmp(cabecalho.magica, "DQSS", 4) != 0 || cabecalho.versao != VERSAO_SNAPSHOT ||
+        cabecalho.bytesPorSessao != bytesPorRegistroSessao(contexto) ||
+        cabecalho.numSessoes > tamanho / cabecalho.bytesPorSessao || esperado != tamanho) {
+        printf("Erro: Arquivo de estados %s invalido!\n", caminho);
+        desmapearArquivo(conteudo, tamanho);
+        return NULL;
+    }
+    if (cabecalho.impressao != contexto->impressao || cabecalho.numSalas != contexto->numSalas ||
+        cabecalho.numPistas != contexto->numPistas) {
+        printf("Erro: Os estados %s pertencem a outra mansao!\n", caminho);
+        desmapearArquivo(conteudo, tamanho);
+        return NULL;
+    }
+    
+    SnapshotSessoes* snapshot = (SnapshotSessoes*)calloc(1, sizeof(SnapshotSessoes));
+    if (snapshot == NULL) {
+        desmapearArquivo(conteudo, tamanho);
+        return NULL;
+    }
+    snapshot->cabecalho = (CabecalhoSnapshot*)conteudo;
+    snapshot->registros = conteudo + sizeof(cabecalho);
+    snapshot->tamanho = tamanho;
+    snapshot->mapeado = 1;
+    return snapshot;
+}
+
+/**
+ * Função: executarSessao
+ * Propósito: Executar uma sessão completa sem interação (mesmas regras de explorarSalas
+ * e verificarSuspeitoFinal, sem nenhuma saída)
+ * Parâmetros: hall - sala de entrada da mansão compartilhada
+ *             tabela - tabela hash de suspeitos compartilhada (apenas leitura)
+ *             sessao - movimentos e acusação da sessão
+ *             arena - arena própria para o caderno da sessão (reiniciada a cada sessão)
+ *             indice - índice de evidências reaproveitado entre sessões
+ *             resultado - saída: resultado compacto da sessão
+ *             contexto - índices da mansão para os estados (NULL se não houver estados)
+ *             retomada - estado de onde a sessão continua (NULL: começa no hall)
+ *             estadoFinal - saída: estado da sessão antes da acusação (ou NULL)
+ * Retorno: void
+ */
+void executarSessao(Sala* hall, TabelaHash* tabela, const SessaoRoteiro* sessao, Arena* arena,
+                    IndiceSuspeitos* indice, ResultadoSessao* resultado, const ContextoSnapshot* contexto,
+                    const RegistroSessao* retomada, RegistroSessao* estadoFinal) {
+    Arena* anterior = usarArena(arena);
+    reiniciarArena(arena);
+    limparIndiceSuspeitos(indice);
+    
+    PistaNode* caderno = NULL;
+    Sala* salaAtual = NULL;
+    IdTexto suspeito;
+    uint32_t movimentos = 0;
+    memset(resultado, 0, sizeof(ResultadoSessao));
+    
+    if (retomada != NULL) {
+        salaAtual = restaurarSessao(contexto, retomada, &caderno, tabela, indice);
+    }
+    if (salaAtual != NULL) {
+        // O caderno restaurado já contém a pista da sala atual
+        movimentos = retomada->movimentos;
+        resultado->movimentosInvalidos = (int)retomada->movimentosInvalidos;
+        for (size_t palavra = 0; palavra < contexto->palavras; palavra++) {
+            for (uint64_t bits = retomada->pistas[palavra]; bits != 0; bits &= bits - 1) {
+                resultado->pistasColetadas++;
+            }
+        }
+    } else {
+        // Sem estado (ou com um registro inválido) a sessão começa do zero
+        reiniciarArena(arena);
+        limparIndiceSuspeitos(indice);
+        caderno = NULL;
+        salaAtual = hall;
+        resultado->pistasColetadas += coletarPistaDaSala(salaAtual, &caderno, tabela, indice, &suspeito);
+    }
+    for (size_t i = 0; i < sessao->numMovimentos; i++) {
+        char movimento = sessao->movimentos[i];
+        Sala* destino = NULL;
+        
+        if (movimento == ' ' || movimento == '\t') continue;
+        movimentos++;
+        if (movimento == 'e' || movimento == 'E') {
+            destino = salaAtual->esquerda;
+        } else if (movimento == 'd' || movimento == 'D') {
+            destino = salaAtual->direita;
+        }
+        
+        if (destino == NULL) {
+            resultado->movimentosInvalidos++;
+            continue;
+        }
+        salaAtual = destino;
+        resultado->pistasColetadas += coletarPistaDaSala(salaAtual, &caderno, tabela, indice, &suspeito);
+    }
+    
+    if (estadoFinal != NULL) {
+        capturarSessao(contexto, estadoFinal, salaAtual, caderno, movimentos, (uint32_t)resultado->movimentosInvalidos);
+    }
+    
+    FichaSuspeito* ficha = buscarFichaSuspeitoPorId(indice, sessao->acusado);
+    resultado->salaFinal = salaAtual->nome;
+    resultado->evidencias = ficha != NULL ? ficha->contagem : 0;
+    resultado->resolvido = resultado->evidencias >= PISTAS_PARA_CONDENACAO;
+    
+    usarArena(anterior);
+}
+
+/**
+ * Função: numeroDeNucleos
+ * Propósito: Consultar quantos processadores estão disponíveis
+ * Parâmetros: nenhum
+ * Retorno: número de processadores (pelo menos 1)
+ */
+int numeroDeNucleos(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long nucleos = sysconf(_SC_NPROCESSORS_ONLN);
+    return nucleos > 0 ? (int)nucleos : 1;
+#endif
+}
+
+/**
+ * Função: retirarFatia
+ * Propósito: Retirar atomicamente a próxima fatia de sessões de uma faixa de trabalho
+ * (usada tanto pela thread dona quanto pelas que roubam trabalho)
+ * Parâmetros: faixa - faixa de trabalho
+ *             tamanhoFatia - quantidade máxima de itens retirados
+ *             inicio, fim - saída: intervalo de itens retirado
+ * Retorno: 1 se uma fatia foi retirada, 0 se a faixa já está vazia
+ */
+static int retirarFatia(FaixaTrabalho* faixa, size_t tamanhoFatia, size_t* inicio, size_t* fim) {
+    if (atomic_load_explicit(&faixa->proximo, memory_order_relaxed) >= faixa->fim) return 0;
+    
+    size_t primeiro = atomic_fetch_add_explicit(&faixa->proximo, tamanhoFatia, memory_order_relaxed);
+    if (primeiro >= faixa->fim) return 0;
+    *inicio = primeiro;
+    *fim = primeiro + tamanhoFatia < faixa->fim ? primeiro + tamanhoFatia : faixa->fim;
+    return 1;
+}
+
+/**
+ * Função: dividirEmFaixas
+ * Propósito: Dividir itens [0, total) em faixas contíguas de mesmo tamanho, uma por thread
+ * Parâmetros: faixas - vetor com uma faixa por thread
+ *             numThreads - quantidade de threads
+ *             total - quantidade de itens
+ * Retorno: void
+ */
+static void dividirEmFaixas(FaixaTrabalho* faixas, int numThreads, size_t total) {
+    for (int t = 0; t < numThreads; t++) {
+        atomic_init(&faixas[t].proximo, total * (size_t)t / (size_t)numThreads);
+        faixas[t].fim = total * (size_t)(t + 1) / (size_t)numThreads;
+    }
+}
+
+/**
+ * Função: executarEmThreads
+ * Propósito: Executar a mesma função em várias threads e esperar todas terminarem
+ * (a thread atual executa o argumento 0); sem pthreads, as execuções são sequenciais
+ * Parâmetros: numThreads - quantidade de threads (até MAX_THREADS_LOTE)
+ *             corpo - função executada por cada thread
+ *             argumentos - vetor com um argumento por thread
+ *             tamanhoArgumento - tamanho de cada elemento do vetor de argumentos
+ * Retorno: void
+ */
+static void executarEmThreads(int numThreads, void* (*corpo)(void*), void* argumentos, size_t tamanhoArgumento) {
+    char* base = (char*)argumentos;
+#ifdef _WIN32
+    for (int t = 0; t < numThreads; t++) {
+        corpo(base + (size_t)t * tamanhoArgumento);
+    }
+#else
+    pthread_t threads[MAX_THREADS_LOTE];
+    int criadas[MAX_THREADS_LOTE] = { 0 };
+    for (int t = 1; t < numThreads; t++) {
+        criadas[t] = pthread_create(&threads[t], NULL, corpo, base + (size_t)t * tamanhoArgumento) == 0;
+    }
+    corpo(base);
+    // Uma thread que não pôde ser criada tem sua faixa roubada pelas demais
+    for (int t = 1; t < numThreads; t++) {
+        if (criadas[t]) pthread_join(threads[t], NULL);
+    }
+#endif
+}
+
+/**
+ * Função: trabalharLote
+ * Propósito: Corpo de uma thread do lote paralelo: esvazia a própria faixa e depois
+ * rouba fatias das faixas das outras threads até não restar trabalho
+ * Parâmetros: argumento - ponteiro para o TrabalhadorLote da thread
+ * Retorno: NULL
+ */
+static void* trabalharLote(void* argumento) {
+    TrabalhadorLote* trabalhador = (TrabalhadorLote*)argumento;
+    ExecucaoLote* execucao = trabalhador->execucao;
+    
+    // Caderno e índice de cada thread: nada é escrito na memória compartilhada
+    Arena* arena = criarArena(64 * 1024);
+    IndiceSuspeitos* indice = criarIndiceSuspeitos();
+    if (arena == NULL || indice == NULL) {
+        // As faixas desta thread serão roubadas pelas demais
+        liberarArena(arena);
+        liberarIndiceSuspeitos(indice);
+        return NULL;
+    }
+    
+    ResultadoSessao local;
+    size_t inicio, fim;
+    for (int passo = 0; passo < execucao->numThreads; passo++) {
+        FaixaTrabalho* faixa = &execucao->faixas[(trabalhador->id + passo) % execucao->numThreads];
+        while (retirarFatia(faixa, TAMANHO_FATIA_LOTE, &inicio, &fim)) {
+            for (size_t g = inicio; g < fim; g++) {
+                ResultadoSessao* resultado = execucao->resultados != NULL ? &execucao->resultados[g] : &local;
+                executarSessao(execucao->hall, execucao->tabela, &execucao->sessoes[g % execucao->numSessoes],
+                               arena, indice, resultado, execucao->contexto, registroDoSnapshot(execucao->retomar, g),
+                               registroDoSnapshot(execucao->salvar, g));
+                trabalhador->resolvidas += resultado->resolvido;
+            }
+            trabalhador->executadas += fim - inicio;
+            if (passo > 0) trabalhador->fatiasRoubadas++;
+        }
+    }
+    
+    liberarArena(arena);
+    liberarIndiceSuspeitos(indice);
+    return NULL;
+}
+
+/**
+ * Função: executarLoteParalelo
+ * Propósito: Executar as sessões de uma ExecucaoLote em várias threads, com faixas
+ * iguais por thread e roubo de trabalho entre elas; sem travas no caminho das consultas
+ * Parâmetros: execucao - descrição da execução (os totais de saída são preenchidos)
+ * Retorno: 1 em caso de sucesso, 0 em caso de erro
+ */
+int executarLoteParalelo(ExecucaoLote* execucao) {
+    int numThreads = execucao->numThreads;
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > MAX_THREADS_LOTE) numThreads = MAX_THREADS_LOTE;
+    execucao->numThreads = numThreads;
+    
+    FaixaTrabalho* faixas = (FaixaTrabalho*)calloc((size_t)numThreads, sizeof(FaixaTrabalho));
+    TrabalhadorLote* trabalhadores = (TrabalhadorLote*)calloc((size_t)numThreads, sizeof(TrabalhadorLote));
+    if (faixas == NULL || trabalhadores == NULL) {
+        printf("Erro: Falha na alocação de memória para o lote paralelo!\n");
+        free(faixas);
+        free(trabalhadores);
+        return 0;
+    }
+    
+    // Faixas contíguas de mesmo tamanho; o roubo compensa threads mais lentas
+    dividirEmFaixas(faixas, numThreads, execucao->totalSessoes);
+    for (int t = 0; t < numThreads; t++) {
+        trabalhadores[t].execucao = execucao;
+        trabalhadores[t].id = t;
+    }
+    execucao->faixas = faixas;
+    
+    double inicio = tempoAtualSegundos();
+    executarEmThreads(numThreads, trabalharLote, trabalhadores, sizeof(TrabalhadorLote));
+    execucao->tempo = tempoAtualSegundos() - inicio;
+    
+    execucao->executadas = execucao->resolvidas = execucao->fatiasRoubadas = 0;
+    for (int t = 0; t < numThreads; t++) {
+        execucao->executadas += trabalhadores[t].executadas;
+        execucao->resolvidas += trabalhadores[t].resolvidas;
+        execucao->fatiasRoubadas += trabalhadores[t].fatiasRoubadas;
+    }
+    execucao->faixas = NULL;
+    free(faixas);
+    free(trabalhadores);
+    
+    if (execucao->executadas != execucao->totalSessoes) {
+        printf("Erro: Apenas %zu de %zu sessoes foram executadas!\n", execucao->executadas, execucao->totalSessoes);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Função: executarLote
+ * Propósito: Executar todas as sessões de um roteiro (repetidas quantas vezes pedido) sobre
+ * a mesma mansão e tabela de suspeitos, distribuídas entre threads, emitindo um registro
+ * compacto por sessão (na ordem do roteiro, em buffer grande) e a vazão em sessões/segundo
+ * Parâmetros: caminho - arquivo de roteiro
+ *             hall - sala de entrada da mansão
+ *             tabela - tabela hash de suspeitos
+ *             repeticoes - quantas vezes o roteiro inteiro é executado
+ *             numThreads - threads de trabalho
+ *             saida - destino dos registros por sessão (TSV no modo texto, um evento "sessao"
+ *                     por linha no modo de eventos, nada no modo SAIDA_NENHUMA)
+ *             caminhoRetomar - arquivo de estados de onde as sessões continuam (ou NULL)
+ *             caminhoSalvar - arquivo onde o estado de cada sessão é gravado antes da
+ *                             acusação (ou NULL)
+ * Retorno: 0 em caso de sucesso, 1 em caso de erro
+ */
+int executarLote(const char* caminho, Sala* hall, TabelaHash* tabela, size_t repeticoes, int numThreads,
+                 SaidaJogo* saida, const char* caminhoRetomar, const char* caminhoSalvar) {
+    RoteiroLote* roteiro = carregarRoteiroLote(caminho);
+    if (roteiro == NULL) return 1;
+    
+    ExecucaoLote execucao;
+    memset(&execucao, 0, sizeof(ExecucaoLote));
+    execucao.hall = hall;
+    execucao.tabela = tabela;
+    execucao.sessoes = roteiro->sessoes;
+    execucao.numSessoes = roteiro->numSessoes;
+    execucao.totalSessoes = roteiro->numSessoes * repeticoes;
+    execucao.numThreads = numThreads;
+    
+    // Estados de sessões: a sessão g continua do registro g (se houver) e grava o seu
+    // estado no registro g, cada thread escrevendo apenas os registros das suas sessões
+    ContextoSnapshot* contexto = NULL;
+    SnapshotSessoes* retomar = NULL;
+    SnapshotSessoes* salvar = NULL;
+    if (caminhoRetomar != NULL || caminhoSalvar != NULL) {
+        contexto = criarContextoSnapshot(hall);
+        if (contexto != NULL && caminhoRetomar != NULL) retomar = abrirSnapshotSessoes(contexto, caminhoRetomar);
+        if (contexto != NULL && caminhoSalvar != NULL) salvar = criarSnapshotSessoes(contexto, execucao.totalSessoes);
+        if (contexto == NULL || (caminhoRetomar != NULL && retomar == NULL) || (caminhoSalvar != NULL && salvar == NULL)) {
+            liberarSnapshotSessoes(retomar);
+            liberarSnapshotSessoes(salvar);
+            liberarContextoSnapshot(contexto);
+            liberarRoteiroLote(roteiro);
+            return 1;
+        }
+        execucao.contexto = contexto;
+        execucao.retomar = retomar;
+        execucao.salvar = salvar;
+    }
+    
+    // Os registros só são guardados quando serão impressos
+    if (saida->modo != SAIDA_NENHUMA && execucao.totalSessoes > 0) {
+        execucao.resultados = (ResultadoSessao*)malloc(execucao.totalSessoes * sizeof(ResultadoSessao));
+        if (execucao.resultados == NULL) {
+            printf("Erro: Falha na alocação de memória para os resultados do lote!\n");
+            liberarSnapshotSessoes(retomar);
+            liberarSnapshotSessoes(salvar);
+            liberarContextoSnapshot(contexto);
+            liberarRoteiroLote(roteiro);
+            return 1;
+        }
+    }
+    
+    int ok = executarLoteParalelo(&execucao);
+    if (ok && salvar != NULL) {
+        ok = salvarSnapshotSessoes(salvar, caminhoSalvar);
+    }
+    liberarSnapshotSessoes(retomar);
+    liberarSnapshotSessoes(salvar);
+    liberarContextoSnapshot(contexto);
+    if (!ok) {
+        free(execucao.resultados);
+        liberarRoteiroLote(roteiro);
+        return 1;
+    }
+    
+    // Registros por sessão montados direto no buffer da saída, sem formatação de printf
+    saidaTexto(saida, "# sessao\tsala_final\tpistas\tinvalidos\tacusado\tevidencias\tveredicto\n");
+    for (size_t g = 0; g < execucao.totalSessoes && saida->modo != SAIDA_NENHUMA; g++) {
+        const ResultadoSessao* resultado = &execucao.resultados[g];
+        const char* acusado = roteiro->sessoes[g % roteiro->numSessoes].textoAcusado;
+        const char* veredicto = resultado->resolvido ? "RESOLVIDO" : "ABERTO";
+        if (saida->modo == SAIDA_EVENTOS) {
+            abrirEvento(saida, "sessao");
+            campoNumeroEvento(saida, "sessao", (long long)g);
+            campoTextoEvento(saida, "sala_final", textoDoId(resultado->salaFinal));
+            campoNumeroEvento(saida, "pistas", resultado->pistasColetadas);
+            campoNumeroEvento(saida, "invalidos", resultado->movimentosInvalidos);
+            campoTextoEvento(saida, "acusado", acusado);
+            campoNumeroEvento(saida, "evidencias", resultado->evidencias);
+            campoTextoEvento(saida, "veredicto", veredicto);
+            fecharEvento(saida);
+            continue;
+        }
+        escreverInteiroSaida(saida, (long long)g);
+        escreverNaSaida(saida, "\t", 1);
+        saidaTexto(saida, textoDoId(resultado->salaFinal));
+        escreverNaSaida(saida, "\t", 1);
+        escreverInteiroSaida(saida, resultado->pistasColetadas);
+        escreverNaSaida(saida, "\t", 1);
+        escreverInteiroSaida(saida, resultado->movimentosInvalidos);
+        escreverNaSaida(saida, "\t", 1);
+        saidaTexto(saida, acusado);
+        escreverNaSaida(saida, "\t", 1);
+        escreverInteiroSaida(saida, resultado->evidencias);
+        escreverNaSaida(saida, "\t", 1);
+        saidaTexto(saida, veredicto);
+        escreverNaSaida(saida, "\n", 1);
+    }
+    if (saida->modo != SAIDA_NENHUMA) descarregarSaida(saida);
+    
+    fprintf(stderr, "Lote: %zu sessoes em %.3f s (%.0f sessoes/s, %d threads, %zu fatias roubadas), %zu resolvidas\n",
+            execucao.executadas, execucao.tempo, execucao.tempo > 0 ? execucao.executadas / execucao.tempo : 0.0,
+            execucao.numThreads, execucao.fatiasRoubadas, execucao.resolvidas);
+    
+    free(execucao.resultados);
+    liberarRoteiroLote(roteiro);
+    return 0;
+}
+
+#ifdef DQ_EPOLL
+static volatile sig_atomic_t servidorAtivo = 1;  // Zerado por SIGINT/SIGTERM
+
+/**
+ * Estrutura que representa o leitor de casos do servidor: threads que leem e validam os
+ * mapas pedidos, para que o epoll nunca espere pelo disco (e um mapa lento não atrase a
+ * leitura dos outros). A montagem do caso (textos internados, salas e tabela) continua na
+ * thread do servidor, dona do acervo
+ */
+typedef struct LeitorCasos {
+    AcervoCasos* acervo;        // Acervo dos casos lidos
+    pthread_t threads[THREADS_LEITOR_CASOS];
+    int numThreads;             // Threads iniciadas
+    pthread_mutex_t trava;      // Protege as filas e o pedido de encerramento
+    pthread_cond_t pedido;      // Sinaliza um caso novo na fila (ou o encerramento)
+    CasoAcervo** fila;          // Casos a ler, em anel (um caso aparece no máximo uma vez)
+    size_t inicioFila;
+    size_t numFila;
+    CasoAcervo** lidos;         // Casos com a leitura terminada, à espera da thread do servidor
+    size_t numLidos;
+    int aviso;                  // eventfd que acorda o epoll a cada caso lido
+    int encerrar;               // 1 quando as threads devem terminar
+} LeitorCasos;
+
+/**
+ * Função: pararServidor
+ * Propósito: Tratador de SIGINT/SIGTERM: pede ao laço do servidor que termine
+ * Parâmetros: sinal - sinal recebido
+ * Retorno: void
+ */
+static void pararServidor(int sinal) {
+    (void)sinal;
+    servidorAtivo = 0;
+}
+
+/**
+ * Função: ampliarLimiteDescritores
+ * Propósito: Subir o limite de arquivos abertos até o máximo permitido ao processo
+ * (milhares de conexões simultâneas passam do limite padrão de 1024)
+ * Parâmetros: nenhum
+ * Retorno: void
+ */
+static void ampliarLimiteDescritores(void) {
+    struct rlimit limite;
+    if (getrlimit(RLIMIT_NOFILE, &limite) == 0 && limite.rlim_cur < limite.rlim_max) {
+        limite.rlim_cur = limite.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limite);
+    }
+}
+
+/**
+ * Função: tornarNaoBloqueante
+ * Propósito: Colocar um descritor em modo não bloqueante
+ * Parâmetros: fd - descritor
+ * Retorno: 1 em caso de sucesso, 0 em caso de erro
+ */
+static int tornarNaoBloqueante(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * Função: corpoLeitorCasos
+ * Propósito: Thread do leitor de casos: lê os mapas da fila, na ordem dos pedidos, e avisa
+ * o epoll de cada um (várias threads tiram da mesma fila). Só o disco e a validação do
+ * mapa rodam aqui; nada do que a thread do servidor usa (acervo, textos internados,
+ * arenas) é tocado
+ * Parâmetros: argumento - ponteiro para o LeitorCasos
+ * Retorno: NULL
+ */
+static void* corpoLeitorCasos(void* argumento) {
+    LeitorCasos* leitor = (LeitorCasos*)argumento;
+    pthread_mutex_lock(&leitor->trava);
+    for (;;) {
+        while (leitor->numFila == 0 && !leitor->encerrar) pthread_cond_wait(&leitor->pedido, &leitor->trava);
+        if (leitor->encerrar) break;
+        CasoAcervo* caso = leitor->fila[leitor->inicioFila];
+        leitor->inicioFila = (leitor->inicioFila + 1) % leitor->acervo->numCasos;
+        leitor->numFila--;
+        pthread_mutex_unlock(&leitor->trava);
+        
+        MapaMansao* mapa = leitor->acervo->lerMapa(caso->caminho);
+        
+        pthread_mutex_lock(&leitor->trava);
+        caso->mapaLido = mapa;
+        leitor->lidos[leitor->numLidos++] = caso;
+        uint64_t um = 1;
+        ssize_t escritos = write(leitor->aviso, &um, sizeof(um));
+        (void)escritos;  // Só falharia com o contador cheio, e o epoll já estaria acordado
+    }
+    pthread_mutex_unlock(&leitor->trava);
+    return NULL;
+}
+
+/**
+ * Função: liberarLeitorCasos
+ * Propósito: Encerrar as threads do leitor e liberar o leitor. Pedidos ainda na fila voltam
+ * a ser lidos ao abrir o caso; leituras terminadas ficam prontas no caso
+ * Parâmetros: leitor - ponteiro para o leitor
+ * Retorno: void
+ */
+static void liberarLeitorCasos(LeitorCasos* leitor) {
+    if (leitor == NULL) return;
+    
+    pthread_mutex_lock(&leitor->trava);
+    leitor->encerrar = 1;
+    pthread_cond_broadcast(&leitor->pedido);
+    pthread_mutex_unlock(&leitor->trava);
+    for (int t = 0; t < leitor->numThreads; t++) pthread_join(leitor->threads[t], NULL);
+    
+    for (size_t i = 0; i < leitor->numFila; i++) {
+        leitor->fila[(leitor->inicioFila + i) % leitor->acervo->numCasos]->leitura = LEITURA_NENHUMA;
+    }
+    for (size_t i = 0; i < leitor->numLidos; i++) leitor->lidos[i]->leitura = LEITURA_PRONTA;
+    pthread_cond_destroy(&leitor->pedido);
+    pthread_mutex_destroy(&leitor->trava);
+    close(leitor->aviso);
+    free(leitor->fila);
+    free(leitor->lidos);
+    free(leitor);
+}
+
+/**
+ * Função: criarLeitorCasos
+ * Propósito: Criar o leitor de casos do servidor e iniciar as suas threads
+ * Parâmetros: acervo - acervo cujos mapas serão lidos
+ * Retorno: ponteiro para o leitor ou NULL em caso de erro (nenhuma thread iniciada)
+ */
+static LeitorCasos* criarLeitorCasos(AcervoCasos* acervo) {
+    LeitorCasos* leitor = (LeitorCasos*)calloc(1, sizeof(LeitorCasos));
+    if (leitor == NULL) return NULL;
+    leitor->acervo = acervo;
+    leitor->fila = (CasoAcervo**)malloc(acervo->numCasos * sizeof(CasoAcervo*));
+    leitor->lidos = (CasoAcervo**)malloc(acervo->numCasos * sizeof(CasoAcervo*));
+    leitor->aviso = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (leitor->fila == NULL || leitor->lidos == NULL || leitor->aviso < 0) {
+        if (leitor->aviso >= 0) close(leitor->aviso);
+        free(leitor->fila);
+        free(leitor->lidos);
+        free(leitor);
+        return NULL;
+    }
+    pthread_mutex_init(&leitor->trava, NULL);
+    pthread_cond_init(&leitor->pedido, NULL);
+    while (leitor->numThreads < THREADS_LEITOR_CASOS &&
+           pthread_create(&leitor->threads[leitor->numThreads], NULL, corpoLeitorCasos, leitor) == 0) {
+        leitor->numThreads++;
+    }
+    if (leitor->numThreads < THREADS_LEITOR_CASOS) {
+        liberarLeitorCasos(leitor);
+        return NULL;
+    }
+    return leitor;
+}
+
+/**
+ * Função: pedirLeituraCaso
+ * Propósito: Colocar um caso na fila do leitor (a thread do servidor segue sem esperar)
+ * Parâmetros: leitor - leitor de casos
+ *             caso - caso fora da memória e sem leitura pendente
+ * Retorno: void
+ */
+static void pedirLeituraCaso(LeitorCasos* leitor, CasoAcervo* caso) {
+    caso->leitura = LEITURA_PENDENTE;
+    pthread_mutex_lock(&leitor->trava);
+    leitor->fila[(leitor->inicioFila + leitor->numFila) % leitor->acervo->numCasos] = caso;
+    leitor->numFila++;
+    pthread_cond_signal(&leitor->pedido);
+    pthread_mutex_unlock(&leitor->trava);
+}
+
+/**
+ * Função: enderecoEhPorta
+ * Propósito: Dizer se um endereço do servidor é uma porta TCP (só dígitos) ou um caminho
+ * Parâmetros: endereco - texto informado na linha de comando
+ * Retorno: 1 se é uma porta, 0 se é o caminho de um socket Unix
+ */
+static int enderecoEhPorta(const char* endereco) {
+    if (*endereco == '\0') return 0;
+    for (const char* c = endereco; *c != '\0'; c++) {
+        if (*c < '0' || *c > '9') return 0;
+    }
+    return 1;
+}
+
+/**
+ * Função: abrirSocketLocal
+ * Propósito: Criar um socket local para escutar ou conectar: uma porta vira TCP em
+ * 127.0.0.1, qualquer outro texto é o caminho de um socket Unix
+ * Parâmetros: endereco - porta ou caminho
+ *             escutar - 1 para aceitar conexões (bind/listen), 0 para conectar
+ * Retorno: descritor do socket ou -1 em caso de erro
+ */
+static int abrirSocketLocal(const char* endereco, int escutar) {
+    struct sockaddr_storage armazenado;
+    socklen_t tamanho;
+    int porta = enderecoEhPorta(endereco);
+    
+    memset(&armazenado, 0, sizeof(armazenado));
+    if (porta) {
+        struct sockaddr_in* ipv4 = (struct sockaddr_in*)&armazenado;
+        ipv4->sin_family = AF_INET;
+        ipv4->sin_port = htons((uint16_t)strtoul(endereco, NULL, 10));
+        ipv4->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        tamanho = sizeof(struct sockaddr_in);
+    } else {
+        struct sockaddr_un* local = (struct sockaddr_un*)&armazenado;
+        if (strlen(endereco) >= sizeof(local->sun_path)) {
+            printf("Erro: Caminho de socket longo demais: %s\n", endereco);
+            return -1;
+        }
+        local->sun_family = AF_UNIX;
+        strcpy(local->sun_path, endereco);
+        tamanho = sizeof(struct sockaddr_un);
+    }
+    
+    int fd = socket(armazenado.ss_family, SOCK_STREAM, 0);
+    if (fd < 0) {
+        printf("Erro: Nao foi possivel criar o socket (%s)!\n", strerror(errno));
+        return -1;
+    }
+    int um = 1;
+    if (escutar) {
+        if (porta) {
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+        } else {
+            // Socket deixado por uma execução anterior (outros arquivos não são apagados)
+            struct stat info;
+            if (stat(endereco, &info) == 0 && S_ISSOCK(info.st_mode)) unlink(endereco);
+        }
+        if (bind(fd, (struct sockaddr*)&armazenado, tamanho) != 0 || listen(fd, FILA_CONEXOES_SERVIDOR) != 0) {
+            printf("Erro: Nao foi possivel escutar em %s (%s)!\n", endereco, strerror(errno));
+            close(fd);
+            return -1;
+        }
+    } else if (connect(fd, (struct sockaddr*)&armazenado, tamanho) != 0) {
+        close(fd);
+        return -1;
+    }
+    // Respostas curtas de ida e volta: sem o atraso do algoritmo de Nagle
+    if (porta && !escutar) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &um, sizeof(um));
+    return fd;
+}
+
+/**
+ * Função: anunciarEsperaSessao
+ * Propósito: Marcar, no formato de eventos, que a sessão terminou de responder e espera
+ * a próxima linha (o gerador de carga mede a latência até este evento)
+ * Parâmetros: saida - saída da conexão
+ *             sessao - sessão da conexão
+ * Retorno: void
+ */
+static void anunciarEsperaSessao(SaidaJogo* saida, const SessaoJogo* sessao) {
+    static const char* nomesFases[] = {"caso", "navegacao", "busca", "acusacao", "encerrada"};
+    abrirEvento(saida, "aguardando");
+    campoTextoEvento(saida, "fase", nomesFases[sessao->fase]);
+    if (sessao->fase == FASE_CASO) campoNumeroEvento(saida, "casos", (long long)sessao->acervo->numCasos);
+    fecharEvento(saida);
+}
+
+/**
+ * Função: atualizarInteresseConexao
+ * Propósito: Esperar escrita enquanto houver resposta pendente e leitura caso contrário
+ * (uma conexão que não lê suas respostas deixa de ter as linhas seguintes processadas);
+ * enquanto o caso pedido é lido do disco, a conexão não lê nada
+ * Parâmetros: servidor - servidor de sessões
+ *             conexao - conexão atendida
+ * Retorno: void
+ */
+static void atualizarInteresseConexao(ServidorJogo* servidor, ConexaoJogo* conexao) {
+    uint32_t interesse = conexao->enviados < conexao->saida.usados ? EPOLLOUT
+                       : conexao->casoAguardado != NULL ? 0 : EPOLLIN;
+    if (interesse == conexao->interesse) return;
+    
+    struct epoll_event evento;
+    evento.events = interesse;
+    evento.data.ptr = conexao;
+    epoll_ctl(servidor->epoll, EPOLL_CTL_MOD, conexao->fd, &evento);
+    conexao->interesse = interesse;
+}
+
+/**
+ * Função: fecharConexao
+ * Propósito: Encerrar uma conexão e liberar a sessão, a arena e a saída dela
+ * Parâmetros: servidor - servidor de sessões
+ *             conexao - conexão a fechar
+ * Retorno: void
+ */
+static void fecharConexao(ServidorJogo* servidor, ConexaoJogo* conexao) {
+    epoll_ctl(servidor->epoll, EPOLL_CTL_DEL, conexao->fd, NULL);
+    close(conexao->fd);
+    
+    // A última conexão do vetor ocupa a posição liberada
+    ConexaoJogo* ultima = servidor->conexoes[--servidor->numConexoes];
+    servidor->conexoes[conexao->posicao] = ultima;
+    ultima->posicao = conexao->posicao;
+    
+    finalizarSessaoJogo(&conexao->sessao);
+    liberarIndiceSuspeitos(conexao->sessao.indice);
+    liberarArena(conexao->arena);
+    finalizarSaidaJogo(&conexao->saida);
+    free(conexao);
+    
+    // Com um descritor livre, volta a aceitar conexões
+    if (servidor->escutaPausada) {
+        struct epoll_event evento;
+        evento.events = EPOLLIN;
+        evento.data.ptr = NULL;
+        if (epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, servidor->escuta, &evento) == 0) servidor->escutaPausada = 0;
+    }
+}
+
+/**
+ * Função: enviarConexao
+ * Propósito: Enviar o que o socket aceitar das respostas pendentes da conexão
+ * Parâmetros: conexao - conexão atendida
+ * Retorno: 1 se a conexão continua utilizável, 0 se o envio falhou
+ */
+static int enviarConexao(ConexaoJogo* conexao) {
+    while (conexao->enviados < conexao->saida.usados) {
+        ssize_t enviados = send(conexao->fd, conexao->saida.buffer + conexao->enviados,
+                                conexao->saida.usados - conexao->enviados, MSG_NOSIGNAL);
+        if (enviados < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        conexao->enviados += (size_t)enviados;
+    }
+    conexao->saida.usados = 0;
+    conexao->enviados = 0;
+    return 1;
+}
+
+/**
+ * Função: esperarLeituraCaso
+ * Propósito: Desviar para o leitor de casos a escolha de um caso que não está em memória:
+ * a conexão para de ler linhas até o mapa chegar e o epoll segue atendendo as outras
+ * (pedidos do mesmo caso compartilham a leitura). A linha do pedido fica no começo do
+ * buffer de entrada e é entregue por receberCasosLidos
+ * Parâmetros: servidor - servidor de sessões
+ *             conexao - conexão em FASE_CASO
+ *             linha - número ou nome digitado
+ * Retorno: 1 se a conexão passou a esperar o caso, 0 se a linha pode ser entregue já
+ */
+static int esperarLeituraCaso(ServidorJogo* servidor, ConexaoJogo* conexao, const char* linha) {
+    AcervoCasos* acervo = servidor->acervo;
+    size_t indice = buscarCasoAcervo(acervo, linha);
+    if (servidor->leitor == NULL || indice >= acervo->numCasos) return 0;
+    
+    CasoAcervo* caso = &acervo->casos[indice];
+    if (caso->hall != NULL || caso->falhou || (caso->leitura == LEITURA_PRONTA && caso->mapaLido != NULL)) return 0;
+    if (caso->leitura != LEITURA_PENDENTE) pedirLeituraCaso(servidor->leitor, caso);
+    conexao->casoAguardado = caso;
+    return 1;
+}
+
+/**
+ * Função: avancarSessaoConexao
+ * Propósito: Avançar a sessão da conexão com uma linha e anunciar a espera pela próxima
+ * Parâmetros: servidor - servidor de sessões
+ *             conexao - conexão atendida
+ *             linha - linha já sem a quebra
+ * Retorno: void
+ */
+static void avancarSessaoConexao(ServidorJogo* servidor, ConexaoJogo* conexao, const char* linha) {
+    Arena* anterior = usarArena(conexao->arena);
+    avancarSessao(&conexao->saida, &conexao->sessao, linha);
+    usarArena(anterior);
+    
+    servidor->entradas++;
+    if (conexao->sessao.fase == FASE_ENCERRADA) {
+        servidor->sessoesConcluidas++;
+    } else {
+        anunciarEsperaSessao(&conexao->saida, &conexao->sessao);
+    }
+}
+
+/**
+ * Função: entregarLinhaConexao
+ * Propósito: Avançar a sessão da conexão com uma linha recebida (a escolha de um caso que
+ * precisa ser lido do disco espera o leitor de casos, ver esperarLeituraCaso)
+ * Parâmetros: servidor - servidor de sessões
+ *             conexao - conexão que enviou a linha
+ *             linha - linha sem o '\n' (um '\r' final também é removido)
+ * Retorno: void
+ */
+static void entregarLinhaConexao(ServidorJogo* servidor, ConexaoJogo* conexao, char* linha) {
+    if (conexao->sessao.fase == FASE_ENCERRADA) return;
+    size_t tamanho = strlen(linha);
+    if (tamanho > 0 && linha[tamanho - 1] == '\r') linha[tamanho - 1] = '\0';
+    
+    if (conexao->sessao.fase == FASE_CASO && esperarLeituraCaso(servidor, conexao, linha)) return;
+    avancarSessaoConexao(servidor, conexao, linha);
+}
+
+/**
+ * Função: terminarEntradaConexao
+ * Propósito: Tratar o fim da entrada de um jogador como no terminal: encerra a
+ * investigação e faz a acusação vazia, deixando o relatório final para ser enviado
+ * Parâmetros: servidor - servidor de sessões
+ *             conexao - conexão cujo jogador parou de enviar
+ * Retorno: void
+ */
+static void terminarEntradaConexao(ServidorJogo* servidor, ConexaoJogo* conexao) {
+    if (conexao->sessao.fase == FASE_ENCERRADA) return;
+    
+    Arena* anterior = usarArena(conexao->arena);
+    while (conexao->sessao.fase != FASE_ENCERRADA) {
+        if (conexao->sessao.fase == FASE_NAVEGACAO) {
+            escolherOpcaoSessao(&conexao->saida, &conexao->sessao, 's');
+        } else {
+            responderSessao(&conexao->saida, &conexao->sessao, NULL);
+        }
+    }
+    usarArena(anterior);
+    servidor->sessoesConcluidas++;
+}
+
+/**
+ * Função: processarEntradaConexao
+ * Propósito: Entregar à sessão cada linha completa já recebida, parando se a conexão
+ * passar a esperar um caso (o pedido e o resto ficam no buffer até a leitura terminar).
+ * Uma linha que não cabe no buffer é entregue truncada e o restante dela é ignorado
+ * Parâmetros: servidor - servidor de sessões
+ *             conexao - conexão atendida
+ * Retorno: void
+ */
+static void processarEntradaConexao(ServidorJogo* servidor, ConexaoJogo* conexao) {
+    size_t inicio = 0;
+    for (size_t i = 0; i < conexao->usadosEntrada && conexao->casoAguardado == NULL; i++) {
+        if (conexao->entrada[i] != '\n') continue;
+        conexao->entrada[i] = '\0';
+        if (conexao->descartando) {
+            conexao->descartando = 0;
+        } else {
+            entregarLinhaConexao(servidor, conexao, conexao->entrada + inicio);
+        }
+        if (conexao->casoAguardado != NULL) {
+            conexao->entrada[i] = '\n';
+            break;
+        }
+        inicio = i + 1;
+    }
+    
+    // Guarda o que ainda não foi processado
+    conexao->usadosEntrada -= inicio;
+    memmove(conexao->entrada, conexao->entrada + inicio, conexao->usadosEntrada);
+    if (conexao->usadosEntrada == sizeof(conexao->entrada) && conexao->casoAguardado == NULL) {
+        conexao->entrada[sizeof(conexao->entrada) - 1] = '\0';
+        if (!conexao->descartando) entregarLinhaConexao(servidor, conexao, conexao->entrada);
+        conexao->descartando = 1;
+        if (conexao->casoAguardado != NULL) {
+            conexao->entrada[sizeof(conexao->entrada) - 1] = '\n';  // O pedido truncado espera no buffer
+        } else {
+            conexao->usadosEntrada = 0;
+        }
+    }
+}
+
+/**
+ * Função: receberConexao
+ * Propósito: Ler o que chegou na conexão e entregar à sessão cada linha completa
+ * Parâmetros: servidor - servidor de sessões
+ *             conexao - conexão atendida
+ * Retorno: 1 se a conexão continua aberta, 0 se o jogador parou de enviar, -1 em caso de erro
+ */
+static int receberConexao(ServidorJogo* servidor, ConexaoJogo* conexao) {
+    ssize_t lidos;
+    do {
+        lidos = recv(conexao->fd, conexao->entrada + conexao->usadosEntrada,
+                     sizeof(conexao->entrada) - conexao->usadosEntrada, 0);
+    } while (lidos < 0 && errno == EINTR);
+    if (lidos == 0) return 0;
+    if (lidos < 0) return errno == EAGAIN || errno == EWOULDBLOCK ? 1 : -1;
+    
+    conexao->usadosEntrada += (size_t)lidos;
+    processarEntradaConexao(servidor, conexao);
+    return 1;
+}
+
+/**
+ * Função: aceitarConexoes
+ * Propósito: Aceitar as conexões pendentes, começando uma sessão no hall para cada uma
+ * Parâmetros: servidor - servidor de sessões
+ * Retorno: void
+ */
+static void aceitarConexoes(ServidorJogo* servidor) {
+    for (;;) {
+        int fd = accept(servidor->escuta, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EMFILE || errno == ENFILE) {
+                // Sem descritores: para de aceitar até alguma conexão fechar
+                printf("Erro: Limite de arquivos abertos atingido com %zu conexoes!\n", servidor->numConexoes);
+                epoll_ctl(servidor->epoll, EPOLL_CTL_DEL, servidor->escuta, NULL);
+                servidor->escutaPausada = 1;
+            }
+            return;
+        }
+        
+        if (servidor->numConexoes == servidor->capacidadeConexoes) {
+            size_t capacidade = servidor->capacidadeConexoes > 0 ? servidor->capacidadeConexoes * 2 : 64;
+            ConexaoJogo** conexoes = (ConexaoJogo**)realloc(servidor->conexoes, capacidade * sizeof(ConexaoJogo*));
+            if (conexoes == NULL) {
+                printf("Erro: Falha na alocação de memória para as conexoes!\n");
+                close(fd);
+                continue;
+            }
+            servidor->conexoes = conexoes;
+            servidor->capacidadeConexoes = capacidade;
+        }
+        
+        ConexaoJogo* conexao = (ConexaoJogo*)calloc(1, sizeof(ConexaoJogo));
+        Arena* arena = criarArena(TAMANHO_BLOCO_CONEXAO);
+        IndiceSuspeitos* indice = criarIndiceSuspeitos();
+        if (conexao == NULL || arena == NULL || indice == NULL || !tornarNaoBloqueante(fd)) {
+            printf("Erro: Nao foi possivel preparar a sessao da conexao!\n");
+            free(conexao);
+            liberarArena(arena);
+            liberarIndiceSuspeitos(indice);
+            close(fd);
+            continue;
+        }
+        int um = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &um, sizeof(um));  // Falha (sem efeito) em sockets Unix
+        
+        conexao->fd = fd;
+        conexao->arena = arena;
+        iniciarSaidaMemoria(&conexao->saida, servidor->modo);
+        exibirBoasVindas(&conexao->saida);
+        Arena* anterior = usarArena(arena);
+        if (servidor->acervo != NULL) {
+            iniciarSessaoAcervo(&conexao->saida, &conexao->sessao, servidor->acervo, NULL, indice);
+        } else {
+            iniciarSessaoJogo(&conexao->saida, &conexao->sessao, servidor->hall, NULL, servidor->tabela, indice);
+        }
+        usarArena(anterior);
+        anunciarEsperaSessao(&conexao->saida, &conexao->sessao);
+        
+        // A primeira sala sai já; o que não couber no socket espera pelo EPOLLOUT
+        struct epoll_event evento;
+        conexao->interesse = EPOLLIN;
+        if (!enviarConexao(conexao) || conexao->saida.usados > 0) conexao->interesse = EPOLLOUT;
+        evento.events = conexao->interesse;
+        evento.data.ptr = conexao;
+        conexao->posicao = servidor->numConexoes;
+        servidor->conexoes[servidor->numConexoes++] = conexao;
+        servidor->sessoesIniciadas++;
+        if (epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, fd, &evento) != 0) fecharConexao(servidor, conexao);
+    }
+}
+
+/**
+ * Função: concluirAtendimento
+ * Propósito: Enviar as respostas pendentes de uma conexão atendida e fechá-la quando a
+ * sessão termina (assim que o relatório final for enviado) ou o jogador sai
+ * Parâmetros: servidor - servidor de sessões
+ *             conexao - conexão atendida
+ *             ativa - 0 se a conexão já falhou ou o jogador saiu
+ * Retorno: 1 se a conexão continua aberta, 0 se foi fechada
+ */
+static int concluirAtendimento(ServidorJogo* servidor, ConexaoJogo* conexao, int ativa) {
+    if (ativa) ativa = enviarConexao(conexao);
+    if (!ativa || (conexao->sessao.fase == FASE_ENCERRADA && conexao->saida.usados == 0)) {
+        fecharConexao(servidor, conexao);
+        return 0;
+    }
+    atualizarInteresseConexao(servidor, conexao);
+    return 1;
+}
+
+/**
+ * Função: atenderConexao
+ * Propósito: Tratar os eventos do epoll de uma conexão: ler e processar linhas, enviar
+ * respostas pendentes e fechar a conexão quando a sessão termina ou o jogador sai
+ * Parâmetros: servidor - servidor de sessões
+ *             conexao - conexão com eventos
+ *             eventos - máscara de eventos devolvida pelo epoll
+ * Retorno: void
+ */
+static void atenderConexao(ServidorJogo* servidor, ConexaoJogo* conexao, uint32_t eventos) {
+    int ativa = 1;
+    if (eventos & EPOLLIN) {
+        int recebido = receberConexao(servidor, conexao);
+        if (recebido == 0) terminarEntradaConexao(servidor, conexao);
+        ativa = recebido >= 0;
+    } else if (eventos & (EPOLLERR | EPOLLHUP)) {
+        ativa = 0;
+    }
+    concluirAtendimento(servidor, conexao, ativa);
+}
+
+/**
+ * Função: receberCasosLidos
+ * Propósito: Tratar o aviso do leitor de casos: para cada mapa lido, entregar o caso a todas
+ * as conexões que o esperavam (a primeira monta a mansão; se a leitura falhou, todas recebem
+ * o aviso de caso que não abre) e só então retomar as linhas que elas já tinham enviado
+ * Parâmetros: servidor - servidor de sessões
+ * Retorno: void
+ */
+static void receberCasosLidos(ServidorJogo* servidor) {
+    LeitorCasos* leitor = servidor->leitor;
+    uint64_t avisos;
+    ssize_t lidos = read(leitor->aviso, &avisos, sizeof(avisos));
+    (void)lidos;  // O contador só zera o aviso; as filas dizem o que foi lido
+    
+    for (;;) {
+        pthread_mutex_lock(&leitor->trava);
+        CasoAcervo* caso = leitor->numLidos > 0 ? leitor->lidos[--leitor->numLidos] : NULL;
+        pthread_mutex_unlock(&leitor->trava);
+        if (caso == NULL) break;
+        caso->leitura = LEITURA_PRONTA;
+        
+        // Todas abrem o caso antes de qualquer uma seguir: nenhuma sessão o solta no meio.
+        // O pedido é a primeira linha do buffer de cada uma
+        for (size_t i = 0; i < servidor->numConexoes; i++) {
+            ConexaoJogo* conexao = servidor->conexoes[i];
+            if (conexao->casoAguardado != caso) continue;
+            char* fim = (char*)memchr(conexao->entrada, '\n', conexao->usadosEntrada);
+            *fim = '\0';
+            avancarSessaoConexao(servidor, conexao, conexao->entrada);
+            conexao->usadosEntrada -= (size_t)(fim + 1 - conexao->entrada);
+            memmove(conexao->entrada, fim + 1, conexao->usadosEntrada);
+        }
+        if (caso->mapaLido == NULL) caso->leitura = LEITURA_NENHUMA;
+        
+        // De trás para frente: uma conexão fechada dá a sua posição a uma já vista
+        for (size_t i = servidor->numConexoes; i-- > 0;) {
+            ConexaoJogo* conexao = servidor->conexoes[i];
+            if (conexao->casoAguardado != caso) continue;
+            conexao->casoAguardado = NULL;
+            processarEntradaConexao(servidor, conexao);
+            concluirAtendimento(servidor, conexao, 1);
+        }
+    }
+}
+
+/**
+ * Função: executarServidor
+ * Propósito: Atender muitos jogadores ao mesmo tempo, uma sessão por conexão, em uma única
+ * thread orientada a eventos (epoll); a mansão e a tabela de suspeitos são compartilhadas
+ * por todas as sessões (ou cada sessão escolhe um caso do acervo). Cada linha recebida
+ * avança a sessão da conexão; no formato de eventos, cada resposta termina com o evento
+ * "aguardando". Com acervo, os mapas fora da memória são lidos pelas threads do leitor de
+ * casos e o epoll só monta o caso lido. SIGINT/SIGTERM encerram
+ * Parâmetros: endereco - porta TCP (em 127.0.0.1) ou caminho do socket Unix
+ *             hall - sala de entrada da mansão (ignorada com acervo)
+ *             tabela - tabela hash de suspeitos (ignorada com acervo)
+ *             acervo - acervo de casos ou NULL
+ *             modo - formato das respostas
+ * Retorno: 0 em caso de sucesso, 1 em caso de erro
+ */
+int executarServidor(const char* endereco, Sala* hall, TabelaHash* tabela, AcervoCasos* acervo, ModoSaida modo) {
+    ServidorJogo servidor;
+    memset(&servidor, 0, sizeof(servidor));
+    servidor.hall = hall;
+    servidor.tabela = tabela;
+    servidor.acervo = acervo;
+    servidor.modo = modo;
+    
+    ampliarLimiteDescritores();
+    servidor.escuta = abrirSocketLocal(endereco, 1);
+    if (servidor.escuta < 0) return 1;
+    servidor.epoll = epoll_create1(0);
+    struct epoll_event evento;
+    evento.events = EPOLLIN;
+    evento.data.ptr = NULL;  // NULL identifica o socket de escuta
+    int pronto = tornarNaoBloqueante(servidor.escuta) && servidor.epoll >= 0 &&
+                 epoll_ctl(servidor.epoll, EPOLL_CTL_ADD, servidor.escuta, &evento) == 0;
+    if (pronto && acervo != NULL) {
+        // Os mapas do acervo são lidos por outra thread; o aviso dela chega pelo epoll
+        servidor.leitor = criarLeitorCasos(acervo);
+        evento.data.ptr = servidor.leitor;  // O leitor identifica o próprio aviso
+        pronto = servidor.leitor != NULL &&
+                 epoll_ctl(servidor.epoll, EPOLL_CTL_ADD, servidor.leitor->aviso, &evento) == 0;
+    }
+    if (!pronto) {
+        printf("Erro: Nao foi possivel preparar o servidor (%s)!\n", strerror(errno));
+        liberarLeitorCasos(servidor.leitor);
+        if (servidor.epoll >= 0) close(servidor.epoll);
+        close(servidor.escuta);
+        return 1;
+    }
+    
+    struct sigaction acao;
+    memset(&acao, 0, sizeof(acao));
+    acao.sa_handler = pararServidor;
+    sigaction(SIGINT, &acao, NULL);
+    sigaction(SIGTERM, &acao, NULL);
+    servidorAtivo = 1;
+    printf("Servidor ouvindo em %s (uma sessao por conexao; Ctrl+C encerra).\n", endereco);
+    fflush(stdout);
+    
+    double inicio = tempoAtualSegundos();
+    struct epoll_event eventos[EVENTOS_POR_ESPERA];
+    while (servidorAtivo) {
+        int prontos = epoll_wait(servidor.epoll, eventos, EVENTOS_POR_ESPERA, -1);
+        if (prontos < 0) {
+            if (errno == EINTR) continue;
+            printf("Erro: Falha ao esperar eventos (%s)!\n", strerror(errno));
+            break;
+        }
+        int casosLidos = 0;
+        for (int i = 0; i < prontos; i++) {
+            void* origem = eventos[i].data.ptr;
+            if (origem == NULL) {
+                aceitarConexoes(&servidor);
+            } else if (origem == servidor.leitor) {
+                casosLidos = 1;
+            } else {
+                atenderConexao(&servidor, (ConexaoJogo*)origem, eventos[i].events);
+            }
+        }
+        // Depois dos eventos: retomar as conexões pode fechar algumas que ainda tinham eventos
+        if (casosLidos) receberCasosLidos(&servidor);
+    }
+    
+    size_t abertas = servidor.numConexoes;
+    while (servidor.numConexoes > 0) fecharConexao(&servidor, servidor.conexoes[0]);
+    free(servidor.conexoes);
+    liberarLeitorCasos(servidor.leitor);
+    close(servidor.epoll);
+    close(servidor.escuta);
+    if (!enderecoEhPorta(endereco)) unlink(endereco);
+    
+    printf("Servidor encerrado: %zu sessoes atendidas, %zu concluidas, %zu ainda abertas, %zu entradas em %.3f s.\n",
+           servidor.sessoesIniciadas, servidor.sessoesConcluidas, abertas, servidor.entradas,
+           tempoAtualSegundos() - inicio);
+    if (acervo != NULL) {
+        printf("Acervo: %zu casos abertos, %zu lidos do disco, %zu despejados; %zu de %zu em memoria (%zu KiB).\n",
+               acervo->aberturas, acervo->leituras, acervo->despejos, acervo->carregados, acervo->numCasos,
+               acervo->bytesCarregados / 1024);
+        printf("Textos internados (fora do orcamento, nunca despejados): %zu KiB.\n", memoriaTextosInternados() / 1024);
+    }
+    return 0;
+}
+
+/**
+ * Função: iniciarClienteCarga
+ * Propósito: Abrir a conexão da próxima sessão do gerador de carga
+ * Parâmetros: carga - execução do gerador
+ *             cliente - cliente sem sessão em andamento
+ * Retorno: void
+ */
+static void iniciarClienteCarga(ExecucaoCarga* carga, ClienteCarga* cliente) {
+    while (carga->proximaSessao < carga->totalSessoes) {
+        size_t g = carga->proximaSessao++;
+        int fd = abrirSocketLocal(carga->endereco, 0);
+        struct epoll_event evento;
+        evento.events = EPOLLIN;
+        evento.data.ptr = cliente;
+        if (fd < 0 || !tornarNaoBloqueante(fd) || epoll_ctl(carga->epoll, EPOLL_CTL_ADD, fd, &evento) != 0) {
+            if (carga->falhas == 0) printf("Erro: Nao foi possivel conectar a %s (%s)!\n", carga->endereco, strerror(errno));
+            if (fd >= 0) close(fd);
+            carga->falhas++;
+            continue;
+        }
+        cliente->fd = fd;
+        cliente->roteiro = &carga->roteiro->sessoes[g % carga->roteiro->numSessoes];
+        cliente->sessao = g;
+        cliente->passo = 0;
+        cliente->encerrou = 0;
+        cliente->mediuMovimento = 0;
+        cliente->recebeuAlgo = 0;
+        cliente->pediuCaso = 0;
+        cliente->usados = 0;
+        carga->ativas++;
+        return;
+    }
+    cliente->fd = -1;
+}
+
+/**
+ * Função: encerrarClienteCarga
+ * Propósito: Fechar a conexão de um cliente e começar a próxima sessão, se houver
+ * Parâmetros: carga - execução do gerador
+ *             cliente - cliente com sessão em andamento
+ *             concluida - 1 se o servidor encerrou a sessão normalmente
+ * Retorno: void
+ */
+static void encerrarClienteCarga(ExecucaoCarga* carga, ClienteCarga* cliente, int concluida) {
+    epoll_ctl(carga->epoll, EPOLL_CTL_DEL, cliente->fd, NULL);
+    close(cliente->fd);
+    cliente->fd = -1;
+    carga->ativas--;
+    if (concluida) {
+        carga->concluidas++;
+    } else {
+        carga->falhas++;
+    }
+    iniciarClienteCarga(carga, cliente);
+}
+
+/**
+ * Função: responderClienteCarga
+ * Propósito: Enviar a próxima linha da sessão do roteiro: o caso (as sessões se revezam
+ * entre os casos do acervo), um movimento, 's' ao fim dos movimentos ou o nome do acusado
+ * quando o servidor pede a acusação
+ * Parâmetros: cliente - cliente cuja resposta acabou de chegar
+ *             fase - fase anunciada pelo servidor no evento "aguardando"
+ *             numCasos - casos do acervo anunciados com a fase "caso"
+ * Retorno: 1 se a linha foi enviada, 0 em caso de erro
+ */
+static int responderClienteCarga(ClienteCarga* cliente, const char* fase, size_t numCasos) {
+    char linha[TAMANHO_ENTRADA_CONEXAO];
+    const SessaoRoteiro* sessao = cliente->roteiro;
+    cliente->mediuMovimento = 0;
+    
+    if (strcmp(fase, "caso") == 0) {
+        snprintf(linha, sizeof(linha), "%zu\n", numCasos > 0 ? cliente->sessao % numCasos + 1 : 1);
+    } else if (strcmp(fase, "acusacao") == 0) {
+        snprintf(linha, sizeof(linha), "%s\n", sessao->textoAcusado);
+    } else if (strcmp(fase, "busca") == 0) {
+        strcpy(linha, "\n");
+    } else {
+        while (cliente->passo < sessao->numMovimentos &&
+               (sessao->movimentos[cliente->passo] == ' ' || sessao->movimentos[cliente->passo] == '\t')) {
+            cliente->passo++;
+        }
+        if (cliente->passo < sessao->numMovimentos) {
+            linha[0] = sessao->movimentos[cliente->passo++];
+            linha[1] = '\n';
+            linha[2] = '\0';
+            cliente->mediuMovimento = 1;
+        } else {
+            strcpy(linha, "s\n");
+            cliente->encerrou = 1;
+        }
+    }
+    
+    // Linhas curtas: o socket local sempre tem espaço para uma linha por vez
+    size_t tamanho = strlen(linha);
+    size_t enviados = 0;
+    cliente->envio = tempoAtualSegundos();
+    while (enviados < tamanho) {
+        ssize_t parte = send(cliente->fd, linha + enviados, tamanho - enviados, MSG_NOSIGNAL);
+        if (parte < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) continue;
+            return 0;
+        }
+        enviados += (size_t)parte;
+    }
+    return 1;
+}
+
+/**
+ * Função: registrarLatenciaCarga
+ * Propósito: Guardar o tempo de resposta de um movimento
+ * Parâmetros: carga - execução do gerador
+ *             latencia - segundos entre o envio e o evento "aguardando"
+ * Retorno: void
+ */
+static void registrarLatenciaCarga(ExecucaoCarga* carga, double latencia) {
+    if (carga->numLatencias == carga->capacidadeLatencias) {
+        size_t capacidade = carga->capacidadeLatencias > 0 ? carga->capacidadeLatencias * 2 : 4096;
+        double* latencias = (double*)realloc(carga->latencias, capacidade * sizeof(double));
+        if (latencias == NULL) return;
+        carga->latencias = latencias;
+        carga->capacidadeLatencias = capacidade;
+    }
+    carga->latencias[carga->numLatencias++] = latencia;
+}
+
+/**
+ * Função: receberClienteCarga
+ * Propósito: Ler as respostas do servidor para um cliente; a cada evento "aguardando"
+ * mede a latência do movimento enviado e envia a próxima linha
+ * Parâmetros: carga - execução do gerador
+ *             cliente - cliente com dados a ler
+ * Retorno: void
+ */
+static void receberClienteCarga(ExecucaoCarga* carga, ClienteCarga* cliente) {
+    ssize_t lidos;
+    do {
+        lidos = recv(cliente->fd, cliente->recebido + cliente->usados, sizeof(cliente->recebido) - cliente->usados, 0);
+    } while (lidos < 0 && errno == EINTR);
+    if (lidos < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+    if (lidos <= 0) {
+        // O servidor fecha a conexão quando a sessão termina (depois do 's')
+        encerrarClienteCarga(carga, cliente, lidos == 0 && cliente->encerrou);
+        return;
+    }
+    if (!cliente->recebeuAlgo && cliente->recebido[0] != '{') {
+        carga->formatoInvalido = 1;
+        return;
+    }
+    cliente->recebeuAlgo = 1;
+    
+    size_t inicio = 0;
+    size_t fim = cliente->usados + (size_t)lidos;
+    for (size_t i = cliente->usados; i < fim; i++) {
+        if (cliente->recebido[i] != '\n') continue;
+        cliente->recebido[i] = '\0';
+        const char* linha = cliente->recebido + inicio;
+        inicio = i + 1;
+        if (strncmp(linha, "{\"evento\":\"aguardando\"", 22) != 0) continue;
+        
+        if (cliente->mediuMovimento) registrarLatenciaCarga(carga, tempoAtualSegundos() - cliente->envio);
+        const char* fase = strstr(linha, "\"fase\":\"");
+        char nomeFase[16] = "navegacao";
+        if (fase != NULL) sscanf(fase + 8, "%15[a-z]", nomeFase);
+        const char* casos = strstr(linha, "\"casos\":");
+        size_t numCasos = casos != NULL ? strtoull(casos + 8, NULL, 10) : 0;
+        if (strcmp(nomeFase, "caso") == 0 && cliente->pediuCaso++) {
+            // O caso enviado foi recusado: repeti-lo não muda a resposta, a sessão falha
+            if (carga->falhas == 0) {
+                printf("Erro: O servidor recusou o caso %zu!\n", numCasos > 0 ? cliente->sessao % numCasos + 1 : 1);
+            }
+            encerrarClienteCarga(carga, cliente, 0);
+            return;
+        }
+        if (!responderClienteCarga(cliente, nomeFase, numCasos)) {
+            encerrarClienteCarga(carga, cliente, 0);
+            return;
+        }
+    }
+    
+    // Guarda o começo da próxima linha; as linhas longas demais não são eventos "aguardando"
+    cliente->usados = fim - inicio;
+    memmove(cliente->recebido, cliente->recebido + inicio, cliente->usados);
+    if (cliente->usados == sizeof(cliente->recebido)) cliente->usados = 0;
+}
+
+/**
+ * Função: compararLatencias
+ * Propósito: Comparar dois tempos para ordenação crescente
+ * Parâmetros: a, b - ponteiros para os tempos
+ * Retorno: negativo, zero ou positivo
+ */
+static int compararLatencias(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Função: executarCarga
+ * Propósito: Gerar carga contra o servidor de sessões: mantém várias conexões abertas ao
+ * mesmo tempo, cada uma jogando sessões do roteiro de lote, e informa a vazão e os
+ * percentis (p50/p99) da latência por movimento. O servidor deve usar --saida eventos
+ * Parâmetros: endereco - porta TCP (em 127.0.0.1) ou caminho do socket Unix do servidor
+ *             caminhoRoteiro - roteiro de lote com as sessões a jogar
+ *             numConexoes - conexões simultâneas
+ *             totalSessoes - sessões a jogar no total
+ * Retorno: 0 em caso de sucesso, 1 em caso de erro
+ */
+int executarCarga(const char* endereco, const char* caminhoRoteiro, size_t numConexoes, size_t totalSessoes) {
+    ExecucaoCarga carga;
+    memset(&carga, 0, sizeof(carga));
+    carga.endereco = endereco;
+    carga.totalSessoes = totalSessoes;
+    
+    carga.roteiro = carregarRoteiroLote(caminhoRoteiro);
+    if (carga.roteiro == NULL) return 1;
+    if (carga.roteiro->numSessoes == 0 || numConexoes == 0) {
+        printf("Erro: O roteiro %s nao tem sessoes (ou nenhuma conexao foi pedida)!\n", caminhoRoteiro);
+        liberarRoteiroLote(carga.roteiro);
+        return 1;
+    }
+    if (numConexoes > totalSessoes) numConexoes = totalSessoes > 0 ? totalSessoes : 1;
+    
+    ampliarLimiteDescritores();
+    ClienteCarga* clientes = (ClienteCarga*)calloc(numConexoes, sizeof(ClienteCarga));
+    carga.epoll = epoll_create1(0);
+    if (clientes == NULL || carga.epoll < 0) {
+        printf("Erro: Nao foi possivel preparar o gerador de carga!\n");
+        if (carga.epoll >= 0) close(carga.epoll);
+        free(clientes);
+        liberarRoteiroLote(carga.roteiro);
+        return 1;
+    }
+    
+    double inicio = tempoAtualSegundos();
+    for (size_t i = 0; i < numConexoes; i++) {
+        iniciarClienteCarga(&carga, &clientes[i]);
+    }
+    struct epoll_event eventos[EVENTOS_POR_ESPERA];
+    while (carga.ativas > 0 && !carga.formatoInvalido) {
+        int prontos = epoll_wait(carga.epoll, eventos, EVENTOS_POR_ESPERA, ESPERA_MAXIMA_CARGA_MS);
+        if (prontos < 0 && errno == EINTR) continue;
+        if (prontos <= 0) {
+            printf("Erro: O servidor nao respondeu em %d ms!\n", ESPERA_MAXIMA_CARGA_MS);
+            break;
+        }
+        for (int i = 0; i < prontos; i++) {
+            ClienteCarga* cliente = (ClienteCarga*)eventos[i].data.ptr;
+            if (cliente->fd >= 0) receberClienteCarga(&carga, cliente);
+        }
+    }
+    double tempo = tempoAtualSegundos() - inicio;
+    
+    for (size_t i = 0; i < numConexoes; i++) {
+        if (clientes[i].fd >= 0) close(clientes[i].fd);
+    }
+    close(carga.epoll);
+    free(clientes);
+    liberarRoteiroLote(carga.roteiro);
+    if (carga.formatoInvalido) {
+        printf("Erro: O servidor precisa responder no formato de eventos (--saida eventos)!\n");
+        free(carga.latencias);
+        return 1;
+    }
+    
+    printf("Carga: %zu sessoes concluidas (%zu falhas) em %.3f s com %zu conexoes: %.0f sessoes/s, %.0f movimentos/s\n",
+           carga.concluidas, carga.falhas, tempo, numConexoes, tempo > 0 ? carga.concluidas / tempo : 0.0,
+           tempo > 0 ? carga.numLatencias / tempo : 0.0);
+    if (carga.numLatencias > 0) {
+        qsort(carga.latencias, carga.numLatencias, sizeof(double), compararLatencias);
+        double p50 = carga.latencias[(carga.numLatencias - 1) / 2];
+        double p99 = carga.latencias[(size_t)((double)(carga.numLatencias - 1) * 0.99)];
+        printf("Latencia por movimento (%zu medidas): p50 %.1f us, p99 %.1f us, max %.1f us\n", carga.numLatencias,
+               p50 * 1e6, p99 * 1e6, carga.latencias[carga.numLatencias - 1] * 1e6);
+    }
+    free(carga.latencias);
+    return carga.falhas > 0 || carga.concluidas < totalSessoes ? 1 : 0;
+}
+#else
+/**
+ * Função: executarServidor
+ * Propósito: Sem epoll (fora do Linux) o servidor de sessões não está disponível
+ * Parâmetros: endereco, hall, tabela, acervo, modo - ignorados
+ * Retorno: 1
+ */
+int executarServidor(const char* endereco, Sala* hall, TabelaHash* tabela, AcervoCasos* acervo, ModoSaida modo) {
+    (void)endereco;
+    (void)hall;
+    (void)tabela;
+    (void)acervo;
+    (void)modo;
+    printf("Erro: O servidor de sessoes exige Linux (epoll)!\n");
+    return 1;
+}
+
+/**
+ * Função: executarCarga
+ * Propósito: Sem epoll (fora do Linux) o gerador de carga não está disponível
+ * Parâmetros: endereco, caminhoRoteiro, numConexoes, totalSessoes - ignorados
+ * Retorno: 1
+ */
+int executarCarga(const char* endereco, const char* caminhoRoteiro, size_t numConexoes, size_t totalSessoes) {
+    (void)endereco;
+    (void)caminhoRoteiro;
+    (void)numConexoes;
+    (void)totalSessoes;
+    printf("Erro: O gerador de carga exige Linux (epoll)!\n");
+    return 1;
+}
+#endif
+
+/**
+ * Função: liberarGrafoSalas
+ * Propósito: Liberar um grafo de salas
+ * Parâmetros: grafo - ponteiro para o grafo
+ * Retorno: void
+ */
+void liberarGrafoSalas(GrafoSalas* grafo) {
+    if (grafo == NULL) return;
+    free(grafo->esquerda);
+    free(grafo->direita);
+    free(grafo->pista);
+    free(grafo->nome);
+    free(grafo);
+}
+
+/**
+ * Função: criarGrafoSalas
+ * Propósito: Alocar os vetores de um grafo de salas
+ * Parâmetros: numSalas - número de salas
+ * Retorno: ponteiro para o grafo (vetores não inicializados) ou NULL se faltar memória
+ */
+GrafoSalas* criarGrafoSalas(size_t numSalas) {
+    GrafoSalas* grafo = (GrafoSalas*)calloc(1, sizeof(GrafoSalas));
+    if (grafo == NULL) return NULL;
+    
+    size_t quantidade = numSalas > 0 ? numSalas : 1;
+    grafo->numSalas = numSalas;
+    grafo->esquerda = (uint32_t*)malloc(quantidade * sizeof(uint32_t));
+    grafo->direita = (uint32_t*)malloc(quantidade * sizeof(uint32_t));
+    grafo->pista = (IdTexto*)malloc(quantidade * sizeof(IdTexto));
+    grafo->nome = (IdTexto*)malloc(quantidade * sizeof(IdTexto));
+    if (grafo->esquerda == NULL || grafo->direita == NULL || grafo->pista == NULL || grafo->nome == NULL) {
+        printf("Erro: Falha na alocação de memória para o grafo de salas!\n");
+        liberarGrafoSalas(grafo);
+        return NULL;
+    }
+    return grafo;
+}
+
+/**
+ * Função: grafoDeSalas
+ * Propósito: Converter a árvore de salas (ponteiros) em grafo compacto, em ordem de largura
+ * Parâmetros: hall - sala de entrada
+ * Retorno: ponteiro para o grafo ou NULL em caso de erro
+ */
+GrafoSalas* grafoDeSalas(Sala* hall) {
+    if (hall == NULL) return NULL;
+    
+    // Primeira passada: ordem de largura das salas alcançáveis
+    size_t capacidade = 1024, n = 0;
+    Sala** ordem = (Sala**)malloc(capacidade * sizeof(Sala*));
+    if (ordem == NULL) return NULL;
+    ordem[n++] = hall;
+    for (size_t i = 0; i < n; i++) {
+        if (n + 2 > capacidade) {
+            Sala** maior = (Sala**)realloc(ordem, capacidade * 2 * sizeof(Sala*));
+            if (maior == NULL) {
+                free(ordem);
+                return NULL;
+            }
+            ordem = maior;
+            capacidade *= 2;
+        }
+        if (ordem[i]->esquerda != NULL) ordem[n++] = ordem[i]->esquerda;
+        if (ordem[i]->direita != NULL) ordem[n++] = ordem[i]->direita;
+    }
+    
+    // Segunda passada: os filhos recebem os índices na mesma ordem da primeira
+    GrafoSalas* grafo = n < SALA_NENHUMA ? criarGrafoSalas(n) : NULL;
+    if (grafo != NULL) {
+        size_t proximo = 1;
+        for (size_t i = 0; i < n; i++) {
+            grafo->esquerda[i] = ordem[i]->esquerda != NULL ? (uint32_t)proximo++ : SALA_NENHUMA;
+            grafo->direita[i] = ordem[i]->direita != NULL ? (uint32_t)proximo++ : SALA_NENHUMA;
+            grafo->pista[i] = ordem[i]->pista;
+            grafo->nome[i] = ordem[i]->nome;
+        }
+    }
+    free(ordem);
+    return grafo;
+}
+
+/**
+ * Função: grafoDoMapa
+ * Propósito: Montar o grafo compacto (ordem de largura) das salas de um mapa carregado
+ * alcançáveis a partir da entrada, internando nomes e pistas
+ * Parâmetros: mapa - ponteiro para o mapa
+ * Retorno: ponteiro para o grafo ou NULL em caso de erro
+ */
+GrafoSalas* grafoDoMapa(const MapaMansao* mapa) {
+    uint32_t* fila = (uint32_t*)malloc(mapa->numSalas * sizeof(uint32_t));
+    if (fila == NULL) {
+        printf("Erro: Falha na alocação de memória para montar a mansao!\n");
+        return NULL;
+    }
+    
+    // Percurso em largura a partir da entrada (sem recursão): fila[i] é a sala i do grafo
+    size_t inicio = 0, fim = 0;
+    fila[fim++] = 0;
+    while (inicio < fim) {
+        const RegistroSala* registro = &mapa->salas[fila[inicio++]];
+        if (registro->esquerda != SALA_NENHUMA) fila[fim++] = registro->esquerda;
+        if (registro->direita != SALA_NENHUMA) fila[fim++] = registro->direita;
+    }
+    
+    GrafoSalas* grafo = criarGrafoSalas(fim);
+    if (grafo != NULL) {
+        size_t proximo = 1;
+        for (size_t i = 0; i < fim; i++) {
+            const RegistroSala* registro = &mapa->salas[fila[i]];
+            grafo->esquerda[i] = registro->esquerda != SALA_NENHUMA ? (uint32_t)proximo++ : SALA_NENHUMA;
+            grafo->direita[i] = registro->direita != SALA_NENHUMA ? (uint32_t)proximo++ : SALA_NENHUMA;
+            grafo->nome[i] = internarTexto(mapa->textos + registro->nome);
+            grafo->pista[i] = internarTexto(mapa->textos + registro->pista);
+            if (grafo->nome[i] == ID_TEXTO_INVALIDO || grafo->pista[i] == ID_TEXTO_INVALIDO) {
+                liberarGrafoSalas(grafo);
+                grafo = NULL;
+                break;
+            }
+        }
+    }
+    free(fila);
+    return grafo;
+}
+
+/**
+ * Função: alturaGrafo
+ * Propósito: Calcular a altura (número de níveis) de um grafo em ordem de largura
+ * Parâmetros: grafo - ponteiro para o grafo (filhos sempre depois do pai)
+ * Retorno: altura do grafo (0 se vazio)
+ */
+static uint32_t alturaGrafo(const GrafoSalas* grafo) {
+    if (grafo->numSalas == 0) return 0;
+    uint32_t* nivel = (uint32_t*)malloc(grafo->numSalas * sizeof(uint32_t));
+    if (nivel == NULL) return 0;
+    
+    uint32_t altura = 1;
+    nivel[0] = 1;
+    for (size_t i = 0; i < grafo->numSalas; i++) {
+        if (nivel[i] > altura) altura = nivel[i];
+        if (grafo->esquerda[i] != SALA_NENHUMA) nivel[grafo->esquerda[i]] = nivel[i] + 1;
+        if (grafo->direita[i] != SALA_NENHUMA) nivel[grafo->direita[i]] = nivel[i] + 1;
+    }
+    free(nivel);
+    return altura;
+}
+
+/**
+ * Função: disporVanEmdeBoas
+ * Propósito: Escrever em "saida" as salas da subárvore de "raiz" com profundidade relativa
+ * menor que "altura", em ordem van Emde Boas: primeiro a metade de cima, depois cada
+ * subárvore de baixo (da esquerda para a direita), recursivamente. A recursão tem
+ * profundidade O(log altura); as descidas dentro de cada metade usam pilha explícita
+ * Parâmetros: grafo - grafo de origem
+ *             raiz - raiz da subárvore
+ *             altura - quantos níveis dispor a partir da raiz
+ *             saida - vetor de índices na nova ordem
+ *             posicao - próxima posição livre em saida
+ * Retorno: nova posição livre em saida (0 indica falta de memória)
+ */
+static size_t disporVanEmdeBoas(const GrafoSalas* grafo, uint32_t raiz, uint32_t altura, uint32_t* saida,
+                                size_t posicao) {
+    if (altura == 1) {
+        saida[posicao++] = raiz;
+        return posicao;
+    }
+    
+    uint32_t alturaCima = altura / 2;
+    uint32_t alturaBaixo = altura - alturaCima;
+    posicao = disporVanEmdeBoas(grafo, raiz, alturaCima, saida, posicao);
+    if (posicao == 0) return 0;
+    
+    // Raízes das subárvores de baixo: salas na profundidade relativa alturaCima
+    size_t capacidade = 64, topo = 0;
+    uint32_t* pilhaSalas = (uint32_t*)malloc(capacidade * sizeof(uint32_t));
+    uint32_t* pilhaNiveis = (uint32_t*)malloc(capacidade * sizeof(uint32_t));
+    if (pilhaSalas == NULL || pilhaNiveis == NULL) {
+        free(pilhaSalas);
+        free(pilhaNiveis);
+        return 0;
+    }
+    pilhaSalas[topo] = raiz;
+    pilhaNiveis[topo++] = 0;
+    while (topo > 0) {
+        uint32_t sala = pilhaSalas[--topo];
+        uint32_t nivel = pilhaNiveis[topo];
+        if (nivel == alturaCima) {
+            posicao = disporVanEmdeBoas(grafo, sala, alturaBaixo, saida, posicao);
+            if (posicao == 0) break;
+            continue;
+        }
+        if (topo + 2 > capacidade) {
+            uint32_t* maisSalas = (uint32_t*)realloc(pilhaSalas, capacidade * 2 * sizeof(uint32_t));
+            if (maisSalas != NULL) pilhaSalas = maisSalas;
+            uint32_t* maisNiveis = (uint32_t*)realloc(pilhaNiveis, capacidade * 2 * sizeof(uint32_t));
+            if (maisNiveis != NULL) pilhaNiveis = maisNiveis;
+            if (maisSalas == NULL || maisNiveis == NULL) {
+                posicao = 0;
+                break;
+            }
+            capacidade *= 2;
+        }
+        // A direita é empilhada primeiro para que a esquerda saia antes
+        if (grafo->direita[sala] != SALA_NENHUMA) {
+            pilhaSalas[topo] = grafo->direita[sala];
+            pilhaNiveis[topo++] = nivel + 1;
+        }
+        if (grafo->esquerda[sala] != SALA_NENHUMA) {
+            pilhaSalas[topo] = grafo->esquerda[sala];
+            pilhaNiveis[topo++] = nivel + 1;
+        }
+    }
+    
+    free(pilhaSalas);
+    free(pilhaNiveis);
+    return posicao;
+}
+
+/**
+ * Função: reordenarGrafo
+ * Propósito: Criar uma cópia do grafo com as salas dispostas em outra ordem de memória
+ * (a entrada continua sendo a sala 0)
+ * Parâmetros: grafo - grafo em ordem de largura (como produzido por grafoDeSalas/grafoDoMapa)
+ *             ordem - ordem desejada
+ * Retorno: ponteiro para o novo grafo ou NULL em caso de erro
+ */
+GrafoSalas* reordenarGrafo(const GrafoSalas* grafo, OrdemGrafo ordem) {
+    size_t n = grafo->numSalas;
+    uint32_t* sequencia = (uint32_t*)malloc((n > 0 ? n : 1) * sizeof(uint32_t));
+    uint32_t* novoIndice = (uint32_t*)malloc((n > 0 ? n : 1) * sizeof(uint32_t));
+    GrafoSalas* novo = criarGrafoSalas(n);
+    if (sequencia == NULL || novoIndice == NULL || novo == NULL) {
+        free(sequencia);
+        free(novoIndice);
+        liberarGrafoSalas(novo);
+        return NULL;
+    }
+    
+    size_t dispostas = n;
+    if (ordem == ORDEM_VEB && n > 0) {
+        dispostas = disporVanEmdeBoas(grafo, 0, alturaGrafo(grafo), sequencia, 0);
+    } else {
+        for (size_t i = 0; i < n; i++) sequencia[i] = (uint32_t)i;
+    }
+    if (dispostas != n) {
+        printf("Erro: Falha ao reordenar o grafo de salas!\n");
+        free(sequencia);
+        free(novoIndice);
+        liberarGrafoSalas(novo);
+        return NULL;
+    }
+    
+    for (size_t i = 0; i < n; i++) novoIndice[sequencia[i]] = (uint32_t)i;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t antiga = sequencia[i];
+        novo->esquerda[i] = grafo->esquerda[antiga] != SALA_NENHUMA ? novoIndice[grafo->esquerda[antiga]] : SALA_NENHUMA;
+        novo->direita[i] = grafo->direita[antiga] != SALA_NENHUMA ? novoIndice[grafo->direita[antiga]] : SALA_NENHUMA;
+        novo->pista[i] = grafo->pista[antiga];
+        novo->nome[i] = grafo->nome[antiga];
+    }
+    
+    free(sequencia);
+    free(novoIndice);
+    return novo;
+}
+
+/**
+ * Função: construirSalasDoGrafo
+ * Propósito: Adaptador para o jogo interativo: montar a árvore de salas (Sala*) a partir
+ * do grafo compacto. Os nós são alocados na ordem do grafo (contíguos com uma arena ativa)
+ * Parâmetros: grafo - ponteiro para o grafo
+ * Retorno: ponteiro para a sala de entrada ou NULL em caso de erro
+ */
+Sala* construirSalasDoGrafo(const GrafoSalas* grafo) {
+    if (grafo == NULL || grafo->numSalas == 0) return NULL;
+    
+    Sala** salas = (Sala**)malloc(grafo->numSalas * sizeof(Sala*));
+    if (salas == NULL) {
+        printf("Erro: Falha na alocação de memória para montar a mansao!\n");
+        return NULL;
+    }
+    for (size_t i = 0; i < grafo->numSalas; i++) {
+        salas[i] = (Sala*)alocarNo(sizeof(Sala));
+        if (salas[i] == NULL) {
+            printf("Erro: Falha na alocação de memória!\n");
+            for (size_t j = 0; j < i && arenaAtual == NULL; j++) liberarNo(salas[j]);
+            free(salas);
+            return NULL;
+        }
+        salas[i]->nome = grafo->nome[i];
+        salas[i]->pista = grafo->pista[i];
+        salas[i]->salasAteCondenacao = CONDENACAO_NAO_CALCULADA;
+    }
+    for (size_t i = 0; i < grafo->numSalas; i++) {
+        salas[i]->esquerda = grafo->esquerda[i] != SALA_NENHUMA ? salas[grafo->esquerda[i]] : NULL;
+        salas[i]->direita = grafo->direita[i] != SALA_NENHUMA ? salas[grafo->direita[i]] : NULL;
+    }
+    
+    Sala* entrada = salas[0];
+    free(salas);
+    return entrada;
+}
+
+/**
+ * Função: liberarMansaoIndexada
+ * Propósito: Liberar os vetores de uma mansão indexada
+ * Parâmetros: mansao - ponteiro para a mansão indexada
+ * Retorno: void
+ */
+void liberarMansaoIndexada(MansaoIndexada* mansao) {
+    if (mansao == NULL) return;
+    liberarGrafoSalas(mansao->grafo);
+    free(mansao->pai);
+    free(mansao->profundidade);
+    free(mansao->pista);
+    free(mansao->folhas);
+    free(mansao->temPista);
+    free(mansao->suspeitoDaPista);
+    free(mansao->idSuspeito);
+    free(mansao->pistasDoSuspeito);
+    free(mansao);
+}
+
+/**
+ * Função: indexarMansao
+ * Propósito: Converter a árvore de salas em grafo compacto (ordem de largura), resolvendo
+ * cada pista para seu suspeito e calculando, de baixo para cima, as folhas e a presença
+ * de pistas de cada subárvore
+ * Parâmetros: hall - sala de entrada
+ *             tabela - tabela hash de suspeitos
+ * Retorno: ponteiro para a mansão indexada ou NULL em caso de erro
+ */
+MansaoIndexada* indexarMansao(Sala* hall, TabelaHash* tabela) {
+    MansaoIndexada* mansao = (MansaoIndexada*)calloc(1, sizeof(MansaoIndexada));
+    if (mansao == NULL) return NULL;
+    mansao->grafo = grafoDeSalas(hall);
+    if (mansao->grafo == NULL || mansao->grafo->numSalas >= MARCA_SAIDA_SALA) {
+        liberarMansaoIndexada(mansao);
+        return NULL;
+    }
+    
+    const GrafoSalas* grafo = mansao->grafo;
+    size_t n = grafo->numSalas;
+    size_t numTextos = textosInternados.quantidade;
+    uint32_t* pistaPorTexto = (uint32_t*)malloc(numTextos * sizeof(uint32_t));
+    uint32_t* suspeitoPorTexto = (uint32_t*)malloc(numTextos * sizeof(uint32_t));
+    mansao->numSalas = n;
+    mansao->pai = (uint32_t*)malloc(n * sizeof(uint32_t));
+    mansao->profundidade = (uint32_t*)malloc(n * sizeof(uint32_t));
+    mansao->pista = (uint32_t*)malloc(n * sizeof(uint32_t));
+    mansao->folhas = (uint64_t*)malloc(n * sizeof(uint64_t));
+    mansao->temPista = (uint8_t*)malloc(n);
+    mansao->suspeitoDaPista = (uint32_t*)malloc(n * sizeof(uint32_t));
+    mansao->idSuspeito = (IdTexto*)malloc(n * sizeof(IdTexto));
+    mansao->pistasDoSuspeito = (uint32_t*)calloc(n, sizeof(uint32_t));
+    if (pistaPorTexto == NULL || suspeitoPorTexto == NULL || mansao->pai == NULL || mansao->profundidade == NULL ||
+        mansao->pista == NULL || mansao->folhas == NULL || mansao->temPista == NULL ||
+        mansao->suspeitoDaPista == NULL || mansao->idSuspeito == NULL || mansao->pistasDoSuspeito == NULL) {
+        free(pistaPorTexto);
+        free(suspeitoPorTexto);
+        liberarMansaoIndexada(mansao);
+        return NULL;
+    }
+    memset(pistaPorTexto, 0xff, numTextos * sizeof(uint32_t));
+    memset(suspeitoPorTexto, 0xff, numTextos * sizeof(uint32_t));
+    
+    // De cima para baixo: pais, profundidades e índices compactos de pistas e suspeitos
+    mansao->pai[0] = SALA_NENHUMA;
+    mansao->profundidade[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t filhos[2] = { grafo->esquerda[i], grafo->direita[i] };
+        for (int f = 0; f < 2; f++) {
+            if (filhos[f] == SALA_NENHUMA) continue;
+            mansao->pai[filhos[f]] = (uint32_t)i;
+            mansao->profundidade[filhos[f]] = mansao->profundidade[i] + 1;
+        }
+        if (mansao->profundidade[i] > mansao->profundidadeMaxima) {
+            mansao->profundidadeMaxima = mansao->profundidade[i];
+        }
+        
+        mansao->pista[i] = INDICE_NENHUM;
+        IdTexto pista = grafo->pista[i];
+        IdTexto suspeito = pista != ID_TEXTO_VAZIO ? encontrarSuspeitoPorId(tabela, pista) : ID_TEXTO_INVALIDO;
+        if (suspeito == ID_TEXTO_INVALIDO) continue;
+        
+        if (suspeitoPorTexto[suspeito] == INDICE_NENHUM) {
+            suspeitoPorTexto[suspeito] = (uint32_t)mansao->numSuspeitos;
+            mansao->idSuspeito[mansao->numSuspeitos++] = suspeito;
+        }
+        if (pistaPorTexto[pista] == INDICE_NENHUM) {
+            pistaPorTexto[pista] = (uint32_t)mansao->numPistas;
+            mansao->suspeitoDaPista[mansao->numPistas++] = suspeitoPorTexto[suspeito];
+            mansao->pistasDoSuspeito[suspeitoPorTexto[suspeito]]++;
+        }
+        mansao->pista[i] = pistaPorTexto[pista];
+    }
+    free(pistaPorTexto);
+    free(suspeitoPorTexto);
+    
+    // De baixo para cima: os filhos têm índices maiores que o pai
+    for (size_t i = n; i-- > 0;) {
+        uint32_t esquerda = grafo->esquerda[i];
+        uint32_t direita = grafo->direita[i];
+        if (esquerda == SALA_NENHUMA && direita == SALA_NENHUMA) {
+            mansao->folhas[i] = 1;
+            mansao->temPista[i] = mansao->pista[i] != INDICE_NENHUM;
+            continue;
+        }
+        mansao->folhas[i] = (esquerda != SALA_NENHUMA ? mansao->folhas[esquerda] : 0) +
+                            (direita != SALA_NENHUMA ? mansao->folhas[direita] : 0);
+        mansao->temPista[i] = mansao->pista[i] != INDICE_NENHUM ||
+                              (esquerda != SALA_NENHUMA && mansao->temPista[esquerda]) ||
+                              (direita != SALA_NENHUMA && mansao->temPista[direita]);
+    }
+    
+    return mansao;
+}
+
+/**
+ * Função: entrarSalaSolucionador
+ * Propósito: Atualizar as contagens do caminho ao entrar em uma sala
+ * Parâmetros: estado - estado da thread
+ *             sala - sala em que se entra
+ * Retorno: void
+ */
+static void entrarSalaSolucionador(EstadoSolucionador* estado, uint32_t sala) {
+    const MansaoIndexada* mansao = estado->mansao;
+    uint32_t pista = mansao->pista[sala];
+    if (pista == INDICE_NENHUM || estado->contagemPista[pista]++ > 0) return;
+    
+    uint32_t suspeito = mansao->suspeitoDaPista[pista];
+    if (++estado->contagemSuspeito[suspeito] != PISTAS_PARA_CONDENACAO) return;
+    
+    estado->posicaoCondenavel[suspeito] = (uint32_t)estado->numCondenaveis;
+    estado->condenaveis[estado->numCondenaveis++] = suspeito;
+    
+    // Empates ficam com o menor índice: o resultado não depende da divisão entre threads
+    uint32_t atual = estado->salaMaisRasa[suspeito];
+    if (atual == SALA_NENHUMA || mansao->profundidade[sala] < mansao->profundidade[atual] ||
+        (mansao->profundidade[sala] == mansao->profundidade[atual] && sala < atual)) {
+        estado->salaMaisRasa[suspeito] = sala;
+    }
+}
+
+/**
+ * Função: sairSalaSolucionador
+ * Propósito: Desfazer as contagens de uma sala ao voltar no percurso
+ * Parâmetros: estado - estado da thread
+ *             sala - sala de que se sai
+ * Retorno: void
+ */
+static void sairSalaSolucionador(EstadoSolucionador* estado, uint32_t sala) {
+    const MansaoIndexada* mansao = estado->mansao;
+    uint32_t pista = mansao->pista[sala];
+    if (pista == INDICE_NENHUM || --estado->contagemPista[pista] > 0) return;
+    
+    uint32_t suspeito = mansao->suspeitoDaPista[pista];
+    if (estado->contagemSuspeito[suspeito]-- != PISTAS_PARA_CONDENACAO) return;
+    
+    // Remove o suspeito dos condenáveis trocando-o com o último
+    uint32_t posicao = estado->posicaoCondenavel[suspeito];
+    uint32_t ultimo = estado->condenaveis[--estado->numCondenaveis];
+    estado->condenaveis[posicao] = ultimo;
+    estado->posicaoCondenavel[ultimo] = posicao;
+}
+
+/**
+ * Função: contarCaminhosSolucionador
+ * Propósito: Contabilizar caminhos completos que terminam com o estado atual
+ * Parâmetros: estado - estado da thread
+ *             sala - sala em que os caminhos se separam do estado atual
+ *             folhas - quantidade de caminhos
+ * Retorno: void
+ */
+static void contarCaminhosSolucionador(EstadoSolucionador* estado, uint32_t sala, uint64_t folhas) {
+    estado->caminhos += folhas;
+    if (estado->numCondenaveis == 0) {
+        if (estado->numExemplos < MAX_EXEMPLOS_SEM_SOLUCAO) {
+            estado->exemplosSemSolucao[estado->numExemplos++] = sala;
+        }
+        return;
+    }
+    estado->caminhosResolviveis += folhas;
+    for (size_t i = 0; i < estado->numCondenaveis; i++) {
+        estado->caminhosPorSuspeito[estado->condenaveis[i]] += folhas;
+    }
+}
+
+/**
+ * Função: resolverSubarvore
+ * Propósito: Percorrer (com pilha explícita) todos os caminhos de uma subárvore,
+ * mantendo as contagens incrementalmente; subárvores sem pistas não mudam o estado e
+ * são contadas de uma vez pelo número de folhas
+ * Parâmetros: estado - estado da thread
+ *             raiz - sala raiz da subárvore
+ * Retorno: void
+ */
+static void resolverSubarvore(EstadoSolucionador* estado, uint32_t raiz) {
+    const MansaoIndexada* mansao = estado->mansao;
+    
+    // Reconstrói o estado do caminho do hall até a raiz da subárvore
+    size_t topo = 0;
+    for (uint32_t sala = mansao->pai[raiz]; sala != SALA_NENHUMA; sala = mansao->pai[sala]) {
+        estado->pilha[topo++] = sala;
+    }
+    while (topo > 0) {
+        entrarSalaSolucionador(estado, estado->pilha[--topo]);
+    }
+    
+    estado->pilha[topo++] = raiz;
+    while (topo > 0) {
+        uint32_t item = estado->pilha[--topo];
+        if (item & MARCA_SAIDA_SALA) {
+            sairSalaSolucionador(estado, item & ~MARCA_SAIDA_SALA);
+            continue;
+        }
+        
+        entrarSalaSolucionador(estado, item);
+        uint32_t filhos[2] = { mansao->grafo->esquerda[item], mansao->grafo->direita[item] };
+        if (filhos[0] == SALA_NENHUMA && filhos[1] == SALA_NENHUMA) {
+            contarCaminhosSolucionador(estado, item, 1);
+            sairSalaSolucionador(estado, item);
+            continue;
+        }
+        
+        estado->pilha[topo++] = item | MARCA_SAIDA_SALA;
+        for (int f = 1; f >= 0; f--) {
+            if (filhos[f] == SALA_NENHUMA) continue;
+            if (mansao->temPista[filhos[f]]) {
+                estado->pilha[topo++] = filhos[f];
+            } else {
+                contarCaminhosSolucionador(estado, filhos[f], mansao->folhas[filhos[f]]);
+            }
+        }
+    }
+    
+    for (uint32_t sala = mansao->pai[raiz]; sala != SALA_NENHUMA; sala = mansao->pai[sala]) {
+        sairSalaSolucionador(estado, sala);
+    }
+}
+
+/**
+ * Função: trabalharSolucionador
+ * Propósito: Corpo de uma thread do solucionador: resolve as subárvores da própria faixa
+ * e depois rouba subárvores das faixas das outras threads
+ * Parâmetros: argumento - ponteiro para o EstadoSolucionador da thread
+ * Retorno: NULL
+ */
+static void* trabalharSolucionador(void* argumento) {
+    EstadoSolucionador* estado = (EstadoSolucionador*)argumento;
+    size_t inicio, fim;
+    for (int passo = 0; passo < estado->numThreads; passo++) {
+        FaixaTrabalho* faixa = &estado->faixas[(estado->id + passo) % estado->numThreads];
+        while (retirarFatia(faixa, 1, &inicio, &fim)) {
+            resolverSubarvore(estado, estado->tarefas[inicio]);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Função: descreverCaminho
+ * Propósito: Escrever os movimentos ('e'/'d') do hall até uma sala
+ * Parâmetros: mansao - mansão indexada
+ *             sala - sala de destino
+ *             destino - buffer com pelo menos profundidade + 1 posições
+ * Retorno: void
+ */
+static void descreverCaminho(const MansaoIndexada* mansao, uint32_t sala, char* destino) {
+    uint32_t profundidade = mansao->profundidade[sala];
+    destino[profundidade] = '\0';
+    for (; mansao->pai[sala] != SALA_NENHUMA; sala = mansao->pai[sala]) {
+        destino[--profundidade] = mansao->grafo->esquerda[mansao->pai[sala]] == sala ? 'e' : 'd';
+    }
+}
+
+/**
+ * Função: executarSolucionador
+ * Propósito: Enumerar todos os caminhos do hall até as folhas e, para cada suspeito,
+ * informar em quantos caminhos ele pode ser condenado (>= PISTAS_PARA_CONDENACAO pistas), o caminho mais curto
+ * até isso e se ele é condenável quando o jogador pode voltar e visitar toda a mansão
+ * Parâmetros: hall - sala de entrada
+ *             tabela - tabela hash de suspeitos
+ *             numThreads - threads de trabalho
+ * Retorno: 0 se todo caminho permite uma acusação, 2 se algum não permite, 1 em caso de erro
+ */
+int executarSolucionador(Sala* hall, TabelaHash* tabela, int numThreads) {
+    double inicio = tempoAtualSegundos();
+    MansaoIndexada* mansao = indexarMansao(hall, tabela);
+    if (mansao == NULL) {
+        printf("Erro: Nao foi possivel indexar a mansao!\n");
+        return 1;
+    }
+    double tempoIndexacao = tempoAtualSegundos() - inicio;
+    
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > MAX_THREADS_LOTE) numThreads = MAX_THREADS_LOTE;
+    
+    // Divide a mansão em subárvores: expande em largura até haver tarefas suficientes
+    size_t n = mansao->numSalas;
+    size_t alvo = (size_t)numThreads > 1 ? (size_t)numThreads * TAREFAS_POR_THREAD : 1;
+    uint32_t* tarefas = (uint32_t*)malloc(n * sizeof(uint32_t));
+    uint32_t* fila = (uint32_t*)malloc(n * sizeof(uint32_t));
+    FaixaTrabalho* faixas = (FaixaTrabalho*)calloc((size_t)numThreads, sizeof(FaixaTrabalho));
+    EstadoSolucionador* estados = (EstadoSolucionador*)calloc((size_t)numThreads, sizeof(EstadoSolucionador));
+    if (tarefas == NULL || fila == NULL || faixas == NULL || estados == NULL) {
+        printf("Erro: Falha na alocação de memória para o solucionador!\n");
+        free(tarefas);
+        free(fila);
+        free(faixas);
+        free(estados);
+        liberarMansaoIndexada(mansao);
+        return 1;
+    }
+    size_t numTarefas = 0, cabeca = 0, cauda = 0;
+    fila[cauda++] = 0;
+    while (cabeca < cauda && numTarefas + (cauda - cabeca) < alvo) {
+        uint32_t sala = fila[cabeca++];
+        uint32_t esquerda = mansao->grafo->esquerda[sala];
+        uint32_t direita = mansao->grafo->direita[sala];
+        if ((esquerda == SALA_NENHUMA && direita == SALA_NENHUMA) || !mansao->temPista[sala]) {
+            tarefas[numTarefas++] = sala;  // Nada a dividir abaixo desta sala
+            continue;
+        }
+        if (esquerda != SALA_NENHUMA) fila[cauda++] = esquerda;
+        if (direita != SALA_NENHUMA) fila[cauda++] = direita;
+    }
+    while (cabeca < cauda) tarefas[numTarefas++] = fila[cabeca++];
+    free(fila);
+    dividirEmFaixas(faixas, numThreads, numTarefas);
+    
+    // Estado próprio por thread; a pilha comporta saída + dois filhos por nível
+    size_t tamanhoPilha = 3 * ((size_t)mansao->profundidadeMaxima + 1) + 2;
+    size_t numSuspeitos = mansao->numSuspeitos > 0 ? mansao->numSuspeitos : 1;
+    int ok = 1;
+    for (int t = 0; t < numThreads; t++) {
+        EstadoSolucionador* estado = &estados[t];
+        estado->mansao = mansao;
+        estado->tarefas = tarefas;
+        estado->faixas = faixas;
+        estado->id = t;
+        estado->numThreads = numThreads;
+        estado->contagemPista = (uint32_t*)calloc(mansao->numPistas > 0 ? mansao->numPistas : 1, sizeof(uint32_t));
+        estado->contagemSuspeito = (uint32_t*)calloc(numSuspeitos, sizeof(uint32_t));
+        estado->condenaveis = (uint32_t*)malloc(numSuspeitos * sizeof(uint32_t));
+        estado->posicaoCondenavel = (uint32_t*)malloc(numSuspeitos * sizeof(uint32_t));
+        estado->pilha = (uint32_t*)malloc(tamanhoPilha * sizeof(uint32_t));
+        estado->caminhosPorSuspeito = (uint64_t*)calloc(numSuspeitos, sizeof(uint64_t));
+        estado->salaMaisRasa = (uint32_t*)malloc(numSuspeitos * sizeof(uint32_t));
+        if (estado->contagemPista == NULL || estado->contagemSuspeito == NULL || estado->condenaveis == NULL ||
+            estado->posicaoCondenavel == NULL || estado->pilha == NULL || estado->caminhosPorSuspeito == NULL ||
+            estado->salaMaisRasa == NULL) {
+            ok = 0;
+            break;
+        }
+        memset(estado->salaMaisRasa, 0xff, numSuspeitos * sizeof(uint32_t));
+    }
+    
+    double tempoResolucao = 0.0;
+    if (ok) {
+        inicio = tempoAtualSegundos();
+        executarEmThreads(numThreads, trabalharSolucionador, estados, sizeof(EstadoSolucionador));
+        tempoResolucao = tempoAtualSegundos() - inicio;
+    } else {
+        printf("Erro: Falha na alocação de memória para o solucionador!\n");
+    }
+    
+    // Junta os totais das threads no estado 0
+    EstadoSolucionador* total = &estados[0];
+    for (int t = 1; ok && t < numThreads; t++) {
+        EstadoSolucionador* estado = &estados[t];
+        total->caminhos += estado->caminhos;
+        total->caminhosResolviveis += estado->caminhosResolviveis;
+        for (size_t s = 0; s < mansao->numSuspeitos; s++) {
+            total->caminhosPorSuspeito[s] += estado->caminhosPorSuspeito[s];
+            uint32_t sala = estado->salaMaisRasa[s];
+            uint32_t atual = total->salaMaisRasa[s];
+            if (sala != SALA_NENHUMA && (atual == SALA_NENHUMA || mansao->profundidade[sala] < mansao->profundidade[atual] ||
+                                         (mansao->profundidade[sala] == mansao->profundidade[atual] && sala < atual))) {
+                total->salaMaisRasa[s] = sala;
+            }
+        }
+        for (size_t e = 0; e < estado->numExemplos && total->numExemplos < MAX_EXEMPLOS_SEM_SOLUCAO; e++) {
+            total->exemplosSemSolucao[total->numExemplos++] = estado->exemplosSemSolucao[e];
+        }
+    }
+    
+    int codigo = 1;
+    char* caminho = (char*)malloc((size_t)mansao->profundidadeMaxima + 1);
+    if (ok && caminho != NULL) {
+        printf("=== SOLUCIONADOR: TODOS OS CAMINHOS DA MANSAO ===\n");
+        printf("Salas: %zu | Profundidade maxima: %u | Pistas com suspeito: %zu | Suspeitos: %zu\n",
+               mansao->numSalas, mansao->profundidadeMaxima, mansao->numPistas, mansao->numSuspeitos);
+        printf("Caminhos completos: %llu | Com acusacao possivel: %llu | Sem acusacao possivel: %llu\n",
+               (unsigned long long)total->caminhos, (unsigned long long)total->caminhosResolviveis,
+               (unsigned long long)(total->caminhos - total->caminhosResolviveis));
+        printf("Tempo: indexacao %.3f ms, resolucao %.3f ms (%d threads, %zu subarvores)\n\n",
+               tempoIndexacao * 1e3, tempoResolucao * 1e3, numThreads, numTarefas);
+        
+        // "com volta": condenável se o jogador puder voltar e visitar a mansão inteira
+        printf("%-24s | %6s | %12s | %9s | %s\n", "suspeito", "pistas", "caminhos", "com volta",
+               "caminho mais curto ate a condenacao");
+        for (size_t s = 0; s < mansao->numSuspeitos; s++) {
+            uint32_t sala = total->salaMaisRasa[s];
+            if (sala != SALA_NENHUMA) descreverCaminho(mansao, sala, caminho);
+            printf("%-24s | %6u | %12llu | %9s | %s%s%s\n", textoDoId(mansao->idSuspeito[s]),
+                   mansao->pistasDoSuspeito[s], (unsigned long long)total->caminhosPorSuspeito[s],
+                   mansao->pistasDoSuspeito[s] >= PISTAS_PARA_CONDENACAO ? "sim" : "nao",
+                   sala == SALA_NENHUMA ? "-" : caminho[0] != '\0' ? caminho : "(hall)",
+                   sala == SALA_NENHUMA ? "" : " -> ", sala == SALA_NENHUMA ? "" : textoDoId(mansao->grafo->nome[sala]));
+        }
+        
+        if (total->numExemplos > 0) {
+            printf("\nCaminhos sem acusacao possivel (exemplos; nada muda depois desta sala):\n");
+            for (size_t e = 0; e < total->numExemplos; e++) {
+                uint32_t sala = total->exemplosSemSolucao[e];
+                descreverCaminho(mansao, sala, caminho);
+                printf("  %s -> %s\n", caminho[0] != '\0' ? caminho : "(hall)", textoDoId(mansao->grafo->nome[sala]));
+            }
+        }
+        codigo = total->caminhos == total->caminhosResolviveis ? 0 : 2;
+    }
+    free(caminho);
+    
+    for (int t = 0; t < numThreads; t++) {
+        free(estados[t].contagemPista);
+        free(estados[t].contagemSuspeito);
+        free(estados[t].condenaveis);
+        free(estados[t].posicaoCondenavel);
+        free(estados[t].pilha);
+        free(estados[t].caminhosPorSuspeito);
+        free(estados[t].salaMaisRasa);
+    }
+    free(estados);
+    free(faixas);
+    free(tarefas);
+    liberarMansaoIndexada(mansao);
+    return codigo;
+}
+
+/**
+ * Função: iniciarConstrutorMapa
+ * Propósito: Preparar um construtor de mapa vazio (o bloco de textos começa com o texto vazio)
+ * Parâmetros: construtor - ponteiro para o construtor
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória
+ */
+int iniciarConstrutorMapa(ConstrutorMapa* construtor) {
+    memset(construtor, 0, sizeof(ConstrutorMapa));
+    construtor->capacidadeTextos = 4096;
+    construtor->textos = (char*)malloc(construtor->capacidadeTextos);
+    construtor->capacidadePosicoes = CAPACIDADE_INICIAL_HASH;
+    construtor->posicoes = (uint32_t*)malloc(construtor->capacidadePosicoes * sizeof(uint32_t));
+    if (construtor->textos == NULL || construtor->posicoes == NULL) {
+        printf("Erro: Falha na alocação de memória para o mapa!\n");
+        free(construtor->textos);
+        free(construtor->posicoes);
+        return 0;
+    }
+    memset(construtor->posicoes, 0xff, construtor->capacidadePosicoes * sizeof(uint32_t));
+    construtor->textos[0] = '\0';
+    construtor->tamanhoTextos = 1;
+    return 1;
+}
+
+/**
+ * Função: adicionarTextoMapa
+ * Propósito: Guardar um texto no bloco de textos do mapa (textos repetidos são reaproveitados)
+ * Parâmetros: construtor - ponteiro para o construtor
+ *             texto - string a guardar
+ * Retorno: deslocamento do texto no bloco (UINT32_MAX se faltou memória ou o bloco passou de 4 GiB)
+ */
+uint32_t adicionarTextoMapa(ConstrutorMapa* construtor, const char* texto) {
+    if (texto[0] == '\0') return 0;
+    
+    size_t mascara = construtor->capacidadePosicoes - 1;
+    size_t posicao = (size_t)funcaoHash(texto) & mascara;
+    while (construtor->posicoes[posicao] != UINT32_MAX) {
+        if (strcmp(construtor->textos + construtor->posicoes[posicao], texto) == 0) {
+            return construtor->posicoes[posicao];
+        }
+        posicao = (posicao + 1) & mascara;
+    }
+    
+    size_t tamanho = strlen(texto) + 1;
+    if (construtor->tamanhoTextos + tamanho > UINT32_MAX) return UINT32_MAX;
+    if (construtor->tamanhoTextos + tamanho > construtor->capacidadeTextos) {
+        size_t novaCapacidade = construtor->capacidadeTextos * 2;
+        while (novaCapacidade < construtor->tamanhoTextos + tamanho) novaCapacidade *= 2;
+        char* novos = (char*)realloc(construtor->textos, novaCapacidade);
+        if (novos == NULL) return UINT32_MAX;
+        construtor->textos = novos;
+        construtor->capacidadeTextos = novaCapacidade;
+    }
+    
+    uint32_t deslocamento = (uint32_t)construtor->tamanhoTextos;
+    memcpy(construtor->textos + deslocamento, texto, tamanho);
+    construtor->tamanhoTextos += tamanho;
+    construtor->posicoes[posicao] = deslocamento;
+    construtor->numTextos++;
+    
+    // Mantém a ocupação das posições abaixo de 1/2
+    if (construtor->numTextos * 2 > construtor->capacidadePosicoes) {
+        size_t novaCapacidade = construtor->capacidadePosicoes * 2;
+        uint32_t* novas = (uint32_t*)malloc(novaCapacidade * sizeof(uint32_t));
+        if (novas == NULL) return UINT32_MAX;
+        memset(novas, 0xff, novaCapacidade * sizeof(uint32_t));
+        for (size_t i = 0; i < construtor->capacidadePosicoes; i++) {
+            uint32_t atual = construtor->posicoes[i];
+            if (atual == UINT32_MAX) continue;
+            size_t p = (size_t)funcaoHash(construtor->textos + atual) & (novaCapacidade - 1);
+            while (novas[p] != UINT32_MAX) p = (p + 1) & (novaCapacidade - 1);
+            novas[p] = atual;
+        }
+        free(construtor->posicoes);
+        construtor->posicoes = novas;
+        construtor->capacidadePosicoes = novaCapacidade;
+    }
+    
+    return deslocamento;
+}
+
+/**
+ * Função: adicionarSalaMapa
+ * Propósito: Acrescentar uma sala ao mapa em construção
+ * Parâmetros: construtor - ponteiro para o construtor
+ *             nome - nome da sala
+ *             pista - pista da sala (vazia se não houver)
+ *             esquerda, direita - índices das salas filhas (SALA_NENHUMA se não houver)
+ * Retorno: índice da nova sala ou SALA_NENHUMA se faltou memória
+ */
+uint32_t adicionarSalaMapa(ConstrutorMapa* construtor, const char* nome, const char* pista,
+                           uint32_t esquerda, uint32_t direita) {
+    if (construtor->numSalas == construtor->capacidadeSalas) {
+        size_t novaCapacidade = construtor->capacidadeSalas == 0 ? 64 : construtor->capacidadeSalas * 2;
+        RegistroSala* novas = (RegistroSala*)realloc(construtor->salas, novaCapacidade * sizeof(RegistroSala));
+        if (novas == NULL) return SALA_NENHUMA;
+        construtor->salas = novas;
+        construtor->capacidadeSalas = novaCapacidade;
+    }
+    
+    RegistroSala registro;
+    registro.esquerda = esquerda;
+    registro.direita = direita;
+    registro.nome = adicionarTextoMapa(construtor, nome);
+    registro.pista = adicionarTextoMapa(construtor, pista);
+    if (registro.nome == UINT32_MAX || registro.pista == UINT32_MAX) return SALA_NENHUMA;
+    
+    construtor->salas[construtor->numSalas] = registro;
+    return (uint32_t)construtor->numSalas++;
+}
+
+/**
+ * Função: adicionarAssociacaoMapa
+ * Propósito: Acrescentar uma associação pista/suspeito ao mapa em construção
+ * Parâmetros: construtor - ponteiro para o construtor
+ *             pista - texto da pista
+ *             suspeito - nome do suspeito
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória
+ */
+int adicionarAssociacaoMapa(ConstrutorMapa* construtor, const char* pista, const char* suspeito) {
+    if (construtor->numAssociacoes == construtor->capacidadeAssociacoes) {
+        size_t novaCapacidade = construtor->capacidadeAssociacoes == 0 ? 16 : construtor->capacidadeAssociacoes * 2;
+        RegistroAssociacao* novas = (RegistroAssociacao*)realloc(construtor->associacoes,
+                                                                 novaCapacidade * sizeof(RegistroAssociacao));
+        if (novas == NULL) return 0;
+        construtor->associacoes = novas;
+        construtor->capacidadeAssociacoes = novaCapacidade;
+    }
+    
+    RegistroAssociacao registro;
+    registro.pista = adicionarTextoMapa(construtor, pista);
+    registro.suspeito = adicionarTextoMapa(construtor, suspeito);
+    if (registro.pista == UINT32_MAX || registro.suspeito == UINT32_MAX) return 0;
+    
+    construtor->associacoes[construtor->numAssociacoes++] = registro;
+    return 1;
+}
+
+/**
+ * Função: descartarConstrutorMapa
+ * Propósito: Liberar um construtor de mapa sem gerar o mapa
+ * Parâmetros: construtor - ponteiro para o construtor
+ * Retorno: void
+ */
+void descartarConstrutorMapa(ConstrutorMapa* construtor) {
+    free(construtor->salas);
+    free(construtor->associacoes);
+    free(construtor->textos);
+    free(construtor->posicoes);
+    memset(construtor, 0, sizeof(ConstrutorMapa));
+}
+
+/**
+ * Função: finalizarConstrutorMapa
+ * Propósito: Transformar o conteúdo do construtor em um MapaMansao (o construtor fica vazio)
+ * Parâmetros: construtor - ponteiro para o construtor
+ * Retorno: ponteiro para o mapa criado ou NULL se faltou memória
+ */
+MapaMansao* finalizarConstrutorMapa(ConstrutorMapa* construtor) {
+    MapaMansao* mapa = (MapaMansao*)calloc(1, sizeof(MapaMansao));
+    if (mapa == NULL) {
+        descartarConstrutorMapa(construtor);
+        return NULL;
+    }
+    
+    mapa->numSalas = (uint32_t)construtor->numSalas;
+    mapa->numAssociacoes = (uint32_t)construtor->numAssociacoes;
+    mapa->salas = construtor->salas;
+    mapa->associacoes = construtor->associacoes;
+    mapa->textos = construtor->textos;
+    mapa->tamanhoTextos = construtor->tamanhoTextos;
+    free(construtor->posicoes);
+    memset(construtor, 0, sizeof(ConstrutorMapa));
+    return mapa;
+}
+
+/**
+ * Função: liberarMapa
+ * Propósito: Liberar um mapa (desfaz o mapeamento do arquivo ou libera os vetores)
+ * Parâmetros: mapa - ponteiro para o mapa
+ * Retorno: void
+ */
+void liberarMapa(MapaMansao* mapa) {
+    if (mapa == NULL) return;
+    
+    if (mapa->mapeamento != NULL) {
+        desmapearArquivo(mapa->mapeamento, mapa->tamanhoMapeamento);
+    } else {
+        free(mapa->salas);
+        free(mapa->associacoes);
+        free(mapa->textos);
+    }
+    free(mapa);
+}
+
+/**
+ * Função: validarMapa
+ * Propósito: Conferir se os índices e deslocamentos de um mapa são válidos e se cada
+ * sala tem no máximo uma sala pai (a parte alcançável a partir da entrada é uma árvore)
+ * Parâmetros: mapa - ponteiro para o mapa
+ * Retorno: 1 se o mapa é válido, 0 caso contrário (com mensagem de erro)
+ */
+int validarMapa(const MapaMansao* mapa) {
+    if (mapa->numSalas == 0) {
+        printf("Erro: O mapa nao possui salas!\n");
+        return 0;
+    }
+    if (mapa->tamanhoTextos == 0 || mapa->textos[mapa->tamanhoTextos - 1] != '\0' || mapa->textos[0] != '\0') {
+        printf("Erro: Bloco de textos do mapa invalido!\n");
+        return 0;
+    }
+    
+    unsigned char* temPai = (unsigned char*)calloc(mapa->numSalas, 1);
+    if (temPai == NULL) {
+        printf("Erro: Falha na alocação de memória para validar o mapa!\n");
+        return 0;
+    }
+    temPai[0] = 1;  // A entrada não pode ser filha de nenhuma sala
+    
+    int valido = 1;
+    for (uint32_t i = 0; i < mapa->numSalas && valido; i++) {
+        const RegistroSala* sala = &mapa->salas[i];
+        uint32_t filhos[2] = { sala->esquerda, sala->direita };
+        for (int f = 0; f < 2 && valido; f++) {
+            if (filhos[f] == SALA_NENHUMA) continue;
+            if (filhos[f] >= mapa->numSalas || temPai[filhos[f]]) {
+                printf("Erro: Sala %u possui uma ligacao invalida!\n", i);
+                valido = 0;
+            } else {
+                temPai[filhos[f]] = 1;
+            }
+        }
+        if (sala->nome >= mapa->tamanhoTextos || sala->pista >= mapa->tamanhoTextos) {
+            printf("Erro: Sala %u possui texto invalido!\n", i);
+            valido = 0;
+        }
+    }
+    for (uint32_t i = 0; i < mapa->numAssociacoes && valido; i++) {
+        if (mapa->associacoes[i].pista >= mapa->tamanhoTextos || mapa->associacoes[i].suspeito >= mapa->tamanhoTextos) {
+            printf("Erro: Associacao %u possui texto invalido!\n", i);
+            valido = 0;
+        }
+    }
+    
+    free(temPai);
+    return valido;
+}
+
+/**
+ * Função: carregarMapaBinario
+ * Propósito: Carregar um mapa no formato binário mapeando o arquivo em memória
+ * (nenhuma alocação por sala: as salas são lidas direto do arquivo)
+ * Parâmetros: caminho - caminho do arquivo .dqm
+ * Retorno: ponteiro para o mapa ou NULL em caso de erro
+ */
+MapaMansao* carregarMapaBinario(const char* caminho) {
+    size_t tamanho = 0;
+    unsigned char* conteudo = (unsigned char*)mapearArquivo(caminho, &tamanho);
+    if (conteudo == NULL) {
+        printf("Erro: Nao foi possivel abrir o mapa %s!\n", caminho);
+        return NULL;
+    }
+    
+    CabecalhoMapaBinario cabecalho;
+    if (tamanho < sizeof(cabecalho)) {
+        printf("Erro: Arquivo de mapa %s truncado!\n", caminho);
+        desmapearArquivo(conteudo, tamanho);
+        return NULL;
+    }
+    memcpy(&cabecalho, conteudo, sizeof(cabecalho));
+    
+    uint64_t esperado = sizeof(cabecalho) + (uint64_t)cabecalho.numSalas * sizeof(RegistroSala) +
+                        (uint64_t)cabecalho.numAssociacoes * sizeof(RegistroAssociacao) + cabecalho.tamanhoTextos;
+    if (memcmp(cabecalho.magica, "DQMB", 4) != 0 || cabecalho.versao != VERSAO_MAPA_BINARIO || esperado != tamanho) {
+        printf("Erro: Arquivo de mapa %s invalido!\n", caminho);
+        desmapearArquivo(conteudo, tamanho);
+        return NULL;
+    }
+    
+    MapaMansao* mapa = (MapaMansao*)calloc(1, sizeof(MapaMansao));
+    if (mapa == NULL) {
+        desmapearArquivo(conteudo, tamanho);
+        return NULL;
+    }
+    mapa->numSalas = cabecalho.numSalas;
+    mapa->numAssociacoes = cabecalho.numAssociacoes;
+    mapa->salas = (RegistroSala*)(conteudo + sizeof(cabecalho));
+    mapa->associacoes = (RegistroAssociacao*)(mapa->salas + mapa->numSalas);
+    mapa->textos = (char*)(mapa->associacoes + mapa->numAssociacoes);
+    mapa->tamanhoTextos = cabecalho.tamanhoTextos;
+    mapa->mapeamento = conteudo;
+    mapa->tamanhoMapeamento = tamanho;
+    
+    if (!validarMapa(mapa)) {
+        liberarMapa(mapa);
+        return NULL;
+    }
+    return mapa;
+}
+
+/**
+ * Função: lerIndiceSala
+ * Propósito: Converter o campo de índice de sala do formato texto ("-1" = nenhuma).
+ * Só são aceitos "-1" e números decimais sem sinal; o limite superior (número de salas)
+ * é conferido pelo chamador depois de ler o mapa inteiro
+ * Parâmetros: campo - texto do campo
+ *             indice - recebe o índice da sala ou SALA_NENHUMA
+ * Retorno: 1 se o campo é válido, 0 caso contrário
+ */
+static int lerIndiceSala(const char* campo, uint32_t* indice) {
+    if (strcmp(campo, "-1") == 0) {
+        *indice = SALA_NENHUMA;
+        return 1;
+    }
+    if (*campo < '0' || *campo > '9') return 0;
+    
+    char* fim = NULL;
+    errno = 0;
+    unsigned long long valor = strtoull(campo, &fim, 10);
+    if (errno != 0 || *fim != '\0' || valor >= SALA_NENHUMA) return 0;
+    *indice = (uint32_t)valor;
+    return 1;
+}
+
+/**
+ * Função: linhaTruncada
+ * Propósito: Verificar se fgets parou no limite do buffer antes do fim da linha
+ * Parâmetros: linha - texto lido por fgets
+ *             arquivo - arquivo de origem
+ * Retorno: 1 se a linha continua no arquivo, 0 se foi lida inteira
+ */
+static int linhaTruncada(const char* linha, FILE* arquivo) {
+    if (strchr(linha, '\n') != NULL) return 0;
+    int proximo = getc(arquivo);
+    if (proximo == EOF) return 0;
+    ungetc(proximo, arquivo);
+    return 1;
+}
+
+/**
+ * Função: carregarMapaTexto
+ * Propósito: Carregar um mapa no formato texto. Cada linha tem campos separados por TAB:
+ *   sala    <esquerda> <direita> <nome> <pista>   (salas numeradas pela ordem, -1 = sem saída)
+ *   pista   <pista> <suspeito>
+ * Linhas vazias e iniciadas por '#' são ignoradas
+ * Parâmetros: caminho - caminho do arquivo
+ * Retorno: ponteiro para o mapa ou NULL em caso de erro
+ */
+MapaMansao* carregarMapaTexto(const char* caminho) {
+    FILE* arquivo = fopen(caminho, "r");
+    if (arquivo == NULL) {
+        printf("Erro: Nao foi possivel abrir o mapa %s!\n", caminho);
+        return NULL;
+    }
+    
+    ConstrutorMapa construtor;
+    if (!iniciarConstrutorMapa(&construtor)) {
+        fclose(arquivo);
+        return NULL;
+    }
+    
+    char linha[TAMANHO_LINHA_MAPA];
+    size_t numeroLinha = 0;
+    uint32_t maiorIndice = 0;           // Maior saída citada, conferida ao final
+    size_t linhaMaiorIndice = 0;
+    int ok = 1;
+    while (ok && fgets(linha, sizeof(linha), arquivo) != NULL) {
+        numeroLinha++;
+        if (linhaTruncada(linha, arquivo)) {
+            printf("Erro: Linha %zu do mapa %s excede %d caracteres!\n", numeroLinha, caminho, TAMANHO_LINHA_MAPA - 2);
+            ok = 0;
+            break;
+        }
+        linha[strcspn(linha, "\r\n")] = '\0';
+        if (linha[0] == '\0' || linha[0] == '#') continue;
+        
+        // Separa os campos por TAB (campos vazios são permitidos)
+        char* campos[5];
+        int numCampos = 0;
+        char* cursor = linha;
+        while (numCampos < 5) {
+            campos[numCampos++] = cursor;
+            char* tab = strchr(cursor, '\t');
+            if (tab == NULL) break;
+            *tab = '\0';
+            cursor = tab + 1;
+        }
+        
+        uint32_t esquerda, direita;
+        if (strcmp(campos[0], "sala") == 0 && numCampos >= 4) {
+            if (!lerIndiceSala(campos[1], &esquerda) || !lerIndiceSala(campos[2], &direita)) {
+                printf("Erro: Linha %zu do mapa %s possui indice de sala invalido!\n", numeroLinha, caminho);
+                ok = 0;
+                break;
+            }
+            uint32_t maior = esquerda == SALA_NENHUMA ? direita
+                           : direita == SALA_NENHUMA ? esquerda
+                           : (esquerda > direita ? esquerda : direita);
+            if (maior != SALA_NENHUMA && (linhaMaiorIndice == 0 || maior > maiorIndice)) {
+                maiorIndice = maior;
+                linhaMaiorIndice = numeroLinha;
+            }
+            ok = adicionarSalaMapa(&construtor, campos[3], numCampos >= 5 ? campos[4] : "",
+                                   esquerda, direita) != SALA_NENHUMA;
+        } else if (strcmp(campos[0], "pista") == 0 && numCampos >= 3) {
+            ok = adicionarAssociacaoMapa(&construtor, campos[1], campos[2]);
+        } else {
+            printf("Erro: Linha %zu do mapa %s invalida!\n", numeroLinha, caminho);
+            ok = 0;
+        }
+    }
+    fclose(arquivo);
+    
+    if (ok && linhaMaiorIndice > 0 && maiorIndice >= construtor.numSalas) {
+        printf("Erro: Linha %zu do mapa %s aponta para a sala %u, mas o mapa tem %zu salas!\n",
+               linhaMaiorIndice, caminho, maiorIndice, construtor.numSalas);
+        ok = 0;
+    }
+    if (!ok) {
+        descartarConstrutorMapa(&construtor);
+        return NULL;
+    }
+    
+    MapaMansao* mapa = finalizarConstrutorMapa(&construtor);
+    if (mapa != NULL && !validarMapa(mapa)) {
+        liberarMapa(mapa);
+        return NULL;
+    }
+    return mapa;
+}
+
+/**
+ * Função: mapaEhBinario
+ * Propósito: Verificar pela assinatura se um arquivo está no formato binário
+ * Parâmetros: caminho - caminho do arquivo
+ * Retorno: 1 se o arquivo começa com "DQMB", 0 caso contrário
+ */
+int mapaEhBinario(const char* caminho) {
+    char magica[4] = {0};
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) return 0;
+    size_t lidos = fread(magica, 1, sizeof(magica), arquivo);
+    fclose(arquivo);
+    return lidos == sizeof(magica) && memcmp(magica, "DQMB", 4) == 0;
+}
+
+/**
+ * Função: carregarMapa
+ * Propósito: Carregar um mapa detectando automaticamente o formato (texto ou binário)
+ * Parâmetros: caminho - caminho do arquivo
+ * Retorno: ponteiro para o mapa ou NULL em caso de erro
+ */
+MapaMansao* carregarMapa(const char* caminho) {
+    return mapaEhBinario(caminho) ? carregarMapaBinario(caminho) : carregarMapaTexto(caminho);
+}
+
+/**
+ * Função: salvarMapaBinario
+ * Propósito: Gravar um mapa no formato binário (.dqm)
+ * Parâmetros: mapa - ponteiro para o mapa
+ *             caminho - arquivo de saída
+ * Retorno: 1 em caso de sucesso, 0 em caso de erro
+ */
+int salvarMapaBinario(const MapaMansao* mapa, const char* caminho) {
+    FILE* arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        printf("Erro: Nao foi possivel criar %s!\n", caminho);
+        return 0;
+    }
+    
+    CabecalhoMapaBinario cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.magica, "DQMB", 4);
+    cabecalho.versao = VERSAO_MAPA_BINARIO;
+    cabecalho.numSalas = mapa->numSalas;
+    cabecalho.numAssociacoes = mapa->numAssociacoes;
+    cabecalho.tamanhoTextos = mapa->tamanhoTextos;
+    
+    int ok = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+             fwrite(mapa->salas, sizeof(RegistroSala), mapa->numSalas, arquivo) == mapa->numSalas &&
+             fwrite(mapa->associacoes, sizeof(RegistroAssociacao), mapa->numAssociacoes, arquivo) == mapa->numAssociacoes &&
+             fwrite(mapa->textos, 1, mapa->tamanhoTextos, arquivo) == mapa->tamanhoTextos;
+    ok = fclose(arquivo) == 0 && ok;
+    if (!ok) {
+        printf("Erro: Falha ao gravar %s!\n", caminho);
+    }
+    return ok;
+}
+
+/**
+ * Função: salvarMapaTexto
+ * Propósito: Gravar um mapa no formato texto (ver carregarMapaTexto)
+ * Parâmetros: mapa - ponteiro para o mapa
+ *             caminho - arquivo de saída
+ * Retorno: 1 em caso de sucesso, 0 em caso de erro
+ */
+int salvarMapaTexto(const MapaMansao* mapa, const char* caminho) {
+    FILE* arquivo = fopen(caminho, "w");
+    if (arquivo == NULL) {
+        printf("Erro: Nao foi possivel criar %s!\n", caminho);
+        return 0;
+    }
+    
+    fprintf(arquivo, "# Detective Quest - mapa da mansao (%u salas, %u pistas catalogadas)\n",
+            mapa->numSalas, mapa->numAssociacoes);
+    for (uint32_t i = 0; i < mapa->numSalas; i++) {
+        const RegistroSala* sala = &mapa->salas[i];
+        fprintf(arquivo, "sala\t%ld\t%ld\t%s\t%s\n",
+                sala->esquerda == SALA_NENHUMA ? -1L : (long)sala->esquerda,
+                sala->direita == SALA_NENHUMA ? -1L : (long)sala->direita,
+                mapa->textos + sala->nome, mapa->textos + sala->pista);
+    }
+    for (uint32_t i = 0; i < mapa->numAssociacoes; i++) {
+        fprintf(arquivo, "pista\t%s\t%s\n", mapa->textos + mapa->associacoes[i].pista,
+                mapa->textos + mapa->associacoes[i].suspeito);
+    }
+    
+    int ok = !ferror(arquivo);
+    ok = fclose(arquivo) == 0 && ok;
+    if (!ok) {
+        printf("Erro: Falha ao gravar %s!\n", caminho);
+    }
+    return ok;
+}
+
+/**
+ * Função: converterMapa
+ * Propósito: Converter um mapa entre os formatos texto e binário (o formato de saída é
+ * sempre o oposto do formato de entrada)
+ * Parâmetros: entrada - arquivo de origem
+ *             saida - arquivo de destino
+ * Retorno: 1 em caso de sucesso, 0 em caso de erro
+ */
+int converterMapa(const char* entrada, const char* saida) {
+    int binario = mapaEhBinario(entrada);
+    MapaMansao* mapa = binario ? carregarMapaBinario(entrada) : carregarMapaTexto(entrada);
+    if (mapa == NULL) return 0;
+    
+    int ok = binario ? salvarMapaTexto(mapa, saida) : salvarMapaBinario(mapa, saida);
+    if (ok) {
+        printf("Mapa convertido (%s -> %s): %u salas, %u pistas catalogadas.\n",
+               binario ? "binario" : "texto", binario ? "texto" : "binario", mapa->numSalas, mapa->numAssociacoes);
+    }
+    liberarMapa(mapa);
+    return ok;
+}
+
+/**
+ * Função: construirSalasDoMapa
+ * Propósito: Montar a árvore de salas (Sala*) usada pelo jogo a partir de um mapa carregado
+ * (apenas as salas alcançáveis a partir da entrada, passando pelo grafo compacto; de
+ * preferência com uma arena ativa, para que as salas fiquem contíguas em ordem de largura)
+ * Parâmetros: mapa - ponteiro para o mapa
+ * Retorno: ponteiro para a sala de entrada ou NULL em caso de erro
+ */
+Sala* construirSalasDoMapa(const MapaMansao* mapa) {
+    GrafoSalas* grafo = grafoDoMapa(mapa);
+    if (grafo == NULL) return NULL;
+    
+    Sala* entrada = construirSalasDoGrafo(grafo);
+    liberarGrafoSalas(grafo);
+    return entrada;
+}
+
+/**
+ * Função: mapaUsaCatalogoEmbutido
+ * Propósito: Verificar se as associações de um mapa são exatamente as do catálogo embutido
+ * Parâmetros: mapa - ponteiro para o mapa
+ * Retorno: 1 se são as mesmas associações, 0 caso contrário
+ */
+static int mapaUsaCatalogoEmbutido(const MapaMansao* mapa) {
+    const CatalogoEmbutido* catalogo = &catalogoEmbutido;
+    if (catalogo->numAssociacoes == 0 || mapa->numAssociacoes != catalogo->numAssociacoes) return 0;
+    
+    // Cada pista do catálogo precisa aparecer uma única vez, com o mesmo suspeito
+    unsigned char* vista = (unsigned char*)calloc(catalogo->numTextos, 1);
+    if (vista == NULL) return 0;
+    int iguais = 1;
+    for (uint32_t i = 0; i < mapa->numAssociacoes && iguais; i++) {
+        const char* pista = mapa->textos + mapa->associacoes[i].pista;
+        const char* suspeito = mapa->textos + mapa->associacoes[i].suspeito;
+        IdTexto idPista = buscarTextoEmbutido(funcaoHash(pista), pista);
+        IdTexto idSuspeito = buscarTextoEmbutido(funcaoHash(suspeito), suspeito);
+        iguais = idPista != ID_TEXTO_INVALIDO && idSuspeito != ID_TEXTO_INVALIDO && !vista[idPista] &&
+                 catalogo->suspeitos[idPista] == idSuspeito;
+        if (iguais) vista[idPista] = 1;
+    }
+    free(vista);
+    return iguais;
+}
+
+/**
+ * Função: carregarSuspeitosDoMapa
+ * Propósito: Preencher a tabela hash com as associações pista/suspeito de um mapa carregado
+ * Parâmetros: mapa - ponteiro para o mapa
+ *             tabela - ponteiro para a tabela hash
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória
+ */
+int carregarSuspeitosDoMapa(const MapaMansao* mapa, TabelaHash* tabela) {
+    // Mapa com exatamente as associações do catálogo embutido: nenhuma inserção
+    if (tabela->quantidade == 0 && tabela->embutido == NULL && mapaUsaCatalogoEmbutido(mapa)) {
+        tabela->embutido = &catalogoEmbutido;
+        return 1;
+    }
+    
+    reservarTabelaHash(tabela, tabela->quantidade + mapa->numAssociacoes);
+    for (uint32_t i = 0; i < mapa->numAssociacoes; i++) {
+        if (!inserirNaHash(tabela, mapa->textos + mapa->associacoes[i].pista,
+                           mapa->textos + mapa->associacoes[i].suspeito)) {
+            printf("Erro: Falha na alocação de memória para as associacoes do mapa!\n");
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Função: carregarCasoDoDisco
+ * Propósito: Ler o mapa de um caso do acervo e montar a mansão (em uma arena própria, do
+ * tamanho exato das salas), a tabela e a lista de suspeitos e as dicas de acusação. O mapa
+ * é descartado em seguida: os textos ficam internados, compartilhados com os outros casos.
+ * Com uma leitura pronta (feita fora desta thread), o mapa já lido é montado sem acessar o
+ * disco; uma leitura que falhou faz o carregamento falhar sem nova tentativa
+ * Parâmetros: caso - caso fora da memória
+ * Retorno: 1 em caso de sucesso, 0 em caso de erro (nada fica alocado)
+ */
+static int carregarCasoDoDisco(CasoAcervo* caso) {
+    MapaMansao* mapa;
+    if (caso->leitura == LEITURA_PRONTA) {
+        mapa = caso->mapaLido;
+        caso->mapaLido = NULL;
+    } else {
+        mapa = carregarMapa(caso->caminho);
+    }
+    if (mapa == NULL) return 0;
+    
+    Arena* arena = criarArena(mapa->numSalas * sizeof(Sala) + ALINHAMENTO_ARENA);
+    TabelaHash* tabela = criarTabelaHash();
+    Sala* hall = NULL;
+    size_t numSuspeitos = 0;
+    if (arena != NULL && tabela != NULL) {
+        Arena* anterior = usarArena(arena);
+        hall = construirSalasDoMapa(mapa);
+        usarArena(anterior);
+        if (hall != NULL && !carregarSuspeitosDoMapa(mapa, tabela)) hall = NULL;
+        if (hall != NULL) suspeitosDaTabela(tabela, &numSuspeitos);
+    }
+    liberarMapa(mapa);
+    if (hall == NULL || !resumirCondenacoes(hall, tabela)) {
+        liberarMemoriaHash(tabela);
+        liberarArena(arena);
+        return 0;
+    }
+    
+    caso->arena = arena;
+    caso->hall = hall;
+    caso->tabela = tabela;
+    caso->bytes = memoriaReservadaArena(arena) + sizeof(Arena) + sizeof(TabelaHash) +
+                  tabela->capacidade * sizeof(EntradaHash) + numSuspeitos * sizeof(IdTexto);
+    return 1;
+}
+
+/**
+ * Função: descarregarCaso
+ * Propósito: Liberar a mansão e a tabela de um caso (os textos internados permanecem)
+ * Parâmetros: caso - caso em memória
+ * Retorno: void
+ */
+static void descarregarCaso(CasoAcervo* caso) {
+    liberarMemoriaHash(caso->tabela);
+    liberarArena(caso->arena);
+    caso->tabela = NULL;
+    caso->arena = NULL;
+    caso->hall = NULL;
+}
+
+/**
+ * Função: liberarAcervoCasos
+ * Propósito: Descarregar os casos em memória e liberar o acervo
+ * Parâmetros: acervo - ponteiro para o acervo
+ * Retorno: void
+ */
+void liberarAcervoCasos(AcervoCasos* acervo) {
+    if (acervo == NULL) return;
+    
+    for (size_t i = 0; i < acervo->numCasos; i++) {
+        if (acervo->casos[i].hall != NULL) acervo->descarregar(&acervo->casos[i]);
+        liberarMapa(acervo->casos[i].mapaLido);
+        free(acervo->casos[i].caminho);
+    }
+    free(acervo->casos);
+    free(acervo->nomes);
+    free(acervo);
+}
+
+/**
+ * Função: criarAcervoCasos
+ * Propósito: Registrar os casos de uma lista (um caminho de mapa por linha; linhas vazias e
+ * iniciadas por '#' são ignoradas; caminhos relativos partem do diretório da lista). Nenhum
+ * mapa é lido aqui: cada caso é carregado na primeira vez em que é aberto
+ * Parâmetros: caminhoLista - arquivo com a lista de casos
+ *             orcamento - bytes de casos em memória antes de despejar (0 = sem limite)
+ * Retorno: ponteiro para o acervo ou NULL em caso de erro
+ */
+AcervoCasos* criarAcervoCasos(const char* caminhoLista, size_t orcamento) {
+    FILE* arquivo = fopen(caminhoLista, "r");
+    if (arquivo == NULL) {
+        printf("Erro: Nao foi possivel abrir a lista de casos %s!\n", caminhoLista);
+        return NULL;
+    }
+    AcervoCasos* acervo = (AcervoCasos*)calloc(1, sizeof(AcervoCasos));
+    if (acervo == NULL) {
+        printf("Erro: Falha na alocação de memória para o acervo de casos!\n");
+        fclose(arquivo);
+        return NULL;
+    }
+    acervo->orcamento = orcamento;
+    acervo->carregar = carregarCasoDoDisco;
+    acervo->descarregar = descarregarCaso;
+    acervo->lerMapa = carregarMapa;
+    
+    // Diretório da lista (inclui a barra final), prefixo dos caminhos relativos
+    size_t tamanhoDiretorio = 0;
+    for (size_t i = 0; caminhoLista[i] != '\0'; i++) {
+        if (caminhoLista[i] == '/' || caminhoLista[i] == '\\') tamanhoDiretorio = i + 1;
+    }
+    
+    char linha[TAMANHO_LINHA_MAPA];
+    size_t capacidade = 0;
+    int ok = 1;
+    size_t numeroLinha = 0;
+    int longa = 0;
+    while (ok && fgets(linha, sizeof(linha), arquivo) != NULL) {
+        numeroLinha++;
+        if (linhaTruncada(linha, arquivo)) {
+            longa = 1;
+            break;
+        }
+        linha[strcspn(linha, "\r\n")] = '\0';
+        char* inicio = linha;
+        while (*inicio == ' ' || *inicio == '\t') inicio++;
+        if (*inicio == '\0' || *inicio == '#') continue;
+        
+        if (acervo->numCasos == capacidade) {
+            size_t novaCapacidade = capacidade > 0 ? capacidade * 2 : 16;
+            CasoAcervo* casos = (CasoAcervo*)realloc(acervo->casos, novaCapacidade * sizeof(CasoAcervo));
+            if (casos != NULL) acervo->casos = casos;
+            IdTexto* nomes = (IdTexto*)realloc(acervo->nomes, novaCapacidade * sizeof(IdTexto));
+            if (nomes != NULL) acervo->nomes = nomes;
+            if (casos == NULL || nomes == NULL) {
+                ok = 0;
+                break;
+            }
+            capacidade = novaCapacidade;
+        }
+        
+        int relativo = inicio[0] != '/' && inicio[0] != '\\' && !(inicio[0] != '\0' && inicio[1] == ':');
+        size_t prefixo = relativo ? tamanhoDiretorio : 0;
+        char* caminho = (char*)malloc(prefixo + strlen(inicio) + 1);
+        if (caminho == NULL) {
+            ok = 0;
+            break;
+        }
+        memcpy(caminho, caminhoLista, prefixo);
+        strcpy(caminho + prefixo, inicio);
+        
+        // Nome do caso: o arquivo sem diretório nem extensão
+        const char* base = inicio;
+        for (const char* c = inicio; *c != '\0'; c++) {
+            if (*c == '/' || *c == '\\') base = c + 1;
+        }
+        const char* ponto = strrchr(base, '.');
+        int tamanhoNome = (int)(ponto != NULL && ponto != base ? (size_t)(ponto - base) : strlen(base));
+        char nome[TAMANHO_NOME_CASO];
+        snprintf(nome, sizeof(nome), "%.*s", tamanhoNome, base);
+        
+        IdTexto idNome = internarTexto(nome);
+        if (idNome == ID_TEXTO_INVALIDO) {
+            free(caminho);
+            ok = 0;
+            break;
+        }
+        CasoAcervo* caso = &acervo->casos[acervo->numCasos];
+        memset(caso, 0, sizeof(CasoAcervo));
+        caso->caminho = caminho;
+        acervo->nomes[acervo->numCasos++] = idNome;
+    }
+    fclose(arquivo);
+    
+    if (longa) {
+        printf("Erro: Linha %zu da lista de casos %s excede %d caracteres!\n", numeroLinha, caminhoLista,
+               TAMANHO_LINHA_MAPA - 2);
+        liberarAcervoCasos(acervo);
+        return NULL;
+    }
+    if (!ok || acervo->numCasos == 0) {
+        if (ok) {
+            printf("Erro: A lista de casos %s nao tem nenhum caso!\n", caminhoLista);
+        } else {
+            printf("Erro: Falha na alocação de memória para o acervo de casos!\n");
+        }
+        liberarAcervoCasos(acervo);
+        return NULL;
+    }
+    return acervo;
+}
+
+/**
+ * Função: executarAcervo
+ * Propósito: Jogar (ou servir) os casos de uma lista: cada sessão começa escolhendo o caso
+ * Parâmetros: caminhoLista - arquivo com a lista de casos
+ *             orcamento - bytes de casos em memória antes de despejar (0 = sem limite)
+ *             enderecoServidor - porta ou socket do servidor de sessões (NULL = jogo no terminal)
+ *             modo - formato das mensagens
+ * Retorno: 0 em caso de sucesso, 1 em caso de erro
+ */
+int executarAcervo(const char* caminhoLista, size_t orcamento, const char* enderecoServidor, ModoSaida modo) {
+    AcervoCasos* acervo = criarAcervoCasos(caminhoLista, orcamento);
+    if (acervo == NULL) return 1;
+    
+    int codigoSaida = 0;
+    if (enderecoServidor != NULL) {
+        codigoSaida = executarServidor(enderecoServidor, NULL, NULL, acervo, modo);
+    } else {
+        // O caderno do jogador fica em uma arena; as salas, nas arenas dos casos
+        Arena* arena = criarArena(0);
+        IndiceSuspeitos* indice = criarIndiceSuspeitos();
+        if (arena != NULL && indice != NULL) {
+            SaidaJogo saida;
+            SessaoJogo sessao;
+            iniciarSaidaJogo(&saida, modo, stdout);
+            exibirBoasVindas(&saida);
+            Arena* anterior = usarArena(arena);
+            iniciarSessaoAcervo(&saida, &sessao, acervo, NULL, indice);
+            conduzirSessao(&saida, &sessao);
+            usarArena(anterior);
+            finalizarSaidaJogo(&saida);
+        } else {
+            codigoSaida = 1;
+        }
+        liberarIndiceSuspeitos(indice);
+        liberarArena(arena);
+    }
+    
+    liberarAcervoCasos(acervo);
+    liberarTextosInternados();
+    return codigoSaida;
+}
+
+/**
+ * Função: compararDecrescente64
+ * Propósito: Comparador de qsort para ordenar inteiros de 64 bits do maior para o menor
+ */
+static int compararDecrescente64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? 1 : (x > y ? -1 : 0);
+}
+
+/**
+ * Função: escreverTextoC
+ * Propósito: Escrever um texto como literal de string C (bytes fora do ASCII imprimível,
+ * aspas, barras e interrogações escapados)
+ * Parâmetros: arquivo - arquivo de destino
+ *             texto - texto a escrever
+ * Retorno: void
+ */
+static void escreverTextoC(FILE* arquivo, const char* texto) {
+    fputc('"', arquivo);
+    for (const unsigned char* c = (const unsigned char*)texto; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\' || *c == '?') {
+            fprintf(arquivo, "\\%c", *c);
+        } else if (*c < 0x20 || *c >= 0x7f) {
+            fprintf(arquivo, "\\%03o", *c);
+        } else {
+            fputc(*c, arquivo);
+        }
+    }
+    fputc('"', arquivo);
+}
+
+/**
+ * Função: gerarCatalogoEmbutido
+ * Propósito: Gerar o cabeçalho C com o catálogo embutido de um mapa: os textos recebem ids
+ * fixos dados por um hash perfeito mínimo (hash-and-displace: os baldes maiores escolhem
+ * primeiro o deslocamento que leva todos os seus textos a posições livres) e as associações
+ * viram um vetor pista -> suspeito
+ * Parâmetros: entrada - mapa de origem (texto ou binário)
+ *             saida - cabeçalho a gravar (ex.: catalogo_embutido.h)
+ * Retorno: 1 em caso de sucesso, 0 em caso de erro
+ */
+int gerarCatalogoEmbutido(const char* entrada, const char* saida) {
+    const uint32_t maximoTentativas = 1u << 24;
+    MapaMansao* mapa = carregarMapa(entrada);
+    if (mapa == NULL) return 0;
+    
+    size_t numCampos = 2 * (size_t)mapa->numSalas + 2 * (size_t)mapa->numAssociacoes;
+    size_t capacidadePosicoes = CAPACIDADE_INICIAL_HASH;
+    while (capacidadePosicoes < 2 * numCampos) capacidadePosicoes *= 2;
+    uint32_t* campos = (uint32_t*)malloc((numCampos + 1) * sizeof(uint32_t));
+    const char** textos = (const char**)malloc((numCampos + 1) * sizeof(const char*));
+    uint64_t* hashes = (uint64_t*)malloc((numCampos + 1) * sizeof(uint64_t));
+    uint32_t* posicoes = (uint32_t*)malloc(capacidadePosicoes * sizeof(uint32_t));
+    if (campos == NULL || textos == NULL || hashes == NULL || posicoes == NULL) {
+        printf("Erro: Falha na alocação de memória para o catalogo!\n");
+        free(campos);
+        free((void*)textos);
+        free(hashes);
+        free(posicoes);
+        liberarMapa(mapa);
+        return 0;
+    }
+    
+    // Textos distintos e não vazios, na ordem em que aparecem no mapa; cada campo passa a
+    // guardar o índice do seu texto (UINT32_MAX para o texto vazio)
+    size_t n = 0;
+    for (uint32_t i = 0; i < mapa->numSalas; i++) {
+        campos[n++] = mapa->salas[i].nome;
+        campos[n++] = mapa->salas[i].pista;
+    }
+    for (uint32_t i = 0; i < mapa->numAssociacoes; i++) {
+        campos[n++] = mapa->associacoes[i].pista;
+        campos[n++] = mapa->associacoes[i].suspeito;
+    }
+    memset(posicoes, 0xff, capacidadePosicoes * sizeof(uint32_t));
+    size_t mascara = capacidadePosicoes - 1;
+    uint32_t numTextos = 0;
+    for (size_t i = 0; i < numCampos; i++) {
+        const char* texto = mapa->textos + campos[i];
+        if (texto[0] == '\0') {
+            campos[i] = UINT32_MAX;
+            continue;
+        }
+        uint64_t hash = funcaoHash(texto);
+        size_t p = (size_t)hash & mascara;
+        while (posicoes[p] != UINT32_MAX && strcmp(textos[posicoes[p]], texto) != 0) {
+            p = (p + 1) & mascara;
+        }
+        if (posicoes[p] == UINT32_MAX) {
+            posicoes[p] = numTextos;
+            textos[numTextos] = texto;
+            hashes[numTextos++] = hash;
+        }
+        campos[i] = posicoes[p];
+    }
+    
+    // Textos agrupados por balde; a ordem de tentativa vai do maior balde ao menor
+    uint32_t numBaldes = numTextos / 4 + 1;
+    uint32_t* inicioBalde = (uint32_t*)calloc((size_t)numBaldes + 1, sizeof(uint32_t));
+    uint32_t* membros = (uint32_t*)malloc(((size_t)numTextos + 1) * sizeof(uint32_t));
+    uint64_t* ordem = (uint64_t*)malloc((size_t)numBaldes * sizeof(uint64_t));
+    uint32_t* deslocamentos = (uint32_t*)calloc(numBaldes, sizeof(uint32_t));
+    uint32_t* textoNaPosicao = (uint32_t*)malloc(((size_t)numTextos + 1) * sizeof(uint32_t));
+    int ok = inicioBalde != NULL && membros != NULL && ordem != NULL && deslocamentos != NULL &&
+             textoNaPosicao != NULL;
+    if (!ok) {
+        printf("Erro: Falha na alocação de memória para o catalogo!\n");
+    } else {
+        for (uint32_t t = 0; t < numTextos; t++) {
+            inicioBalde[baldeNoCatalogo(hashes[t], numBaldes) + 1]++;
+        }
+        for (uint32_t b = 0; b < numBaldes; b++) {
+            ordem[b] = ((uint64_t)inicioBalde[b + 1] << 32) | b;
+            inicioBalde[b + 1] += inicioBalde[b];
+        }
+        for (uint32_t t = 0; t < numTextos; t++) {
+            uint32_t b = baldeNoCatalogo(hashes[t], numBaldes);
+            membros[inicioBalde[b] + (uint32_t)(ordem[b] >> 32) - 1] = t;
+            ordem[b] -= (uint64_t)1 << 32;
+        }
+        for (uint32_t b = 0; b < numBaldes; b++) {
+            ordem[b] = ((uint64_t)(inicioBalde[b + 1] - inicioBalde[b]) << 32) | b;
+        }
+        qsort(ordem, numBaldes, sizeof(uint64_t), compararDecrescente64);
+        memset(textoNaPosicao, 0xff, ((size_t)numTextos + 1) * sizeof(uint32_t));
+    }
+    
+    for (uint32_t i = 0; ok && i < numBaldes && (ordem[i] >> 32) > 0; i++) {
+        uint32_t b = (uint32_t)ordem[i];
+        uint32_t d = 0;
+        for (; d < maximoTentativas; d++) {
+            // Ocupa as posições do balde; na primeira colisão desfaz e tenta o próximo deslocamento
+            uint32_t k = inicioBalde[b];
+            for (; k < inicioBalde[b + 1]; k++) {
+                uint32_t p = posicaoNoCatalogo(hashes[membros[k]], d, numTextos);
+                if (textoNaPosicao[p] != UINT32_MAX) break;
+                textoNaPosicao[p] = membros[k];
+            }
+            if (k == inicioBalde[b + 1]) break;
+            for (uint32_t j = inicioBalde[b]; j < k; j++) {
+                textoNaPosicao[posicaoNoCatalogo(hashes[membros[j]], d, numTextos)] = UINT32_MAX;
+            }
+        }
+        if (d == maximoTentativas) {
+            printf("Erro: Nao foi possivel montar o hash perfeito do catalogo (textos com o mesmo hash?)!\n");
+            ok = 0;
+        }
+        deslocamentos[b] = d;
+    }
+    
+    // Id fixo de cada texto: 1 + posição no hash perfeito (o id 0 é o texto vazio)
+    IdTexto* idDoTexto = ok ? (IdTexto*)malloc(((size_t)numTextos + 1) * sizeof(IdTexto)) : NULL;
+    IdTexto* suspeitos = ok ? (IdTexto*)malloc(((size_t)numTextos + 1) * sizeof(IdTexto)) : NULL;
+    uint32_t numAssociacoes = 0;
+    if (ok && (idDoTexto == NULL || suspeitos == NULL)) {
+        printf("Erro: Falha na alocação de memória para o catalogo!\n");
+        ok = 0;
+    }
+    if (ok) {
+        for (uint32_t p = 0; p < numTextos; p++) {
+            idDoTexto[textoNaPosicao[p]] = p + 1;
+        }
+        memset(suspeitos, 0xff, ((size_t)numTextos + 1) * sizeof(IdTexto));
+        const uint32_t* associacoes = &campos[2 * (size_t)mapa->numSalas];
+        for (uint32_t i = 0; i < mapa->numAssociacoes; i++) {
+            if (associacoes[2 * i] == UINT32_MAX || associacoes[2 * i + 1] == UINT32_MAX) continue;
+            IdTexto pista = idDoTexto[associacoes[2 * i]];
+            if (suspeitos[pista] == ID_TEXTO_INVALIDO) numAssociacoes++;
+            suspeitos[pista] = idDoTexto[associacoes[2 * i + 1]];
+        }
+    }
+    
+    FILE* arquivo = ok ? fopen(saida, "w") : NULL;
+    if (ok && arquivo == NULL) {
+        printf("Erro: Nao foi possivel criar %s!\n", saida);
+        ok = 0;
+    }
+    if (ok) {
+        fprintf(arquivo, "/*\n * Catalogo embutido do Detective Quest: textos e associacoes de %s\n", entrada);
+        fprintf(arquivo, " * Gerado por: detective_quest_mestre --gerar-catalogo %s %s (nao edite a mao)\n */\n\n",
+                entrada, saida);
+        fprintf(arquivo, "static const char* const textosEmbutidos[] = {\n    \"\",\n");
+        for (uint32_t p = 0; p < numTextos; p++) {
+            fprintf(arquivo, "    ");
+            escreverTextoC(arquivo, textos[textoNaPosicao[p]]);
+            fprintf(arquivo, ",\n");
+        }
+        fprintf(arquivo, "};\n\nstatic const uint64_t hashesEmbutidos[] = {\n    0x%016llxULL,",
+                (unsigned long long)funcaoHash(""));
+        for (uint32_t p = 0; p < numTextos; p++) {
+            fprintf(arquivo, (p + 1) % 4 == 0 ? "\n    0x%016llxULL," : " 0x%016llxULL,",
+                    (unsigned long long)hashes[textoNaPosicao[p]]);
+        }
+        fprintf(arquivo, "\n};\n\nstatic const uint32_t deslocamentosEmbutidos[] = {\n   ");
+        for (uint32_t b = 0; b < numBaldes; b++) {
+            fprintf(arquivo, b > 0 && b % 8 == 0 ? "\n    %u," : " %u,", deslocamentos[b]);
+        }
+        fprintf(arquivo, "\n};\n\nstatic const IdTexto suspeitosEmbutidos[] = {\n   ");
+        for (uint32_t id = 0; id <= numTextos; id++) {
+            if (id > 0 && id % 4 == 0) fprintf(arquivo, "\n   ");
+            if (suspeitos[id] == ID_TEXTO_INVALIDO) {
+                fprintf(arquivo, " ID_TEXTO_INVALIDO,");
+            } else {
+                fprintf(arquivo, " %u,", suspeitos[id]);
+            }
+        }
+        fprintf(arquivo, "\n};\n\nstatic const CatalogoEmbutido catalogoEmbutido = {\n");
+        fprintf(arquivo, "    %u, %u, %u, textosEmbutidos, hashesEmbutidos, deslocamentosEmbutidos, suspeitosEmbutidos\n};\n",
+                numTextos + 1, numBaldes, numAssociacoes);
+        ok = !ferror(arquivo);
+        ok = fclose(arquivo) == 0 && ok;
+        if (!ok) {
+            printf("Erro: Falha ao gravar %s!\n", saida);
+        } else {
+            printf("Catalogo gerado em %s: %u textos, %u pistas com suspeito, %u baldes.\n", saida, numTextos + 1,
+                   numAssociacoes, numBaldes);
+        }
+    }
+    
+    free(idDoTexto);
+    free(suspeitos);
+    free(inicioBalde);
+    free(membros);
+    free(ordem);
+    free(deslocamentos);
+    free(textoNaPosicao);
+    free(campos);
+    free((void*)textos);
+    free(hashes);
+    free(posicoes);
+    liberarMapa(mapa);
+    return ok;
+}
+
+/**
+ * Função: iniciarParametrosGerador
+ * Propósito: Preencher os parâmetros do gerador com os valores padrão
+ * Parâmetros: parametros - ponteiro para os parâmetros
+ * Retorno: void
+ */
+void iniciarParametrosGerador(ParametrosGerador* parametros) {
+    parametros->semente = 1;
+    parametros->numSalas = 1000;
+    parametros->profundidadeMaxima = 0;
+    parametros->equilibrio = 0.5;
+    parametros->densidadePistas = 0.5;
+    parametros->numSuspeitos = 8;
+}
+
+/**
+ * Função: misturarBits
+ * Propósito: Função de mistura do splitmix64: misturarBits(semente + i * constante) é o
+ * i-ésimo valor de uma sequência pseudoaleatória, calculado sem depender dos anteriores
+ * Parâmetros: x - valor de entrada
+ * Retorno: valor misturado
+ */
+static uint64_t misturarBits(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Função: digitosAntes
+ * Propósito: Somar a quantidade de dígitos decimais dos números 0, 1, ..., x - 1
+ * (dá o deslocamento do texto número x quando todos têm o mesmo prefixo)
+ * Parâmetros: x - quantidade de números
+ * Retorno: total de dígitos
+ */
+static uint64_t digitosAntes(uint64_t x) {
+    uint64_t total = x;  // Todo número tem pelo menos um dígito
+    for (uint64_t potencia = 10; potencia <= x; potencia *= 10) {
+        total += x - potencia;  // Números com mais de log10(potencia) dígitos ganham mais um
+        if (potencia > UINT64_MAX / 10) break;
+    }
+    return total;
+}
+
+/**
+ * Função: deslocamentoNomeSala
+ * Propósito: Deslocamento do nome "Sala i" no bloco de textos gerado
+ * Parâmetros: sala - número da sala
+ * Retorno: deslocamento do nome
+ */
+static uint64_t deslocamentoNomeSala(uint64_t sala) {
+    return 1 + 6 * sala + digitosAntes(sala);
+}
+
+/**
+ * Função: deslocamentoPista
+ * Propósito: Deslocamento do texto "Pista sintetica c" no bloco de textos gerado
+ * Parâmetros: gerador - gerador preparado
+ *             pista - número da pista
+ * Retorno: deslocamento do texto
+ */
+static uint64_t deslocamentoPista(const GeradorMansao* gerador, uint64_t pista) {
+    return gerador->inicioPistas + 17 * pista + digitosAntes(pista);
+}
+
+/**
+ * Função: pistasAntes
+ * Propósito: Quantidade de pistas nas salas [0, sala), para sala no início de uma janela
+ * (ou igual ao número de salas)
+ * Parâmetros: gerador - gerador preparado
+ *             sala - número da sala
+ * Retorno: quantidade de pistas
+ */
+static uint64_t pistasAntes(const GeradorMansao* gerador, uint64_t sala) {
+    return (sala * gerador->densidade) >> 32;
+}
+
+/**
+ * Função: mascaraPistasJanela
+ * Propósito: Sortear quais salas de uma janela de SALAS_POR_JANELA_PISTAS salas têm pista.
+ * A quantidade por janela é fixa (dada pela densidade), então o número de cada pista sai
+ * da janela e da posição dentro dela, sem percorrer as salas anteriores
+ * Parâmetros: gerador - gerador preparado
+ *             janela - número da janela
+ * Retorno: máscara com um bit por sala da janela
+ */
+static uint64_t mascaraPistasJanela(const GeradorMansao* gerador, uint64_t janela) {
+    uint64_t inicio = janela * SALAS_POR_JANELA_PISTAS;
+    uint64_t fim = inicio + SALAS_POR_JANELA_PISTAS;
+    if (fim > gerador->parametros.numSalas) fim = gerador->parametros.numSalas;
+    uint32_t largura = (uint32_t)(fim - inicio);
+    uint32_t quantidade = (uint32_t)(pistasAntes(gerador, fim) - pistasAntes(gerador, inicio));
+    
+    // Embaralhamento parcial de Fisher-Yates: as primeiras posições sorteadas recebem pista
+    unsigned char posicoes[SALAS_POR_JANELA_PISTAS];
+    for (uint32_t i = 0; i < largura; i++) posicoes[i] = (unsigned char)i;
+    uint64_t semente = gerador->parametros.semente ^ 0x5049535441530000ULL;
+    uint64_t mascara = 0;
+    for (uint32_t i = 0; i < quantidade; i++) {
+        uint64_t sorteio = misturarBits(semente + (janela * SALAS_POR_JANELA_PISTAS + i) * 0x9E3779B97F4A7C15ULL);
+        uint32_t escolhida = i + (uint32_t)(sorteio % (largura - i));
+        unsigned char temp = posicoes[i];
+        posicoes[i] = posicoes[escolhida];
+        posicoes[escolhida] = temp;
+        mascara |= 1ULL << posicoes[i];
+    }
+    return mascara;
+}
+
+/**
+ * Função: pistasAntesDaSala
+ * Propósito: Contar as pistas das salas [0, sala), para qualquer sala (as pistas são
+ * numeradas na ordem das salas, então este é também o número da pista da sala, se houver)
+ * Parâmetros: gerador - gerador preparado
+ *             sala - número da sala
+ *             janela, mascara - última janela consultada e sua máscara (cache do chamador)
+ * Retorno: quantidade de pistas
+ */
+static uint64_t pistasAntesDaSala(const GeradorMansao* gerador, uint64_t sala, uint64_t* janela, uint64_t* mascara) {
+    if (sala >= gerador->parametros.numSalas) return gerador->numPistas;
+    uint64_t janelaSala = sala / SALAS_POR_JANELA_PISTAS;
+    if (janelaSala != *janela) {
+        *janela = janelaSala;
+        *mascara = mascaraPistasJanela(gerador, janelaSala);
+    }
+    uint32_t posicao = (uint32_t)(sala % SALAS_POR_JANELA_PISTAS);
+    return pistasAntes(gerador, janelaSala * SALAS_POR_JANELA_PISTAS) +
+           (uint64_t)contarBits64(*mascara & ((1ULL << posicao) - 1));
+}
+
+/**
+ * Função: pistaDaSala
+ * Propósito: Descobrir se uma sala tem pista e qual é o número dela
+ * Parâmetros: gerador - gerador preparado
+ *             sala - número da sala
+ *             janela, mascara - cache de pistasAntesDaSala
+ * Retorno: número da pista ou UINT64_MAX se a sala não tem pista
+ */
+static uint64_t pistaDaSala(const GeradorMansao* gerador, uint64_t sala, uint64_t* janela, uint64_t* mascara) {
+    uint64_t pista = pistasAntesDaSala(gerador, sala, janela, mascara);
+    return (*mascara >> (sala % SALAS_POR_JANELA_PISTAS)) & 1 ? pista : UINT64_MAX;
+}
+
+/**
+ * Função: capacidadeNiveis
+ * Propósito: Maior número de salas de uma árvore binária com um dado número de níveis
+ * Parâmetros: niveis - quantidade de níveis
+ * Retorno: 2^niveis - 1 (saturado em UINT64_MAX)
+ */
+static uint64_t capacidadeNiveis(uint32_t niveis) {
+    return niveis >= 64 ? UINT64_MAX : (1ULL << niveis) - 1;
+}
+
+/**
+ * Função: tamanhoEsquerdaGerador
+ * Propósito: Sortear quantas salas de uma subárvore ficam à esquerda da raiz (o resto fica
+ * à direita), respeitando o equilíbrio e o limite de níveis
+ * Parâmetros: gerador - gerador preparado
+ *             sala - raiz da subárvore
+ *             tamanho - salas da subárvore
+ *             niveis - níveis disponíveis a partir da raiz (0 = sem limite)
+ * Retorno: tamanho da subárvore esquerda
+ */
+static uint64_t tamanhoEsquerdaGerador(const GeradorMansao* gerador, uint64_t sala, uint64_t tamanho, uint32_t niveis) {
+    uint64_t resto = tamanho - 1;
+    if (resto == 0) return 0;
+    
+    double sorteio = (double)(misturarBits(gerador->parametros.semente + sala * 0x9E3779B97F4A7C15ULL) >> 11) *
+                     (1.0 / 9007199254740992.0);
+    double fracao = 0.5 + (sorteio - 0.5) * (1.0 - gerador->parametros.equilibrio);
+    uint64_t esquerda = (uint64_t)(fracao * (double)resto + 0.5);
+    if (esquerda > resto) esquerda = resto;
+    if (niveis > 0) {
+        uint64_t capacidade = capacidadeNiveis(niveis - 1);
+        if (esquerda > capacidade) esquerda = capacidade;
+        if (resto - esquerda > capacidade) esquerda = resto - capacidade;
+    }
+    return esquerda;
+}
+
+/**
+ * Função: gerarSala
+ * Propósito: Gerar o registro, o nome e a pista (com a associação) de uma sala no bloco
+ * Parâmetros: gerador - gerador preparado
+ *             bloco - janela de memória de destino
+ *             sala, tamanho, niveis - sala e a subárvore que ela encabeça
+ *             janela, mascara - cache de pistaDaSala
+ * Retorno: tamanho da subárvore esquerda
+ */
+static uint64_t gerarSala(const GeradorMansao* gerador, const BlocoGerador* bloco, uint64_t sala, uint64_t tamanho,
+                          uint32_t niveis, uint64_t* janela, uint64_t* mascara) {
+    uint64_t esquerda = tamanhoEsquerdaGerador(gerador, sala, tamanho, niveis);
+    RegistroSala* registro = &bloco->salas[sala - bloco->primeiraSala];
+    registro->esquerda = esquerda > 0 ? (uint32_t)(sala + 1) : SALA_NENHUMA;
+    registro->direita = tamanho - 1 - esquerda > 0 ? (uint32_t)(sala + 1 + esquerda) : SALA_NENHUMA;
+    
+    uint64_t nome = deslocamentoNomeSala(sala);
+    char* texto = bloco->nomes + (nome - bloco->inicioNomes);
+    memcpy(texto, "Sala ", 5);
+    texto[5 + formatarDecimal(texto + 5, sala)] = '\0';
+    registro->nome = (uint32_t)nome;
+    
+    uint64_t pista = pistaDaSala(gerador, sala, janela, mascara);
+    registro->pista = 0;
+    if (pista != UINT64_MAX) {
+        uint64_t deslocamento = deslocamentoPista(gerador, pista);
+        texto = bloco->pistas + (deslocamento - bloco->inicioPistas);
+        memcpy(texto, "Pista sintetica ", 16);
+        texto[16 + formatarDecimal(texto + 16, pista)] = '\0';
+        registro->pista = (uint32_t)deslocamento;
+        
+        // Suspeito sorteado pelo número da pista: "Suspeito k" também tem deslocamento fixo
+        uint64_t suspeito = misturarBits((gerador->parametros.semente ^ 0x5355535045495400ULL) +
+                                         pista * 0x9E3779B97F4A7C15ULL) % gerador->parametros.numSuspeitos;
+        RegistroAssociacao* associacao = &bloco->associacoes[pista - bloco->primeiraPista];
+        associacao->pista = (uint32_t)deslocamento;
+        associacao->suspeito = (uint32_t)(gerador->inicioSuspeitos + 10 * suspeito + digitosAntes(suspeito));
+    }
+    return esquerda;
+}
+
+/**
+ * Função: trabalharGerador
+ * Propósito: Corpo de uma thread do gerador: retira tarefas até acabarem e gera cada
+ * subárvore em pré-ordem (pilha explícita, sem recursão)
+ * Parâmetros: argumento - ponteiro para o TrabalhadorGerador da thread
+ * Retorno: NULL
+ */
+static void* trabalharGerador(void* argumento) {
+    TrabalhadorGerador* trabalhador = (TrabalhadorGerador*)argumento;
+    const GeradorMansao* gerador = trabalhador->gerador;
+    uint64_t janela = UINT64_MAX, mascara = 0;
+    size_t capacidade = 64;
+    TarefaGerador* pilha = (TarefaGerador*)malloc(capacidade * sizeof(TarefaGerador));
+    if (pilha == NULL) {
+        trabalhador->ok = 0;
+        return NULL;
+    }
+    
+    for (;;) {
+        size_t t = atomic_fetch_add_explicit(trabalhador->proximaTarefa, 1, memory_order_relaxed);
+        if (t >= trabalhador->fimTarefas) break;
+        const TarefaGerador* tarefa = &gerador->tarefas[t];
+        if (tarefa->somenteRaiz) {
+            gerarSala(gerador, trabalhador->bloco, tarefa->sala, tarefa->tamanho, tarefa->niveis, &janela, &mascara);
+            continue;
+        }
+        
+        size_t topo = 0;
+        pilha[topo++] = *tarefa;
+        while (topo > 0) {
+            TarefaGerador atual = pilha[--topo];
+            uint64_t esquerda = gerarSala(gerador, trabalhador->bloco, atual.sala, atual.tamanho, atual.niveis,
+                                          &janela, &mascara);
+            uint64_t direita = atual.tamanho - 1 - esquerda;
+            uint32_t niveisFilhos = atual.niveis > 0 ? atual.niveis - 1 : 0;
+            if (topo + 2 > capacidade) {
+                TarefaGerador* maior = (TarefaGerador*)realloc(pilha, capacidade * 2 * sizeof(TarefaGerador));
+                if (maior == NULL) {
+                    trabalhador->ok = 0;
+                    free(pilha);
+                    return NULL;
+                }
+                pilha = maior;
+                capacidade *= 2;
+            }
+            // A direita entra primeiro para a esquerda sair antes (pré-ordem)
+            if (direita > 0) pilha[topo++] = (TarefaGerador){ atual.sala + 1 + esquerda, direita, niveisFilhos, 0 };
+            if (esquerda > 0) pilha[topo++] = (TarefaGerador){ atual.sala + 1, esquerda, niveisFilhos, 0 };
+        }
+    }
+    free(pilha);
+    return NULL;
+}
+
+/**
+ * Função: prepararGeradorMansao
+ * Propósito: Validar os parâmetros, calcular o leiaute do bloco de textos e dividir a
+ * mansão em tarefas: subárvores de até SALAS_POR_TAREFA_GERADOR salas, mais as salas do
+ * topo da árvore acima delas (uma tarefa cada), em ordem de numeração
+ * Parâmetros: gerador - gerador a preparar
+ *             parametros - parâmetros da mansão
+ * Retorno: 1 em caso de sucesso, 0 em caso de erro (com mensagem)
+ */
+int prepararGeradorMansao(GeradorMansao* gerador, const ParametrosGerador* parametros) {
+    memset(gerador, 0, sizeof(GeradorMansao));
+    gerador->parametros = *parametros;
+    uint64_t n = parametros->numSalas;
+    if (n == 0 || n >= SALA_NENHUMA) {
+        printf("Erro: O numero de salas deve estar entre 1 e %u!\n", SALA_NENHUMA - 1);
+        return 0;
+    }
+    if (!(parametros->equilibrio >= 0.0 && parametros->equilibrio <= 1.0) ||
+        !(parametros->densidadePistas >= 0.0 && parametros->densidadePistas <= 1.0)) {
+        printf("Erro: Equilibrio e densidade de pistas devem estar entre 0 e 1!\n");
+        return 0;
+    }
+    if (parametros->numSuspeitos == 0) {
+        printf("Erro: A mansao precisa de pelo menos 1 suspeito!\n");
+        return 0;
+    }
+    if (parametros->profundidadeMaxima > 0 && n > capacidadeNiveis(parametros->profundidadeMaxima)) {
+        printf("Erro: %llu salas nao cabem em %u niveis!\n", (unsigned long long)n, parametros->profundidadeMaxima);
+        return 0;
+    }
+    
+    // Bloco de textos: "", nomes das salas, textos das pistas e nomes dos suspeitos
+    gerador->densidade = (uint64_t)(parametros->densidadePistas * 4294967296.0 + 0.5);
+    gerador->numPistas = pistasAntes(gerador, n);
+    gerador->inicioPistas = deslocamentoNomeSala(n);
+    gerador->inicioSuspeitos = deslocamentoPista(gerador, gerador->numPistas);
+    gerador->tamanhoTextos = gerador->inicioSuspeitos + 10ULL * parametros->numSuspeitos +
+                             digitosAntes(parametros->numSuspeitos);
+    if (gerador->tamanhoTextos > UINT32_MAX) {
+        printf("Erro: Os textos da mansao passam de 4 GiB (reduza as salas ou a densidade de pistas)!\n");
+        return 0;
+    }
+    
+    // Divide o topo da árvore (pilha explícita, pré-ordem) até as subárvores ficarem pequenas
+    size_t capacidadeTarefas = 1024, capacidadePilha = 64, topo = 0;
+    gerador->tarefas = (TarefaGerador*)malloc(capacidadeTarefas * sizeof(TarefaGerador));
+    TarefaGerador* pilha = (TarefaGerador*)malloc(capacidadePilha * sizeof(TarefaGerador));
+    int ok = gerador->tarefas != NULL && pilha != NULL;
+    if (ok) pilha[topo++] = (TarefaGerador){ 0, n, parametros->profundidadeMaxima, 0 };
+    while (ok && topo > 0) {
+        TarefaGerador atual = pilha[--topo];
+        if (gerador->numTarefas == capacidadeTarefas || topo + 2 > capacidadePilha) {
+            TarefaGerador* tarefas = (TarefaGerador*)realloc(gerador->tarefas, capacidadeTarefas * 2 * sizeof(TarefaGerador));
+            TarefaGerador* maior = tarefas != NULL ? (TarefaGerador*)realloc(pilha, capacidadePilha * 2 * sizeof(TarefaGerador)) : NULL;
+            if (tarefas != NULL) gerador->tarefas = tarefas;
+            if (maior == NULL) {
+                ok = 0;
+                break;
+            }
+            pilha = maior;
+            capacidadeTarefas *= 2;
+            capacidadePilha *= 2;
+        }
+        
+        atual.somenteRaiz = atual.tamanho > SALAS_POR_TAREFA_GERADOR;
+        gerador->tarefas[gerador->numTarefas++] = atual;
+        if (atual.somenteRaiz) {
+            uint64_t esquerda = tamanhoEsquerdaGerador(gerador, atual.sala, atual.tamanho, atual.niveis);
+            uint64_t direita = atual.tamanho - 1 - esquerda;
+            uint32_t niveisFilhos = atual.niveis > 0 ? atual.niveis - 1 : 0;
+            if (direita > 0) pilha[topo++] = (TarefaGerador){ atual.sala + 1 + esquerda, direita, niveisFilhos, 0 };
+            if (esquerda > 0) pilha[topo++] = (TarefaGerador){ atual.sala + 1, esquerda, niveisFilhos, 0 };
+        }
+    }
+    free(pilha);
+    if (!ok) {
+        printf("Erro: Falha na alocação de memória para o gerador de mansoes!\n");
+        free(gerador->tarefas);
+        gerador->tarefas = NULL;
+    }
+    return ok;
+}
+
+/**
+ * Função: descartarGeradorMansao
+ * Propósito: Liberar as tarefas do gerador
+ * Parâmetros: gerador - gerador preparado
+ * Retorno: void
+ */
+void descartarGeradorMansao(GeradorMansao* gerador) {
+    free(gerador->tarefas);
+    gerador->tarefas = NULL;
+    gerador->numTarefas = 0;
+}
+
+/**
+ * Função: gerarTextosFixos
+ * Propósito: Escrever o texto vazio e os nomes dos suspeitos no bloco de textos
+ * Parâmetros: gerador - gerador preparado
+ *             textos - destino a partir do deslocamento 0 (NULL para não escrever o texto vazio)
+ *             suspeitos - destino a partir de inicioSuspeitos
+ * Retorno: void
+ */
+static void gerarTextosFixos(const GeradorMansao* gerador, char* textos, char* suspeitos) {
+    if (textos != NULL) textos[0] = '\0';
+    for (uint32_t k = 0; k < gerador->parametros.numSuspeitos; k++) {
+        memcpy(suspeitos, "Suspeito ", 9);
+        size_t tamanho = 9 + formatarDecimal(suspeitos + 9, k);
+        suspeitos[tamanho] = '\0';
+        suspeitos += tamanho + 1;
+    }
+}
+
+/**
+ * Função: executarTarefasGerador
+ * Propósito: Gerar as tarefas [inicio, fim) no bloco, dividindo-as entre as threads
+ * Parâmetros: gerador - gerador preparado
+ *             bloco - janela de memória de destino (cobre todas as salas das tarefas)
+ *             inicio, fim - intervalo de tarefas
+ *             numThreads - threads de trabalho
+ * Retorno: 1 em caso de sucesso, 0 se faltou memória
+ */
+static int executarTarefasGerador(const GeradorMansao* gerador, const BlocoGerador* bloco, size_t inicio, size_t fim,
+                                  int numThreads) {
+    if (fim <= inicio) return 1;
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > MAX_THREADS_LOTE) numThreads = MAX_THREADS_LOTE;
+    if ((size_t)numThreads > fim - inicio) numThreads = (int)(fim - inicio);
+    
+    atomic_size_t proximaTarefa;
+    atomic_init(&proximaTarefa, inicio);
+    TrabalhadorGerador trabalhadores[MAX_THREADS_LOTE];
+    for (int t = 0; t < numThreads; t++) {
+        trabalhadores[t] = (TrabalhadorGerador){ gerador, bloco, &proximaTarefa, fim, 1 };
+    }
+    executarEmThreads(numThreads, trabalharGerador, trabalhadores, sizeof(TrabalhadorGerador));
+    
+    int ok = 1;
+    for (int t = 0; t < numThreads; t++) ok = ok && trabalhadores[t].ok;
+    return ok;
+}
+
+/**
+ * Função: gerarMapaMansao
+ * Propósito: Gerar em memória uma mansão procedural (salas, catálogo de pistas e textos),
+ * com as salas divididas entre threads; o resultado é um mapa comum, usado pelo jogo, pelo
+ * lote e pelo solucionador como um mapa carregado de arquivo
+ * Parâmetros: parametros - parâmetros da mansão
+ *             numThreads - threads de trabalho
+ * Retorno: ponteiro para o mapa ou NULL em caso de erro
+ */
+MapaMansao* gerarMapaMansao(const ParametrosGerador* parametros, int numThreads) {
+    GeradorMansao gerador;
+    if (!prepararGeradorMansao(&gerador, parametros)) return NULL;
+    
+    MapaMansao* mapa = (MapaMansao*)calloc(1, sizeof(MapaMansao));
+    if (mapa != NULL) {
+        mapa->numSalas = (uint32_t)parametros->numSalas;
+        mapa->numAssociacoes = (uint32_t)gerador.numPistas;
+        mapa->tamanhoTextos = gerador.tamanhoTextos;
+        mapa->salas = (RegistroSala*)malloc(parametros->numSalas * sizeof(RegistroSala));
+        mapa->associacoes = (RegistroAssociacao*)malloc((gerador.numPistas > 0 ? gerador.numPistas : 1) * sizeof(RegistroAssociacao));
+        mapa->textos = (char*)malloc(gerador.tamanhoTextos);
+    }
+    if (mapa == NULL || mapa->salas == NULL || mapa->associacoes == NULL || mapa->textos == NULL) {
+        printf("Erro: Falha na alocação de memória para a mansao gerada!\n");
+        liberarMapa(mapa);
+        descartarGeradorMansao(&gerador);
+        return NULL;
+    }
+    
+    BlocoGerador bloco = { 0, 0, 0, 0, mapa->salas, mapa->associacoes, mapa->textos, mapa->textos };
+    gerarTextosFixos(&gerador, mapa->textos, mapa->textos + gerador.inicioSuspeitos);
+    int ok = executarTarefasGerador(&gerador, &bloco, 0, gerador.numTarefas, numThreads);
+    descartarGeradorMansao(&gerador);
+    if (!ok) {
+        printf("Erro: Falha na alocação de memória para a mansao gerada!\n");
+        liberarMapa(mapa);
+        return NULL;
+    }
+    return mapa;
+}
+
+/**
+ * Função: posicionarArquivo
+ * Propósito: Posicionar um arquivo em um deslocamento de 64 bits
+ * Parâmetros: arquivo - arquivo aberto
+ *             posicao - deslocamento a partir do início
+ * Retorno: 1 em caso de sucesso, 0 em caso de erro
+ */
+static int posicionarArquivo(FILE* arquivo, uint64_t posicao) {
+#ifdef _WIN32
+    return _fseeki64(arquivo, (long long)posicao, SEEK_SET) == 0;
+#else
+    return fseeko(arquivo, (off_t)posicao, SEEK_SET) == 0;
+#endif
+}
+
+/**
+ * Função: gravarMansaoGerada
+ * Propósito: Gerar uma mansão procedural direto em um arquivo de mapa binário (.dqm), em
+ * blocos de até SALAS_POR_BLOCO_GRAVACAO salas: cada bloco é gerado em paralelo na memória
+ * e escrito nas posições já conhecidas de cada região do arquivo, de modo que mansões
+ * maiores que a memória também podem ser geradas
+ * Parâmetros: parametros - parâmetros da mansão
+ *             caminho - arquivo de saída
+ *             numThreads - threads de trabalho
+ * Retorno: 1 em caso de sucesso, 0 em caso de erro
+ */
+int gravarMansaoGerada(const ParametrosGerador* parametros, const char* caminho, int numThreads) {
+    GeradorMansao gerador;
+    if (!prepararGeradorMansao(&gerador, parametros)) return 0;
+    
+    FILE* arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        printf("Erro: Nao foi possivel criar %s!\n", caminho);
+        descartarGeradorMansao(&gerador);
+        return 0;
+    }
+    
+    // Regiões do arquivo: cabeçalho, salas, associações e textos
+    uint64_t n = parametros->numSalas;
+    uint64_t inicioSalas = sizeof(CabecalhoMapaBinario);
+    uint64_t inicioAssociacoes = inicioSalas + n * sizeof(RegistroSala);
+    uint64_t inicioTextos = inicioAssociacoes + gerador.numPistas * sizeof(RegistroAssociacao);
+    
+    CabecalhoMapaBinario cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.magica, "DQMB", 4);
+    cabecalho.versao = VERSAO_MAPA_BINARIO;
+    cabecalho.numSalas = (uint32_t)n;
+    cabecalho.numAssociacoes = (uint32_t)gerador.numPistas;
+    cabecalho.tamanhoTextos = gerador.tamanhoTextos;
+    
+    size_t tamanhoSuspeitos = (size_t)(gerador.tamanhoTextos - gerador.inicioSuspeitos);
+    char* suspeitos = (char*)malloc(tamanhoSuspeitos);
+    int ok = suspeitos != NULL;
+    if (ok) {
+        gerarTextosFixos(&gerador, NULL, suspeitos);
+        ok = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+             posicionarArquivo(arquivo, inicioTextos) && fputc('\0', arquivo) != EOF &&
+             posicionarArquivo(arquivo, inicioTextos + gerador.inicioSuspeitos) &&
+             fwrite(suspeitos, 1, tamanhoSuspeitos, arquivo) == tamanhoSuspeitos;
+    }
+    free(suspeitos);
+    
+    // Blocos de tarefas consecutivas: cada bloco cobre salas, pistas e textos contíguos
+    RegistroSala* salas = (RegistroSala*)malloc(SALAS_POR_BLOCO_GRAVACAO * sizeof(RegistroSala));
+    RegistroAssociacao* associacoes = (RegistroAssociacao*)malloc(SALAS_POR_BLOCO_GRAVACAO * sizeof(RegistroAssociacao));
+    uint64_t janela = UINT64_MAX, mascara = 0;
+    size_t tarefa = 0;
+    ok = ok && salas != NULL && associacoes != NULL;
+    while (ok && tarefa < gerador.numTarefas) {
+        size_t fimTarefas = tarefa;
+        uint64_t primeiraSala = gerador.tarefas[tarefa].sala;
+        uint64_t fimSalas = primeiraSala;
+        while (fimTarefas < gerador.numTarefas) {
+            const TarefaGerador* proxima = &gerador.tarefas[fimTarefas];
+            uint64_t fimProxima = proxima->sala + (proxima->somenteRaiz ? 1 : proxima->tamanho);
+            if (fimTarefas > tarefa && fimProxima - primeiraSala > SALAS_POR_BLOCO_GRAVACAO) break;
+            fimSalas = fimProxima;
+            fimTarefas++;
+        }
+        
+        // As pistas das salas [primeiraSala, fimSalas) são as de números [primeiraPista, fimPistas)
+        uint64_t primeiraPista = pistasAntesDaSala(&gerador, primeiraSala, &janela, &mascara);
+        uint64_t fimPistas = pistasAntesDaSala(&gerador, fimSalas, &janela, &mascara);
+        
+        BlocoGerador bloco;
+        bloco.primeiraSala = primeiraSala;
+        bloco.primeiraPista = primeiraPista;
+        bloco.inicioNomes = deslocamentoNomeSala(primeiraSala);
+        bloco.inicioPistas = deslocamentoPista(&gerador, primeiraPista);
+        bloco.salas = salas;
+        bloco.associacoes = associacoes;
+        size_t tamanhoNomes = (size_t)(deslocamentoNomeSala(fimSalas) - bloco.inicioNomes);
+        size_t tamanhoPistas = (size_t)(deslocamentoPista(&gerador, fimPistas) - bloco.inicioPistas);
+        bloco.nomes = (char*)malloc(tamanhoNomes + tamanhoPistas + 1);
+        bloco.pistas = bloco.nomes != NULL ? bloco.nomes + tamanhoNomes : NULL;
+        size_t salasBloco = (size_t)(fimSalas - primeiraSala);
+        size_t pistasBloco = (size_t)(fimPistas - primeiraPista);
+        
+        ok = bloco.nomes != NULL && executarTarefasGerador(&gerador, &bloco, tarefa, fimTarefas, numThreads) &&
+             posicionarArquivo(arquivo, inicioSalas + primeiraSala * sizeof(RegistroSala)) &&
+             fwrite(salas, sizeof(RegistroSala), salasBloco, arquivo) == salasBloco &&
+             posicionarArquivo(arquivo, inicioAssociacoes + primeiraPista * sizeof(RegistroAssociacao)) &&
+             fwrite(associacoes, sizeof(RegistroAssociacao), pistasBloco, arquivo) == pistasBloco &&
+             posicionarArquivo(arquivo, inicioTextos + bloco.inicioNomes) &&
+             fwrite(bloco.nomes, 1, tamanhoNomes, arquivo) == tamanhoNomes &&
+             posicionarArquivo(arquivo, inicioTextos + bloco.inicioPistas) &&
+             fwrite(bloco.pistas, 1, tamanhoPistas, arquivo) == tamanhoPistas;
+        free(bloco.nomes);
+        tarefa = fimTarefas;
+    }
+    
+    free(salas);
+    free(associacoes);
+    descartarGeradorMansao(&gerador);
+    ok = fclose(arquivo) == 0 && ok;
+    if (!ok) {
+        printf("Erro: Falha ao gravar %s!\n", caminho);
+    }
+    return ok;
+}
+
+#define TAMANHO_HASH_ENCADEADA 20  // Tamanho fixo da tabela encadeada original
+
+/**
+ * Estrutura que reproduz a tabela hash encadeada original (20 listas fixas),
+ * mantida apenas como referência de comparação no benchmark
+ */
+typedef struct NoHashEncadeado {
+    char pista[100];
+    char suspeito[50];
+    struct NoHashEncadeado* proximo;
+} NoHashEncadeado;
+
+typedef struct TabelaHashEncadeada {
+    NoHashEncadeado* tabela[TAMANHO_HASH_ENCADEADA];
+} TabelaHashEncadeada;
+
+/**
+ * Função: funcaoHashAditiva
+ * Propósito: Função hash original (soma dos caracteres módulo o tamanho da tabela)
+ * Parâmetros: pista - string da pista
+ * Retorno: índice na tabela encadeada
+ */
+static int funcaoHashAditiva(const char* pista) {
+    int hash = 0;
+    for (int i = 0; pista[i] != '\0'; i++) {
+        hash += (int)pista[i];
+    }
+    return hash % TAMANHO_HASH_ENCADEADA;
+}
+
+static void inserirNaHashEncadeada(TabelaHashEncadeada* tabela, const char* pista, const char* suspeito) {
+    int indice = funcaoHashAditiva(pista);
+    NoHashEncadeado* novoNode = (NoHashEncadeado*)malloc(sizeof(NoHashEncadeado));
+    if (novoNode == NULL) return;
+    strcpy(novoNode->pista, pista);
+    strcpy(novoNode->suspeito, suspeito);
+    novoNode->proximo = tabela->tabela[indice];
+    tabela->tabela[indice] = novoNode;
+}
+
+static char* encontrarSuspeitoEncadeado(TabelaHashEncadeada* tabela, const char* pista) {
+    size_t percorridos = 0;
+    char* suspeito = NULL;
+    for (NoHashEncadeado* atual = tabela->tabela[funcaoHashAditiva(pista)]; atual != NULL; atual = atual->proximo) {
+        percorridos++;
+        if (strcmp(atual->pista, pista) == 0) {
+            suspeito = atual->suspeito;
+            break;
+        }
+    }
+    INSTRUMENTAR_SOMAR(buscasEncadeada, 1);
+    INSTRUMENTAR_SOMAR(nosPercorridosEncadeada, percorridos);
+    INSTRUMENTAR_MAXIMO(maiorCadeiaEncadeada, percorridos);
+    (void)percorridos;
+    return suspeito;
+}
+
+static void liberarHashEncadeada(TabelaHashEncadeada* tabela) {
+    for (int i = 0; i < TAMANHO_HASH_ENCADEADA; i++) {
+        NoHashEncadeado* atual = tabela->tabela[i];
+        while (atual != NULL) {
+            NoHashEncadeado* temp = atual;
+            atual = atual->proximo;
+            free(temp);
+        }
+    }
+}
+
+/**
+ * Função: gerarTextoSintetico
+ * Propósito: Escrever em destino um texto sintético determinístico para o índice i
+ * (usado para gerar pistas e suspeitos artificiais nos benchmarks)
+ * Parâmetros: destino - buffer de saída (pelo menos 100 bytes)
+ *             prefixo - prefixo do texto
+ *             i - número que diferencia os textos
+ * Retorno: void
+ */
+void gerarTextoSintetico(char* destino, const char* prefixo, size_t i) {
+    sprintf(destino, "%s %zu", prefixo, i);
+}
+
+/**
+ * Função: benchmarkHash
+ * Propósito: Comparar a tabela com endereçamento aberto com a tabela encadeada
+ * original para quantidades de 10^3 até maxEntradas associações
+ * Parâmetros: maxEntradas - maior quantidade de associações testada
+ * Retorno: void
+ */
+void benchmarkHash(size_t maxEntradas) {
+    char pista[100];
+    char suspeito[50];
+    
+    printf("=== BENCHMARK: TABELA HASH ===\n");
+    printf("%10s | %-12s | %14s | %14s | %9s\n", "entradas", "tabela", "insercao ns/op", "busca ns/op", "buscas");
+    
+    for (size_t n = 1000; n <= maxEntradas; n *= 10) {
+        // Tabela com endereçamento aberto
+        TabelaHash* tabela = criarTabelaHash();
+        if (tabela == NULL) return;
+        
+        double inicio = tempoAtualSegundos();
+        for (size_t i = 0; i < n; i++) {
+            gerarTextoSintetico(pista, "Pista sintetica", i);
+            gerarTextoSintetico(suspeito, "Suspeito", i % 97);
+            inserirNaHash(tabela, pista, suspeito);
+        }
+        double tempoInsercao = tempoAtualSegundos() - inicio;
+        
+        size_t encontrados = 0;
+        inicio = tempoAtualSegundos();
+        for (size_t i = 0; i < n; i++) {
+            gerarTextoSintetico(pista, "Pista sintetica", (i * 7919) % n);
+            encontrados += encontrarSuspeito(tabela, pista) != NULL;
+        }
+        double tempoBusca = tempoAtualSegundos() - inicio;
+        printf("%10zu | %-12s | %14.1f | %14.1f | %9zu\n", n, "aberta", tempoInsercao * 1e9 / n, tempoBusca * 1e9 / n, encontrados);
+        liberarMemoriaHash(tabela);
+        
+        // Mesma carga item a item e em lote (um único dimensionamento), com os textos já
+        // internados acima: a diferença entre as duas linhas é o custo dos redimensionamentos
+        const char** pistas = (const char**)malloc(n * sizeof(const char*));
+        const char** suspeitos = (const char**)malloc(n * sizeof(const char*));
+        if (pistas != NULL && suspeitos != NULL) {
+            for (size_t i = 0; i < n; i++) {
+                gerarTextoSintetico(pista, "Pista sintetica", i);
+                gerarTextoSintetico(suspeito, "Suspeito", i % 97);
+                pistas[i] = textoDoId(buscarIdTexto(pista));
+                suspeitos[i] = textoDoId(buscarIdTexto(suspeito));
+            }
+            for (int lote = 0; lote <= 1; lote++) {
+                tabela = criarTabelaHash();
+                if (tabela == NULL) break;
+                inicio = tempoAtualSegundos();
+                if (lote) {
+                    inserirNaHashEmLote(tabela, pistas, suspeitos, n);
+                } else {
+                    for (size_t i = 0; i < n; i++) inserirNaHash(tabela, pistas[i], suspeitos[i]);
+                }
+                tempoInsercao = tempoAtualSegundos() - inicio;
+                printf("%10zu | %-12s | %14.1f | %14s | %9zu\n", n, lote ? "aberta lote" : "aberta item",
+                       tempoInsercao * 1e9 / n, "-", tabela->quantidade);
+                liberarMemoriaHash(tabela);
+            }
+        }
+        free(pistas);
+        free(suspeitos);
+        
+        // Tabela encadeada original (as buscas são amostradas nos tamanhos grandes,
+        // já que cada busca percorre em média n/40 nós)
+        TabelaHashEncadeada encadeada;
+        memset(&encadeada, 0, sizeof(encadeada));
+        
+        inicio = tempoAtualSegundos();
+        for (size_t i = 0; i < n; i++) {
+            gerarTextoSintetico(pista, "Pista sintetica", i);
+            gerarTextoSintetico(suspeito, "Suspeito", i % 97);
+            inserirNaHashEncadeada(&encadeada, pista, suspeito);
+        }
+        tempoInsercao = tempoAtualSegundos() - inicio;
+        
+        size_t amostra = n <= 10000 ? n : 1000;
+        encontrados = 0;
+        inicio = tempoAtualSegundos();
+        for (size_t i = 0; i < amostra; i++) {
+            gerarTextoSintetico(pista, "Pista sintetica", (i * 7919) % n);
+            encontrados += encontrarSuspeitoEncadeado(&encadeada, pista) != NULL;
+        }
+        tempoBusca = tempoAtualSegundos() - inicio;
+        printf("%10zu | %-12s | %14.1f | %14.1f | %9zu\n", n, "encadeada", tempoInsercao * 1e9 / n, tempoBusca * 1e9 / amostra, encontrados);
+        liberarHashEncadeada(&encadeada);
+    }
+}
+
+/**
+ * Função: medirAlturaPistas
+ * Propósito: Medir a altura real de uma árvore de pistas (válida também para a BST simples,
+ * que não mantém o campo altura atualizado)
+ * Parâmetros: raiz - ponteiro para a raiz da árvore
+ * Retorno: altura da árvore
+ */
+static int medirAlturaPistas(PistaNode* raiz) {
+    // Percurso em profundidade com pilha explícita de (nó, profundidade)
+    size_t capacidade = 64, topo = 0;
+    PistaNode** nos = (PistaNode**)malloc(capacidade * sizeof(PistaNode*));
+    int* profundidades = (int*)malloc(capacidade * sizeof(int));
+    int altura = 0;
+    
+    if (raiz != NULL && nos != NULL && profundidades != NULL) {
+        nos[topo] = raiz;
+        profundidades[topo++] = 1;
+    }
+    while (topo > 0) {
+        PistaNode* no = nos[--topo];
+        int profundidade = profundidades[topo];
+        if (profundidade > altura) altura = profundidade;
+        
+        if (topo + 2 > capacidade) {
+            PistaNode** maisNos = (PistaNode**)realloc(nos, capacidade * 2 * sizeof(PistaNode*));
+            if (maisNos != NULL) nos = maisNos;
+            int* maisProfundidades = (int*)realloc(profundidades, capacidade * 2 * sizeof(int));
+            if (maisProfundidades != NULL) profundidades = maisProfundidades;
+            if (maisNos == NULL || maisProfundidades == NULL) break;
+            capacidade *= 2;
+        }
+        if (no->esquerda != NULL) {
+            nos[topo] = no->esquerda;
+            profundidades[topo++] = profundidade + 1;
+        }
+        if (no->direita != NULL) {
+            nos[topo] = no->direita;
+            profundidades[topo++] = profundidade + 1;
+        }
+    }
+    
+    free(nos);
+    free(profundidades);
+    return altura;
+}
+
+/**
+ * Função: medirInsercaoPistas
+ * Propósito: Inserir n pistas sintéticas (em ordem crescente ou embaralhada) e imprimir
+ * o tempo por inserção e a altura resultante
+ * Parâmetros: rotulo - nome da variante exibido na tabela
+ *             inserir - função de inserção (inserirPista ou inserirPistaBalanceada)
+ *             ordem - permutação dos índices a inserir
+ *             n - quantidade de pistas
+ *             ordenada - 1 se a ordem é crescente (apenas para exibição)
+ * Retorno: void
+ */
+static void medirInsercaoPistas(const char* rotulo, PistaNode* (*inserir)(PistaNode*, IdTexto),
+                                const size_t* ordem, size_t n, int ordenada) {
+    char pista[100];
+    PistaNode* raiz = NULL;
+    
+    // Os textos são internados antes da medição
+    IdTexto* ids = (IdTexto*)malloc(n * sizeof(IdTexto));
+    if (ids == NULL) return;
+    for (size_t i = 0; i < n; i++) {
+        sprintf(pista, "Pista %09zu", ordem[i]);
+        ids[i] = internarTexto(pista);
+        if (ids[i] == ID_TEXTO_INVALIDO) {
+            free(ids);
+            return;
+        }
+    }
+    
+    double inicio = tempoAtualSegundos();
+    for (size_t i = 0; i < n; i++) {
+        raiz = inserir(raiz, ids[i]);
+    }
+    double tempo = tempoAtualSegundos() - inicio;
+    
+    printf("%-12s | %-10s | %10zu | %14.1f | %8d\n", rotulo, ordenada ? "ordenada" : "aleatoria",
+           n, tempo * 1e9 / n, medirAlturaPistas(raiz));
+    liberarMemoriaPistas(raiz, NULL);
+    free(ids);
+}
+
+/**
+ * Função: medirInsercaoLotePistas
+ * Propósito: Medir inserirPistasEmLote com as mesmas pistas de medirInsercaoPistas: metade
+ * monta a árvore a partir do zero e a outra metade é mesclada à árvore já existente
+ * Parâmetros: ordem - permutação dos índices a inserir
+ *             n - quantidade de pistas
+ *             ordenada - 1 se a ordem é crescente (apenas para exibição)
+ * Retorno: void
+ */
+static void medirInsercaoLotePistas(const size_t* ordem, size_t n, int ordenada) {
+    char pista[100];
+    
+    IdTexto* ids = (IdTexto*)malloc(n * sizeof(IdTexto));
+    if (ids == NULL) return;
+    for (size_t i = 0; i < n; i++) {
+        sprintf(pista, "Pista %09zu", ordem[i]);
+        ids[i] = internarTexto(pista);
+        if (ids[i] == ID_TEXTO_INVALIDO) {
+            free(ids);
+            return;
+        }
+    }
+    
+    double inicio = tempoAtualSegundos();
+    PistaNode* raiz = NULL;
+    inserirPistasEmLote(&raiz, ids, n / 2);
+    inserirPistasEmLote(&raiz, ids + n / 2, n - n / 2);
+    double tempo = tempoAtualSegundos() - inicio;
+    
+    printf("%-12s | %-10s | %10zu | %14.1f | %8d\n", "AVL (lote)", ordenada ? "ordenada" : "aleatoria",
+           n, tempo * 1e9 / n, medirAlturaPistas(raiz));
+    liberarMemoriaPistas(raiz, NULL);
+    free(ids);
+}
+
+/**
+ * Função: benchmarkPistas
+ * Propósito: Comparar inserção ordenada x aleatória na BST simples e na árvore AVL
+ * (a BST simples com entrada ordenada é limitada a 20000 pistas, pois degenera
+ * em lista e a recursão estouraria a pilha)
+ * Parâmetros: n - quantidade de pistas
+ * Retorno: void
+ */
+void benchmarkPistas(size_t n) {
+    size_t* ordenada = (size_t*)malloc(n * sizeof(size_t));
+    size_t* aleatoria = (size_t*)malloc(n * sizeof(size_t));
+    if (ordenada == NULL || aleatoria == NULL) {
+        printf("Erro: Falha na alocação de memória para o benchmark!\n");
+        free(ordenada);
+        free(aleatoria);
+        return;
+    }
+    
+    // Embaralhamento de Fisher-Yates com gerador xorshift de semente fixa
+    uint64_t estado = 88172645463325252ULL;
+    for (size_t i = 0; i < n; i++) {
+        ordenada[i] = i;
+        aleatoria[i] = i;
+    }
+    for (size_t i = n; i > 1; i--) {
+        estado ^= estado << 13;
+        estado ^= estado >> 7;
+        estado ^= estado << 17;
+        size_t j = (size_t)(estado % i);
+        size_t temp = aleatoria[i - 1];
+        aleatoria[i - 1] = aleatoria[j];
+        aleatoria[j] = temp;
+    }
+    
+    size_t limiteSimples = n < 20000 ? n : 20000;
+    
+    printf("=== BENCHMARK: ARVORE DE PISTAS ===\n");
+    printf("%-12s | %-10s | %10s | %14s | %8s\n", "arvore", "entrada", "pistas", "insercao ns/op", "altura");
+    medirInsercaoPistas("BST simples", inserirPista, ordenada, limiteSimples, 1);
+    medirInsercaoPistas("BST simples", inserirPista, aleatoria, n, 0);
+    medirInsercaoPistas("AVL", inserirPistaBalanceada, ordenada, n, 1);
+    medirInsercaoPistas("AVL", inserirPistaBalanceada, aleatoria, n, 0);
+    medirInsercaoLotePistas(ordenada, n, 1);
+    medirInsercaoLotePistas(aleatoria, n, 0);
+    
+    free(ordenada);
+    free(aleatoria);
+}
+
+/**
+ * Função: construirMansaoCompleta
+ * Propósito: Construir uma mansão sintética em forma de árvore binária completa
+ * (sala i tem filhos 2i+1 e 2i+2), com uma pista distinta em cada sala
+ * Parâmetros: n - número de salas
+ * Retorno: ponteiro para a sala raiz (NULL se n == 0 ou faltar memória)
+ */
+Sala* construirMansaoCompleta(size_t n) {
+    if (n == 0) return NULL;
+    
+    Sala** salas = (Sala**)malloc(n * sizeof(Sala*));
+    if (salas == NULL) {
+        printf("Erro: Falha na alocação de memória para a mansao sintetica!\n");
+        return NULL;
+    }
+    
+    char nome[50];
+    char pista[100];
+    for (size_t i = 0; i < n; i++) {
+        gerarTextoSintetico(nome, "Sala", i);
+        gerarTextoSintetico(pista, "Pista sintetica", i);
+        salas[i] = criarSala(nome, pista);
+        if (salas[i] == NULL) {
+            for (size_t j = 0; j < i && arenaAtual == NULL; j++) liberarNo(salas[j]);
+            free(salas);
+            return NULL;
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (2 * i + 1 < n) salas[i]->esquerda = salas[2 * i + 1];
+        if (2 * i + 2 < n) salas[i]->direita = salas[2 * i + 2];
+    }
+    
+    Sala* raiz = salas[0];
+    free(salas);
+    return raiz;
+}
+
+/**
+ * Função: contarSalasEmOrdem
+ * Propósito: Percorrer toda a mansão (em pré-ordem) tocando o conteúdo de cada sala,
+ * usada para medir a localidade dos nós
+ * Parâmetros: raiz - ponteiro para a sala raiz
+ * Retorno: soma de verificação do percurso
+ */
+static size_t contarSalasEmOrdem(Sala* raiz) {
+    size_t verificacao = 0, capacidade = 64, topo = 0;
+    Sala** pilha = (Sala**)malloc(capacidade * sizeof(Sala*));
+    if (pilha == NULL) return 0;
+    
+    if (raiz != NULL) pilha[topo++] = raiz;
+    while (topo > 0) {
+        Sala* sala = pilha[--topo];
+        verificacao += (size_t)sala->pista;
+        
+        if (topo + 2 > capacidade) {
+            Sala** maior = (Sala**)realloc(pilha, capacidade * 2 * sizeof(Sala*));
+            if (maior == NULL) break;
+            pilha = maior;
+            capacidade *= 2;
+        }
+        if (sala->direita != NULL) pilha[topo++] = sala->direita;
+        if (sala->esquerda != NULL) pilha[topo++] = sala->esquerda;
+    }
+    
+    free(pilha);
+    return verificacao;
+}
+
+/**
+ * Função: medirSessaoSintetica
+ * Propósito: Montar e desmontar uma sessão sintética completa (mansão, caderno com todas
+ * as pistas e tabela hash) no modo de alocação atual e imprimir os tempos
+ * Parâmetros: rotulo - nome do modo exibido na tabela
+ *             arena - arena a usar (NULL para malloc por nó)
+ *             n - número de salas
+ * Retorno: void
+ */
+static void medirSessaoSintetica(const char* rotulo, Arena* arena, size_t n) {
+    char pista[100];
+    char suspeito[50];
+    ContadoresAlocacao antes = contadoresMalloc;
+    Arena* anterior = usarArena(arena);
+    
+    double inicio = tempoAtualSegundos();
+    Sala* hall = construirMansaoCompleta(n);
+    PistaNode* caderno = NULL;
+    TabelaHash* tabela = criarTabelaHash();
+    for (size_t i = 0; i < n; i++) {
+        gerarTextoSintetico(pista, "Pista sintetica", i);
+        gerarTextoSintetico(suspeito, "Suspeito", i % 97);
+        IdTexto idPista = internarTexto(pista);
+        if (idPista == ID_TEXTO_INVALIDO) break;
+        caderno = inserirPistaBalanceada(caderno, idPista);
+        inserirNaHash(tabela, pista, suspeito);
+    }
+    double tempoMontagem = tempoAtualSegundos() - inicio;
+    
+    inicio = tempoAtualSegundos();
+    size_t verificacao = contarSalasEmOrdem(hall);
+    double tempoPercurso = tempoAtualSegundos() - inicio;
+    
+    size_t nos = arena != NULL ? arena->alocacoes : contadoresMalloc.alocacoes - antes.alocacoes;
+    size_t bytes = arena != NULL ? arena->bytesAlocados : contadoresMalloc.bytesAlocados - antes.bytesAlocados;
+    size_t blocos = arena != NULL ? arena->blocosAlocados : nos;
+    
+    inicio = tempoAtualSegundos();
+    liberarMemoriaSalas(hall, arena);
+    liberarMemoriaPistas(caderno, arena);
+    liberarMemoriaHash(tabela);
+    usarArena(anterior);
+    if (arena != NULL) {
+        liberarArena(arena);
+    }
+    double tempoLiberacao = tempoAtualSegundos() - inicio;
+    
+    printf("%-8s | %10zu | %10zu | %8zu | %12.3f | %12.3f | %12.3f | %zu\n", rotulo, nos, bytes / 1024, blocos,
+           tempoMontagem * 1e3, tempoPercurso * 1e3, tempoLiberacao * 1e3, verificacao);
+}
+
+/**
+ * Função: benchmarkArena
+ * Propósito: Comparar a alocação por malloc individual com a alocação em arena
+ * (montagem, percurso completo da mansão e liberação)
+ * Parâmetros: n - número de salas (e de pistas) da sessão sintética
+ * Retorno: void
+ */
+void benchmarkArena(size_t n) {
+    printf("=== BENCHMARK: ARENA X MALLOC (%zu salas) ===\n", n);
+    printf("%-8s | %10s | %10s | %8s | %12s | %12s | %12s | %s\n", "modo", "nos", "KiB", "blocos",
+           "montagem ms", "percurso ms", "liberacao ms", "verificacao");
+    medirSessaoSintetica("malloc", NULL, n);
+    medirSessaoSintetica("arena", criarArena(0), n);
+}
+
+/**
+ * Função: construirMapaSintetico
+ * Propósito: Montar um MapaMansao sintético em forma de árvore binária completa
+ * (uma pista distinta por sala, associadas a 97 suspeitos)
+ * Parâmetros: n - número de salas
+ * Retorno: ponteiro para o mapa ou NULL se faltou memória
+ */
+MapaMansao* construirMapaSintetico(size_t n) {
+    ConstrutorMapa construtor;
+    if (!iniciarConstrutorMapa(&construtor)) return NULL;
+    
+    char nome[50];
+    char pista[100];
+    char suspeito[50];
+    for (size_t i = 0; i < n; i++) {
+        gerarTextoSintetico(nome, "Sala", i);
+        gerarTextoSintetico(pista, "Pista sintetica", i);
+        gerarTextoSintetico(suspeito, "Suspeito", i % 97);
+        uint32_t esquerda = 2 * i + 1 < n ? (uint32_t)(2 * i + 1) : SALA_NENHUMA;
+        uint32_t direita = 2 * i + 2 < n ? (uint32_t)(2 * i + 2) : SALA_NENHUMA;
+        if (adicionarSalaMapa(&construtor, nome, pista, esquerda, direita) == SALA_NENHUMA ||
+            !adicionarAssociacaoMapa(&construtor, pista, suspeito)) {
+            descartarConstrutorMapa(&construtor);
+            return NULL;
+        }
+    }
+    return finalizarConstrutorMapa(&construtor);
+}
+
+/**
+ * Função: benchmarkMapa
+ * Propósito: Medir o tempo de inicialização a partir do formato texto e do formato
+ * binário mapeado em memória, para um mapa sintético de n salas
+ * Parâmetros: n - número de salas
+ * Retorno: void
+ */
+void benchmarkMapa(size_t n) {
+    const char* caminhoTexto = "bench_mapa_tmp.txt";
+    const char* caminhoBinario = "bench_mapa_tmp.dqm";
+    
+    MapaMansao* mapa = construirMapaSintetico(n);
+    if (mapa == NULL) {
+        printf("Erro: Nao foi possivel gerar o mapa sintetico!\n");
+        return;
+    }
+    int ok = salvarMapaTexto(mapa, caminhoTexto) && salvarMapaBinario(mapa, caminhoBinario);
+    liberarMapa(mapa);
+    if (!ok) return;
+    
+    printf("=== BENCHMARK: CARREGAMENTO DE MAPAS (%zu salas) ===\n", n);
+    printf("%-8s | %12s | %14s | %16s\n", "formato", "carga ms", "percurso ms", "salas alcancadas");
+    
+    const char* caminhos[2] = { caminhoTexto, caminhoBinario };
+    const char* rotulos[2] = { "texto", "binario" };
+    for (int f = 0; f < 2; f++) {
+        double inicio = tempoAtualSegundos();
+        mapa = carregarMapa(caminhos[f]);
+        double tempoCarga = tempoAtualSegundos() - inicio;
+        if (mapa == NULL) break;
+        
+        // Percurso completo pelos índices (toca as páginas do arquivo mapeado)
+        inicio = tempoAtualSegundos();
+        size_t alcancadas = 0;
+        uint32_t* pilha = (uint32_t*)malloc(mapa->numSalas * sizeof(uint32_t));
+        if (pilha != NULL) {
+            size_t topo = 0;
+            pilha[topo++] = 0;
+            while (topo > 0) {
+                const RegistroSala* sala = &mapa->salas[pilha[--topo]];
+                alcancadas++;
+                if (sala->direita != SALA_NENHUMA) pilha[topo++] = sala->direita;
+                if (sala->esquerda != SALA_NENHUMA) pilha[topo++] = sala->esquerda;
+            }
+            free(pilha);
+        }
+        double tempoPercurso = tempoAtualSegundos() - inicio;
+        
+        printf("%-8s | %12.3f | %14.3f | %16zu\n", rotulos[f], tempoCarga * 1e3, tempoPercurso * 1e3, alcancadas);
+        liberarMapa(mapa);
+    }
+    
+    remove(caminhoTexto);
+    remove(caminhoBinario);
+}
+
+/**
+ * Função: benchmarkParalelo
+ * Propósito: Medir a escalabilidade do lote paralelo de 1 até N threads (N = número de
+ * processadores), com sessões aleatórias sobre uma mansão sintética compartilhada
+ * Parâmetros: totalSessoes - sessões executadas em cada medição
+ * Retorno: void
+ */
+void benchmarkParalelo(size_t totalSessoes) {
+    const size_t numSalas = (1 << 16) - 1;  // 16 níveis: sessões de até 15 movimentos
+    const size_t numRoteiros = 4096;
+    const size_t movimentosPorSessao = 15;
+    
+    Arena* arena = criarArena(0);
+    if (arena == NULL) return;
+    Arena* anterior = usarArena(arena);
+    
+    Sala* hall = construirMansaoCompleta(numSalas);
+    TabelaHash* tabela = criarTabelaHash();
+    SessaoRoteiro* sessoes = (SessaoRoteiro*)malloc(numRoteiros * sizeof(SessaoRoteiro));
+    char* movimentos = (char*)malloc(numRoteiros * movimentosPorSessao);
+    if (hall == NULL || tabela == NULL || sessoes == NULL || movimentos == NULL) {
+        printf("Erro: Falha na alocação de memória para o benchmark!\n");
+        liberarMemoriaHash(tabela);
+        free(sessoes);
+        free(movimentos);
+        usarArena(anterior);
+        liberarArena(arena);
+        return;
+    }
+    
+    char pista[100];
+    char suspeito[50];
+    for (size_t i = 0; i < numSalas; i++) {
+        gerarTextoSintetico(pista, "Pista sintetica", i);
+        gerarTextoSintetico(suspeito, "Suspeito", i % 97);
+        inserirNaHash(tabela, pista, suspeito);
+    }
+    
+    // Roteiros aleatórios de semente fixa (xorshift), acusando um suspeito qualquer
+    uint64_t estado = 88172645463325252ULL;
+    for (size_t i = 0; i < numRoteiros; i++) {
+        for (size_t m = 0; m < movimentosPorSessao; m++) {
+            estado ^= estado << 13;
+            estado ^= estado >> 7;
+            estado ^= estado << 17;
+            movimentos[i * movimentosPorSessao + m] = (estado & 1) ? 'd' : 'e';
+        }
+        gerarTextoSintetico(suspeito, "Suspeito", (size_t)(estado >> 8) % 97);
+        sessoes[i].movimentos = &movimentos[i * movimentosPorSessao];
+        sessoes[i].numMovimentos = movimentosPorSessao;
+        sessoes[i].acusado = buscarIdTexto(suspeito);
+        sessoes[i].textoAcusado = textoDoId(sessoes[i].acusado);
+    }
+    usarArena(anterior);
+    
+    int nucleos = numeroDeNucleos();
+    printf("=== BENCHMARK: LOTE PARALELO (%zu sessoes, %zu salas, %d nucleos) ===\n", totalSessoes, numSalas, nucleos);
+    printf("%7s | %10s | %14s | %10s | %10s | %8s | %s\n", "threads", "tempo ms", "sessoes/s", "aceleracao",
+           "eficiencia", "roubos", "resolvidas");
+    
+    double tempoBase = 0.0;
+    for (int threads = 1; ; threads = threads * 2 < nucleos ? threads * 2 : nucleos) {
+        ExecucaoLote execucao;
+        memset(&execucao, 0, sizeof(ExecucaoLote));
+        execucao.hall = hall;
+        execucao.tabela = tabela;
+        execucao.sessoes = sessoes;
+        execucao.numSessoes = numRoteiros;
+        execucao.totalSessoes = totalSessoes;
+        execucao.numThreads = threads;
+        if (!executarLoteParalelo(&execucao)) break;
+        
+        if (threads == 1) tempoBase = execucao.tempo;
+        double aceleracao = execucao.tempo > 0 ? tempoBase / execucao.tempo : 0.0;
+        printf("%7d | %10.3f | %14.0f | %9.2fx | %9.1f%% | %8zu | %zu\n", threads, execucao.tempo * 1e3,
+               execucao.tempo > 0 ? totalSessoes / execucao.tempo : 0.0, aceleracao, 100.0 * aceleracao / threads,
+               execucao.fatiasRoubadas, execucao.resolvidas);
+        if (threads >= nucleos) break;
+    }
+    
+    liberarMemoriaHash(tabela);
+    free(sessoes);
+    free(movimentos);
+    liberarArena(arena);
+}
+
+/**
+ * Função: benchmarkSolucionador
+ * Propósito: Medir o solucionador em uma mansão sintética de n salas, com 1 thread
+ * e com todos os núcleos
+ * Parâmetros: n - número de salas
+ * Retorno: void
+ */
+void benchmarkSolucionador(size_t n) {
+    Arena* arena = criarArena(0);
+    if (arena == NULL) return;
+    Arena* anterior = usarArena(arena);
+    
+    Sala* hall = construirMansaoCompleta(n);
+    TabelaHash* tabela = criarTabelaHash();
+    if (hall != NULL && tabela != NULL) {
+        char pista[100];
+        char suspeito[50];
+        for (size_t i = 0; i < n; i++) {
+            gerarTextoSintetico(pista, "Pista sintetica", i);
+            gerarTextoSintetico(suspeito, "Suspeito", i % 97);
+            inserirNaHash(tabela, pista, suspeito);
+        }
+        
+        int nucleos = numeroDeNucleos();
+        printf("=== BENCHMARK: SOLUCIONADOR (%zu salas) ===\n\n", n);
+        executarSolucionador(hall, tabela, 1);
+        if (nucleos > 1) {
+            printf("\n");
+            executarSolucionador(hall, tabela, nucleos);
+        }
+    }
+    
+    liberarMemoriaHash(tabela);
+    usarArena(anterior);
+    liberarArena(arena);
+}
+
+/**
+ * Função: abrirArquivoNulo
+ * Propósito: Abrir o dispositivo nulo para escrita (para medir laços interativos sem
+ * imprimir no terminal)
+ * Retorno: arquivo aberto ou NULL em caso de erro
+ */
+static FILE* abrirArquivoNulo(void) {
+#ifdef _WIN32
+    return fopen("NUL", "w");
+#else
+    return fopen("/dev/null", "w");
+#endif
+}
+
+/**
+ * Função: exibirMedicao
+ * Propósito: Imprimir uma linha da tabela do benchmark de estruturas
+ * Parâmetros: operacao - nome da operação
+ *             operacoes - quantidade de operações medidas
+ *             tempo - tempo total em segundos
+ *             verificacao - soma de verificação (evita que o trabalho seja descartado)
+ * Retorno: void
+ */
+static void exibirMedicao(const char* operacao, size_t operacoes, double tempo, size_t verificacao) {
+    printf("%-28s | %12zu | %12.3f | %14.1f | %zu\n", operacao, operacoes, tempo * 1e3,
+           operacoes > 0 ? tempo * 1e9 / operacoes : 0.0, verificacao);
+}
+
+/**
+ * Função: benchmarkEstruturas
+ * Propósito: Medir as operações centrais do jogo em dados sintéticos: inserirNaHash,
+ * encontrarSuspeito, inserirPista, contarPistasPorSuspeito e o laço completo de
+ * explorarSalas (entrada roteirizada, saída para o dispositivo nulo em cada formato)
+ * Parâmetros: n - número de pistas (e de salas da mansão sintética)
+ * Retorno: void
+ */
+void benchmarkEstruturas(size_t n) {
+    const size_t numSuspeitos = 97;
+    const size_t tamanhoTexto = 32;
+    if (n == 0) return;
+    
+    char* pistas = (char*)malloc(n * tamanhoTexto);
+    char* suspeitos = (char*)malloc(numSuspeitos * tamanhoTexto);
+    size_t* ordem = (size_t*)malloc(n * sizeof(size_t));
+    if (pistas == NULL || suspeitos == NULL || ordem == NULL) {
+        printf("Erro: Falha na alocação de memória para o benchmark!\n");
+        free(pistas);
+        free(suspeitos);
+        free(ordem);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        gerarTextoSintetico(&pistas[i * tamanhoTexto], "Pista sintetica", i);
+        ordem[i] = i;
+    }
+    for (size_t i = 0; i < numSuspeitos; i++) {
+        gerarTextoSintetico(&suspeitos[i * tamanhoTexto], "Suspeito", i);
+    }
+    
+    // Ordem aleatória de semente fixa (xorshift) para as buscas e inserções no caderno
+    uint64_t estado = 88172645463325252ULL;
+    for (size_t i = n; i > 1; i--) {
+        estado ^= estado << 13;
+        estado ^= estado >> 7;
+        estado ^= estado << 17;
+        size_t j = (size_t)(estado % i);
+        size_t temp = ordem[i - 1];
+        ordem[i - 1] = ordem[j];
+        ordem[j] = temp;
+    }
+    
+    printf("=== BENCHMARK: ESTRUTURAS CENTRAIS (%zu pistas, %zu suspeitos) ===\n", n, numSuspeitos);
+    printf("%-28s | %12s | %12s | %14s | %s\n", "operacao", "operacoes", "total ms", "ns/op", "verificacao");
+    
+    // inserirNaHash (interna pista e suspeito a cada chamada)
+    TabelaHash* tabela = criarTabelaHash();
+    double inicio = tempoAtualSegundos();
+    for (size_t i = 0; i < n; i++) {
+        inserirNaHash(tabela, &pistas[i * tamanhoTexto], &suspeitos[(i % numSuspeitos) * tamanhoTexto]);
+    }
+    exibirMedicao("inserirNaHash", n, tempoAtualSegundos() - inicio, tabela->quantidade);
+    
+    // encontrarSuspeito em ordem aleatória (todas encontradas)
+    size_t encontrados = 0;
+    inicio = tempoAtualSegundos();
+    for (size_t i = 0; i < n; i++) {
+        encontrados += encontrarSuspeito(tabela, &pistas[ordem[i] * tamanhoTexto]) != NULL;
+    }
+    exibirMedicao("encontrarSuspeito", n, tempoAtualSegundos() - inicio, encontrados);
+    
+    // inserirPista (BST simples) em ordem aleatória
+    PistaNode* caderno = NULL;
+    inicio = tempoAtualSegundos();
+    for (size_t i = 0; i < n; i++) {
+        caderno = inserirPista(caderno, buscarIdTexto(&pistas[ordem[i] * tamanhoTexto]));
+    }
+    exibirMedicao("inserirPista", n, tempoAtualSegundos() - inicio, (size_t)medirAlturaPistas(caderno));
+    
+    // contarPistasPorSuspeito: um percurso completo do caderno por suspeito
+    size_t contadas = 0;
+    inicio = tempoAtualSegundos();
+    for (size_t i = 0; i < numSuspeitos; i++) {
+        contadas += (size_t)contarPistasPorSuspeito(caderno, tabela, &suspeitos[i * tamanhoTexto]);
+    }
+    exibirMedicao("contarPistasPorSuspeito", numSuspeitos, tempoAtualSegundos() - inicio, contadas);
+    liberarMemoriaPistas(caderno, NULL);
+    caderno = NULL;
+    
+    // explorarSalas: sessões completas até uma folha, acusando um suspeito qualquer
+    const char* caminhoRoteiro = "bench_sessoes_tmp.txt";
+    size_t sessoes = n / 100 < 100 ? 100 : (n / 100 > 10000 ? 10000 : n / 100);
+    size_t movimentos = 0;
+    Sala* hall = construirMansaoCompleta(n);
+    IndiceSuspeitos* indice = criarIndiceSuspeitos();
+    FILE* roteiro = fopen(caminhoRoteiro, "w");
+    if (hall != NULL && indice != NULL && roteiro != NULL) {
+        // Passada única que prepara as dicas de acusação (feita uma vez, antes do jogo)
+        inicio = tempoAtualSegundos();
+        resumirCondenacoes(hall, tabela);
+        exibirMedicao("resumirCondenacoes", n, tempoAtualSegundos() - inicio, hall->salasAteCondenacao);
+        
+        for (size_t i = 0; i < sessoes; i++) {
+            for (Sala* sala = hall; sala->esquerda != NULL || sala->direita != NULL; movimentos++) {
+                estado ^= estado << 13;
+                estado ^= estado >> 7;
+                estado ^= estado << 17;
+                int esquerda = sala->direita == NULL || (sala->esquerda != NULL && (estado & 1));
+                fputs(esquerda ? "e\n" : "d\n", roteiro);
+                sala = esquerda ? sala->esquerda : sala->direita;
+            }
+            fprintf(roteiro, "s\n%s\n", &suspeitos[(size_t)(estado >> 8) % numSuspeitos * tamanhoTexto]);
+        }
+        fclose(roteiro);
+        roteiro = NULL;
+        
+        static const ModoSaida modos[] = {SAIDA_TEXTO, SAIDA_EVENTOS, SAIDA_NENHUMA};
+        static const char* rotulos[][2] = {{"explorar texto (sessao)", "explorar texto (movimento)"},
+                                           {"explorar eventos (sessao)", "explorar eventos (movimento)"},
+                                           {"explorar nenhuma (sessao)", "explorar nenhuma (movimento)"}};
+        FILE* nulo = abrirArquivoNulo();
+        for (int m = 0; m < 3 && nulo != NULL && freopen(caminhoRoteiro, "r", stdin) != NULL; m++) {
+            SaidaJogo saida;
+            iniciarSaidaJogo(&saida, modos[m], nulo);
+            inicio = tempoAtualSegundos();
+            for (size_t i = 0; i < sessoes; i++) {
+                explorarSalas(&saida, hall, &caderno, tabela, indice);
+                liberarMemoriaPistas(caderno, NULL);
+                caderno = NULL;
+                limparIndiceSuspeitos(indice);
+            }
+            finalizarSaidaJogo(&saida);
+            double tempo = tempoAtualSegundos() - inicio;
+            exibirMedicao(rotulos[m][0], sessoes, tempo, movimentos);
+            exibirMedicao(rotulos[m][1], movimentos, tempo, movimentos);
+        }
+        if (nulo != NULL) fclose(nulo);
+    }
+    if (roteiro != NULL) fclose(roteiro);
+    remove(caminhoRoteiro);
+    
+    liberarMemoriaSalas(hall, NULL);
+    liberarIndiceSuspeitos(indice);
+    liberarMemoriaHash(tabela);
+    free(pistas);
+    free(suspeitos);
+    free(ordem);
+}
+
+/**
+ * Função: medirPercursosPistas
+ * Propósito: Medir os percursos do caderno (iterador, Morris e liberação por rotações)
+ * sobre uma árvore já montada e imprimir uma linha por operação
+ * Parâmetros: rotulo - nome da forma da árvore
+ *             caderno - raiz da árvore (é liberada ao final)
+ *             n - número de nós
+ *             tabela - tabela hash de suspeitos das pistas
+ * Retorno: void
+ */
+static void medirPercursosPistas(const char* rotulo, PistaNode* caderno, size_t n, TabelaHash* tabela) {
+    int altura = medirAlturaPistas(caderno);
+    
+    IteradorPistas iterador;
+    size_t visitados = 0;
+    double inicio = tempoAtualSegundos();
+    iniciarIteradorPistas(&iterador, caderno);
+    while (proximaPista(&iterador) != NULL) visitados++;
+    finalizarIteradorPistas(&iterador);
+    double tempo = tempoAtualSegundos() - inicio;
+    printf("%-18s | %-26s | %9zu | %9d | %10.3f | %8.1f\n", rotulo, "iterador em ordem", visitados, altura,
+           tempo * 1e3, tempo * 1e9 / n);
+    
+    inicio = tempoAtualSegundos();
+    size_t contadas = (size_t)contarPistasPorSuspeito(caderno, tabela, "Suspeito 0");
+    tempo = tempoAtualSegundos() - inicio;
+    printf("%-18s | %-26s | %9zu | %9d | %10.3f | %8.1f\n", rotulo, "contarPistasPorSuspeito", contadas, altura,
+           tempo * 1e3, tempo * 1e9 / n);
+    
+    int exibidas = 0;
+    FILE* nulo = abrirArquivoNulo();
+    SaidaJogo saida;
+    iniciarSaidaJogo(&saida, SAIDA_TEXTO, nulo != NULL ? nulo : stdout);
+    inicio = tempoAtualSegundos();
+    exibirPistas(&saida, caderno, &exibidas);
+    finalizarSaidaJogo(&saida);
+    tempo = tempoAtualSegundos() - inicio;
+    if (nulo != NULL) fclose(nulo);
+    printf("%-18s | %-26s | %9d | %9d | %10.3f | %8.1f\n", rotulo, "exibirPistas (saida nula)", exibidas, altura,
+           tempo * 1e3, tempo * 1e9 / n);
+    
+    inicio = tempoAtualSegundos();
+    liberarMemoriaPistas(caderno, NULL);
+    tempo = tempoAtualSegundos() - inicio;
+    printf("%-18s | %-26s | %9zu | %9d | %10.3f | %8.1f\n", rotulo, "liberarMemoriaPistas", n, altura,
+           tempo * 1e3, tempo * 1e9 / n);
+}
+
+/**
+ * Função: benchmarkPercursos
+ * Propósito: Medir os percursos iterativos em árvores balanceadas e em árvores
+ * degeneradas de profundidade n (que estourariam a pilha com recursão)
+ * Parâmetros: n - número de nós (e profundidade das árvores degeneradas)
+ * Retorno: void
+ */
+void benchmarkPercursos(size_t n) {
+    if (n == 0) return;
+    IdTexto* ids = (IdTexto*)malloc(n * sizeof(IdTexto));
+    TabelaHash* tabela = criarTabelaHash();
+    if (ids == NULL || tabela == NULL) {
+        printf("Erro: Falha na alocação de memória para o benchmark!\n");
+        free(ids);
+        liberarMemoriaHash(tabela);
+        return;
+    }
+    
+    char pista[100];
+    char suspeito[50];
+    for (size_t i = 0; i < n; i++) {
+        gerarTextoSintetico(pista, "Pista sintetica", i);
+        gerarTextoSintetico(suspeito, "Suspeito", i % 97);
+        inserirNaHash(tabela, pista, suspeito);
+        ids[i] = buscarIdTexto(pista);
+    }
+    qsort(ids, n, sizeof(IdTexto), compararIdsTexto);
+    
+    printf("=== BENCHMARK: PERCURSOS ITERATIVOS (%zu nos) ===\n", n);
+    printf("%-18s | %-26s | %9s | %9s | %10s | %8s\n", "arvore", "operacao", "nos", "altura", "ms", "ns/no");
+    
+    // Caderno balanceado (AVL)
+    PistaNode* caderno = NULL;
+    for (size_t i = 0; i < n; i++) {
+        caderno = inserirPistaBalanceada(caderno, ids[i]);
+    }
+    medirPercursosPistas("caderno AVL", caderno, n, tabela);
+    
+    // Caderno degenerado: BST simples com entrada ordenada (uma lista à direita), montado
+    // diretamente pois a inserção um a um custaria O(n^2)
+    caderno = NULL;
+    for (size_t i = n; i-- > 0;) {
+        PistaNode* no = criarPistaNode(ids[i]);
+        if (no == NULL) break;
+        no->direita = caderno;
+        caderno = no;
+    }
+    medirPercursosPistas("caderno degenerado", caderno, n, tabela);
+    
+    // Mansões: completa e em zigue-zague (profundidade n)
+    Sala* hall = construirMansaoCompleta(n);
+    double inicio = tempoAtualSegundos();
+    size_t verificacao = contarSalasEmOrdem(hall);
+    double tempo = tempoAtualSegundos() - inicio;
+    printf("%-18s | %-26s | %9zu | %9s | %10.3f | %8.1f\n", "mansao completa", "percurso em pre-ordem", n, "-",
+           tempo * 1e3, tempo * 1e9 / n);
+    inicio = tempoAtualSegundos();
+    liberarMemoriaSalas(hall, NULL);
+    tempo = tempoAtualSegundos() - inicio;
+    printf("%-18s | %-26s | %9zu | %9s | %10.3f | %8.1f\n", "mansao completa", "liberarMemoriaSalas", n, "-",
+           tempo * 1e3, tempo * 1e9 / n);
+    
+    hall = NULL;
+    for (size_t i = n; i-- > 0;) {
+        gerarTextoSintetico(pista, "Sala profunda", i);
+        Sala* sala = criarSala(pista, "");
+        if (sala == NULL) break;
+        if (i % 2 == 0) sala->esquerda = hall; else sala->direita = hall;
+        hall = sala;
+    }
+    inicio = tempoAtualSegundos();
+    verificacao += contarSalasEmOrdem(hall);
+    tempo = tempoAtualSegundos() - inicio;
+    printf("%-18s | %-26s | %9zu | %9zu | %10.3f | %8.1f\n", "mansao zigue-zague", "percurso em pre-ordem", n, n,
+           tempo * 1e3, tempo * 1e9 / n);
+    inicio = tempoAtualSegundos();
+    liberarMemoriaSalas(hall, NULL);
+    tempo = tempoAtualSegundos() - inicio;
+    printf("%-18s | %-26s | %9zu | %9zu | %10.3f | %8.1f\n", "mansao zigue-zague", "liberarMemoriaSalas", n, n,
+           tempo * 1e3, tempo * 1e9 / n);
+    
+    (void)verificacao;
+    liberarMemoriaHash(tabela);
+    free(ids);
+}
+
+/**
+ * Função: percorrerGrafoEmProfundidade
+ * Propósito: Percorrer todo o grafo de salas em pré-ordem (pilha explícita) somando as
+ * pistas, o equivalente de contarSalasEmOrdem para o grafo compacto
+ * Parâmetros: grafo - ponteiro para o grafo
+ * Retorno: soma de verificação do percurso
+ */
+static size_t percorrerGrafoEmProfundidade(const GrafoSalas* grafo) {
+    size_t verificacao = 0, capacidade = 64, topo = 0;
+    uint32_t* pilha = (uint32_t*)malloc(capacidade * sizeof(uint32_t));
+    if (pilha == NULL || grafo->numSalas == 0) {
+        free(pilha);
+        return 0;
+    }
+    
+    pilha[topo++] = 0;
+    while (topo > 0) {
+        uint32_t sala = pilha[--topo];
+        verificacao += (size_t)grafo->pista[sala];
+        
+        if (topo + 2 > capacidade) {
+            uint32_t* maior = (uint32_t*)realloc(pilha, capacidade * 2 * sizeof(uint32_t));
+            if (maior == NULL) break;
+            pilha = maior;
+            capacidade *= 2;
+        }
+        if (grafo->direita[sala] != SALA_NENHUMA) pilha[topo++] = grafo->direita[sala];
+        if (grafo->esquerda[sala] != SALA_NENHUMA) pilha[topo++] = grafo->esquerda[sala];
+    }
+    
+    free(pilha);
+    return verificacao;
+}
+
+/**
+ * Função: caminharSalas
+ * Propósito: Simular a navegação de explorarSalas: caminhadas aleatórias (semente fixa)
+ * do hall até uma folha pela árvore de ponteiros
+ * Parâmetros: hall - sala de entrada
+ *             caminhadas - quantidade de caminhadas
+ *             passos - saída: total de movimentos
+ * Retorno: soma de verificação das pistas visitadas
+ */
+static size_t caminharSalas(Sala* hall, size_t caminhadas, size_t* passos) {
+    uint64_t estado = 88172645463325252ULL;
+    size_t verificacao = 0;
+    *passos = 0;
+    for (size_t i = 0; i < caminhadas; i++) {
+        for (Sala* sala = hall; sala != NULL; (*passos)++) {
+            estado ^= estado << 13;
+            estado ^= estado >> 7;
+            estado ^= estado << 17;
+            verificacao += (size_t)sala->pista;
+            sala = (estado & 1) && sala->esquerda != NULL ? sala->esquerda : sala->direita != NULL ? sala->direita : sala->esquerda;
+        }
+    }
+    return verificacao;
+}
+
+/**
+ * Função: caminharGrafo
+ * Propósito: Mesmas caminhadas de caminharSalas, sobre o grafo compacto
+ * Parâmetros: grafo - ponteiro para o grafo
+ *             caminhadas - quantidade de caminhadas
+ *             passos - saída: total de movimentos
+ * Retorno: soma de verificação das pistas visitadas
+ */
+static size_t caminharGrafo(const GrafoSalas* grafo, size_t caminhadas, size_t* passos) {
+    uint64_t estado = 88172645463325252ULL;
+    size_t verificacao = 0;
+    *passos = 0;
+    for (size_t i = 0; i < caminhadas; i++) {
+        for (uint32_t sala = 0; sala != SALA_NENHUMA; (*passos)++) {
+            estado ^= estado << 13;
+            estado ^= estado >> 7;
+            estado ^= estado << 17;
+            verificacao += (size_t)grafo->pista[sala];
+            uint32_t esquerda = grafo->esquerda[sala];
+            uint32_t direita = grafo->direita[sala];
+            sala = (estado & 1) && esquerda != SALA_NENHUMA ? esquerda : direita != SALA_NENHUMA ? direita : esquerda;
+        }
+    }
+    return verificacao;
+}
+
+/**
+ * Função: construirSalasEmbaralhadas
+ * Propósito: Montar a árvore de ponteiros de um grafo com os nós alocados em ordem
+ * aleatória (malloc), simulando uma mansão montada aos poucos com o heap fragmentado
+ * Parâmetros: grafo - ponteiro para o grafo
+ *             salas - saída: vetor de nós (para a liberação)
+ * Retorno: ponteiro para a sala de entrada ou NULL em caso de erro
+ */
+static Sala* construirSalasEmbaralhadas(const GrafoSalas* grafo, Sala*** salas) {
+    size_t n = grafo->numSalas;
+    size_t* ordem = (size_t*)malloc(n * sizeof(size_t));
+    *salas = (Sala**)calloc(n, sizeof(Sala*));
+    if (ordem == NULL || *salas == NULL) {
+        free(ordem);
+        free(*salas);
+        *salas = NULL;
+        return NULL;
+    }
+    
+    uint64_t estado = 88172645463325252ULL;
+    for (size_t i = 0; i < n; i++) ordem[i] = i;
+    for (size_t i = n; i > 1; i--) {
+        estado ^= estado << 13;
+        estado ^= estado >> 7;
+        estado ^= estado << 17;
+        size_t j = (size_t)(estado % i);
+        size_t temp = ordem[i - 1];
+        ordem[i - 1] = ordem[j];
+        ordem[j] = temp;
+    }
+    for (size_t i = 0; i < n; i++) {
+        Sala* sala = (Sala*)malloc(sizeof(Sala));
+        if (sala == NULL) break;
+        sala->nome = grafo->nome[ordem[i]];
+        sala->pista = grafo->pista[ordem[i]];
+        sala->salasAteCondenacao = CONDENACAO_NAO_CALCULADA;
+        (*salas)[ordem[i]] = sala;
+    }
+    free(ordem);
+    for (size_t i = 0; i < n; i++) {
+        if ((*salas)[i] == NULL) return NULL;
+        (*salas)[i]->esquerda = grafo->esquerda[i] != SALA_NENHUMA ? (*salas)[grafo->esquerda[i]] : NULL;
+        (*salas)[i]->direita = grafo->direita[i] != SALA_NENHUMA ? (*salas)[grafo->direita[i]] : NULL;
+    }
+    return (*salas)[0];
+}
+
+/**
+ * Função: benchmarkGrafo
+ * Propósito: Comparar a árvore de ponteiros com o grafo compacto (ordem de largura e
+ * van Emde Boas) no percurso completo da mansão e em caminhadas do hall até as folhas
+ * Parâmetros: n - número de salas
+ * Retorno: void
+ */
+void benchmarkGrafo(size_t n) {
+    const size_t caminhadas = 1 << 20;
+    if (n == 0) return;
+    
+    Arena* arena = criarArena(0);
+    if (arena == NULL) return;
+    Arena* anterior = usarArena(arena);
+    Sala* hallArena = construirMansaoCompleta(n);
+    usarArena(anterior);
+    
+    GrafoSalas* largura = grafoDeSalas(hallArena);
+    GrafoSalas* veb = largura != NULL ? reordenarGrafo(largura, ORDEM_VEB) : NULL;
+    Sala** salasEmbaralhadas = NULL;
+    Sala* hallEmbaralhado = largura != NULL ? construirSalasEmbaralhadas(largura, &salasEmbaralhadas) : NULL;
+    if (hallArena == NULL || largura == NULL || veb == NULL || hallEmbaralhado == NULL) {
+        printf("Erro: Falha na alocação de memória para o benchmark!\n");
+    } else {
+        printf("=== BENCHMARK: GRAFO COMPACTO X ARVORE DE PONTEIROS (%zu salas, %zu caminhadas) ===\n", n, caminhadas);
+        printf("%-28s | %10s | %14s | %14s | %s\n", "representacao", "bytes/sala", "percurso ns/sala",
+               "caminhada ns/passo", "verificacao");
+        
+        const char* rotulos[2] = { "ponteiros (heap embaralhado)", "ponteiros (arena, largura)" };
+        Sala* halls[2] = { hallEmbaralhado, hallArena };
+        for (int r = 0; r < 2; r++) {
+            size_t passos;
+            double inicio = tempoAtualSegundos();
+            size_t verificacao = contarSalasEmOrdem(halls[r]);
+            double tempoPercurso = tempoAtualSegundos() - inicio;
+            inicio = tempoAtualSegundos();
+            verificacao += caminharSalas(halls[r], caminhadas, &passos);
+            double tempoCaminhada = tempoAtualSegundos() - inicio;
+            printf("%-28s | %10zu | %16.2f | %18.2f | %zu\n", rotulos[r], sizeof(Sala), tempoPercurso * 1e9 / n,
+                   tempoCaminhada * 1e9 / passos, verificacao);
+        }
+        
+        const char* rotulosGrafo[2] = { "grafo (largura)", "grafo (van Emde Boas)" };
+        GrafoSalas* grafos[2] = { largura, veb };
+        for (int r = 0; r < 2; r++) {
+            size_t passos;
+            double inicio = tempoAtualSegundos();
+            size_t verificacao = percorrerGrafoEmProfundidade(grafos[r]);
+            double tempoPercurso = tempoAtualSegundos() - inicio;
+            inicio = tempoAtualSegundos();
+            verificacao += caminharGrafo(grafos[r], caminhadas, &passos);
+            double tempoCaminhada = tempoAtualSegundos() - inicio;
+            printf("%-28s | %10zu | %16.2f | %18.2f | %zu\n", rotulosGrafo[r],
+                   2 * sizeof(uint32_t) + sizeof(IdTexto), tempoPercurso * 1e9 / n, tempoCaminhada * 1e9 / passos,
+                   verificacao);
+        }
+        
+        // Sem ordem de visita, o grafo permite uma varredura linear das pistas
+        double inicio = tempoAtualSegundos();
+        size_t verificacao = 0;
+        for (size_t i = 0; i < largura->numSalas; i++) verificacao += (size_t)largura->pista[i];
+        double tempoVarredura = tempoAtualSegundos() - inicio;
+        printf("%-28s | %10zu | %16.2f | %18s | %zu\n", "grafo (varredura linear)", sizeof(IdTexto),
+               tempoVarredura * 1e9 / n, "-", verificacao);
+    }
+    
+    if (salasEmbaralhadas != NULL) {
+        for (size_t i = 0; i < n; i++) free(salasEmbaralhadas[i]);
+        free(salasEmbaralhadas);
+    }
+    liberarGrafoSalas(largura);
+    liberarGrafoSalas(veb);
+    liberarArena(arena);
+}
+
+/**
+ * Função: medirEstados
+ * Propósito: Simular n sessões em andamento (caminhadas aleatórias de semente fixa a partir
+ * do hall), capturar seus estados, gravá-los, mapeá-los de volta e restaurá-los, imprimindo
+ * o custo de cada etapa
+ * Parâmetros: rotulo - nome da mansão exibido na tabela
+ *             hall - sala de entrada
+ *             tabela - tabela hash de suspeitos
+ *             n - número de sessões
+ * Retorno: void
+ */
+static void medirEstados(const char* rotulo, Sala* hall, TabelaHash* tabela, size_t n) {
+    const char* caminho = "bench_estados_tmp.dqs";
+    ContextoSnapshot* contexto = criarContextoSnapshot(hall);
+    SnapshotSessoes* snapshot = contexto != NULL ? criarSnapshotSessoes(contexto, n) : NULL;
+    uint32_t* pistasPorSessao = (uint32_t*)malloc(n * sizeof(uint32_t));
+    Arena* arena = criarArena(64 * 1024);
+    IndiceSuspeitos* indice = criarIndiceSuspeitos();
+    if (snapshot == NULL || pistasPorSessao == NULL || arena == NULL || indice == NULL) {
+        printf("Erro: Falha na alocação de memória para o benchmark!\n");
+        liberarSnapshotSessoes(snapshot);
+        liberarContextoSnapshot(contexto);
+        free(pistasPorSessao);
+        liberarArena(arena);
+        liberarIndiceSuspeitos(indice);
+        return;
+    }
+    
+    // Sessões simuladas: só a captura entra na medição
+    Arena* anterior = usarArena(arena);
+    uint64_t estado = 88172645463325252ULL;
+    double tempoCaptura = 0;
+    for (size_t i = 0; i < n; i++) {
+        reiniciarArena(arena);
+        limparIndiceSuspeitos(indice);
+        PistaNode* caderno = NULL;
+        IdTexto suspeito;
+        Sala* sala = hall;
+        uint32_t movimentos = 0;
+        pistasPorSessao[i] = (uint32_t)coletarPistaDaSala(sala, &caderno, tabela, indice, &suspeito);
+        for (;;) {
+            estado ^= estado << 13;
+            estado ^= estado >> 7;
+            estado ^= estado << 17;
+            Sala* destino = (estado & 3) == 0 ? NULL : (estado & 4) ? sala->esquerda : sala->direita;
+            if (destino == NULL) break;
+            sala = destino;
+            movimentos++;
+            pistasPorSessao[i] += (uint32_t)coletarPistaDaSala(sala, &caderno, tabela, indice, &suspeito);
+        }
+        double inicio = tempoAtualSegundos();
+        capturarSessao(contexto, registroDoSnapshot(snapshot, i), sala, caderno, movimentos, 0);
+        tempoCaptura += tempoAtualSegundos() - inicio;
+    }
+    
+    double inicio = tempoAtualSegundos();
+    int ok = salvarSnapshotSessoes(snapshot, caminho);
+    double tempoGravacao = tempoAtualSegundos() - inicio;
+    size_t tamanho = snapshot->tamanho;
+    liberarSnapshotSessoes(snapshot);
+    
+    inicio = tempoAtualSegundos();
+    snapshot = ok ? abrirSnapshotSessoes(contexto, caminho) : NULL;
+    double tempoAbertura = tempoAtualSegundos() - inicio;
+    
+    // Restauração de toda a população (caderno balanceado + índice de evidências)
+    double tempoRestauracao = 0;
+    size_t divergencias = 0;
+    if (snapshot != NULL) {
+        inicio = tempoAtualSegundos();
+        for (size_t i = 0; i < n; i++) {
+            reiniciarArena(arena);
+            limparIndiceSuspeitos(indice);
+            PistaNode* caderno = NULL;
+            divergencias += restaurarSessao(contexto, registroDoSnapshot(snapshot, i), &caderno, tabela, indice) == NULL;
+        }
+        tempoRestauracao = tempoAtualSegundos() - inicio;
+        
+        // Conferência (fora da medição): cadernos restaurados têm as mesmas pistas
+        for (size_t i = 0; i < n; i += 1 + n / 100000) {
+            reiniciarArena(arena);
+            limparIndiceSuspeitos(indice);
+            PistaNode* caderno = NULL;
+            restaurarSessao(contexto, registroDoSnapshot(snapshot, i), &caderno, tabela, indice);
+            uint32_t contador = 0;
+            IteradorPistas iterador;
+            iniciarIteradorPistas(&iterador, caderno);
+            while (proximaPista(&iterador) != NULL) contador++;
+            finalizarIteradorPistas(&iterador);
+            divergencias += contador != pistasPorSessao[i];
+        }
+    }
+    usarArena(anterior);
+    
+    printf("%-10s | %6zu | %6zu | %8zu | %14.1f | %12.0f | %11.3f | %16.1f | %s\n", rotulo, contexto->numSalas,
+           contexto->numPistas, bytesPorRegistroSessao(contexto), tempoCaptura * 1e9 / n,
+           tempoGravacao > 0 ? tamanho / tempoGravacao / (1 << 20) : 0.0, tempoAbertura * 1e3,
+           tempoRestauracao * 1e9 / n, snapshot != NULL && divergencias == 0 ? "ok" : "FALHOU");
+    
+    liberarSnapshotSessoes(snapshot);
+    liberarContextoSnapshot(contexto);
+    free(pistasPorSessao);
+    liberarArena(arena);
+    liberarIndiceSuspeitos(indice);
+    remove(caminho);
+}
+
+/**
+ * Função: benchmarkEstados
+ * Propósito: Medir a captura, gravação, abertura (mmap) e restauração de grandes populações
+ * de sessões em andamento, na mansão padrão e em uma mansão sintética com mais pistas
+ * Parâmetros: n - número de sessões
+ * Retorno: void
+ */
+void benchmarkEstados(size_t n) {
+    if (n == 0) return;
+    
+    Arena* arena = criarArena(0);
+    TabelaHash* tabela = criarTabelaHash();
+    if (arena == NULL || tabela == NULL) {
+        liberarArena(arena);
+        liberarMemoriaHash(tabela);
+        return;
+    }
+    inicializarSuspeitos(tabela);
+    Arena* anterior = usarArena(arena);
+    Sala* padrao = construirMansaoPadrao();
+    Sala* sintetica = construirMansaoCompleta(255);
+    usarArena(anterior);
+    
+    printf("=== BENCHMARK: ESTADOS DE SESSOES (%zu sessoes) ===\n", n);
+    printf("%-10s | %6s | %6s | %8s | %14s | %12s | %11s | %16s | %s\n", "mansao", "salas", "pistas",
+           "bytes", "captura ns/op", "gravacao MB/s", "abertura ms", "restauracao ns/op", "verificacao");
+    if (padrao != NULL) medirEstados("padrao", padrao, tabela, n);
+    if (sintetica != NULL) medirEstados("sintetica", sintetica, tabela, n);
+    
+    liberarMemoriaHash(tabela);
+    liberarArena(arena);
+}
+
+/**
+ * Função: benchmarkEvidencias
+ * Propósito: Comparar a pontuação de todos os suspeitos com o caderno em árvore (percurso +
+ * consulta na hash por suspeito) e com o caderno de bits (AND + contagem, portátil, AVX2
+ * e em passada única)
+ * Parâmetros: n - pistas no catálogo
+ * Retorno: void
+ */
+void benchmarkEvidencias(size_t n) {
+    const size_t numSuspeitos = 64, numCadernos = 16, repeticoesBits = 200;
+    char pista[100];
+    char suspeito[50];
+    if (n == 0) return;
+    
+    TabelaHash* tabela = criarTabelaHash();
+    if (tabela == NULL) return;
+    reservarTabelaHash(tabela, n);
+    for (size_t i = 0; i < n; i++) {
+        gerarTextoSintetico(pista, "Pista sintetica", i);
+        gerarTextoSintetico(suspeito, "Suspeito", i % numSuspeitos);
+        inserirNaHash(tabela, pista, suspeito);
+    }
+    CatalogoPistas* catalogo = criarCatalogoPistas(tabela);
+    PistaNode* arvores[16];
+    CadernoBits* cadernos[16];
+    uint32_t* contagens = catalogo != NULL ? (uint32_t*)malloc(catalogo->numSuspeitos * sizeof(uint32_t)) : NULL;
+    memset(arvores, 0, sizeof(arvores));
+    memset(cadernos, 0, sizeof(cadernos));
+    if (catalogo == NULL || contagens == NULL) {
+        printf("Erro: Falha na alocação de memória para o benchmark!\n");
+        liberarCatalogoPistas(catalogo);
+        liberarMemoriaHash(tabela);
+        return;
+    }
+    
+    // Cada caderno recebe n/8 pistas sorteadas (semente fixa), nas duas representações
+    uint64_t estado = 88172645463325252ULL;
+    for (size_t c = 0; c < numCadernos; c++) {
+        cadernos[c] = criarCadernoBits(catalogo);
+        if (cadernos[c] == NULL) break;
+        for (size_t j = 0; j < n / 8 + 1; j++) {
+            estado ^= estado << 13;
+            estado ^= estado >> 7;
+            estado ^= estado << 17;
+            gerarTextoSintetico(pista, "Pista sintetica", (size_t)(estado % n));
+            IdTexto id = buscarIdTexto(pista);
+            if (marcarPistaBits(catalogo, cadernos[c], id)) arvores[c] = inserirPistaBalanceada(arvores[c], id);
+        }
+    }
+    
+    printf("=== BENCHMARK: PONTUACAO DE SUSPEITOS (%zu pistas, %zu suspeitos, %zu cadernos de ~%zu pistas) ===\n",
+           n, catalogo->numSuspeitos, numCadernos, n / 8);
+    printf("%-28s | %18s | %s\n", "caderno", "pontuacao us/op", "verificacao");
+    
+    for (int variante = 0; variante < 4 && cadernos[numCadernos - 1] != NULL; variante++) {
+#ifdef DQ_SIMD_X86
+        if (variante == 2 && !__builtin_cpu_supports("avx2")) continue;
+#else
+        if (variante == 2) continue;
+#endif
+        size_t repeticoes = variante == 0 ? 1 : repeticoesBits;
+        uint64_t verificacao = 0;
+        double inicio = tempoAtualSegundos();
+        for (size_t r = 0; r < repeticoes; r++) {
+            for (size_t c = 0; c < numCadernos; c++) {
+                if (variante == 3) {
+                    pontuarSuspeitosBits(catalogo, cadernos[c], contagens);
+                    for (size_t s = 0; s < catalogo->numSuspeitos; s++) verificacao += contagens[s];
+                    continue;
+                }
+                for (size_t s = 0; s < catalogo->numSuspeitos; s++) {
+                    const uint64_t* mascara = catalogo->mascaras + s * catalogo->palavras;
+                    if (variante == 0) {
+                        verificacao += (uint64_t)contarPistasPorIdSuspeito(arvores[c], tabela, catalogo->idSuspeito[s]);
+                    } else if (variante == 1) {
+                        verificacao += contarInterseccaoPortatil(cadernos[c]->bits, mascara, catalogo->palavras);
+#ifdef DQ_SIMD_X86
+                    } else {
+                        verificacao += contarInterseccaoAvx2(cadernos[c]->bits, mascara, catalogo->palavras);
+#endif
+                    }
+                }
+            }
+        }
+        double tempo = tempoAtualSegundos() - inicio;
+        
+        const char* rotulos[4] = { "arvore + hash", "bits portatil (por suspeito)", "bits AVX2 (por suspeito)",
+                                   "bits (passada unica)" };
+        printf("%-28s | %18.2f | %llu\n", rotulos[variante], tempo * 1e6 / (repeticoes * numCadernos),
+               (unsigned long long)(verificacao / repeticoes));
+    }
+    
+    for (size_t c = 0; c < numCadernos; c++) {
+        liberarMemoriaPistas(arvores[c], NULL);
+        liberarCadernoBits(cadernos[c]);
+    }
+    free(contagens);
+    liberarCatalogoPistas(catalogo);
+    liberarMemoriaHash(tabela);
+}
+
+/**
+ * Função: benchmarkTextos
+ * Propósito: Medir o índice de textos (árvore radix) com n pistas sintéticas variadas:
+ * inserção, busca exata, enumeração por prefixo e busca aproximada com erros de digitação
+ * Parâmetros: n - número de pistas
+ * Retorno: void
+ */
+void benchmarkTextos(size_t n) {
+    static const char* objetos[] = { "Frasco", "Carta", "Faca", "Luva", "Livro", "Chave", "Pegada", "Cinza",
+                                     "Partitura", "Documento", "Anel", "Lenco", "Bilhete", "Retrato", "Vela", "Taca" };
+    static const char* estados[] = { "quebrado", "rasgado", "manchado", "queimado", "escondido", "molhado",
+                                     "falsificado", "esquecido" };
+    static const char* locais[] = { "biblioteca", "cozinha", "estufa", "despensa", "escritorio", "jardim",
+                                    "adega", "capela" };
+    const size_t consultas = 200000;
+    char texto[120];
+    if (n == 0) return;
+    
+    IdTexto* ids = (IdTexto*)malloc(n * sizeof(IdTexto));
+    IndiceTextos* indice = criarIndiceTextos();
+    if (ids == NULL || indice == NULL) {
+        printf("Erro: Falha na alocação de memória para o benchmark!\n");
+        free(ids);
+        liberarIndiceTextos(indice);
+        return;
+    }
+    
+    uint64_t estado = 88172645463325252ULL;
+    for (size_t i = 0; i < n; i++) {
+        estado ^= estado << 13;
+        estado ^= estado >> 7;
+        estado ^= estado << 17;
+        snprintf(texto, sizeof(texto), "%s %s na %s %zu", objetos[estado % 16], estados[(estado >> 8) % 8],
+                 locais[(estado >> 16) % 8], (size_t)(estado >> 24) % (n * 4 + 1));
+        ids[i] = internarTexto(texto);
+        if (ids[i] == ID_TEXTO_INVALIDO) {
+            free(ids);
+            liberarIndiceTextos(indice);
+            return;
+        }
+    }
+    
+    printf("=== BENCHMARK: INDICE DE TEXTOS (%zu pistas) ===\n", n);
+    printf("%-24s | %12s | %s\n", "operacao", "ns/op", "verificacao");
+    
+    double inicio = tempoAtualSegundos();
+    size_t inseridas = 0;
+    for (size_t i = 0; i < n; i++) inseridas += (size_t)inserirNoIndiceTextos(indice, ids[i]);
+    double tempo = tempoAtualSegundos() - inicio;
+    printf("%-24s | %12.1f | %zu textos, %zu nos\n", "insercao", tempo * 1e9 / n, inseridas, indice->numNos);
+    
+    size_t acertos = 0;
+    inicio = tempoAtualSegundos();
+    for (size_t i = 0; i < consultas; i++) {
+        IdTexto id = ids[(i * 7919) % n];
+        acertos += buscarNoIndiceTextos(indice, textoDoId(id)) == id;
+    }
+    tempo = tempoAtualSegundos() - inicio;
+    printf("%-24s | %12.1f | %zu/%zu\n", "busca exata", tempo * 1e9 / consultas, acertos, consultas);
+    
+    IdTexto resultados[MAX_RESULTADOS_PREFIXO];
+    size_t listados = 0;
+    inicio = tempoAtualSegundos();
+    for (size_t i = 0; i < consultas; i++) {
+        // Prefixos de tamanhos variados: objeto, objeto + estado, quase o texto inteiro
+        const char* completo = textoDoId(ids[(i * 7919) % n]);
+        size_t tamanho = strlen(completo);
+        size_t corte = i % 3 == 0 ? 4 : i % 3 == 1 ? tamanho / 2 : tamanho - 2;
+        memcpy(texto, completo, corte);
+        texto[corte] = '\0';
+        listados += listarPorPrefixo(indice, texto, resultados, MAX_RESULTADOS_PREFIXO);
+    }
+    tempo = tempoAtualSegundos() - inicio;
+    printf("%-24s | %12.1f | %zu resultados\n", "prefixo (ate 20)", tempo * 1e9 / consultas, listados);
+    
+    for (uint32_t erros = 1; erros <= 2; erros++) {
+        const size_t consultasAproximadas = consultas / 10;
+        acertos = 0;
+        double tempoTotal = 0;
+        for (size_t i = 0; i < consultasAproximadas; i++) {
+            // Erros de digitação: troca de letras em posições sorteadas
+            IdTexto id = ids[(i * 7919) % n];
+            const char* completo = textoDoId(id);
+            size_t tamanho = strlen(completo);
+            memcpy(texto, completo, tamanho + 1);
+            for (uint32_t e = 0; e < erros; e++) {
+                estado ^= estado << 13;
+                estado ^= estado >> 7;
+                estado ^= estado << 17;
+                size_t posicao = (size_t)(estado % tamanho);
+                texto[posicao] = texto[posicao] == 'x' ? 'y' : 'x';
+            }
+            uint32_t distancia;
+            inicio = tempoAtualSegundos();
+            IdTexto encontrado = buscarTextoAproximado(indice, texto, erros, &distancia);
+            tempoTotal += tempoAtualSegundos() - inicio;
+            acertos += encontrado != ID_TEXTO_INVALIDO && distancia <= erros;
+        }
+        snprintf(texto, sizeof(texto), "aproximada (%u erro%s)", erros, erros > 1 ? "s" : "");
+        printf("%-24s | %12.1f | %zu/%zu dentro do limite\n", texto, tempoTotal * 1e9 / consultasAproximadas,
+               acertos, consultasAproximadas);
     }
     
-    // Copia o conteúdo e inicializa os ponteiros como NULL
-    strcpy(novoNode->conteudo, conteudo);
-    novoNode->esquerda = NULL;
-    novoNode->direita = NULL;
-    
-    return novoNode;
+    free(ids);
+    liberarIndiceTextos(indice);
 }
 
 /**
- * Função: inserirPista (também conhecida como adicionarPista)
- * Propósito: Inserir uma nova pista na árvore BST de pistas em ordem alfabética
- * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas
- *             conteudo - string com o conteúdo da pista a ser inserida
- * Retorno: ponteiro para a raiz da árvore (pode ter mudado)
+ * Função: benchmarkGerador
+ * Propósito: Medir o gerador procedural: geração em memória (1 e N threads), gravação em
+ * fluxo no formato binário e montagem da árvore de salas e da tabela de suspeitos
+ * Parâmetros: n - número de salas
+ * Retorno: void
  */
-PistaNode* inserirPista(PistaNode* raiz, const char* conteudo) {
-    // Caso base: árvore vazia ou chegou ao local de inserção
-    if (raiz == NULL) {
-        return criarPistaNode(conteudo);
-    }
+void benchmarkGerador(size_t n) {
+    const char* caminho = "bench_gerador_tmp.dqm";
+    int nucleos = numeroDeNucleos();
+    ParametrosGerador parametros;
+    iniciarParametrosGerador(&parametros);
+    parametros.numSalas = n;
+    parametros.numSuspeitos = 97;
     
-    // Compara a nova pista com a pista atual
-    int comparacao = strcmp(conteudo, raiz->conteudo);
+    printf("=== BENCHMARK: GERADOR DE MANSOES (%zu salas, densidade %.2f, %d nucleos) ===\n", n,
+           parametros.densidadePistas, nucleos);
+    printf("%-26s | %7s | %10s | %8s | %s\n", "etapa", "threads", "tempo ms", "ns/sala", "verificacao");
     
-    if (comparacao < 0) {
-        // Nova pista é menor lexicograficamente - insere à esquerda
-        raiz->esquerda = inserirPista(raiz->esquerda, conteudo);
-    } else if (comparacao > 0) {
-        // Nova pista é maior lexicograficamente - insere à direita
-        raiz->direita = inserirPista(raiz->direita, conteudo);
+    // Geração em memória; a soma dos registros das salas confere que o resultado não muda
+    MapaMansao* mapa = NULL;
+    for (int threads = 1; threads <= nucleos; threads = threads < nucleos ? nucleos : nucleos + 1) {
+        liberarMapa(mapa);
+        double inicio = tempoAtualSegundos();
+        mapa = gerarMapaMansao(&parametros, threads);
+        double tempo = tempoAtualSegundos() - inicio;
+        if (mapa == NULL) return;
+        uint64_t soma = 0;
+        for (uint32_t i = 0; i < mapa->numSalas; i++) {
+            soma = soma * 31 + mapa->salas[i].esquerda + mapa->salas[i].direita + mapa->salas[i].pista;
+        }
+        printf("%-26s | %7d | %10.3f | %8.1f | %016llx\n", "memoria", threads, tempo * 1e3, tempo * 1e9 / n,
+               (unsigned long long)soma);
     }
-    // Se comparacao == 0, a pista já existe, não insere duplicata
     
-    return raiz;
+    // Gravação em blocos direto no arquivo
+    double inicio = tempoAtualSegundos();
+    int gravado = gravarMansaoGerada(&parametros, caminho, nucleos);
+    double tempo = tempoAtualSegundos() - inicio;
+    if (gravado) {
+        MapaMansao* carregado = carregarMapaBinario(caminho);
+        printf("%-26s | %7d | %10.3f | %8.1f | %s\n", "arquivo (fluxo)", nucleos, tempo * 1e3, tempo * 1e9 / n,
+               carregado != NULL && carregado->tamanhoTextos == mapa->tamanhoTextos &&
+               memcmp(carregado->salas, mapa->salas, n * sizeof(RegistroSala)) == 0 ? "igual a memoria" : "DIFERENTE");
+        liberarMapa(carregado);
+    }
+    remove(caminho);
+    
+    // Árvore de salas e tabela de suspeitos para o jogo (sequencial: os textos são internados)
+    Arena* arena = criarArena(0);
+    Arena* anterior = usarArena(arena);
+    TabelaHash* tabela = criarTabelaHash();
+    inicio = tempoAtualSegundos();
+    Sala* hall = construirSalasDoMapa(mapa);
+    if (tabela != NULL) carregarSuspeitosDoMapa(mapa, tabela);
+    tempo = tempoAtualSegundos() - inicio;
+    printf("%-26s | %7d | %10.3f | %8.1f | %zu associacoes\n", "arvore de salas + hash", 1, tempo * 1e3,
+           tempo * 1e9 / n, tabela != NULL ? tabela->quantidade : 0);
+    
+    liberarMemoriaSalas(hall, arena);
+    liberarMemoriaHash(tabela);
+    usarArena(anterior);
+    liberarArena(arena);
+    liberarMapa(mapa);
 }
 
 /**
- * Função: exibirPistas
- * Propósito: Exibir todas as pistas coletadas em ordem alfabética
- * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas
- *             contador - ponteiro para variável que conta as pistas exibidas
- * Retorno: void
+ * Estrutura que representa uma thread do benchmark da tabela concorrente
+ * Leitores consultam pistas cadastradas; o escritor (opcional) cadastra pistas novas
+ * e troca suspeitos de pistas existentes ao mesmo tempo
  */
-void exibirPistas(PistaNode* raiz, int* contador) {
-    if (raiz != NULL) {
-        // Percorre em ordem (in-order): esquerda, raiz, direita
-        exibirPistas(raiz->esquerda, contador);
-        
-        (*contador)++;
-        printf("%d. %s\n", *contador, raiz->conteudo);
-        
-        exibirPistas(raiz->direita, contador);
-    }
-}
+typedef struct TrabalhadorConcorrente {
+    TabelaHashConcorrente* concorrente;  // Tabela concorrente (NULL = tabela comum com trava)
+    TabelaHash* tabela;         // Tabela comum, protegida por trava de leitura/escrita
+#ifndef _WIN32
+    pthread_rwlock_t* trava;    // Trava da tabela comum
+#endif
+    const char* pistas;         // Pistas cadastradas (tamanhoTexto bytes cada)
+    size_t numPistas;
+    size_t tamanhoTexto;
+    size_t operacoes;           // Consultas (leitor) ou inserções (escritor)
+    int escritor;               // 1 para a thread escritora
+    uint64_t semente;           // Semente das consultas aleatórias do leitor
+    double tempo;               // Saída: duração do trabalho da thread
+    size_t verificacao;         // Saída: suspeitos encontrados ou inserções feitas
+} TrabalhadorConcorrente;
 
 /**
- * Função: contarPistasPorSuspeito
- * Propósito: Contar quantas pistas apontam para um determinado suspeito
- * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas
- *             tabela - ponteiro para a tabela hash
- *             suspeito - nome do suspeito a ser contado
- * Retorno: número de pistas que apontam para o suspeito
+ * Função: trabalharConcorrente
+ * Propósito: Corpo de uma thread do benchmark da tabela concorrente
+ * Parâmetros: argumento - ponteiro para o TrabalhadorConcorrente da thread
+ * Retorno: NULL
  */
-int contarPistasPorSuspeito(PistaNode* raiz, TabelaHash* tabela, const char* suspeito) {
-    if (raiz == NULL) return 0;
-    
-    int count = 0;
-    char* suspeitoAssociado = encontrarSuspeito(tabela, raiz->conteudo);
+static void* trabalharConcorrente(void* argumento) {
+    const size_t consultasPorLeitura = 64;
+    TrabalhadorConcorrente* trabalhador = (TrabalhadorConcorrente*)argumento;
+    TabelaHashConcorrente* concorrente = trabalhador->concorrente;
+    double inicio = tempoAtualSegundos();
     
-    if (suspeitoAssociado != NULL && strcmp(suspeitoAssociado, suspeito) == 0) {
-        count = 1;
+    if (trabalhador->escritor) {
+        char pista[100];
+        char suspeito[50];
+        for (size_t i = 0; i < trabalhador->operacoes; i++) {
+            // Alterna pistas novas (que fazem a tabela crescer) com trocas de suspeito
+            if (i % 2 == 0) {
+                gerarTextoSintetico(pista, "Pista nova", i);
+            } else {
+                strcpy(pista, &trabalhador->pistas[(i / 2 % trabalhador->numPistas) * trabalhador->tamanhoTexto]);
+            }
+            gerarTextoSintetico(suspeito, "Suspeito", i % 89);
+            if (concorrente != NULL) {
+                trabalhador->verificacao += (size_t)inserirNaHashConcorrente(concorrente, pista, suspeito);
+            } else {
+#ifndef _WIN32
+                pthread_rwlock_wrlock(trabalhador->trava);
+                inserirNaHash(trabalhador->tabela, pista, suspeito);
+                pthread_rwlock_unlock(trabalhador->trava);
+                trabalhador->verificacao++;
+#endif
+            }
+        }
+    } else {
+        int leitor = concorrente != NULL ? registrarLeitorTabela(concorrente) : -1;
+        if (concorrente != NULL && leitor < 0) return NULL;
+        
+        uint64_t estado = trabalhador->semente;
+        for (size_t feitas = 0; feitas < trabalhador->operacoes;) {
+            size_t fim = feitas + consultasPorLeitura < trabalhador->operacoes ? feitas + consultasPorLeitura
+                                                                               : trabalhador->operacoes;
+            // Uma leitura (ou trava de leitura) cobre um grupo de consultas
+            if (concorrente != NULL) {
+                entrarLeituraTabela(concorrente, leitor);
+            } else {
+#ifndef _WIN32
+                pthread_rwlock_rdlock(trabalhador->trava);
+#endif
+            }
+            for (; feitas < fim; feitas++) {
+                estado ^= estado << 13;
+                estado ^= estado >> 7;
+                estado ^= estado << 17;
+                const char* pista = &trabalhador->pistas[(size_t)(estado % trabalhador->numPistas) * trabalhador->tamanhoTexto];
+                const char* suspeito = concorrente != NULL ? encontrarSuspeitoConcorrente(concorrente, pista)
+                                                           : encontrarSuspeito(trabalhador->tabela, pista);
+                if (suspeito != NULL) trabalhador->verificacao++;
+            }
+            if (concorrente != NULL) {
+                sairLeituraTabela(concorrente, leitor);
+            } else {
+#ifndef _WIN32
+                pthread_rwlock_unlock(trabalhador->trava);
+#endif
+            }
+        }
+        if (concorrente != NULL) liberarLeitorTabela(concorrente, leitor);
     }
     
-    // Recursivamente conta nas subárvores esquerda e direita
-    count += contarPistasPorSuspeito(raiz->esquerda, tabela, suspeito);
-    count += contarPistasPorSuspeito(raiz->direita, tabela, suspeito);
-    
-    return count;
+    trabalhador->tempo = tempoAtualSegundos() - inicio;
+    return NULL;
 }
 
 /**
- * Função: listarPistasPorSuspeito
- * Propósito: Listar todas as pistas que apontam para um determinado suspeito
- * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas
- *             tabela - ponteiro para a tabela hash
- *             suspeito - nome do suspeito
+ * Função: medirTabelaConcorrente
+ * Propósito: Executar leitores (e opcionalmente um escritor) sobre uma tabela e imprimir
+ * a vazão das consultas e o custo das inserções
+ * Parâmetros: rotulo - nome da estrutura medida
+ *             modelo - trabalhador com a tabela e as pistas preenchidas
+ *             leitores - quantidade de threads leitoras
+ *             consultas - consultas feitas por leitor
+ *             insercoes - inserções do escritor (0 = sem escritor)
  * Retorno: void
  */
-void listarPistasPorSuspeito(PistaNode* raiz, TabelaHash* tabela, const char* suspeito) {
-    if (raiz == NULL) return;
-    
-    // Percorre em ordem (in-order)
-    listarPistasPorSuspeito(raiz->esquerda, tabela, suspeito);
-    
-    char* suspeitoAssociado = encontrarSuspeito(tabela, raiz->conteudo);
-    if (suspeitoAssociado != NULL && strcmp(suspeitoAssociado, suspeito) == 0) {
-        printf("   - %s\n", raiz->conteudo);
+static void medirTabelaConcorrente(const char* rotulo, const TrabalhadorConcorrente* modelo, int leitores,
+                                   size_t consultas, size_t insercoes) {
+    int numThreads = leitores + (insercoes > 0 ? 1 : 0);
+    TrabalhadorConcorrente* trabalhadores =
+        (TrabalhadorConcorrente*)malloc((size_t)numThreads * sizeof(TrabalhadorConcorrente));
+    if (trabalhadores == NULL) {
+        printf("Erro: Falha na alocação de memória para o benchmark!\n");
+        return;
+    }
+    for (int t = 0; t < numThreads; t++) {
+        trabalhadores[t] = *modelo;
+        trabalhadores[t].escritor = t == leitores;
+        trabalhadores[t].operacoes = t == leitores ? insercoes : consultas;
+        trabalhadores[t].semente = 88172645463325252ULL + (uint64_t)t * 0x9E3779B97F4A7C15ULL;
+        trabalhadores[t].tempo = 0.0;
+        trabalhadores[t].verificacao = 0;
     }
+    executarEmThreads(numThreads, trabalharConcorrente, trabalhadores, sizeof(TrabalhadorConcorrente));
     
-    listarPistasPorSuspeito(raiz->direita, tabela, suspeito);
+    // Vazão agregada: todas as consultas sobre o tempo do leitor mais lento
+    double tempoLeitores = 0.0;
+    size_t encontradas = 0;
+    for (int t = 0; t < leitores; t++) {
+        if (trabalhadores[t].tempo > tempoLeitores) tempoLeitores = trabalhadores[t].tempo;
+        encontradas += trabalhadores[t].verificacao;
+    }
+    size_t totalConsultas = consultas * (size_t)leitores;
+    char custoEscrita[32] = "-";
+    if (insercoes > 0) {
+        snprintf(custoEscrita, sizeof(custoEscrita), "%.1f", trabalhadores[leitores].tempo * 1e9 / insercoes);
+    }
+    printf("%-18s | %8d | %8s | %14.0f | %11.1f | %11s | %zu/%zu\n", rotulo, leitores, insercoes > 0 ? "sim" : "nao",
+           tempoLeitores > 0 ? totalConsultas / tempoLeitores : 0.0,
+           totalConsultas > 0 ? tempoLeitores * 1e9 * leitores / totalConsultas : 0.0, custoEscrita, encontradas,
+           totalConsultas);
+    free(trabalhadores);
 }
 
 /**
- * Função: verificarSuspeitoFinal
- * Propósito: Conduzir a fase de julgamento final, verificando se há evidências suficientes
- * Parâmetros: arvorePistas - ponteiro para a raiz da árvore de pistas
- *             tabela - ponteiro para a tabela hash de pistas/suspeitos
+ * Função: benchmarkConcorrente
+ * Propósito: Medir a disputa entre leitores e escritor na tabela hash compartilhada:
+ * tabela concorrente (leituras sem trava, recuperação por épocas) x tabela comum
+ * protegida por trava de leitura/escrita, com e sem inserções simultâneas
+ * Parâmetros: n - associações cadastradas antes das medições (e consultas por leitor)
  * Retorno: void
  */
-void verificarSuspeitoFinal(PistaNode* arvorePistas, TabelaHash* tabela) {
-    char suspeitoAcusado[50];
-    
-    printf("\n=== FASE DE ACUSACAO FINAL ===\n");
-    printf("Com base nas pistas coletadas, voce deve fazer sua acusacao!\n");
-    printf("Suspeitos disponiveis: Dr. Smith, Sra. Johnson, Sr. Williams, Mordomo James\n");
-    printf("\nQuem voce acusa do crime? ");
+void benchmarkConcorrente(size_t n) {
+    const size_t tamanhoTexto = 32;
+    if (n == 0) return;
+    int leitores = numeroDeNucleos();
+    if (leitores >= MAX_THREADS_LOTE) leitores = MAX_THREADS_LOTE - 1;
+    size_t insercoes = n / 4 > 0 ? n / 4 : 1;
     
-    // Lê o nome do suspeito com espaços
-    fgets(suspeitoAcusado, sizeof(suspeitoAcusado), stdin);
-    suspeitoAcusado[strcspn(suspeitoAcusado, "\n")] = 0; // Remove quebra de linha
-    
-    // Conta quantas pistas apontam para o suspeito acusado
-    int pistasEncontradas = contarPistasPorSuspeito(arvorePistas, tabela, suspeitoAcusado);
+    char* pistas = (char*)malloc(n * tamanhoTexto);
+    char (*suspeitos)[50] = (char (*)[50])malloc(97 * sizeof(*suspeitos));
+    if (pistas == NULL || suspeitos == NULL) {
+        printf("Erro: Falha na alocação de memória para o benchmark!\n");
+        free(pistas);
+        free(suspeitos);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        gerarTextoSintetico(&pistas[i * tamanhoTexto], "Pista sintetica", i);
+    }
+    for (size_t k = 0; k < 97; k++) {
+        gerarTextoSintetico(suspeitos[k], "Suspeito", k);
+    }
     
-    printf("\n=== ANALISE DAS EVIDENCIAS ===\n");
-    printf("Suspeito acusado: %s\n", suspeitoAcusado);
-    printf("Pistas que apontam para %s: %d\n", suspeitoAcusado, pistasEncontradas);
+    printf("=== BENCHMARK: TABELA CONCORRENTE (%zu associacoes, %d leitores, %zu insercoes) ===\n", n, leitores,
+           insercoes);
+    TrabalhadorConcorrente modelo;
+    memset(&modelo, 0, sizeof(TrabalhadorConcorrente));
+    modelo.pistas = pistas;
+    modelo.numPistas = n;
+    modelo.tamanhoTexto = tamanhoTexto;
     
-    if (pistasEncontradas > 0) {
-        printf("\nPistas encontradas:\n");
-        listarPistasPorSuspeito(arvorePistas, tabela, suspeitoAcusado);
+    // Carga inicial em uma thread, medida para as duas estruturas
+    TabelaHashConcorrente* concorrente = criarTabelaHashConcorrente();
+    double inicio = tempoAtualSegundos();
+    for (size_t i = 0; i < n && concorrente != NULL; i++) {
+        inserirNaHashConcorrente(concorrente, &pistas[i * tamanhoTexto], suspeitos[i % 97]);
     }
+    double tempoCargaConcorrente = tempoAtualSegundos() - inicio;
+    TabelaHash* tabela = criarTabelaHash();
+    inicio = tempoAtualSegundos();
+    for (size_t i = 0; i < n && tabela != NULL; i++) {
+        inserirNaHash(tabela, &pistas[i * tamanhoTexto], suspeitos[i % 97]);
+    }
+    double tempoCargaTabela = tempoAtualSegundos() - inicio;
+    printf("Carga (1 thread): concorrente %.1f ns/insercao, hash comum %.1f ns/insercao\n",
+           tempoCargaConcorrente * 1e9 / n, tempoCargaTabela * 1e9 / n);
     
-    printf("\n=== VEREDICTO ===\n");
-    if (pistasEncontradas >= 2) {
-        printf("*** PARABENS! ***\n");
-        printf("Voce resolveu o caso com sucesso!\n");
-        printf("Ha evidencias suficientes (%d pistas) para sustentar sua acusacao.\n", pistasEncontradas);
-        printf("%s foi preso(a) e confessou o crime!\n", suspeitoAcusado);
-        printf("A mansao misteriosa finalmente pode descansar em paz.\n");
-    } else {
-        printf("*** CASO NAO RESOLVIDO ***\n");
-        printf("Evidencias insuficientes para uma condenacao.\n");
-        printf("Voce precisa de pelo menos 2 pistas convincentes para sustentar a acusacao.\n");
-        if (pistasEncontradas == 1) {
-            printf("Apenas 1 pista foi encontrada - nao e suficiente para o tribunal.\n");
-        } else {
-            printf("Nenhuma pista aponta para %s.\n", suspeitoAcusado);
-        }
-        printf("O caso permanece em aberto...\n");
+    printf("%-18s | %8s | %8s | %14s | %11s | %11s | %s\n", "estrutura", "leitores", "escritor", "consultas/s",
+           "ns/consulta", "ns/insercao", "encontradas");
+    if (concorrente != NULL) {
+        modelo.concorrente = concorrente;
+        medirTabelaConcorrente("concorrente", &modelo, leitores, n, 0);
+        medirTabelaConcorrente("concorrente", &modelo, leitores, n, insercoes);
+        printf("Tabela concorrente: %zu associacoes, %zu redimensionamentos, %zu blocos aguardando liberacao\n",
+               concorrente->quantidade, concorrente->redimensionamentos, concorrente->numAposentados);
+        liberarTabelaHashConcorrente(concorrente);
     }
+#ifndef _WIN32
+    pthread_rwlock_t trava;
+    if (tabela != NULL && pthread_rwlock_init(&trava, NULL) == 0) {
+        modelo.concorrente = NULL;
+        modelo.tabela = tabela;
+        modelo.trava = &trava;
+        medirTabelaConcorrente("hash + rwlock", &modelo, leitores, n, 0);
+        medirTabelaConcorrente("hash + rwlock", &modelo, leitores, n, insercoes);
+        pthread_rwlock_destroy(&trava);
+    }
+#endif
+    
+    liberarMemoriaHash(tabela);
+    free(pistas);
+    free(suspeitos);
 }
 
 /**
- * Função: inicializarSuspeitos
- * Propósito: Preencher a tabela hash com as associações entre pistas e suspeitos
- * Parâmetros: tabela - ponteiro para a tabela hash
+ * Função: benchmarkCatalogo
+ * Propósito: Comparar o catálogo embutido (hash perfeito em dados estáticos) com a tabela
+ * hash dinâmica preenchida com as mesmas associações: preparo da tabela e consultas
+ * Parâmetros: n - número de consultas (e de preparos) medidos
  * Retorno: void
  */
-void inicializarSuspeitos(TabelaHash* tabela) {
-    // Dr. Smith - especialista em venenos
-    inserirNaHash(tabela, "Livro sobre venenos deixado aberto na mesa", "Dr. Smith");
-    inserirNaHash(tabela, "Frasco vazio de arsênico", "Dr. Smith");
-    inserirNaHash(tabela, "Flores venenosas recentemente colhidas", "Dr. Smith");
+void benchmarkCatalogo(size_t n) {
+    const CatalogoEmbutido* catalogo = &catalogoEmbutido;
+    IdTexto pistas[256];
+    size_t numPistas = 0;
+    for (IdTexto id = 1; id < catalogo->numTextos && numPistas < 256; id++) {
+        if (catalogo->suspeitos[id] != ID_TEXTO_INVALIDO) pistas[numPistas++] = id;
+    }
+    if (numPistas == 0 || n == 0) {
+        printf("Catalogo embutido sem pistas: nada a medir.\n");
+        return;
+    }
+    size_t preparos = n / 100 > 0 ? n / 100 : 1;
     
-    // Sra. Johnson - acesso aos documentos
-    inserirNaHash(tabela, "Carta de ameaca parcialmente queimada", "Sra. Johnson");
-    inserirNaHash(tabela, "Documento com assinatura falsificada", "Sra. Johnson");
+    printf("=== BENCHMARK: CATALOGO EMBUTIDO (%u textos, %zu pistas, %zu consultas) ===\n", catalogo->numTextos,
+           numPistas, n);
+    printf("%-28s | %12s | %12s | %14s | %s\n", "operacao", "operacoes", "total ms", "ns/op", "verificacao");
     
-    // Sr. Williams - conhece a casa
-    inserirNaHash(tabela, "Uma pegada estranha na entrada principal", "Sr. Williams");
-    inserirNaHash(tabela, "Cinzas ainda quentes na lareira", "Sr. Williams");
-    inserirNaHash(tabela, "Partitura com codigo secreto", "Sr. Williams");
+    // Preparo da tabela de suspeitos: ligar o catálogo x inserir cada associação
+    size_t verificacao = 0;
+    double inicio = tempoAtualSegundos();
+    for (size_t r = 0; r < preparos; r++) {
+        TabelaHash* tabela = criarTabelaHash();
+        if (tabela == NULL) return;
+        inicializarSuspeitos(tabela);
+        verificacao += tabela->capacidade;
+        liberarMemoriaHash(tabela);
+    }
+    exibirMedicao("preparo embutido", preparos, tempoAtualSegundos() - inicio, verificacao);
+    
+    verificacao = 0;
+    inicio = tempoAtualSegundos();
+    for (size_t r = 0; r < preparos; r++) {
+        TabelaHash* tabela = criarTabelaHash();
+        if (tabela == NULL) return;
+        for (size_t i = 0; i < numPistas; i++) {
+            inserirNaHash(tabela, catalogo->textos[pistas[i]], catalogo->textos[catalogo->suspeitos[pistas[i]]]);
+        }
+        verificacao += tabela->capacidade;
+        liberarMemoriaHash(tabela);
+    }
+    exibirMedicao("preparo dinamico", preparos, tempoAtualSegundos() - inicio, verificacao);
+    
+    // Consultas: pelo texto da pista (encontrarSuspeito) e pelo id (caminho do jogo)
+    TabelaHash* embutida = criarTabelaHash();
+    TabelaHash* dinamica = criarTabelaHash();
+    if (embutida == NULL || dinamica == NULL) {
+        liberarMemoriaHash(embutida);
+        liberarMemoriaHash(dinamica);
+        return;
+    }
+    inicializarSuspeitos(embutida);
+    for (size_t i = 0; i < numPistas; i++) {
+        inserirNaHashPorId(dinamica, pistas[i], catalogo->suspeitos[pistas[i]]);
+    }
+    TabelaHash* tabelas[2] = { embutida, dinamica };
+    const char* rotulosTexto[2] = { "encontrarSuspeito embutido", "encontrarSuspeito dinamico" };
+    const char* rotulosId[2] = { "por id embutido", "por id dinamico" };
+    for (int t = 0; t < 2; t++) {
+        verificacao = 0;
+        inicio = tempoAtualSegundos();
+        for (size_t i = 0; i < n; i++) {
+            const char* suspeito = encontrarSuspeito(tabelas[t], catalogo->textos[pistas[i % numPistas]]);
+            verificacao += suspeito != NULL ? (size_t)suspeito[0] : 0;
+        }
+        exibirMedicao(rotulosTexto[t], n, tempoAtualSegundos() - inicio, verificacao);
+    }
+    for (int t = 0; t < 2; t++) {
+        verificacao = 0;
+        inicio = tempoAtualSegundos();
+        for (size_t i = 0; i < n; i++) {
+            verificacao += encontrarSuspeitoPorId(tabelas[t], pistas[i % numPistas]);
+        }
+        exibirMedicao(rotulosId[t], n, tempoAtualSegundos() - inicio, verificacao);
+    }
     
-    // Mordomo James - acesso à cozinha e jardim
-    inserirNaHash(tabela, "Faca com manchas suspeitas", "Mordomo James");
-    inserirNaHash(tabela, "Luvas com residuos toxicos", "Mordomo James");
+    liberarMemoriaHash(embutida);
+    liberarMemoriaHash(dinamica);
 }
 
 /**
- * Função: explorarSalas
- * Propósito: Permitir a navegação interativa do jogador pela mansão com coleta de pistas
- * Parâmetros: salaAtual - ponteiro para a sala onde o jogador está
- *             arvorePistas - ponteiro para ponteiro da raiz da árvore de pistas
- *             tabela - ponteiro para a tabela hash de suspeitos
+ * Função: benchmarkCasos
+ * Propósito: Medir o acervo com n casos gerados em disco: memória por caso, textos
+ * compartilhados entre os casos e latência da troca de caso (primeira leitura, caso já em
+ * memória e trocas sob um orçamento de 1/4 da memória, que força despejos LRU)
+ * Parâmetros: n - número de casos
  * Retorno: void
  */
-void explorarSalas(Sala* salaAtual, PistaNode** arvorePistas, TabelaHash* tabela) {
-    char escolha;
-    int pistasColetadas = 0;
+void benchmarkCasos(size_t n) {
+    const char* caminhoLista = "bench_casos_tmp.txt";
+    const size_t salasPorCaso = 2000;
+    if (n == 0) return;
+    FILE* lista = fopen(caminhoLista, "w");
+    if (lista == NULL) {
+        printf("Erro: Nao foi possivel criar a lista de casos %s!\n", caminhoLista);
+        return;
+    }
+    
+    // Casos distintos (sementes e números de suspeitos diferentes), gravados em mapas binários
+    ParametrosGerador parametros;
+    iniciarParametrosGerador(&parametros);
+    parametros.numSalas = salasPorCaso;
+    uint64_t textosSeparados = 0;  // Bytes de texto se cada caso guardasse os seus
+    char caminho[64];
+    size_t gerados = 0;
+    for (size_t i = 0; i < n; i++) {
+        parametros.semente = i + 1;
+        parametros.numSuspeitos = 4 + (uint32_t)(i % 8);
+        MapaMansao* mapa = gerarMapaMansao(&parametros, 1);
+        snprintf(caminho, sizeof(caminho), "bench_caso_%zu_tmp.dqm", i);
+        int ok = mapa != NULL && salvarMapaBinario(mapa, caminho);
+        if (mapa != NULL) textosSeparados += mapa->tamanhoTextos;
+        liberarMapa(mapa);
+        if (!ok) break;
+        fprintf(lista, "%s\n", caminho);
+        gerados++;
+    }
+    fclose(lista);
     
-    // Continua explorando até o jogador decidir sair
-    while (salaAtual != NULL) {
-        printf("\n=== DETECTIVE QUEST - NIVEL MESTRE ===\n");
-        printf("Voce esta na: %s\n", salaAtual->nome);
+    size_t textosAntes = textosInternados.quantidade;
+    size_t caracteresAntes = textosInternados.armazenamento != NULL ? textosInternados.armazenamento->bytesAlocados : 0;
+    AcervoCasos* acervo = gerados == n ? criarAcervoCasos(caminhoLista, 0) : NULL;
+    if (acervo != NULL) {
+        printf("=== BENCHMARK: ACERVO DE CASOS (%zu casos de %zu salas) ===\n", n, salasPorCaso);
+        printf("%-28s | %12s | %12s | %14s | %s\n", "operacao", "operacoes", "total ms", "ns/op", "verificacao");
         
-        // Verifica se há uma pista nesta sala
-        if (strlen(salaAtual->pista) > 0) {
-            printf("\n*** PISTA ENCONTRADA! ***\n");
-            printf("Pista: %s\n", salaAtual->pista);
-            
-            // Adiciona a pista à árvore de pistas
-            *arvorePistas = inserirPista(*arvorePistas, salaAtual->pista);
-            pistasColetadas++;
-            
-            // Encontra o suspeito associado à pista
-            char* suspeito = encontrarSuspeito(tabela, salaAtual->pista);
-            if (suspeito != NULL) {
-                printf("Esta pista aponta para: %s\n", suspeito);
-            } else {
-                printf("Pista nao associada a nenhum suspeito conhecido.\n");
-            }
-            
-            printf("Pista adicionada ao seu caderno de investigacao!\n");
-        } else {
-            printf("\nEsta sala nao contem pistas visiveis.\n");
+        // Primeira abertura de cada caso: leitura do mapa e montagem da mansão
+        double inicio = tempoAtualSegundos();
+        for (size_t i = 0; i < n; i++) {
+            soltarCasoAcervo(acervo, abrirCasoAcervo(acervo, i));
         }
+        exibirMedicao("abrir caso (disco)", n, tempoAtualSegundos() - inicio, acervo->leituras);
+        size_t memoriaTotal = acervo->bytesCarregados;
+        size_t textosDepois = textosInternados.quantidade;
+        size_t caracteresDepois = textosInternados.armazenamento != NULL ? textosInternados.armazenamento->bytesAlocados : 0;
         
-        // Verifica se é uma sala final (nó-folha)
-        if (salaAtual->esquerda == NULL && salaAtual->direita == NULL) {
-            printf("\nVoce chegou ao fim deste caminho!\n");
-            printf("Esta sala nao possui mais saidas.\n");
-            printf("Pressione 's' para sair ou explore outro caminho.\n");
+        // Trocas entre casos já em memória, em ordem sorteada
+        size_t trocas = n * 100;
+        uint64_t estado = 88172645463325252ull;
+        size_t verificacao = 0;
+        inicio = tempoAtualSegundos();
+        for (size_t t = 0; t < trocas; t++) {
+            estado ^= estado << 13;
+            estado ^= estado >> 7;
+            estado ^= estado << 17;
+            CasoAcervo* caso = abrirCasoAcervo(acervo, (size_t)(estado % n));
+            if (caso != NULL) verificacao += caso->hall->nome;
+            soltarCasoAcervo(acervo, caso);
         }
+        exibirMedicao("trocar caso (em memoria)", trocas, tempoAtualSegundos() - inicio, verificacao);
         
-        // Exibe as opções disponíveis
-        printf("\nOpcoes de navegacao:\n");
-        if (salaAtual->esquerda != NULL) {
-            printf("(e) - Ir para a esquerda: %s\n", salaAtual->esquerda->nome);
-        }
-        if (salaAtual->direita != NULL) {
-            printf("(d) - Ir para a direita: %s\n", salaAtual->direita->nome);
+        // Orçamento de 1/4: trocas uniformes e com 90% delas em um grupo de 10% dos casos
+        acervo->orcamento = memoriaTotal / 4 > 0 ? memoriaTotal / 4 : 1;
+        size_t quentes = n / 10 > 0 ? n / 10 : 1;
+        const char* rotulos[2] = { "trocar caso 1/4 uniforme", "trocar caso 1/4 localidade" };
+        for (int modo = 0; modo < 2; modo++) {
+            size_t leituras = acervo->leituras;
+            inicio = tempoAtualSegundos();
+            for (size_t t = 0; t < trocas / 10; t++) {
+                estado ^= estado << 13;
+                estado ^= estado >> 7;
+                estado ^= estado << 17;
+                size_t escolhido = modo == 0 || estado % 10 == 0 ? (size_t)((estado >> 8) % n)
+                                                                 : (size_t)((estado >> 8) % quentes);
+                soltarCasoAcervo(acervo, abrirCasoAcervo(acervo, escolhido));
+            }
+            exibirMedicao(rotulos[modo], trocas / 10, tempoAtualSegundos() - inicio, acervo->leituras - leituras);
         }
-        printf("(s) - Encerrar investigacao e fazer acusacao final\n");
         
-        printf("\nEscolha sua acao: ");
-        scanf(" %c", &escolha);
-        getchar(); // Limpa o buffer para fgets
-        
-        // Processa a escolha do jogador
-        switch (escolha) {
-            case 'e':
-            case 'E':
-                if (salaAtual->esquerda != NULL) {
-                    salaAtual = salaAtual->esquerda;
-                    printf("\nMovendo-se para a esquerda...\n");
-                } else {
-                    printf("\nNao ha caminho a esquerda! Tente outra direcao.\n");
-                }
-                break;
-                
-            case 'd':
-            case 'D':
-                if (salaAtual->direita != NULL) {
-                    salaAtual = salaAtual->direita;
-                    printf("\nMovendo-se para a direita...\n");
-                } else {
-                    printf("\nNao ha caminho a direita! Tente outra direcao.\n");
-                }
-                break;
-                
-            case 's':
-            case 'S':
-                printf("\n=== RELATORIO FINAL DE INVESTIGACAO ===\n");
-                printf("Investigacao da mansao encerrada!\n");
-                
-                // Exibe todas as pistas coletadas
-                if (*arvorePistas != NULL) {
-                    printf("\nPistas coletadas (em ordem alfabetica):\n");
-                    printf("========================================\n");
-                    int contador = 0;
-                    exibirPistas(*arvorePistas, &contador);
-                    printf("========================================\n");
-                    printf("Total de pistas coletadas: %d\n", contador);
-                    
-                    // Inicia a fase de acusação final
-                    verificarSuspeitoFinal(*arvorePistas, tabela);
-                } else {
-                    printf("\nNenhuma pista foi coletada durante a investigacao.\n");
-                    printf("Impossivel fazer uma acusacao sem evidencias!\n");
-                }
-                
-                printf("\nObrigado por jogar Detective Quest - Nivel Mestre!\n");
-                return;
-                
-            default:
-                printf("\nOpcao invalida! Use 'e' para esquerda, 'd' para direita ou 's' para sair.\n");
-                break;
-        }
+        printf("\nMemoria por caso: %.1f KiB em media (salas, tabela e lista de suspeitos); %zu KiB com todos em memoria\n",
+               (double)memoriaTotal / n / 1024.0, memoriaTotal / 1024);
+        printf("Textos compartilhados: %zu textos, %zu KiB de caracteres (cada caso com os seus: %llu KiB)\n",
+               textosDepois - textosAntes, (caracteresDepois - caracteresAntes) / 1024,
+               (unsigned long long)(textosSeparados / 1024));
+        printf("Orcamento de 1/4 (%zu KiB): %zu casos em memoria ao final, %zu despejos, %zu leituras do disco\n",
+               acervo->orcamento / 1024, acervo->carregados, acervo->despejos, acervo->leituras);
     }
-}
-
-/**
- * Função: liberarMemoriaSalas
- * Propósito: Liberar toda a memória alocada para a árvore de salas
- * Parâmetros: raiz - ponteiro para a raiz da árvore
- * Retorno: void
- */
-void liberarMemoriaSalas(Sala* raiz) {
-    if (raiz != NULL) {
-        liberarMemoriaSalas(raiz->esquerda);
-        liberarMemoriaSalas(raiz->direita);
-        free(raiz);
+    
+    liberarAcervoCasos(acervo);
+    for (size_t i = 0; i < gerados; i++) {
+        snprintf(caminho, sizeof(caminho), "bench_caso_%zu_tmp.dqm", i);
+        remove(caminho);
     }
+    remove(caminhoLista);
 }
 
 /**
- * Função: liberarMemoriaPistas
- * Propósito: Liberar toda a memória alocada para a árvore de pistas
- * Parâmetros: raiz - ponteiro para a raiz da árvore de pistas
- * Retorno: void
+ * Função: executarBenchmark
+ * Propósito: Despachar a opção --bench da linha de comando para o benchmark pedido
+ * Parâmetros: nome - nome do benchmark
+ *             parametro - tamanho máximo opcional (NULL para o padrão)
+ * Retorno: 0 em caso de sucesso, 1 se o benchmark não existir
  */
-void liberarMemoriaPistas(PistaNode* raiz) {
-    if (raiz != NULL) {
-        liberarMemoriaPistas(raiz->esquerda);
-        liberarMemoriaPistas(raiz->direita);
-        free(raiz);
+int executarBenchmark(const char* nome, const char* parametro) {
+    if (strcmp(nome, "hash") == 0) {
+        benchmarkHash(parametro != NULL ? strtoull(parametro, NULL, 10) : 1000000);
+        return 0;
+    }
+    if (strcmp(nome, "pistas") == 0) {
+        benchmarkPistas(parametro != NULL ? strtoull(parametro, NULL, 10) : 1000000);
+        return 0;
     }
-}
-
-/**
- * Função: liberarMemoriaHash
- * Propósito: Liberar toda a memória alocada para a tabela hash
- * Parâmetros: tabela - ponteiro para a tabela hash
- * Retorno: void
- */
-void liberarMemoriaHash(TabelaHash* tabela) {
-    if (tabela == NULL) return;
     
-    for (int i = 0; i < TAMANHO_HASH; i++) {
-        HashNode* atual = tabela->tabela[i];
-        while (atual != NULL) {
-            HashNode* temp = atual;
-            atual = atual->proximo;
-            free(temp);
+    if (strcmp(nome, "arena") == 0) {
+        benchmarkArena(parametro != NULL ? strtoull(parametro, NULL, 10) : 1000000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "mapa") == 0) {
+        benchmarkMapa(parametro != NULL ? strtoull(parametro, NULL, 10) : 1000000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "paralelo") == 0) {
+        benchmarkParalelo(parametro != NULL ? strtoull(parametro, NULL, 10) : 2000000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "solucionador") == 0) {
+        benchmarkSolucionador(parametro != NULL ? strtoull(parametro, NULL, 10) : 1000000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "estruturas") == 0) {
+        benchmarkEstruturas(parametro != NULL ? strtoull(parametro, NULL, 10) : 100000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "percursos") == 0) {
+        benchmarkPercursos(parametro != NULL ? strtoull(parametro, NULL, 10) : 1000000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "grafo") == 0) {
+        benchmarkGrafo(parametro != NULL ? strtoull(parametro, NULL, 10) : 1000000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "estados") == 0) {
+        benchmarkEstados(parametro != NULL ? strtoull(parametro, NULL, 10) : 1000000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "evidencias") == 0) {
+        benchmarkEvidencias(parametro != NULL ? strtoull(parametro, NULL, 10) : 50000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "textos") == 0) {
+        benchmarkTextos(parametro != NULL ? strtoull(parametro, NULL, 10) : 1000000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "gerador") == 0) {
+        benchmarkGerador(parametro != NULL ? strtoull(parametro, NULL, 10) : 10000000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "concorrente") == 0) {
+        benchmarkConcorrente(parametro != NULL ? strtoull(parametro, NULL, 10) : 1000000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "catalogo") == 0) {
+        benchmarkCatalogo(parametro != NULL ? strtoull(parametro, NULL, 10) : 10000000);
+        return 0;
+    }
+    
+    if (strcmp(nome, "casos") == 0) {
+        benchmarkCasos(parametro != NULL ? strtoull(parametro, NULL, 10) : 200);
+        return 0;
+    }
+    
+    // Todos os benchmarks em sequência (com o mesmo tamanho, se informado)
+    if (strcmp(nome, "todos") == 0) {
+        const char* nomes[] = { "estruturas", "hash", "pistas", "arena", "mapa", "paralelo", "solucionador",
+                                "percursos", "grafo", "estados", "evidencias", "textos", "gerador", "concorrente", "catalogo",
+                                "casos" };
+        for (size_t i = 0; i < sizeof(nomes) / sizeof(nomes[0]); i++) {
+            executarBenchmark(nomes[i], parametro);
+            printf("\n");
         }
+        return 0;
     }
-    free(tabela);
+    
+    printf("Benchmark desconhecido: %s\n", nome);
+    printf("Disponiveis: estruturas, hash, pistas, arena, mapa, paralelo, solucionador, percursos, grafo, estados,\n");
+    printf("             evidencias, textos, gerador, concorrente, catalogo, casos, todos\n");
+    return 1;
 }
 
 /**
  * Função: main
  * Propósito: Montar o mapa inicial da mansão com pistas, inicializar a tabela de suspeitos
  * e iniciar a exploração completa do nível mestre
+ * Parâmetros: argc, argv - opções da linha de comando:
+ *             --bench <nome> [tamanho]     executa um benchmark em vez do jogo
+ *             --mapa <arquivo>             joga em uma mansão carregada de arquivo (texto ou binário)
+ *             --converter <entrada> <saida> converte um mapa entre os formatos texto e binário
+ *             --gerar-catalogo <mapa> <saida.h> gera o cabeçalho do catálogo embutido de um mapa
+ *             --carga <endereco> <roteiro> [conexoes] [sessoes] gerador de carga para o servidor
+ *             --lote <roteiro>             executa as sessões do roteiro sem interação
+ *             --repeticoes <n>             (lote) executa o roteiro n vezes
+ *             --saida texto|eventos|nenhuma mensagens em prosa (padrão), um evento JSON por linha
+ *                                          ou nenhuma (jogo e registros do lote)
+ *             --silencioso                 o mesmo que --saida nenhuma
+ *             --threads <n>                (lote/solucionador) threads de trabalho (padrão: todos os núcleos)
+ *             --resolver                   enumera todos os caminhos e acusações possíveis da mansão
+ *             --servidor <porta|caminho>   atende uma sessão por conexão (TCP em 127.0.0.1 ou socket Unix)
+ *             --casos <lista>              (jogo/servidor) cada sessão escolhe um caso da lista de mapas
+ *             --memoria-casos <KiB>        orçamento das salas e tabelas dos casos em memória, sem os
+ *                                          textos internados (padrão 256 MiB; 0 = sem limite)
+ *             --salas <n>                  joga (ou executa o lote/solucionador) em uma mansão gerada
+ *             --gerar-mapa <arquivo>       grava a mansão gerada em um mapa binário, em blocos
+ *             --semente, --profundidade, --equilibrio, --densidade-pistas, --suspeitos
+ *                                          parâmetros do gerador (ver ParametrosGerador)
  * Retorno: 0 se o programa executar com sucesso
  */
-int main() {
-    printf("=== BEM-VINDO AO DETECTIVE QUEST - NIVEL MESTRE ===\n");
-    printf("Explore a mansao misteriosa, colete pistas e desvende quem e o culpado!\n");
-    printf("Use 'e' para ir a esquerda, 'd' para direita e 's' para encerrar.\n");
-    printf("As pistas serao associadas automaticamente aos suspeitos!\n");
-    printf("No final, voce devera fazer uma acusacao baseada nas evidencias!\n");
+int main(int argc, char* argv[]) {
+#ifdef DQ_INSTRUMENTAR
+    atexit(exibirInstrumentacao);
+#endif
+    if (argc >= 3 && strcmp(argv[1], "--bench") == 0) {
+        return executarBenchmark(argv[2], argc >= 4 ? argv[3] : NULL);
+    }
+    if (argc >= 4 && strcmp(argv[1], "--converter") == 0) {
+        return converterMapa(argv[2], argv[3]) ? 0 : 1;
+    }
+    if (argc >= 4 && strcmp(argv[1], "--gerar-catalogo") == 0) {
+        return gerarCatalogoEmbutido(argv[2], argv[3]) ? 0 : 1;
+    }
+    if (argc >= 4 && strcmp(argv[1], "--carga") == 0) {
+        size_t conexoes = argc >= 5 ? strtoull(argv[4], NULL, 10) : CONEXOES_PADRAO_CARGA;
+        size_t sessoes = argc >= 6 ? strtoull(argv[5], NULL, 10) : conexoes * SESSOES_POR_CONEXAO_CARGA;
+        return executarCarga(argv[2], argv[3], conexoes, sessoes);
+    }
+    
+    // Opções do jogo e do modo em lote
+    const char* caminhoMapa = NULL;
+    const char* caminhoRoteiro = NULL;
+    size_t repeticoes = 1;
+    ModoSaida modoSaida = SAIDA_TEXTO;
+    int resolver = 0;
+    const char* caminhoRetomar = NULL;
+    const char* caminhoSalvar = NULL;
+    int numThreads = numeroDeNucleos();
+    ParametrosGerador parametros;
+    iniciarParametrosGerador(&parametros);
+    int gerar = 0;
+    const char* caminhoGerado = NULL;
+    const char* enderecoServidor = NULL;
+    const char* caminhoCasos = NULL;
+    size_t orcamentoCasosKiB = ORCAMENTO_PADRAO_CASOS_KIB;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mapa") == 0 && i + 1 < argc) {
+            caminhoMapa = argv[++i];
+        } else if (strcmp(argv[i], "--lote") == 0 && i + 1 < argc) {
+            caminhoRoteiro = argv[++i];
+        } else if (strcmp(argv[i], "--repeticoes") == 0 && i + 1 < argc) {
+            repeticoes = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            numThreads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--retomar") == 0 && i + 1 < argc) {
+            caminhoRetomar = argv[++i];
+        } else if (strcmp(argv[i], "--salvar-estado") == 0 && i + 1 < argc) {
+            caminhoSalvar = argv[++i];
+        } else if (strcmp(argv[i], "--saida") == 0 && i + 1 < argc) {
+            const char* modo = argv[++i];
+            if (strcmp(modo, "texto") == 0) {
+                modoSaida = SAIDA_TEXTO;
+            } else if (strcmp(modo, "eventos") == 0) {
+                modoSaida = SAIDA_EVENTOS;
+            } else if (strcmp(modo, "nenhuma") == 0) {
+                modoSaida = SAIDA_NENHUMA;
+            } else {
+                printf("Saida desconhecida: %s (use texto, eventos ou nenhuma)\n", modo);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--silencioso") == 0) {
+            modoSaida = SAIDA_NENHUMA;
+        } else if (strcmp(argv[i], "--resolver") == 0) {
+            resolver = 1;
+        } else if (strcmp(argv[i], "--servidor") == 0 && i + 1 < argc) {
+            enderecoServidor = argv[++i];
+        } else if (strcmp(argv[i], "--casos") == 0 && i + 1 < argc) {
+            caminhoCasos = argv[++i];
+        } else if (strcmp(argv[i], "--memoria-casos") == 0 && i + 1 < argc) {
+            orcamentoCasosKiB = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--salas") == 0 && i + 1 < argc) {
+            parametros.numSalas = strtoull(argv[++i], NULL, 10);
+            gerar = 1;
+        } else if (strcmp(argv[i], "--gerar-mapa") == 0 && i + 1 < argc) {
+            caminhoGerado = argv[++i];
+        } else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc) {
+            parametros.semente = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--profundidade") == 0 && i + 1 < argc) {
+            parametros.profundidadeMaxima = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--equilibrio") == 0 && i + 1 < argc) {
+            parametros.equilibrio = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--densidade-pistas") == 0 && i + 1 < argc) {
+            parametros.densidadePistas = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--suspeitos") == 0 && i + 1 < argc) {
+            parametros.numSuspeitos = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else {
+            printf("Opcao desconhecida: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    
+    // Mansão gerada gravada direto em arquivo, sem jogar
+    if (caminhoGerado != NULL) {
+        double inicio = tempoAtualSegundos();
+        if (!gravarMansaoGerada(&parametros, caminhoGerado, numThreads)) return 1;
+        printf("Mansao gerada em %s: %llu salas em %.3f s (%d threads).\n", caminhoGerado,
+               (unsigned long long)parametros.numSalas, tempoAtualSegundos() - inicio, numThreads);
+        return 0;
+    }
+    if (gerar && caminhoMapa != NULL) {
+        printf("Erro: Use --mapa ou --salas, nao os dois!\n");
+        return 1;
+    }
+    
+    // Acervo de casos: cada sessão escolhe o seu, no terminal ou no servidor
+    if (caminhoCasos != NULL) {
+        if (caminhoMapa != NULL || gerar || caminhoRoteiro != NULL || resolver) {
+            printf("Erro: --casos vale apenas para o jogo e o servidor (sem --mapa, --salas, --lote ou --resolver)!\n");
+            return 1;
+        }
+        return executarAcervo(caminhoCasos, orcamentoCasosKiB * 1024, enderecoServidor, modoSaida);
+    }
+    
+    // Mapa opcional carregado de arquivo ou gerado em memória
+    MapaMansao* mapa = NULL;
+    if (caminhoMapa != NULL || gerar) {
+        mapa = gerar ? gerarMapaMansao(&parametros, numThreads) : carregarMapa(caminhoMapa);
+        if (mapa == NULL) {
+            return 1;
+        }
+    }
+    
+    // Todos os nós da sessão (salas, pistas e hash) são alocados em uma arena
+    Arena* arenaSessao = criarArena(0);
+    if (arenaSessao == NULL) {
+        liberarMapa(mapa);
+        return 1;
+    }
+    usarArena(arenaSessao);
     
     // Inicializa a árvore de pistas como vazia
     PistaNode* arvorePistas = NULL;
@@ -528,68 +11490,81 @@ int main() {
     TabelaHash* tabelaSuspeitos = criarTabelaHash();
     if (tabelaSuspeitos == NULL) {
         printf("Erro: Nao foi possivel criar a tabela de suspeitos!\n");
+        liberarArena(arenaSessao);
+        liberarMapa(mapa);
         return 1;
     }
     
     // Preenche a tabela hash com as associações pista/suspeito
-    inicializarSuspeitos(tabelaSuspeitos);
-    
-    // Criação manual da árvore binária representando o mapa da mansão com pistas
-    
-    // Nível 0 - Raiz (Hall de entrada)
-    Sala* hallEntrada = criarSala("Hall de Entrada", "Uma pegada estranha na entrada principal");
-    
-    // Nível 1
-    Sala* biblioteca = criarSala("Biblioteca", "Livro sobre venenos deixado aberto na mesa");
-    Sala* salaEstar = criarSala("Sala de Estar", "Cinzas ainda quentes na lareira");
-    
-    // Nível 2 - Lado esquerdo (filhos da Biblioteca)
-    Sala* escritorio = criarSala("Escritorio", "Carta de ameaca parcialmente queimada");
-    Sala* salaMusica = criarSala("Sala de Musica", "");  // Sem pista
-    
-    // Nível 2 - Lado direito (filhos da Sala de Estar)
-    Sala* cozinha = criarSala("Cozinha", "Faca com manchas suspeitas");
-    Sala* jardim = criarSala("Jardim", "Flores venenosas recentemente colhidas");
-    
-    // Nível 3 - Folhas (salas finais)
-    Sala* cofre = criarSala("Cofre Secreto", "Documento com assinatura falsificada");
-    Sala* piano = criarSala("Piano Antigo", "Partitura com codigo secreto");
-    Sala* despensa = criarSala("Despensa", "Frasco vazio de arsênico");
-    Sala* greenhouse = criarSala("Estufa", "Luvas com residuos toxicos");
-    
-    // Montagem da estrutura da árvore
-    
-    // Hall de entrada -> Biblioteca (esquerda) e Sala de Estar (direita)
-    hallEntrada->esquerda = biblioteca;
-    hallEntrada->direita = salaEstar;
-    
-    // Biblioteca -> Escritório (esquerda) e Sala de Música (direita)
-    biblioteca->esquerda = escritorio;
-    biblioteca->direita = salaMusica;
-    
-    // Sala de Estar -> Cozinha (esquerda) e Jardim (direita)
-    salaEstar->esquerda = cozinha;
-    salaEstar->direita = jardim;
+    if (mapa != NULL && !carregarSuspeitosDoMapa(mapa, tabelaSuspeitos)) {
+        liberarMemoriaHash(tabelaSuspeitos);
+        liberarArena(arenaSessao);
+        liberarMapa(mapa);
+        return 1;
+    } else if (mapa == NULL) {
+        inicializarSuspeitos(tabelaSuspeitos);
+    }
     
-    // Escritório -> Cofre Secreto (esquerda apenas)
-    escritorio->esquerda = cofre;
+    // Cria o índice de evidências por suspeito (preenchido durante a exploração)
+    IndiceSuspeitos* indiceSuspeitos = criarIndiceSuspeitos();
+    if (indiceSuspeitos == NULL) {
+        liberarMemoriaHash(tabelaSuspeitos);
+        liberarArena(arenaSessao);
+        liberarMapa(mapa);
+        return 1;
+    }
     
-    // Sala de Música -> Piano Antigo (direita apenas)
-    salaMusica->direita = piano;
+    // Monta a mansão: a partir do arquivo de mapa ou a mansão padrão
+    Sala* hallEntrada = mapa != NULL ? construirSalasDoMapa(mapa) : construirMansaoPadrao();
+    if (hallEntrada == NULL) {
+        printf("Erro: Nao foi possivel montar a mansao!\n");
+        liberarMemoriaHash(tabelaSuspeitos);
+        liberarIndiceSuspeitos(indiceSuspeitos);
+        liberarArena(arenaSessao);
+        liberarMapa(mapa);
+        return 1;
+    }
     
-    // Cozinha -> Despensa (esquerda apenas)
-    cozinha->esquerda = despensa;
+    // Dicas de acusação (jogo e servidor): cada sala sabe, de antemão, se ainda leva a uma condenação
+    if (caminhoRoteiro == NULL && !resolver && !resumirCondenacoes(hallEntrada, tabelaSuspeitos)) {
+        liberarMemoriaSalas(hallEntrada, arenaSessao);
+        liberarMemoriaHash(tabelaSuspeitos);
+        liberarIndiceSuspeitos(indiceSuspeitos);
+        liberarArena(arenaSessao);
+        liberarMapa(mapa);
+        return 1;
+    }
     
-    // Jardim -> Estufa (direita apenas)
-    jardim->direita = greenhouse;
+    // Mensagens do jogo e registros do lote passam pela saída com buffer
+    SaidaJogo saida;
+    iniciarSaidaJogo(&saida, modoSaida, stdout);
+    if (caminhoRoteiro == NULL && !resolver && enderecoServidor == NULL) {
+        exibirBoasVindas(&saida);
+    }
     
-    // Inicia a exploração a partir do Hall de entrada
-    explorarSalas(hallEntrada, &arvorePistas, tabelaSuspeitos);
+    // Inicia a exploração a partir do Hall de entrada (ou executa o roteiro em lote / o solucionador /
+    // o servidor de sessões)
+    int codigoSaida = 0;
+    if (resolver) {
+        codigoSaida = executarSolucionador(hallEntrada, tabelaSuspeitos, numThreads);
+    } else if (caminhoRoteiro != NULL) {
+        codigoSaida = executarLote(caminhoRoteiro, hallEntrada, tabelaSuspeitos, repeticoes, numThreads, &saida,
+                                   caminhoRetomar, caminhoSalvar);
+    } else if (enderecoServidor != NULL) {
+        codigoSaida = executarServidor(enderecoServidor, hallEntrada, tabelaSuspeitos, NULL, modoSaida);
+    } else {
+        explorarSalas(&saida, hallEntrada, &arvorePistas, tabelaSuspeitos, indiceSuspeitos);
+    }
+    finalizarSaidaJogo(&saida);
     
-    // Libera toda a memória alocada
-    liberarMemoriaSalas(hallEntrada);
-    liberarMemoriaPistas(arvorePistas);
+    // Libera toda a memória alocada (os nós saem de uma só vez com a arena)
+    liberarMemoriaSalas(hallEntrada, arenaSessao);
+    liberarMemoriaPistas(arvorePistas, arenaSessao);
     liberarMemoriaHash(tabelaSuspeitos);
+    liberarIndiceSuspeitos(indiceSuspeitos);
+    liberarArena(arenaSessao);
+    liberarMapa(mapa);
+    liberarTextosInternados();
     
-    return 0;
+    return codigoSaida;
 }
\ No newline at end of file